@@ -0,0 +1,256 @@
+// Keep-alive allocation check: serves requests over one keep-alive connection from an
+// in-process http::server and reports the heap and arena allocations each route makes per
+// request, by phase. With --fail-on-alloc it exits non-zero if the steady-state path (after
+// warm-up) makes any heap allocation. Needs a build with -DKATANA_ALLOC_TRACKING=ON.
+
+#include "katana/core/alloc_tracking.hpp"
+#include "katana/core/http_server.hpp"
+#include "katana/core/router.hpp"
+#include "katana/core/shutdown.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std::chrono;
+using namespace katana;
+
+constexpr uint16_t DEFAULT_PORT = 18095;
+constexpr size_t WARMUP_REQUESTS = 2000;
+constexpr size_t MEASURED_REQUESTS = 20000;
+
+constexpr std::string_view REQUESTS[] = {
+    "GET / HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n",
+    "GET /users/42 HTTP/1.1\r\nHost: localhost\r\nConnection: keep-alive\r\n\r\n",
+};
+
+const http::router& bench_router() {
+    static const http::route_entry routes[] = {
+        {http::method::get,
+         http::path_pattern::from_literal<"/">(),
+         http::handler_fn([](const http::request&, http::request_context&) {
+             return http::response::ok("Hello, World!");
+         })},
+        {http::method::get,
+         http::path_pattern::from_literal<"/users/{id:int}">(),
+         http::handler_fn([](const http::request&, http::request_context& ctx) {
+             return http::response::json(R"({"id":)" +
+                                         std::string(ctx.params.get("id").value_or("0")) + "}");
+         })},
+    };
+    static const http::router r(routes);
+    return r;
+}
+
+uint16_t bench_port() {
+    if (const char* env = std::getenv("ALLOC_BENCH_PORT")) {
+        int v = std::atoi(env);
+        if (v > 0 && v <= 65535) {
+            return static_cast<uint16_t>(v);
+        }
+    }
+    return DEFAULT_PORT;
+}
+
+class keepalive_client {
+public:
+    bool connect(uint16_t port) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) {
+            return false;
+        }
+        int one = 1;
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    ~keepalive_client() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    // Sends `request` and reads one Content-Length framed response
+    bool round_trip(std::string_view request) {
+        if (::send(fd_, request.data(), request.size(), MSG_NOSIGNAL) !=
+            static_cast<ssize_t>(request.size())) {
+            return false;
+        }
+
+        buffer_.clear();
+        size_t header_end = std::string::npos;
+        size_t expected = 0;
+        while (header_end == std::string::npos || buffer_.size() < expected) {
+            char chunk[4096];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+
+            if (header_end == std::string::npos) {
+                header_end = buffer_.find("\r\n\r\n");
+                if (header_end == std::string::npos) {
+                    continue;
+                }
+                auto length_pos = buffer_.find("Content-Length: ");
+                if (length_pos == std::string::npos || length_pos > header_end) {
+                    return false;
+                }
+                expected = header_end + 4 +
+                           std::strtoul(buffer_.c_str() + length_pos + 16, nullptr, 10);
+            }
+        }
+        return buffer_.compare(0, 12, "HTTP/1.1 200") == 0;
+    }
+
+private:
+    int fd_ = -1;
+    std::string buffer_;
+};
+
+// Counters gathered between two alloc_metrics() calls
+std::vector<http::route_alloc_snapshot>
+difference(const std::vector<http::route_alloc_snapshot>& before,
+           const std::vector<http::route_alloc_snapshot>& after) {
+    std::vector<http::route_alloc_snapshot> result;
+    for (const auto& route : after) {
+        http::route_alloc_snapshot delta = route;
+        for (const auto& earlier : before) {
+            if (earlier.route != route.route) {
+                continue;
+            }
+            delta.requests -= earlier.requests;
+            for (size_t i = 0; i < ALLOC_PHASE_COUNT; ++i) {
+                auto& d = delta.phases[i];
+                const auto& e = earlier.phases[i];
+                d.heap_allocations -= e.heap_allocations;
+                d.heap_bytes -= e.heap_bytes;
+                d.heap_frees -= e.heap_frees;
+                d.arena_allocations -= e.arena_allocations;
+                d.arena_bytes -= e.arena_bytes;
+            }
+        }
+        if (delta.requests > 0) {
+            result.push_back(std::move(delta));
+        }
+    }
+    return result;
+}
+
+double per_request(uint64_t count, uint64_t requests) {
+    return static_cast<double>(count) / static_cast<double>(requests);
+}
+
+void print_report(const std::vector<http::route_alloc_snapshot>& routes) {
+    for (const auto& route : routes) {
+        std::cout << "\n=== " << route.route << " (" << route.requests << " requests) ===\n";
+        std::cout << std::left << std::setw(12) << "phase" << std::right << std::setw(14)
+                  << "heap allocs" << std::setw(14) << "heap bytes" << std::setw(14)
+                  << "arena allocs" << std::setw(14) << "arena bytes" << "   (per request)\n";
+        for (size_t i = 0; i < ALLOC_PHASE_COUNT; ++i) {
+            const auto& c = route.phases[i];
+            std::cout << std::left << std::setw(12) << alloc_phase_name(static_cast<alloc_phase>(i))
+                      << std::right << std::fixed << std::setprecision(2) << std::setw(14)
+                      << per_request(c.heap_allocations, route.requests) << std::setw(14)
+                      << per_request(c.heap_bytes, route.requests) << std::setw(14)
+                      << per_request(c.arena_allocations, route.requests) << std::setw(14)
+                      << per_request(c.arena_bytes, route.requests) << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool fail_on_alloc = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--fail-on-alloc") {
+            fail_on_alloc = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--fail-on-alloc]\n";
+            return 2;
+        }
+    }
+
+    std::cout << "========================================\n";
+    std::cout << "   KATANA Keep-Alive Allocation Check\n";
+    std::cout << "========================================\n";
+
+    if (!alloc_tracking::enabled) {
+        std::cout << "\nBuilt without KATANA_ALLOC_TRACKING: allocations are not counted.\n";
+        if (fail_on_alloc) {
+            std::cerr << "--fail-on-alloc needs a build configured with "
+                         "-DKATANA_ALLOC_TRACKING=ON\n";
+            return 2;
+        }
+    }
+
+    const uint16_t port = bench_port();
+    std::atomic<bool> started{false};
+    http::server server(bench_router());
+    server.listen(port).workers(1).on_start([&started] { started = true; });
+    std::thread server_thread([&server] { server.run(); });
+
+    while (!started) {
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+
+    keepalive_client client;
+    bool ok = client.connect(port);
+    for (size_t i = 0; ok && i < WARMUP_REQUESTS; ++i) {
+        ok = client.round_trip(REQUESTS[i % std::size(REQUESTS)]);
+    }
+
+    const auto before = server.alloc_metrics();
+    const auto start = steady_clock::now();
+    for (size_t i = 0; ok && i < MEASURED_REQUESTS; ++i) {
+        ok = client.round_trip(REQUESTS[i % std::size(REQUESTS)]);
+    }
+    const auto elapsed = steady_clock::now() - start;
+
+    // The last request is counted once the server has reset its connection for the next one
+    ok = ok && client.round_trip(REQUESTS[0]);
+    const auto steady = difference(before, server.alloc_metrics());
+
+    shutdown_manager::instance().trigger_shutdown();
+    server_thread.join();
+
+    if (!ok) {
+        std::cerr << "ERROR: request failed; is port " << port << " free? (ALLOC_BENCH_PORT)\n";
+        return 1;
+    }
+
+    std::cout << "\nRound trip: " << std::fixed << std::setprecision(2)
+              << static_cast<double>(duration_cast<nanoseconds>(elapsed).count()) /
+                     static_cast<double>(MEASURED_REQUESTS)
+              << " ns/request over " << MEASURED_REQUESTS << " keep-alive requests\n";
+    print_report(steady);
+
+    uint64_t heap_allocations = 0;
+    for (const auto& route : steady) {
+        heap_allocations += route.total().heap_allocations;
+    }
+    std::cout << "\nSteady-state heap allocations: " << heap_allocations << "\n";
+
+    if (fail_on_alloc && heap_allocations > 0) {
+        std::cerr << "FAIL: the keep-alive path allocated on the heap\n";
+        return 1;
+    }
+    return 0;
+}
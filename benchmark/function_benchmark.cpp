@@ -0,0 +1,177 @@
+#include "katana/core/function_ref.hpp"
+#include "katana/core/inplace_function.hpp"
+#include "katana/core/memory_pool.hpp"
+#include "katana/core/small_function.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace katana;
+
+struct benchmark_result {
+    std::string name;
+    double throughput;
+    double ns_per_op;
+    uint64_t operations;
+    uint64_t duration_ms;
+};
+
+void print_result(const benchmark_result& result) {
+    std::cout << "\n=== " << result.name << " ===\n";
+    std::cout << "Operations: " << result.operations << "\n";
+    std::cout << "Duration: " << result.duration_ms << " ms\n";
+    std::cout << "Throughput: " << std::fixed << std::setprecision(2) << result.throughput
+              << " ops/sec\n";
+    std::cout << "Per operation: " << std::fixed << std::setprecision(2) << result.ns_per_op
+              << " ns\n";
+}
+
+template <typename Body>
+benchmark_result run(const std::string& name, size_t num_operations, Body body) {
+    auto start = steady_clock::now();
+    uint64_t sink = body(num_operations);
+    auto end = steady_clock::now();
+
+    // Keeps the loops from being optimised away
+    if (sink == 42) {
+        std::cout << "";
+    }
+
+    auto elapsed_ns = static_cast<double>(duration_cast<nanoseconds>(end - start).count());
+    benchmark_result result;
+    result.name = name;
+    result.operations = num_operations;
+    result.duration_ms = static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count());
+    result.throughput = static_cast<double>(num_operations) * 1e9 / elapsed_ns;
+    result.ns_per_op = elapsed_ns / static_cast<double>(num_operations);
+    return result;
+}
+
+// Out of line, so the wrapper is only known by its type and its indirection is really paid
+template <typename Fn> [[gnu::noinline]] uint64_t call_loop(const Fn& fn, size_t n) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sum += fn(i);
+    }
+    return sum;
+}
+
+// A reactor task's life: built from a fresh capture, moved into place, called once, destroyed
+template <typename Fn, size_t CaptureSize>
+[[gnu::noinline]] uint64_t build_call_destroy_loop(size_t n) {
+    std::array<uint8_t, CaptureSize> capture{};
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        capture[0] = static_cast<uint8_t>(i);
+        Fn fn = [capture](size_t x) -> uint64_t { return x + capture[0]; };
+        Fn moved = std::move(fn);
+        sum += moved(i);
+    }
+    return sum;
+}
+
+constexpr size_t CALLS = 50000000;
+constexpr size_t BUILDS = 10000000;
+
+using small_fn = small_function<uint64_t(size_t), 128>;
+using inplace_fn = inplace_function<uint64_t(size_t), 128>;
+using std_fn = std::function<uint64_t(size_t)>;
+
+std::vector<benchmark_result> benchmark_call_overhead() {
+    std::vector<benchmark_result> results;
+    const uint64_t offset = 3;
+    auto lambda = [offset](size_t x) -> uint64_t { return x + offset; };
+    std::array<uint64_t, 32> table{};
+    table[31] = offset;
+    auto large = [table](size_t x) -> uint64_t { return x + table[31]; };
+
+    results.push_back(
+        run("direct call (inlined)", CALLS, [&](size_t n) { return call_loop(lambda, n); }));
+    results.push_back(run("function_ref", CALLS, [&](size_t n) {
+        return call_loop(function_ref<uint64_t(size_t)>(lambda), n);
+    }));
+    results.push_back(
+        run("inplace_function", CALLS, [&](size_t n) { return call_loop(inplace_fn(lambda), n); }));
+    results.push_back(run("small_function (inline)", CALLS, [&](size_t n) {
+        return call_loop(small_fn(lambda), n);
+    }));
+    results.push_back(run("small_function (out of line, 256 B)", CALLS, [&](size_t n) {
+        return call_loop(small_fn(large), n);
+    }));
+    results.push_back(run("std::function (small)", CALLS, [&](size_t n) {
+        return call_loop(std_fn(lambda), n);
+    }));
+    results.push_back(run("std::function (heap, 256 B)", CALLS, [&](size_t n) {
+        return call_loop(std_fn(large), n);
+    }));
+    return results;
+}
+
+std::vector<benchmark_result> benchmark_build_call_destroy() {
+    std::vector<benchmark_result> results;
+    results.push_back(run("inplace_function 96 B", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<inplace_fn, 96>(n);
+    }));
+    results.push_back(run("small_function 96 B (inline)", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<small_fn, 96>(n);
+    }));
+    results.push_back(run("std::function 96 B (heap)", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<std_fn, 96>(n);
+    }));
+
+    // What a reactor thread sees: the pool serves and recycles the out-of-line blocks
+    memory_pool pool;
+    memory_pool::set_current(&pool);
+    results.push_back(run("small_function 256 B (reactor pool)", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<small_fn, 256>(n);
+    }));
+    memory_pool::set_current(nullptr);
+
+    results.push_back(run("small_function 256 B (no pool)", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<small_fn, 256>(n);
+    }));
+    results.push_back(run("std::function 256 B (heap)", BUILDS, [](size_t n) {
+        return build_call_destroy_loop<std_fn, 256>(n);
+    }));
+    return results;
+}
+
+int main() {
+    std::cout << "========================================\n";
+    std::cout << "   KATANA Callable Wrapper Benchmarks\n";
+    std::cout << "========================================\n";
+
+    std::vector<benchmark_result> results;
+
+    std::cout << "\n[1/2] Benchmarking call overhead...\n";
+    for (auto& r : benchmark_call_overhead()) {
+        print_result(r);
+        results.push_back(std::move(r));
+    }
+
+    std::cout << "\n[2/2] Benchmarking build + move + call + destroy...\n";
+    for (auto& r : benchmark_build_call_destroy()) {
+        print_result(r);
+        results.push_back(std::move(r));
+    }
+
+    std::cout << "\n========================================\n";
+    std::cout << "         Benchmark Summary\n";
+    std::cout << "========================================\n";
+
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(40) << result.name << ": " << std::fixed
+                  << std::setprecision(2) << result.ns_per_op << " ns/op\n";
+    }
+
+    std::cout << "\nAll benchmarks completed successfully!\n";
+
+    return 0;
+}
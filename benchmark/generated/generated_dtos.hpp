@@ -16,6 +16,7 @@ struct UserInput {
     struct metadata {
         static constexpr bool NAME_REQUIRED = true;
         static constexpr size_t NAME_MIN_LENGTH = 1;
+        static constexpr std::string_view NAME_PATTERN = "^[A-Za-z][A-Za-z .-]{0,63}$";
         static constexpr bool EMAIL_REQUIRED = true;
         static constexpr bool AGE_REQUIRED = false;
         static constexpr double AGE_MINIMUM = 0;
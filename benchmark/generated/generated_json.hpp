@@ -2,21 +2,32 @@
 #pragma once
 
 #include "katana/core/arena.hpp"
+#include "katana/core/json_writer.hpp"
 #include "katana/core/serde.hpp"
+#include "katana/core/validation.hpp"
 #include <charconv>
+#include <cmath>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 using katana::monotonic_arena;
 
+using katana::is_valid_datetime;
+using katana::is_valid_email;
+using katana::is_valid_uuid;
+using katana::validation_error;
+using katana::validation_error_code;
+
 inline std::optional<UserInput> parse_UserInput(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_object_start())
         return std::nullopt;
 
     UserInput obj(arena);
+    static constexpr katana::serde::key_table keys{"name", "email", "age"};
     bool has_name = false;
     bool has_email = false;
 
@@ -28,28 +39,36 @@ inline std::optional<UserInput> parse_UserInput(std::string_view json, monotonic
         if (!key || !cur.consume(':'))
             break;
 
-        if (*key == "name") {
+        switch (keys.find(*key)) {
+        case 0: { // name
             has_name = true;
-            if (auto v = cur.string()) {
+            if (auto v = cur.unescaped_string(*arena)) {
                 obj.name = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
             } else {
                 cur.skip_value();
             }
-        } else if (*key == "email") {
+            break;
+        }
+        case 1: { // email
             has_email = true;
-            if (auto v = cur.string()) {
+            if (auto v = cur.unescaped_string(*arena)) {
                 obj.email = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
             } else {
                 cur.skip_value();
             }
-        } else if (*key == "age") {
-            if (auto v = katana::serde::parse_size(cur)) {
-                obj.age = static_cast<int64_t>(*v);
+            break;
+        }
+        case 2: { // age
+            if (auto v = katana::serde::parse_int64(cur)) {
+                obj.age = *v;
             } else {
                 cur.skip_value();
             }
-        } else {
+            break;
+        }
+        default:
             cur.skip_value();
+            break;
         }
         cur.try_comma();
     }
@@ -60,43 +79,197 @@ inline std::optional<UserInput> parse_UserInput(std::string_view json, monotonic
     return obj;
 }
 
+inline std::optional<validation_error>
+parse_validated_UserInput(std::string_view json, monotonic_arena* arena, UserInput& obj) {
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
+    if (!cur.try_object_start())
+        return validation_error{"", validation_error_code::invalid_type};
+
+    static constexpr katana::serde::key_table keys{"name", "email", "age"};
+    bool has_name = false;
+    bool has_email = false;
+
+    while (!cur.eof()) {
+        cur.skip_ws();
+        if (cur.try_object_end())
+            break;
+        auto key = cur.string();
+        if (!key || !cur.consume(':'))
+            return validation_error{"", validation_error_code::invalid_type};
+
+        switch (keys.find(*key)) {
+        case 0: { // name
+            has_name = true;
+            if (auto v = cur.unescaped_string(*arena)) {
+                obj.name = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
+            } else {
+                cur.skip_value();
+            }
+            if (obj.name.empty()) {
+                return validation_error{"name", validation_error_code::required_field_missing};
+            }
+            if (!obj.name.empty() && obj.name.size() < UserInput::metadata::NAME_MIN_LENGTH) {
+                return validation_error{"name",
+                                        validation_error_code::string_too_short,
+                                        UserInput::metadata::NAME_MIN_LENGTH};
+            }
+            {
+                static constexpr katana::pattern_dfa<66, 3> dfa_{
+                    {{32, 32, 1}, {45, 46, 1}, {65, 90, 2}, {97, 122, 2}},
+                    {0, 0, 0,
+                     0, 0, 2,
+                     0, 3, 3,
+                     0, 4, 4,
+                     0, 5, 5,
+                     0, 6, 6,
+                     0, 7, 7,
+                     0, 8, 8,
+                     0, 9, 9,
+                     0, 10, 10,
+                     0, 11, 11,
+                     0, 12, 12,
+                     0, 13, 13,
+                     0, 14, 14,
+                     0, 15, 15,
+                     0, 16, 16,
+                     0, 17, 17,
+                     0, 18, 18,
+                     0, 19, 19,
+                     0, 20, 20,
+                     0, 21, 21,
+                     0, 22, 22,
+                     0, 23, 23,
+                     0, 24, 24,
+                     0, 25, 25,
+                     0, 26, 26,
+                     0, 27, 27,
+                     0, 28, 28,
+                     0, 29, 29,
+                     0, 30, 30,
+                     0, 31, 31,
+                     0, 32, 32,
+                     0, 33, 33,
+                     0, 34, 34,
+                     0, 35, 35,
+                     0, 36, 36,
+                     0, 37, 37,
+                     0, 38, 38,
+                     0, 39, 39,
+                     0, 40, 40,
+                     0, 41, 41,
+                     0, 42, 42,
+                     0, 43, 43,
+                     0, 44, 44,
+                     0, 45, 45,
+                     0, 46, 46,
+                     0, 47, 47,
+                     0, 48, 48,
+                     0, 49, 49,
+                     0, 50, 50,
+                     0, 51, 51,
+                     0, 52, 52,
+                     0, 53, 53,
+                     0, 54, 54,
+                     0, 55, 55,
+                     0, 56, 56,
+                     0, 57, 57,
+                     0, 58, 58,
+                     0, 59, 59,
+                     0, 60, 60,
+                     0, 61, 61,
+                     0, 62, 62,
+                     0, 63, 63,
+                     0, 64, 64,
+                     0, 65, 65,
+                     0, 0, 0},
+                    {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+                     18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+                     34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+                     50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65}};
+                if (!obj.name.empty() && !dfa_.matches(obj.name)) {
+                    return validation_error{"name", validation_error_code::pattern_mismatch};
+                }
+            }
+            break;
+        }
+        case 1: { // email
+            has_email = true;
+            if (auto v = cur.unescaped_string(*arena)) {
+                obj.email = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
+            } else {
+                cur.skip_value();
+            }
+            if (obj.email.empty()) {
+                return validation_error{"email", validation_error_code::required_field_missing};
+            }
+            if (!obj.email.empty() && !is_valid_email(obj.email)) {
+                return validation_error{"email", validation_error_code::invalid_email_format};
+            }
+            break;
+        }
+        case 2: { // age
+            if (auto v = katana::serde::parse_int64(cur)) {
+                obj.age = *v;
+            } else {
+                cur.skip_value();
+            }
+            if (static_cast<double>(obj.age) < UserInput::metadata::AGE_MINIMUM) {
+                return validation_error{"age",
+                                        validation_error_code::value_too_small,
+                                        UserInput::metadata::AGE_MINIMUM};
+            }
+            break;
+        }
+        default:
+            cur.skip_value();
+            break;
+        }
+        cur.try_comma();
+    }
+    if (!has_name)
+        return validation_error{"name", validation_error_code::required_field_missing};
+    if (!has_email)
+        return validation_error{"email", validation_error_code::required_field_missing};
+    return std::nullopt;
+}
+
+inline size_t json_size_bound_UserInput(const UserInput& obj) noexcept {
+    size_t n = 25;
+    n += katana::serde::json_string_size_bound(obj.name.size());
+    n += katana::serde::json_string_size_bound(obj.email.size());
+    n += katana::serde::json_int_max_size;
+    return n;
+}
+
+inline char* serialize_UserInput_to(const UserInput& obj, char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.raw("{\"name\":");
+    w.string(obj.name);
+    w.raw(",\"email\":");
+    w.string(obj.email);
+    w.raw(",\"age\":");
+    w.integer(obj.age);
+    w.put('}');
+    return w.pos;
+}
+
+template <typename Out> inline auto serialize_UserInput_into(const UserInput& obj, Out& out) {
+    return katana::serde::write_json(out, json_size_bound_UserInput(obj), [&](char* p) {
+        return serialize_UserInput_to(obj, p);
+    });
+}
+
 inline std::string serialize_UserInput(const UserInput& obj) {
     std::string json;
-    json.reserve(256);
-    json.push_back('{');
-    bool first = true;
-
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"name\":");
-    json.push_back('"');
-    json.append(katana::serde::escape_json_string(obj.name));
-    json.push_back('"');
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"email\":");
-    json.push_back('"');
-    json.append(katana::serde::escape_json_string(obj.email));
-    json.push_back('"');
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"age\":");
-    {
-        char buf[32];
-        auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), obj.age);
-        json.append(buf, static_cast<size_t>(ptr - buf));
-    }
-    json.push_back('}');
+    serialize_UserInput_into(obj, json);
     return json;
 }
 
 inline std::optional<std::vector<UserInput>> parse_UserInput_array(std::string_view json,
                                                                    monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -123,23 +296,45 @@ inline std::optional<std::vector<UserInput>> parse_UserInput_array(std::string_v
 }
 
 inline std::string serialize_UserInput_array(const std::vector<UserInput>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_UserInput(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_UserInput(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_UserInput_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string serialize_UserInput_array(const arena_vector<UserInput>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_UserInput(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_UserInput(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_UserInput_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
+
+template <typename Range> inline auto stream_UserInput_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_UserInput,
+                                            &serialize_UserInput_to);
+}
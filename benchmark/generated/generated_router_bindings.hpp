@@ -36,52 +36,6 @@
 
 namespace generated {
 
-inline std::optional<std::string_view> query_param(std::string_view uri, std::string_view key) {
-    auto qpos = uri.find('?');
-    if (qpos == std::string_view::npos)
-        return std::nullopt;
-    auto query = uri.substr(qpos + 1);
-    while (!query.empty()) {
-        auto amp = query.find('&');
-        auto part = query.substr(0, amp);
-        auto eq = part.find('=');
-        auto name = part.substr(0, eq);
-        if (name == key) {
-            if (eq == std::string_view::npos)
-                return std::string_view{};
-            return part.substr(eq + 1);
-        }
-        if (amp == std::string_view::npos)
-            break;
-        query.remove_prefix(amp + 1);
-    }
-    return std::nullopt;
-}
-
-inline std::optional<std::string_view> cookie_param(const katana::http::request& req,
-                                                    std::string_view key) {
-    auto cookie = req.headers.get("Cookie");
-    if (!cookie)
-        return std::nullopt;
-    std::string_view rest = *cookie;
-    while (!rest.empty()) {
-        auto sep = rest.find(';');
-        auto token = rest.substr(0, sep);
-        if (sep != std::string_view::npos)
-            rest.remove_prefix(sep + 1);
-        auto eq = token.find('=');
-        if (eq == std::string_view::npos)
-            continue;
-        auto name = katana::serde::trim_view(token.substr(0, eq));
-        auto val = katana::serde::trim_view(token.substr(eq + 1));
-        if (name == key)
-            return val;
-        if (sep == std::string_view::npos)
-            break;
-    }
-    return std::nullopt;
-}
-
 inline std::optional<size_t> find_content_type(std::optional<std::string_view> header,
                                                std::span<const content_type_info> allowed) {
     if (allowed.empty())
@@ -203,11 +157,15 @@ inline const katana::http::router& make_router(api_handler& handler) {
                         std::optional<UserInput> parsed_body;
                         switch (*matched_ct) {
                         case 0: {
-                            auto candidate = parse_UserInput(req.body, &ctx.arena);
-                            if (!candidate)
-                                return katana::http::response::error(
-                                    katana::problem_details::bad_request("invalid request body"));
-                            parsed_body = std::move(*candidate);
+                            auto& candidate = parsed_body.emplace(&ctx.arena);
+                            if (auto err =
+                                    parse_validated_UserInput(req.body, &ctx.arena, candidate)) {
+                                if (err->field.empty())
+                                    return katana::http::response::error(
+                                        katana::problem_details::bad_request(
+                                            "invalid request body"));
+                                return format_validation_error(*err);
+                            }
                             break;
                         }
                         default:
@@ -215,54 +173,36 @@ inline const katana::http::router& make_router(api_handler& handler) {
                                 katana::problem_details::unsupported_media_type(
                                     "unsupported Content-Type"));
                         }
-                        // Automatic validation (optimized: single allocation)
-                        if (auto validation_error = validate_UserInput(*parsed_body)) {
-                            return format_validation_error(*validation_error);
-                        }
                         // Set handler context for zero-boilerplate access
                         katana::http::handler_context::scope context_scope(req, ctx);
                         auto generated_response = handler.create_user(*parsed_body);
                         return generated_response;
                     })},
         route_entry{katana::http::method::get,
-                    katana::http::path_pattern::from_literal<"/users/{id}">(),
+                    katana::http::path_pattern::from_literal<"/users/{id:int}">(),
                     handler_fn([&handler](const katana::http::request& req,
                                           katana::http::request_context& ctx)
                                    -> katana::result<katana::http::response> {
-                        auto p_id = ctx.params.get("id");
+                        auto p_id = ctx.params.get_int("id");
                         if (!p_id)
                             return katana::http::response::error(
                                 katana::problem_details::bad_request("missing path param id"));
-                        int64_t id = 0;
-                        {
-                            auto [ptr, ec] =
-                                std::from_chars(p_id->data(), p_id->data() + p_id->size(), id);
-                            if (ec != std::errc())
-                                return katana::http::response::error(
-                                    katana::problem_details::bad_request("invalid path param id"));
-                        }
+                        int64_t id = *p_id;
                         // Set handler context for zero-boilerplate access
                         katana::http::handler_context::scope context_scope(req, ctx);
                         auto generated_response = handler.get_user(id);
                         return generated_response;
                     })},
         route_entry{katana::http::method::put,
-                    katana::http::path_pattern::from_literal<"/users/{id}">(),
+                    katana::http::path_pattern::from_literal<"/users/{id:int}">(),
                     handler_fn([&handler](const katana::http::request& req,
                                           katana::http::request_context& ctx)
                                    -> katana::result<katana::http::response> {
-                        auto p_id = ctx.params.get("id");
+                        auto p_id = ctx.params.get_int("id");
                         if (!p_id)
                             return katana::http::response::error(
                                 katana::problem_details::bad_request("missing path param id"));
-                        int64_t id = 0;
-                        {
-                            auto [ptr, ec] =
-                                std::from_chars(p_id->data(), p_id->data() + p_id->size(), id);
-                            if (ec != std::errc())
-                                return katana::http::response::error(
-                                    katana::problem_details::bad_request("invalid path param id"));
-                        }
+                        int64_t id = *p_id;
                         auto matched_ct =
                             find_content_type(req.headers.get("Content-Type"), route_4_consumes);
                         if (!matched_ct)
@@ -272,11 +212,15 @@ inline const katana::http::router& make_router(api_handler& handler) {
                         std::optional<UserInput> parsed_body;
                         switch (*matched_ct) {
                         case 0: {
-                            auto candidate = parse_UserInput(req.body, &ctx.arena);
-                            if (!candidate)
-                                return katana::http::response::error(
-                                    katana::problem_details::bad_request("invalid request body"));
-                            parsed_body = std::move(*candidate);
+                            auto& candidate = parsed_body.emplace(&ctx.arena);
+                            if (auto err =
+                                    parse_validated_UserInput(req.body, &ctx.arena, candidate)) {
+                                if (err->field.empty())
+                                    return katana::http::response::error(
+                                        katana::problem_details::bad_request(
+                                            "invalid request body"));
+                                return format_validation_error(*err);
+                            }
                             break;
                         }
                         default:
@@ -284,10 +228,6 @@ inline const katana::http::router& make_router(api_handler& handler) {
                                 katana::problem_details::unsupported_media_type(
                                     "unsupported Content-Type"));
                         }
-                        // Automatic validation (optimized: single allocation)
-                        if (auto validation_error = validate_UserInput(*parsed_body)) {
-                            return format_validation_error(*validation_error);
-                        }
                         // Set handler context for zero-boilerplate access
                         katana::http::handler_context::scope context_scope(req, ctx);
                         auto generated_response = handler.update_user(id, *parsed_body);
@@ -9,7 +9,6 @@
 #include <string>
 #include <string_view>
 
-#include <regex>
 #include <unordered_set>
 
 using katana::validation_error;
@@ -55,67 +54,9 @@ inline constexpr std::string_view to_string(validation_error_code code) noexcept
     return "unknown error";
 }
 
-inline bool is_valid_email(std::string_view v) {
-    auto at = v.find('@');
-    if (at == std::string_view::npos || at == 0 || at + 1 >= v.size())
-        return false;
-    auto domain = v.substr(at + 1);
-    auto dot = domain.find('.');
-    if (dot == std::string_view::npos || dot == 0 || dot + 1 >= domain.size())
-        return false;
-    return true;
-}
-
-inline bool is_valid_uuid(std::string_view v) {
-    if (v.size() != 36)
-        return false;
-    auto is_hex = [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; };
-    for (size_t i = 0; i < v.size(); ++i) {
-        if (i == 8 || i == 13 || i == 18 || i == 23) {
-            if (v[i] != '-')
-                return false;
-        } else if (!is_hex(v[i])) {
-            return false;
-        }
-    }
-    return true;
-}
-
-inline bool is_valid_datetime(std::string_view v) {
-    auto is_digit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
-    if (v.size() < 20)
-        return false;
-    for (size_t i : {0u, 1u, 2u, 3u, 5u, 6u, 8u, 9u, 11u, 12u, 14u, 15u, 17u, 18u}) {
-        if (!is_digit(v[i]))
-            return false;
-    }
-    if (v[4] != '-' || v[7] != '-' || v[10] != 'T' || v[13] != ':' || v[16] != ':')
-        return false;
-    size_t pos = 19;
-    if (pos < v.size() && v[pos] == '.') {
-        ++pos;
-        if (pos >= v.size())
-            return false;
-        while (pos < v.size() && is_digit(v[pos]))
-            ++pos;
-    }
-    if (pos >= v.size())
-        return false;
-    if (v[pos] == 'Z')
-        return pos + 1 == v.size();
-    if (v[pos] == '+' || v[pos] == '-') {
-        if (pos + 5 >= v.size())
-            return false;
-        if (!is_digit(v[pos + 1]) || !is_digit(v[pos + 2]))
-            return false;
-        if (v[pos + 3] != ':')
-            return false;
-        if (!is_digit(v[pos + 4]) || !is_digit(v[pos + 5]))
-            return false;
-        return pos + 6 == v.size();
-    }
-    return false;
-}
+using katana::is_valid_datetime;
+using katana::is_valid_email;
+using katana::is_valid_uuid;
 
 inline std::optional<validation_error> validate_UserInput(const UserInput& obj) {
     if (obj.name.empty()) {
@@ -125,6 +66,83 @@ inline std::optional<validation_error> validate_UserInput(const UserInput& obj)
         return validation_error{
             "name", validation_error_code::string_too_short, UserInput::metadata::NAME_MIN_LENGTH};
     }
+    {
+        static constexpr katana::pattern_dfa<66, 3> dfa_{
+            {{32, 32, 1}, {45, 46, 1}, {65, 90, 2}, {97, 122, 2}},
+            {0, 0, 0,
+             0, 0, 2,
+             0, 3, 3,
+             0, 4, 4,
+             0, 5, 5,
+             0, 6, 6,
+             0, 7, 7,
+             0, 8, 8,
+             0, 9, 9,
+             0, 10, 10,
+             0, 11, 11,
+             0, 12, 12,
+             0, 13, 13,
+             0, 14, 14,
+             0, 15, 15,
+             0, 16, 16,
+             0, 17, 17,
+             0, 18, 18,
+             0, 19, 19,
+             0, 20, 20,
+             0, 21, 21,
+             0, 22, 22,
+             0, 23, 23,
+             0, 24, 24,
+             0, 25, 25,
+             0, 26, 26,
+             0, 27, 27,
+             0, 28, 28,
+             0, 29, 29,
+             0, 30, 30,
+             0, 31, 31,
+             0, 32, 32,
+             0, 33, 33,
+             0, 34, 34,
+             0, 35, 35,
+             0, 36, 36,
+             0, 37, 37,
+             0, 38, 38,
+             0, 39, 39,
+             0, 40, 40,
+             0, 41, 41,
+             0, 42, 42,
+             0, 43, 43,
+             0, 44, 44,
+             0, 45, 45,
+             0, 46, 46,
+             0, 47, 47,
+             0, 48, 48,
+             0, 49, 49,
+             0, 50, 50,
+             0, 51, 51,
+             0, 52, 52,
+             0, 53, 53,
+             0, 54, 54,
+             0, 55, 55,
+             0, 56, 56,
+             0, 57, 57,
+             0, 58, 58,
+             0, 59, 59,
+             0, 60, 60,
+             0, 61, 61,
+             0, 62, 62,
+             0, 63, 63,
+             0, 64, 64,
+             0, 65, 65,
+             0, 0, 0},
+            {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+             18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33,
+             34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+             50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65}};
+        if (!obj.name.empty() && !dfa_.matches(obj.name)) {
+            return validation_error{"name", validation_error_code::pattern_mismatch};
+        }
+    }
     if (obj.email.empty()) {
         return validation_error{"email", validation_error_code::required_field_missing};
     }
@@ -1,12 +1,21 @@
 #include "generated/generated_handlers.hpp"
 #include "generated/generated_router_bindings.hpp"
+#include "generated_wide/generated_dtos.hpp"
+#include "generated_wide/generated_json.hpp"
+#include "generated_wide/generated_msgpack.hpp"
 #include "katana/core/arena.hpp"
 #include "katana/core/http.hpp"
+#include "katana/core/io_buffer.hpp"
+#include "katana/core/json_parser.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <ranges>
+#include <regex>
 #include <string_view>
 #include <vector>
 
@@ -121,6 +130,88 @@ bench_result bench_dispatch(const std::string& name,
     return result;
 }
 
+template <typename Fn>
+bench_result bench_parse(const std::string& name, Fn&& parse, size_t iterations) {
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+
+    uint64_t errors = 0;
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        monotonic_arena arena;
+
+        auto t0 = steady_clock::now();
+        bool ok = parse(arena);
+        auto t1 = steady_clock::now();
+
+        if (!ok) {
+            ++errors;
+        }
+        latencies.push_back(static_cast<double>(duration_cast<nanoseconds>(t1 - t0).count()) /
+                            1000.0);
+    }
+
+    auto end = steady_clock::now();
+    auto duration_ms = std::max<uint64_t>(
+        1, static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count()));
+
+    std::sort(latencies.begin(), latencies.end());
+
+    bench_result result;
+    result.name = name;
+    result.operations = iterations;
+    result.duration_ms = duration_ms;
+    result.throughput =
+        (static_cast<double>(iterations) * 1000.0) / static_cast<double>(duration_ms);
+    result.latency_p50 = latencies[iterations / 2];
+    result.latency_p99 = latencies[iterations * 99 / 100];
+    result.latency_p999 = latencies[iterations * 999 / 1000];
+    result.errors = errors;
+    return result;
+}
+
+// 40 integer fields for comparing descriptor-driven lookup strategies on a wide object
+constexpr size_t wide_field_count = 40;
+
+struct wide_dto {
+    std::array<int64_t, wide_field_count> values{};
+    explicit wide_dto(monotonic_arena*) {}
+};
+
+const std::array<std::string, wide_field_count>& wide_names() {
+    static const auto names = [] {
+        std::array<std::string, wide_field_count> out;
+        for (size_t i = 0; i < wide_field_count; ++i) {
+            out[i] = "property_" + std::to_string(i);
+        }
+        return out;
+    }();
+    return names;
+}
+
+std::array<json::field_descriptor<wide_dto>, wide_field_count> make_wide_fields() {
+    std::array<json::field_descriptor<wide_dto>, wide_field_count> fields{};
+    for (size_t i = 0; i < wide_field_count; ++i) {
+        fields[i].json_name = wide_names()[i];
+        fields[i].kind = json::field_kind::integer;
+        fields[i].offset =
+            static_cast<std::ptrdiff_t>(offsetof(wide_dto, values) + i * sizeof(int64_t));
+        fields[i].parse = &json::parse_integer_field<wide_dto>;
+    }
+    return fields;
+}
+
+// Keys in reverse declaration order: the worst case for a compare-each-field lookup
+std::string make_wide_body(const std::array<std::string, wide_field_count>& keys) {
+    std::string body = "{";
+    for (size_t i = keys.size(); i-- > 0;) {
+        body.append("\"").append(keys[i]).append("\":").append(std::to_string(i));
+        body += i > 0 ? "," : "}";
+    }
+    return body;
+}
+
 int main() {
     bench_handler handler;
     auto r = generated::make_router(handler);
@@ -140,5 +231,223 @@ int main() {
     auto result = bench_dispatch("Generated API dispatch+parse", r, reqs, iterations);
     print_result(result);
 
+    // Request body checks: parse then validate_* (two passes) vs the fused parse_validated_*.
+    // The invalid body fails on its first key, ahead of a large member the fused parser never
+    // reaches (each of its runs is reported as an error).
+    const std::string valid_user = R"({"name":"Alice","email":"a@b.com","age":30})";
+    const std::string invalid_user =
+        R"({"name":"","email":"a@b.com","age":30,"notes":")" + std::string(4096, 'x') + R"("})";
+    for (const auto& [label, body] : {std::pair{"valid", &valid_user},
+                                      std::pair{"invalid first field", &invalid_user}}) {
+        const std::string suffix = std::string(" (") + label + ")";
+        print_result(bench_parse(
+            "Parse, then validate" + suffix,
+            [&](monotonic_arena& arena) {
+                auto user = parse_UserInput(*body, &arena);
+                return user && !validate_UserInput(*user);
+            },
+            iterations));
+        print_result(bench_parse(
+            "Fused parse_validated" + suffix,
+            [&](monotonic_arena& arena) {
+                UserInput user(&arena);
+                return !parse_validated_UserInput(*body, &arena, user);
+            },
+            iterations));
+    }
+
+    // UserInput.name's `pattern`: std::regex_match, as validators used to run it, vs the
+    // validator katana_gen emits now, which checks it with a generated DFA (plus the other
+    // UserInput constraints)
+    {
+        const std::regex name_re{"^[A-Za-z][A-Za-z .-]{0,63}$"};
+        const std::string name = "Alexandra Montgomery-Smith";
+        monotonic_arena user_arena;
+        UserInput user(&user_arena);
+        user.name = arena_string<>(name.begin(), name.end(), arena_allocator<char>(&user_arena));
+        user.email = arena_string<>("a@b.com", arena_allocator<char>(&user_arena));
+        print_result(bench_parse(
+            "Pattern check, std::regex_match",
+            [&](monotonic_arena&) { return std::regex_match(name, name_re); },
+            iterations));
+        print_result(bench_parse(
+            "Pattern check, generated validate_UserInput",
+            [&](monotonic_arena&) { return !validate_UserInput(user); },
+            iterations));
+    }
+
+    // Wide schema: generated parser (perfect-hash switch) and both parse_object lookups
+    static constexpr auto wide_record_keys = std::to_array<std::string_view>(
+        {"id",         "name",          "email",       "age",          "created_at",
+         "updated_at", "first_name",    "last_name",   "phone",        "address_line1",
+         "address_line2", "city",       "state",       "postal_code",  "country",
+         "company",    "title",         "department",  "manager_id",   "employee_number",
+         "hire_date",  "salary",        "currency",    "is_active",    "is_admin",
+         "last_login", "login_count",   "timezone",    "locale",       "avatar_url",
+         "bio",        "website",       "score",       "rank",         "level",
+         "experience", "referral_code", "referred_by", "notes",        "version"});
+    std::string wide_record = "{";
+    for (size_t i = wide_record_keys.size(); i-- > 0;) {
+        const auto key = wide_record_keys[i];
+        wide_record.append("\"").append(key).append("\":");
+        if (key == "salary" || key == "score") {
+            wide_record += "1.5";
+        } else if (key == "is_active" || key == "is_admin") {
+            wide_record += "true";
+        } else if (key == "id" || key == "age" || key == "manager_id" || key == "login_count" ||
+                   key == "rank" || key == "level" || key == "version" || key == "experience" ||
+                   key == "employee_number") {
+            wide_record += std::to_string(i);
+        } else {
+            wide_record += "\"value\"";
+        }
+        wide_record += i > 0 ? "," : "}";
+    }
+    print_result(bench_parse(
+        "Generated parse (40-property schema)",
+        [&](monotonic_arena& arena) { return parse_WideRecord(wide_record, &arena).has_value(); },
+        iterations));
+    // Handlers that need two fields: full parse vs x-katana-partial lazy view ("id" is the
+    // last key of the body, so the view still walks past every other member)
+    print_result(bench_parse(
+        "Generated parse, read id + name (40-property schema)",
+        [&](monotonic_arena& arena) {
+            auto rec = parse_WideRecord(wide_record, &arena);
+            return rec && rec->id >= 0 && !rec->name.empty();
+        },
+        iterations));
+    print_result(bench_parse(
+        "Partial view, read id + name (40-property schema)",
+        [&](monotonic_arena& arena) {
+            auto rec = parse_WideRecordPartial(wide_record, &arena);
+            return rec && rec->id() && rec->name();
+        },
+        iterations));
+
+    const auto wide_fields = make_wide_fields();
+    const json::object_descriptor<wide_dto, wide_field_count> wide_object{wide_fields};
+    const auto wide_body = make_wide_body(wide_names());
+    print_result(bench_parse(
+        "parse_object linear lookup (40 fields)",
+        [&](monotonic_arena& arena) {
+            return json::parse_object<wide_dto>(wide_body, wide_fields, &arena).has_value();
+        },
+        iterations));
+    print_result(bench_parse(
+        "parse_object perfect hash (40 fields)",
+        [&](monotonic_arena& arena) {
+            return json::parse_object<wide_dto>(wide_body, wide_object, &arena).has_value();
+        },
+        iterations));
+
+    // Wide schema serializers: one sized allocation per std::string, none for a reused buffer
+    monotonic_arena record_arena;
+    const auto record = parse_WideRecord(wide_record, &record_arena);
+    if (!record) {
+        std::cerr << "failed to parse the wide record\n";
+        return 1;
+    }
+    print_result(bench_parse(
+        "Generated serialize to std::string (40-property schema)",
+        [&](monotonic_arena&) { return !serialize_WideRecord(*record).empty(); },
+        iterations));
+    io_buffer out;
+    print_result(bench_parse(
+        "Generated serialize into reused io_buffer (40-property schema)",
+        [&](monotonic_arena&) {
+            out.clear();
+            return serialize_WideRecord_into(*record, out) > 0;
+        },
+        iterations));
+    print_result(bench_parse(
+        "Generated serialize into arena (40-property schema)",
+        [&](monotonic_arena& arena) { return !serialize_WideRecord_into(*record, arena).empty(); },
+        iterations));
+
+    // The same record as MessagePack: bytes on the wire and per-object encode/decode time
+    const auto record_json = serialize_WideRecord(*record);
+    const auto record_msgpack = serialize_msgpack_WideRecord(*record);
+    const auto decoded = parse_msgpack_WideRecord(record_msgpack, &record_arena);
+    if (!decoded || serialize_WideRecord(*decoded) != record_json) {
+        std::cerr << "MessagePack round trip changed the wide record\n";
+        return 1;
+    }
+    const auto json_encode = bench_parse(
+        "JSON encode into reused io_buffer (40-property schema)",
+        [&](monotonic_arena&) {
+            out.clear();
+            return serialize_WideRecord_into(*record, out) > 0;
+        },
+        iterations);
+    const auto msgpack_encode = bench_parse(
+        "MessagePack encode into reused io_buffer (40-property schema)",
+        [&](monotonic_arena&) {
+            out.clear();
+            return serialize_msgpack_WideRecord_into(*record, out) > 0;
+        },
+        iterations);
+    const auto json_decode = bench_parse(
+        "JSON decode (40-property schema)",
+        [&](monotonic_arena& arena) { return parse_WideRecord(record_json, &arena).has_value(); },
+        iterations);
+    const auto msgpack_decode = bench_parse(
+        "MessagePack decode (40-property schema)",
+        [&](monotonic_arena& arena) {
+            return parse_msgpack_WideRecord(record_msgpack, &arena).has_value();
+        },
+        iterations);
+    for (const auto& codec_result : {json_encode, msgpack_encode, json_decode, msgpack_decode}) {
+        print_result(codec_result);
+    }
+    auto ns_per_object = [](const bench_result& codec_result) {
+        return 1e9 / std::max(codec_result.throughput, 1.0);
+    };
+    std::cout << "\nWide record, JSON vs MessagePack:\n"
+              << "  bytes:     " << record_json.size() << " vs " << record_msgpack.size() << "\n"
+              << std::setprecision(1) << "  encode ns: " << ns_per_object(json_encode) << " vs "
+              << ns_per_object(msgpack_encode) << "\n"
+              << "  decode ns: " << ns_per_object(json_decode) << " vs "
+              << ns_per_object(msgpack_decode) << "\n";
+
+    // Large list response: the whole array in one string vs chunks pulled by the connection.
+    // Streaming holds one chunk at a time and its first chunk is ready after a few records.
+    constexpr size_t list_size = 10000;
+    const std::vector<WideRecord> records(list_size, *record);
+    const size_t list_iterations = std::max<size_t>(20, iterations / 5000);
+    size_t whole_peak = 0;
+    print_result(bench_parse(
+        "Generated array serialize (10000 x 40-property records)",
+        [&](monotonic_arena&) {
+            auto json = serialize_WideRecord_array(records);
+            whole_peak = std::max(whole_peak, json.capacity());
+            return !json.empty();
+        },
+        list_iterations));
+    std::string chunk;
+    print_result(bench_parse(
+        "Streamed array, first chunk (10000 x 40-property records)",
+        [&](monotonic_arena&) {
+            chunk.clear();
+            auto stream = stream_WideRecord_array(records);
+            return stream(chunk);
+        },
+        iterations / 10));
+    size_t stream_peak = 0;
+    print_result(bench_parse(
+        "Streamed array, all chunks (10000 x 40-property records)",
+        [&](monotonic_arena&) {
+            auto stream = stream_WideRecord_array(records);
+            bool more = true;
+            while (more) {
+                chunk.clear();
+                more = stream(chunk);
+                stream_peak = std::max(stream_peak, chunk.size());
+            }
+            return true;
+        },
+        list_iterations));
+    std::cout << "\nPeak body buffer: " << whole_peak << " bytes whole, " << stream_peak
+              << " bytes streamed\n";
+
     return 0;
 }
@@ -0,0 +1,282 @@
+#include "katana/core/json_index.hpp"
+#include "katana/core/serde.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono;
+using namespace katana::serde;
+
+struct benchmark_result {
+    std::string name;
+    double throughput_mb;
+    double latency_p50;
+    double latency_p99;
+    uint64_t operations;
+    uint64_t duration_ms;
+    uint64_t errors;
+};
+
+void print_result(const benchmark_result& result) {
+    std::cout << "\n=== " << result.name << " ===\n";
+    std::cout << "Operations: " << result.operations << "\n";
+    std::cout << "Duration: " << result.duration_ms << " ms\n";
+    std::cout << "Throughput: " << std::fixed << std::setprecision(2) << result.throughput_mb
+              << " MB/sec\n";
+    std::cout << "Errors: " << result.errors << "\n";
+    std::cout << "Latency p50: " << std::fixed << std::setprecision(3) << result.latency_p50
+              << " us\n";
+    std::cout << "Latency p99: " << std::fixed << std::setprecision(3) << result.latency_p99
+              << " us\n";
+}
+
+// Array of objects with long string fields and a nested payload the walker skips over;
+// `payload_items` controls how much of the document sits inside skipped subtrees.
+std::string make_document(size_t items, size_t payload_items) {
+    std::string doc = "[";
+    for (size_t i = 0; i < items; ++i) {
+        doc += R"({"id":)" + std::to_string(i);
+        doc += R"(,"name":"item-)" + std::to_string(i) + R"( with a fairly long \"quoted\" name")";
+        doc += R"(,"description":")" + std::string(96, 'x') + R"(")";
+        doc += R"(,"payload":[)";
+        for (size_t j = 0; j < payload_items; ++j) {
+            doc += R"({"tags":["alpha","beta","gamma"],"nested":{"a":[1,2,3],"b":"}{"}})";
+            doc += j + 1 < payload_items ? "," : "";
+        }
+        doc += "]}";
+        doc += i + 1 < items ? "," : "]";
+    }
+    return doc;
+}
+
+// Visit every key of every object, skipping all values
+bool walk(json_cursor& cur) {
+    if (!cur.try_array_start()) {
+        return false;
+    }
+    while (!cur.eof()) {
+        if (cur.try_array_end()) {
+            return true;
+        }
+        if (!cur.try_object_start()) {
+            return false;
+        }
+        while (!cur.try_object_end()) {
+            if (!cur.string() || !cur.consume(':')) {
+                return false;
+            }
+            cur.skip_value();
+            cur.try_comma();
+        }
+        cur.try_comma();
+    }
+    return false;
+}
+
+// Mostly plain prose with a quote, newline or non-ASCII character every few dozen bytes
+std::string make_text(size_t size) {
+    static constexpr std::string_view words[] = {
+        "lorem ", "ipsum ", "dolor ", "sit ", "amet, ", "\"quoted\" ", "line\n", "caf\xc3\xa9 ",
+        "consectetur ", "adipiscing ", "elit ", "sed ", "do ", "eiusmod ", "tempor ",
+    };
+    std::string text;
+    for (size_t i = 0; text.size() < size; i = (i * 7 + 3) % std::size(words)) {
+        text += words[i];
+    }
+    text.resize(size);
+    return text;
+}
+
+// The escaper as it was before the SIMD run scan: one switch per input byte
+char* escape_char_loop(std::string_view sv, char* out) {
+    for (char c : sv) {
+        switch (c) {
+        case '\\':
+        case '"':
+            *out++ = '\\';
+            *out++ = c;
+            break;
+        case '\n':
+            *out++ = '\\';
+            *out++ = 'n';
+            break;
+        default:
+            *out++ = c;
+            break;
+        }
+    }
+    return out;
+}
+
+// Sensor-style readings: a few digits before the point and two to four after
+std::string make_number_array(size_t count) {
+    std::string doc = "[";
+    uint64_t state = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const auto whole = static_cast<int64_t>((state >> 33) % 20000) - 10000;
+        doc += std::to_string(whole) + "." + std::to_string((state >> 20) % 10000);
+        doc += i + 1 < count ? "," : "]";
+    }
+    return doc;
+}
+
+std::string make_integer_array(size_t count) {
+    std::string doc = "[";
+    uint64_t state = 67890;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        doc += std::to_string(state >> 24);
+        doc += i + 1 < count ? "," : "]";
+    }
+    return doc;
+}
+
+// The array walk every numeric parser below shares; only the element parser differs
+template <typename Parse> bool sum_array(std::string_view json, Parse&& parse) {
+    json_cursor cur{json.data(), json.data() + json.size()};
+    if (!cur.try_array_start()) {
+        return false;
+    }
+    double sum = 0.0;
+    while (!cur.try_array_end()) {
+        auto v = parse(cur);
+        if (!v) {
+            return false;
+        }
+        sum += static_cast<double>(*v);
+        cur.try_comma();
+    }
+    return sum == sum;
+}
+
+// parse_double as it was before: strtod, which reads past the number and honours the locale
+std::optional<double> parse_double_strtod(json_cursor& cur) {
+    cur.skip_ws();
+    char* endptr = nullptr;
+    double v = std::strtod(cur.ptr, &endptr);
+    if (endptr == cur.ptr) {
+        return std::nullopt;
+    }
+    cur.ptr = endptr;
+    return v;
+}
+
+benchmark_result bench_walk(const std::string& name,
+                            const std::string& doc,
+                            size_t iterations,
+                            const std::function<bool(std::string_view)>& fn) {
+    std::vector<double> latencies;
+    latencies.reserve(iterations);
+
+    uint64_t errors = 0;
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        auto t0 = steady_clock::now();
+        if (!fn(doc)) {
+            ++errors;
+        }
+        auto t1 = steady_clock::now();
+        latencies.push_back(static_cast<double>(duration_cast<nanoseconds>(t1 - t0).count()) /
+                            1000.0);
+    }
+    auto end = steady_clock::now();
+    auto duration_us = static_cast<double>(duration_cast<microseconds>(end - start).count());
+
+    std::sort(latencies.begin(), latencies.end());
+
+    benchmark_result result;
+    result.name = name;
+    result.operations = iterations;
+    result.duration_ms = static_cast<uint64_t>(duration_us / 1000.0);
+    result.throughput_mb =
+        static_cast<double>(doc.size() * iterations) / std::max(duration_us, 1.0);
+    result.latency_p50 = latencies[iterations / 2];
+    result.latency_p99 = latencies[iterations * 99 / 100];
+    result.errors = errors;
+    return result;
+}
+
+int main() {
+    auto scalar = [](std::string_view json) {
+        json_cursor cur{json.data(), json.data() + json.size()};
+        return walk(cur);
+    };
+    json_structural_index index;
+    auto stage1 = [&](std::string_view json) { return index.build(json); };
+    // Builds the index regardless of json_index_min_size, to show where the threshold sits
+    auto indexed = [&](std::string_view json) {
+        if (!index.build(json)) {
+            return false;
+        }
+        json_cursor cur{json.data(), json.data() + json.size(), &index};
+        return walk(cur);
+    };
+
+    struct shape {
+        size_t items;
+        size_t payload_items;
+    };
+    for (auto [items, payload_items] :
+         {shape{4, 1}, shape{64, 1}, shape{1024, 1}, shape{4, 32}, shape{64, 32}}) {
+        const auto doc = make_document(items, payload_items);
+        const size_t iterations = std::max<size_t>(1000, 4000000 / doc.size());
+        const auto suffix = " (" + std::to_string(doc.size()) + " bytes, " +
+                            std::to_string(payload_items) + " payload items)";
+
+        bench_walk("Warmup", doc, iterations / 10, scalar);
+        print_result(bench_walk("json_cursor scalar walk" + suffix, doc, iterations, scalar));
+        print_result(bench_walk("structural index build" + suffix, doc, iterations, stage1));
+        print_result(bench_walk("json_cursor indexed walk" + suffix, doc, iterations, indexed));
+    }
+
+    for (size_t size : {64, 1024, 16384}) {
+        const auto text = make_text(size);
+        const auto escaped = escape_json_string(text);
+        const size_t iterations = std::max<size_t>(1000, 4000000 / size);
+        const auto suffix = " (" + std::to_string(size) + " bytes)";
+        std::string out(size * json_escape_max_expansion, '\0');
+
+        print_result(bench_walk("escape, per-byte loop" + suffix, text, iterations, [&](auto sv) {
+            return escape_char_loop(sv, out.data()) != out.data();
+        }));
+        print_result(bench_walk("escape_json_into" + suffix, text, iterations, [&](auto sv) {
+            return escape_json_into(sv, out.data()) != out.data();
+        }));
+        print_result(bench_walk("unescape_json_into" + suffix, escaped, iterations, [&](auto sv) {
+            return unescape_json_into(sv, out.data()) != nullptr;
+        }));
+        // No escapes: the view is returned as is, after one memchr, and the arena is untouched
+        const std::string plain(size, 'x');
+        katana::monotonic_arena arena;
+        print_result(bench_walk(
+            "unescape_json_string, nothing escaped" + suffix, plain, iterations, [&](auto sv) {
+                return unescape_json_string(sv, arena).has_value();
+            }));
+    }
+
+    for (size_t count : {16, 1024, 65536}) {
+        const auto numbers = make_number_array(count);
+        const auto integers = make_integer_array(count);
+        const size_t iterations = std::max<size_t>(200, 4000000 / numbers.size());
+        const auto suffix = " (" + std::to_string(count) + " values)";
+
+        print_result(bench_walk("number array, strtod" + suffix, numbers, iterations, [](auto sv) {
+            return sum_array(sv, parse_double_strtod);
+        }));
+        print_result(bench_walk("number array, parse_double" + suffix, numbers, iterations,
+                                [](auto sv) { return sum_array(sv, parse_double); }));
+        print_result(bench_walk("integer array, parse_size" + suffix, integers, iterations,
+                                [](auto sv) { return sum_array(sv, parse_size); }));
+        print_result(bench_walk("integer array, parse_int64" + suffix, integers, iterations,
+                                [](auto sv) { return sum_array(sv, parse_int64); }));
+    }
+
+    return 0;
+}
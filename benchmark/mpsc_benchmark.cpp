@@ -1,10 +1,12 @@
 #include "katana/core/mpsc_queue.hpp"
+#include "katana/core/ring_buffer_queue.hpp"
 
 #include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <numeric>
 #include <thread>
 #include <vector>
@@ -78,11 +80,14 @@ benchmark_result benchmark_mpsc_single_producer() {
     return result;
 }
 
-benchmark_result benchmark_mpsc_multi_producer(int num_producers) {
+// Producers push `total_operations` values between them while one consumer drains them with
+// `drain`, which returns how many it took (0 when it found nothing)
+template <typename Push, typename Drain>
+benchmark_result
+run_producers(const std::string& name, size_t num_producers, Push push, Drain drain) {
     const size_t total_operations = 1000000;
     const size_t ops_per_producer = total_operations / num_producers;
-    mpsc_queue<int> queue;
-    std::atomic<size_t> total_pushed{0};
+    const size_t expected = ops_per_producer * num_producers;
     std::atomic<size_t> total_popped{0};
 
     auto start = steady_clock::now();
@@ -90,24 +95,24 @@ benchmark_result benchmark_mpsc_multi_producer(int num_producers) {
     std::vector<std::thread> producers;
     producers.reserve(num_producers);
 
-    for (int t = 0; t < num_producers; ++t) {
+    for (size_t t = 0; t < num_producers; ++t) {
         producers.emplace_back([&, t] {
             for (size_t i = 0; i < ops_per_producer; ++i) {
-                queue.push(static_cast<int>(t * ops_per_producer + i));
-                total_pushed.fetch_add(1, std::memory_order_relaxed);
+                push(t * ops_per_producer + i);
             }
         });
     }
 
     std::thread consumer([&] {
-        while (total_popped.load(std::memory_order_relaxed) < total_operations) {
-            auto val = queue.pop();
-            if (val) {
-                total_popped.fetch_add(1, std::memory_order_relaxed);
-            } else {
+        size_t popped = 0;
+        while (popped < expected) {
+            const size_t n = drain();
+            if (n == 0) {
                 std::this_thread::yield();
             }
+            popped += n;
         }
+        total_popped.store(popped, std::memory_order_relaxed);
     });
 
     for (auto& t : producers) {
@@ -119,10 +124,11 @@ benchmark_result benchmark_mpsc_multi_producer(int num_producers) {
     auto duration_ms = static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count());
 
     benchmark_result result;
-    result.name = "MPSC Queue (" + std::to_string(num_producers) + " Producers)";
-    result.operations = total_operations;
+    result.name = name + " (" + std::to_string(num_producers) + "P)";
+    result.operations = total_popped.load(std::memory_order_relaxed);
     result.duration_ms = duration_ms;
-    result.throughput = (total_operations * 1000.0) / static_cast<double>(duration_ms);
+    result.throughput = (static_cast<double>(result.operations) * 1000.0) /
+                        static_cast<double>(std::max<uint64_t>(duration_ms, 1));
     result.latency_p50 = 0.0;
     result.latency_p99 = 0.0;
     result.latency_p999 = 0.0;
@@ -130,6 +136,70 @@ benchmark_result benchmark_mpsc_multi_producer(int num_producers) {
     return result;
 }
 
+constexpr size_t BATCH_SIZE = 64;
+constexpr size_t BOUNDED_CAPACITY = 4096;
+
+benchmark_result benchmark_mpsc_multi_producer(size_t num_producers) {
+    mpsc_queue<int> queue;
+    return run_producers(
+        "mpsc_queue",
+        num_producers,
+        [&](size_t v) { queue.push(static_cast<int>(v)); },
+        [&]() -> size_t { return queue.pop() ? 1 : 0; });
+}
+
+struct bench_node : mpsc_hook {
+    int value = 0;
+};
+
+benchmark_result benchmark_intrusive_multi_producer(size_t num_producers) {
+    intrusive_mpsc_queue<bench_node> queue;
+    // Caller-owned nodes, allocated up front so the run itself allocates nothing
+    auto nodes = std::make_unique<bench_node[]>(1000000);
+    return run_producers(
+        "intrusive_mpsc_queue",
+        num_producers,
+        [&](size_t v) {
+            nodes[v].value = static_cast<int>(v);
+            queue.push(nodes[v]);
+        },
+        [&]() -> size_t {
+            size_t n = 0;
+            while (n < BATCH_SIZE && queue.pop()) {
+                ++n;
+            }
+            return n;
+        });
+}
+
+benchmark_result benchmark_bounded_multi_producer(size_t num_producers) {
+    bounded_mpsc_queue<int> queue(BOUNDED_CAPACITY);
+    int batch[BATCH_SIZE];
+    return run_producers(
+        "bounded_mpsc_queue pop_n",
+        num_producers,
+        [&](size_t v) {
+            while (!queue.try_push(static_cast<int>(v))) {
+                std::this_thread::yield();
+            }
+        },
+        [&]() -> size_t { return queue.pop_n(batch, BATCH_SIZE); });
+}
+
+benchmark_result benchmark_ring_buffer_multi_producer(size_t num_producers) {
+    ring_buffer_queue<int> queue(BOUNDED_CAPACITY, false);
+    int batch[BATCH_SIZE];
+    return run_producers(
+        "ring_buffer_queue pop_batch",
+        num_producers,
+        [&](size_t v) {
+            while (!queue.try_push(static_cast<int>(v))) {
+                std::this_thread::yield();
+            }
+        },
+        [&]() -> size_t { return queue.pop_batch(batch, BATCH_SIZE); });
+}
+
 benchmark_result benchmark_mpsc_with_limit() {
     const size_t num_operations = 500000;
     const size_t queue_limit = 1024;
@@ -185,26 +255,26 @@ int main() {
 
     std::vector<benchmark_result> results;
 
-    std::cout << "\n[1/5] Benchmarking MPSC queue (single producer)...\n";
+    std::cout << "\n[1/3] Benchmarking MPSC queue (single producer)...\n";
     results.push_back(benchmark_mpsc_single_producer());
     print_result(results.back());
 
-    std::cout << "\n[2/5] Benchmarking MPSC queue (2 producers)...\n";
-    results.push_back(benchmark_mpsc_multi_producer(2));
-    print_result(results.back());
-
-    std::cout << "\n[3/5] Benchmarking MPSC queue (4 producers)...\n";
-    results.push_back(benchmark_mpsc_multi_producer(4));
-    print_result(results.back());
-
-    std::cout << "\n[4/5] Benchmarking MPSC queue (8 producers)...\n";
-    results.push_back(benchmark_mpsc_multi_producer(8));
-    print_result(results.back());
-
-    std::cout << "\n[5/5] Benchmarking MPSC queue (bounded)...\n";
+    std::cout << "\n[2/3] Benchmarking MPSC queue (bounded)...\n";
     results.push_back(benchmark_mpsc_with_limit());
     print_result(results.back());
 
+    std::cout << "\n[3/3] Comparing queues under 1/4/16 producers...\n";
+    for (size_t producers : {size_t{1}, size_t{4}, size_t{16}}) {
+        results.push_back(benchmark_mpsc_multi_producer(producers));
+        print_result(results.back());
+        results.push_back(benchmark_intrusive_multi_producer(producers));
+        print_result(results.back());
+        results.push_back(benchmark_bounded_multi_producer(producers));
+        print_result(results.back());
+        results.push_back(benchmark_ring_buffer_multi_producer(producers));
+        print_result(results.back());
+    }
+
     std::cout << "\n========================================\n";
     std::cout << "         Benchmark Summary\n";
     std::cout << "========================================\n";
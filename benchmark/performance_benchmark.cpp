@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
@@ -483,6 +484,59 @@ benchmark_result benchmark_arena_small_allocs() {
     return result;
 }
 
+// Arena traffic of one short-lived connection: the connection arena, the header map's own
+// arena and a request that spills into a second block. With `cached` the blocks come from
+// the thread's arena block cache; with the cache limited to zero every block hits malloc.
+benchmark_result benchmark_arena_connection_churn(bool cached) {
+    const size_t num_operations = 500000;
+    auto& cache = arena_block_cache::local();
+    const size_t limit = cache.max_cached_bytes();
+    cache.set_max_cached_bytes(cached ? limit : 0);
+    const auto before = cache.stats();
+    std::vector<double> latencies;
+    latencies.reserve(num_operations);
+
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < num_operations; ++i) {
+        auto op_start = steady_clock::now();
+        {
+            monotonic_arena arena(8192);
+            monotonic_arena header_arena(4096);
+            auto* line = arena.allocate(512);
+            auto* headers = header_arena.allocate(256);
+            auto* body = arena.allocate(12 * 1024);
+            if (!line || !headers || !body) {
+                std::abort();
+            }
+        }
+        auto op_end = steady_clock::now();
+        latencies.push_back(
+            static_cast<double>(duration_cast<nanoseconds>(op_end - op_start).count()) / 1000.0);
+    }
+    auto end = steady_clock::now();
+
+    const auto after = cache.stats();
+    cache.set_max_cached_bytes(limit);
+    std::cout << "Blocks from cache: " << (after.hits - before.hits)
+              << ", from malloc: " << (after.misses - before.misses) << "\n";
+
+    std::sort(latencies.begin(), latencies.end());
+    auto duration_ms = std::max<uint64_t>(
+        1, static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count()));
+
+    benchmark_result result;
+    result.name =
+        cached ? "Arena Connection Churn (block cache)" : "Arena Connection Churn (malloc)";
+    result.operations = num_operations;
+    result.duration_ms = duration_ms;
+    result.throughput = (num_operations * 1000.0) / static_cast<double>(duration_ms);
+    result.latency_p50 = percentile(latencies, 0.50);
+    result.latency_p99 = percentile(latencies, 0.99);
+    result.latency_p999 = percentile(latencies, 0.999);
+
+    return result;
+}
+
 benchmark_result benchmark_http_parser_fragmented() {
     const size_t num_operations = 50000;
     const size_t sample_rate = 20;
@@ -575,46 +629,52 @@ int main() {
 
     std::vector<benchmark_result> results;
 
-    std::cout << "\n[1/10] Benchmarking ring_buffer_queue (single thread)...\n";
+    std::cout << "\n[1/11] Benchmarking ring_buffer_queue (single thread)...\n";
     results.push_back(benchmark_ring_buffer_queue());
     print_result(results.back());
 
-    std::cout << "\n[2/10] Benchmarking ring_buffer_queue (concurrent)...\n";
+    std::cout << "\n[2/11] Benchmarking ring_buffer_queue (concurrent)...\n";
     results.push_back(benchmark_ring_buffer_concurrent());
     print_result(results.back());
 
-    std::cout << "\n[3/10] Benchmarking ring_buffer_queue (high contention)...\n";
+    std::cout << "\n[3/11] Benchmarking ring_buffer_queue (high contention)...\n";
     results.push_back(benchmark_ring_buffer_high_contention());
     print_result(results.back());
 
-    std::cout << "\n[4/10] Benchmarking circular_buffer...\n";
+    std::cout << "\n[4/11] Benchmarking circular_buffer...\n";
     results.push_back(benchmark_circular_buffer());
     print_result(results.back());
 
-    std::cout << "\n[5/10] Benchmarking SIMD CRLF search (1.5KB)...\n";
+    std::cout << "\n[5/11] Benchmarking SIMD CRLF search (1.5KB)...\n";
     results.push_back(benchmark_simd_crlf_search());
     print_result(results.back());
 
-    std::cout << "\n[6/10] Benchmarking SIMD CRLF search (16KB)...\n";
+    std::cout << "\n[6/11] Benchmarking SIMD CRLF search (16KB)...\n";
     results.push_back(benchmark_simd_crlf_large_buffer());
     print_result(results.back());
 
-    std::cout << "\n[7/10] Benchmarking HTTP parser (full message)...\n";
+    std::cout << "\n[7/11] Benchmarking HTTP parser (full message)...\n";
     results.push_back(benchmark_http_parser());
     print_result(results.back());
 
-    std::cout << "\n[8/10] Benchmarking HTTP parser (fragmented)...\n";
+    std::cout << "\n[8/11] Benchmarking HTTP parser (fragmented)...\n";
     results.push_back(benchmark_http_parser_fragmented());
     print_result(results.back());
 
-    std::cout << "\n[9/10] Benchmarking arena allocations...\n";
+    std::cout << "\n[9/11] Benchmarking arena allocations...\n";
     results.push_back(benchmark_arena_small_allocs());
     print_result(results.back());
 
-    std::cout << "\n[10/10] Benchmarking memory allocations...\n";
+    std::cout << "\n[10/11] Benchmarking memory allocations...\n";
     results.push_back(benchmark_memory_allocations());
     print_result(results.back());
 
+    std::cout << "\n[11/11] Benchmarking arena connection churn...\n";
+    for (const bool cached : {false, true}) {
+        results.push_back(benchmark_arena_connection_churn(cached));
+        print_result(results.back());
+    }
+
     std::cout << "\n========================================\n";
     std::cout << "         Benchmark Summary\n";
     std::cout << "========================================\n";
@@ -1,3 +1,4 @@
+#include "katana/core/hierarchical_timer.hpp"
 #include "katana/core/wheel_timer.hpp"
 
 #include <algorithm>
@@ -6,6 +7,8 @@
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <queue>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -186,6 +189,164 @@ benchmark_result benchmark_timer_tick() {
     return result;
 }
 
+// The reactor asks for the next expiration on every loop iteration to size its epoll_wait
+// timeout. Timers are spread like connection timeouts; with `far` they are all more than one
+// revolution of the wheel away.
+benchmark_result benchmark_next_expiration(size_t num_timers, bool far) {
+    const size_t num_operations = 200000;
+    wheel_timer<2048, 8> timer; // the reactors' fd timeout wheel
+    const auto min_timeout = far ? 20000 : 1000;
+    for (size_t i = 0; i < num_timers; ++i) {
+        timer.add(milliseconds(min_timeout + static_cast<int64_t>((i * 7919) % 40000)), []() {});
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(num_operations);
+    const auto now = steady_clock::now();
+    int64_t sink = 0;
+
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < num_operations; ++i) {
+        auto op_start = steady_clock::now();
+        sink += timer.time_until_next_expiration(now).count();
+        auto op_end = steady_clock::now();
+
+        double latency_us =
+            static_cast<double>(duration_cast<nanoseconds>(op_end - op_start).count()) / 1000.0;
+        latencies.push_back(latency_us);
+    }
+
+    auto end = steady_clock::now();
+    auto duration_ms = std::max<uint64_t>(
+        1, static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count()));
+    if (sink == 0) {
+        std::cout << "(no expirations)\n";
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    benchmark_result result;
+    result.name = "Next Expiration (" + std::to_string(num_timers / 1000) + "k" +
+                  (far ? ", far)" : ")");
+    result.operations = num_operations;
+    result.duration_ms = duration_ms;
+    result.throughput = (num_operations * 1000.0) / static_cast<double>(duration_ms);
+    result.latency_p50 = latencies[num_operations / 2];
+    result.latency_p99 = latencies[num_operations * 99 / 100];
+    result.latency_p999 = latencies[num_operations * 999 / 1000];
+
+    return result;
+}
+
+// Keep-alive churn as the reactor sees it: a fixed population of connection timeouts where
+// every operation refreshes one (cancel + add) and the clock advances 1 ms every 64
+// operations. Both timers are driven with the same simulated time.
+template <typename Timer> benchmark_result benchmark_timeout_churn(const char* name) {
+    const size_t num_timers = 100000;
+    const size_t num_operations = 1000000;
+    const auto t0 = steady_clock::now();
+    Timer timer;
+    std::vector<typename Timer::timeout_id> ids(num_timers);
+    auto now = t0;
+    size_t fired = 0;
+    for (size_t i = 0; i < num_timers; ++i) {
+        ids[i] = timer.add(milliseconds(1000 + static_cast<int64_t>((i * 7919) % 59000)),
+                           [&fired]() { ++fired; });
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(num_operations);
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < num_operations; ++i) {
+        const size_t k = (i * 104729) % num_timers;
+        auto op_start = steady_clock::now();
+        (void)timer.cancel(ids[k]);
+        ids[k] = timer.add(milliseconds(1000 + static_cast<int64_t>((i * 7919) % 59000)),
+                           [&fired]() { ++fired; });
+        if (i % 64 == 63) {
+            now += milliseconds(1);
+            timer.tick(now);
+        }
+        auto op_end = steady_clock::now();
+
+        double latency_us =
+            static_cast<double>(duration_cast<nanoseconds>(op_end - op_start).count()) / 1000.0;
+        latencies.push_back(latency_us);
+    }
+
+    auto end = steady_clock::now();
+    auto duration_ms = std::max<uint64_t>(
+        1, static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count()));
+
+    std::sort(latencies.begin(), latencies.end());
+
+    benchmark_result result;
+    result.name = std::string("Timeout Churn (") + name + ")";
+    result.operations = num_operations;
+    result.duration_ms = duration_ms;
+    result.throughput = (num_operations * 1000.0) / static_cast<double>(duration_ms);
+    result.latency_p50 = latencies[num_operations / 2];
+    result.latency_p99 = latencies[num_operations * 99 / 100];
+    result.latency_p999 = latencies[num_operations * 999 / 1000];
+
+    return result;
+}
+
+// schedule_after() used to keep its tasks in a binary heap; add 1M delayed tasks spread over
+// 10 s and run them all, with the heap and with the hierarchical wheel.
+benchmark_result benchmark_delayed_tasks(bool heap) {
+    const size_t num_tasks = 1000000;
+    const auto t0 = steady_clock::now();
+    size_t executed = 0;
+
+    struct timer_entry {
+        steady_clock::time_point deadline;
+        inplace_function<void(), 128> task;
+        bool operator>(const timer_entry& other) const { return deadline > other.deadline; }
+    };
+    std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> queue;
+    hierarchical_timer<> timer(t0);
+
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < num_tasks; ++i) {
+        const auto deadline = t0 + microseconds(static_cast<int64_t>((i * 7919) % 10'000'000));
+        if (heap) {
+            queue.push(timer_entry{deadline, [&executed]() { ++executed; }});
+        } else {
+            timer.add_at(deadline, [&executed]() { ++executed; });
+        }
+    }
+    for (auto now = t0; executed < num_tasks; now += milliseconds(1)) {
+        if (heap) {
+            while (!queue.empty() && queue.top().deadline <= now) {
+                auto task = std::move(queue.top().task);
+                queue.pop();
+                task();
+            }
+        } else {
+            timer.tick(now);
+        }
+    }
+
+    auto end = steady_clock::now();
+    auto duration_ms = std::max<uint64_t>(
+        1, static_cast<uint64_t>(duration_cast<milliseconds>(end - start).count()));
+
+    benchmark_result result;
+    result.name = heap ? "Delayed Tasks (binary heap)" : "Delayed Tasks (hierarchical)";
+    result.operations = num_tasks;
+    result.duration_ms = duration_ms;
+    result.throughput = (num_tasks * 1000.0) / static_cast<double>(duration_ms);
+    result.latency_p50 = 0.0;
+    result.latency_p99 = 0.0;
+    result.latency_p999 = 0.0;
+
+    return result;
+}
+
 int main() {
     std::cout << "========================================\n";
     std::cout << "   KATANA Wheel Timer Benchmarks\n";
@@ -193,22 +354,42 @@ int main() {
 
     std::vector<benchmark_result> results;
 
-    std::cout << "\n[1/4] Benchmarking timer add operations...\n";
+    std::cout << "\n[1/7] Benchmarking timer add operations...\n";
     results.push_back(benchmark_timer_add());
     print_result(results.back());
 
-    std::cout << "\n[2/4] Benchmarking timer cancel operations...\n";
+    std::cout << "\n[2/7] Benchmarking timer cancel operations...\n";
     results.push_back(benchmark_timer_cancel());
     print_result(results.back());
 
-    std::cout << "\n[3/4] Benchmarking timer tick operations...\n";
+    std::cout << "\n[3/7] Benchmarking timer tick operations...\n";
     results.push_back(benchmark_timer_tick());
     print_result(results.back());
 
-    std::cout << "\n[4/4] Benchmarking timer execution...\n";
+    std::cout << "\n[4/7] Benchmarking timer execution...\n";
     results.push_back(benchmark_timer_execution());
     print_result(results.back());
 
+    std::cout << "\n[5/7] Benchmarking next-expiration lookups (reactor timeout)...\n";
+    for (const bool far : {false, true}) {
+        for (const size_t timers : {size_t{10000}, size_t{100000}, size_t{1000000}}) {
+            results.push_back(benchmark_next_expiration(timers, far));
+            print_result(results.back());
+        }
+    }
+
+    std::cout << "\n[6/7] Benchmarking keep-alive timeout churn...\n";
+    results.push_back(benchmark_timeout_churn<wheel_timer<2048, 8>>("wheel 2048x8ms"));
+    print_result(results.back());
+    results.push_back(benchmark_timeout_churn<hierarchical_timer<>>("hierarchical 1ms"));
+    print_result(results.back());
+
+    std::cout << "\n[7/7] Benchmarking delayed task execution...\n";
+    for (const bool heap : {true, false}) {
+        results.push_back(benchmark_delayed_tasks(heap));
+        print_result(results.back());
+    }
+
     std::cout << "\n========================================\n";
     std::cout << "         Benchmark Summary\n";
     std::cout << "========================================\n";
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "katana/core/arena.hpp"
+#include "katana/core/json_writer.hpp"
 #include "katana/core/serde.hpp"
 #include <charconv>
 #include <optional>
@@ -16,8 +17,15 @@ inline std::optional<schema> parse_schema(std::string_view json, monotonic_arena
 inline std::optional<compute_sum_resp_200_0> parse_compute_sum_resp_200_0(std::string_view json,
                                                                           monotonic_arena* arena);
 
+inline size_t json_size_bound_compute_sum_body_0(const compute_sum_body_0& obj) noexcept;
+inline char* serialize_compute_sum_body_0_to(const compute_sum_body_0& obj, char* out) noexcept;
 inline std::string serialize_compute_sum_body_0(const compute_sum_body_0& obj);
+inline size_t json_size_bound_schema(const schema& obj) noexcept;
+inline char* serialize_schema_to(const schema& obj, char* out) noexcept;
 inline std::string serialize_schema(const schema& obj);
+inline size_t json_size_bound_compute_sum_resp_200_0(const compute_sum_resp_200_0& obj) noexcept;
+inline char* serialize_compute_sum_resp_200_0_to(const compute_sum_resp_200_0& obj,
+                                                 char* out) noexcept;
 inline std::string serialize_compute_sum_resp_200_0(const compute_sum_resp_200_0& obj);
 
 inline std::optional<std::vector<compute_sum_body_0>>
@@ -38,8 +46,8 @@ serialize_compute_sum_resp_200_0_array(const arena_vector<compute_sum_resp_200_0
 
 inline std::optional<compute_sum_body_0> parse_compute_sum_body_0(std::string_view json,
                                                                   monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
     compute_sum_body_0 result{arena_allocator<schema>(arena)};
@@ -58,8 +66,8 @@ inline std::optional<compute_sum_body_0> parse_compute_sum_body_0(std::string_vi
 }
 
 inline std::optional<schema> parse_schema(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     (void)arena;
     if (auto v = katana::serde::parse_double(cur))
         return schema{*v};
@@ -68,46 +76,100 @@ inline std::optional<schema> parse_schema(std::string_view json, monotonic_arena
 
 inline std::optional<compute_sum_resp_200_0> parse_compute_sum_resp_200_0(std::string_view json,
                                                                           monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     (void)arena;
     if (auto v = katana::serde::parse_double(cur))
         return compute_sum_resp_200_0{*v};
     return std::nullopt;
 }
 
-inline std::string serialize_compute_sum_body_0(const compute_sum_body_0& obj) {
-    const auto& arr = obj;
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        if (i > 0)
-            json.push_back(',');
-        json += serialize_schema(arr[i]);
+inline size_t json_size_bound_compute_sum_body_0(const compute_sum_body_0& obj) noexcept {
+    size_t n = 0;
+    n += 2 + obj.size() * (katana::serde::json_double_max_size + 1);
+    return n;
+}
+
+inline char* serialize_compute_sum_body_0_to(const compute_sum_body_0& obj, char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.put('[');
+    for (size_t i0 = 0; i0 < obj.size(); ++i0) {
+        if (i0 > 0)
+            w.put(',');
+        w.number(obj[i0]);
     }
-    json.push_back(']');
+    w.put(']');
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_compute_sum_body_0_into(const compute_sum_body_0& obj, Out& out) {
+    return katana::serde::write_json(out, json_size_bound_compute_sum_body_0(obj), [&](char* p) {
+        return serialize_compute_sum_body_0_to(obj, p);
+    });
+}
+
+inline std::string serialize_compute_sum_body_0(const compute_sum_body_0& obj) {
+    std::string json;
+    serialize_compute_sum_body_0_into(obj, json);
     return json;
 }
 
+inline size_t json_size_bound_schema([[maybe_unused]] const schema& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_double_max_size;
+    return n;
+}
+
+inline char* serialize_schema_to(const schema& obj, char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.number(obj);
+    return w.pos;
+}
+
+template <typename Out> inline auto serialize_schema_into(const schema& obj, Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_schema(obj), [&](char* p) { return serialize_schema_to(obj, p); });
+}
+
 inline std::string serialize_schema(const schema& obj) {
-    char buf[64];
-    auto res = std::to_chars(buf, buf + sizeof(buf), obj);
-    if (res.ec == std::errc())
-        return std::string(buf, static_cast<size_t>(res.ptr - buf));
-    return {};
+    std::string json;
+    serialize_schema_into(obj, json);
+    return json;
+}
+
+inline size_t json_size_bound_compute_sum_resp_200_0(
+    [[maybe_unused]] const compute_sum_resp_200_0& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_double_max_size;
+    return n;
+}
+
+inline char* serialize_compute_sum_resp_200_0_to(const compute_sum_resp_200_0& obj,
+                                                 char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.number(obj);
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_compute_sum_resp_200_0_into(const compute_sum_resp_200_0& obj, Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_compute_sum_resp_200_0(obj), [&](char* p) {
+            return serialize_compute_sum_resp_200_0_to(obj, p);
+        });
 }
 
 inline std::string serialize_compute_sum_resp_200_0(const compute_sum_resp_200_0& obj) {
-    char buf[64];
-    auto res = std::to_chars(buf, buf + sizeof(buf), obj);
-    if (res.ec == std::errc())
-        return std::string(buf, static_cast<size_t>(res.ptr - buf));
-    return {};
+    std::string json;
+    serialize_compute_sum_resp_200_0_into(obj, json);
+    return json;
 }
 
 inline std::optional<std::vector<compute_sum_body_0>>
 parse_compute_sum_body_0_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -135,8 +197,8 @@ parse_compute_sum_body_0_array(std::string_view json, monotonic_arena* arena) {
 
 inline std::optional<std::vector<schema>> parse_schema_array(std::string_view json,
                                                              monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -164,8 +226,8 @@ inline std::optional<std::vector<schema>> parse_schema_array(std::string_view js
 
 inline std::optional<std::vector<compute_sum_resp_200_0>>
 parse_compute_sum_resp_200_0_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -192,69 +254,134 @@ parse_compute_sum_resp_200_0_array(std::string_view json, monotonic_arena* arena
 }
 
 inline std::string serialize_compute_sum_body_0_array(const std::vector<compute_sum_body_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_compute_sum_body_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_compute_sum_body_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_compute_sum_body_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string serialize_compute_sum_body_0_array(const arena_vector<compute_sum_body_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_compute_sum_body_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_compute_sum_body_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_compute_sum_body_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_compute_sum_body_0_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_compute_sum_body_0,
+                                            &serialize_compute_sum_body_0_to);
+}
+
 inline std::string serialize_schema_array(const std::vector<schema>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_schema(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_schema(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_schema_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string serialize_schema_array(const arena_vector<schema>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_schema(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_schema(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_schema_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_schema_array(Range&& items) {
+    return katana::serde::json_array_stream(
+        std::forward<Range>(items), &json_size_bound_schema, &serialize_schema_to);
+}
+
 inline std::string
 serialize_compute_sum_resp_200_0_array(const std::vector<compute_sum_resp_200_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_compute_sum_resp_200_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_compute_sum_resp_200_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_compute_sum_resp_200_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string
 serialize_compute_sum_resp_200_0_array(const arena_vector<compute_sum_resp_200_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_compute_sum_resp_200_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_compute_sum_resp_200_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_compute_sum_resp_200_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
+
+template <typename Range> inline auto stream_compute_sum_resp_200_0_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_compute_sum_resp_200_0,
+                                            &serialize_compute_sum_resp_200_0_to);
+}
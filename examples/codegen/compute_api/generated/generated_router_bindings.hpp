@@ -36,52 +36,6 @@
 
 namespace generated {
 
-inline std::optional<std::string_view> query_param(std::string_view uri, std::string_view key) {
-    auto qpos = uri.find('?');
-    if (qpos == std::string_view::npos)
-        return std::nullopt;
-    auto query = uri.substr(qpos + 1);
-    while (!query.empty()) {
-        auto amp = query.find('&');
-        auto part = query.substr(0, amp);
-        auto eq = part.find('=');
-        auto name = part.substr(0, eq);
-        if (name == key) {
-            if (eq == std::string_view::npos)
-                return std::string_view{};
-            return part.substr(eq + 1);
-        }
-        if (amp == std::string_view::npos)
-            break;
-        query.remove_prefix(amp + 1);
-    }
-    return std::nullopt;
-}
-
-inline std::optional<std::string_view> cookie_param(const katana::http::request& req,
-                                                    std::string_view key) {
-    auto cookie = req.headers.get("Cookie");
-    if (!cookie)
-        return std::nullopt;
-    std::string_view rest = *cookie;
-    while (!rest.empty()) {
-        auto sep = rest.find(';');
-        auto token = rest.substr(0, sep);
-        if (sep != std::string_view::npos)
-            rest.remove_prefix(sep + 1);
-        auto eq = token.find('=');
-        if (eq == std::string_view::npos)
-            continue;
-        auto name = katana::serde::trim_view(token.substr(0, eq));
-        auto val = katana::serde::trim_view(token.substr(eq + 1));
-        if (name == key)
-            return val;
-        if (sep == std::string_view::npos)
-            break;
-    }
-    return std::nullopt;
-}
-
 inline std::optional<size_t> find_content_type(std::optional<std::string_view> header,
                                                std::span<const content_type_info> allowed) {
     if (allowed.empty())
@@ -2,14 +2,24 @@
 #pragma once
 
 #include "katana/core/arena.hpp"
+#include "katana/core/json_writer.hpp"
 #include "katana/core/serde.hpp"
+#include "katana/core/validation.hpp"
 #include <charconv>
+#include <cmath>
 #include <optional>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 using katana::monotonic_arena;
 
+using katana::is_valid_datetime;
+using katana::is_valid_email;
+using katana::is_valid_uuid;
+using katana::validation_error;
+using katana::validation_error_code;
+
 inline std::optional<RegisterUserRequest> parse_RegisterUserRequest(std::string_view json,
                                                                     monotonic_arena* arena);
 inline std::optional<RegisterUserRequest_Email_t>
@@ -21,11 +31,29 @@ parse_RegisterUserRequest_Age_t(std::string_view json, monotonic_arena* arena);
 inline std::optional<register_user_resp_200_0>
 parse_register_user_resp_200_0(std::string_view json, monotonic_arena* arena);
 
+inline size_t json_size_bound_RegisterUserRequest(const RegisterUserRequest& obj) noexcept;
+inline char* serialize_RegisterUserRequest_to(const RegisterUserRequest& obj, char* out) noexcept;
 inline std::string serialize_RegisterUserRequest(const RegisterUserRequest& obj);
+inline size_t
+json_size_bound_RegisterUserRequest_Email_t(const RegisterUserRequest_Email_t& obj) noexcept;
+inline char* serialize_RegisterUserRequest_Email_t_to(const RegisterUserRequest_Email_t& obj,
+                                                      char* out) noexcept;
 inline std::string serialize_RegisterUserRequest_Email_t(const RegisterUserRequest_Email_t& obj);
+inline size_t
+json_size_bound_RegisterUserRequest_Password_t(const RegisterUserRequest_Password_t& obj) noexcept;
+inline char* serialize_RegisterUserRequest_Password_t_to(const RegisterUserRequest_Password_t& obj,
+                                                         char* out) noexcept;
 inline std::string
 serialize_RegisterUserRequest_Password_t(const RegisterUserRequest_Password_t& obj);
+inline size_t
+json_size_bound_RegisterUserRequest_Age_t(const RegisterUserRequest_Age_t& obj) noexcept;
+inline char* serialize_RegisterUserRequest_Age_t_to(const RegisterUserRequest_Age_t& obj,
+                                                    char* out) noexcept;
 inline std::string serialize_RegisterUserRequest_Age_t(const RegisterUserRequest_Age_t& obj);
+inline size_t
+json_size_bound_register_user_resp_200_0(const register_user_resp_200_0& obj) noexcept;
+inline char* serialize_register_user_resp_200_0_to(const register_user_resp_200_0& obj,
+                                                   char* out) noexcept;
 inline std::string serialize_register_user_resp_200_0(const register_user_resp_200_0& obj);
 
 inline std::optional<std::vector<RegisterUserRequest>>
@@ -61,12 +89,13 @@ serialize_register_user_resp_200_0_array(const arena_vector<register_user_resp_2
 
 inline std::optional<RegisterUserRequest> parse_RegisterUserRequest(std::string_view json,
                                                                     monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_object_start())
         return std::nullopt;
 
     RegisterUserRequest obj(arena);
+    static constexpr katana::serde::key_table keys{"email", "password", "age"};
     bool has_email = false;
     bool has_password = false;
 
@@ -78,28 +107,36 @@ inline std::optional<RegisterUserRequest> parse_RegisterUserRequest(std::string_
         if (!key || !cur.consume(':'))
             break;
 
-        if (*key == "email") {
+        switch (keys.find(*key)) {
+        case 0: { // email
             has_email = true;
-            if (auto v = cur.string()) {
+            if (auto v = cur.unescaped_string(*arena)) {
                 obj.email = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
             } else {
                 cur.skip_value();
             }
-        } else if (*key == "password") {
+            break;
+        }
+        case 1: { // password
             has_password = true;
-            if (auto v = cur.string()) {
+            if (auto v = cur.unescaped_string(*arena)) {
                 obj.password = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
             } else {
                 cur.skip_value();
             }
-        } else if (*key == "age") {
-            if (auto v = katana::serde::parse_size(cur)) {
-                obj.age = static_cast<int64_t>(*v);
+            break;
+        }
+        case 2: { // age
+            if (auto v = katana::serde::parse_int64(cur)) {
+                obj.age = *v;
             } else {
                 cur.skip_value();
             }
-        } else {
+            break;
+        }
+        default:
             cur.skip_value();
+            break;
         }
         cur.try_comma();
     }
@@ -112,9 +149,9 @@ inline std::optional<RegisterUserRequest> parse_RegisterUserRequest(std::string_
 
 inline std::optional<RegisterUserRequest_Email_t>
 parse_RegisterUserRequest_Email_t(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
-    if (auto v = cur.string()) {
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
+    if (auto v = cur.unescaped_string(*arena)) {
         return RegisterUserRequest_Email_t{
             arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena))};
     }
@@ -123,9 +160,9 @@ parse_RegisterUserRequest_Email_t(std::string_view json, monotonic_arena* arena)
 
 inline std::optional<RegisterUserRequest_Password_t>
 parse_RegisterUserRequest_Password_t(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
-    if (auto v = cur.string()) {
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
+    if (auto v = cur.unescaped_string(*arena)) {
         return RegisterUserRequest_Password_t{
             arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena))};
     }
@@ -134,87 +171,277 @@ parse_RegisterUserRequest_Password_t(std::string_view json, monotonic_arena* are
 
 inline std::optional<RegisterUserRequest_Age_t>
 parse_RegisterUserRequest_Age_t(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     (void)arena;
-    if (auto v = katana::serde::parse_size(cur))
-        return RegisterUserRequest_Age_t{static_cast<int64_t>(*v)};
+    if (auto v = katana::serde::parse_int64(cur))
+        return RegisterUserRequest_Age_t{*v};
     return std::nullopt;
 }
 
 inline std::optional<register_user_resp_200_0>
 parse_register_user_resp_200_0(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
-    if (auto v = cur.string()) {
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
+    if (auto v = cur.unescaped_string(*arena)) {
         return register_user_resp_200_0{
             arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena))};
     }
     return std::nullopt;
 }
 
-inline std::string serialize_RegisterUserRequest(const RegisterUserRequest& obj) {
-    std::string json;
-    json.reserve(256);
-    json.push_back('{');
-    bool first = true;
-
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"email\":");
-    json.push_back('"');
-    json.append(katana::serde::escape_json_string(obj.email));
-    json.push_back('"');
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"password\":");
-    json.push_back('"');
-    json.append(katana::serde::escape_json_string(obj.password));
-    json.push_back('"');
-    if (!first)
-        json.push_back(',');
-    first = false;
-    json.append("\"age\":");
-    {
-        if (!obj.age) {
-            json.append("null");
-        } else {
-            char buf[32];
-            auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), *obj.age);
-            json.append(buf, static_cast<size_t>(ptr - buf));
+inline std::optional<validation_error> parse_validated_RegisterUserRequest(
+    std::string_view json, monotonic_arena* arena, RegisterUserRequest& obj) {
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
+    if (!cur.try_object_start())
+        return validation_error{"", validation_error_code::invalid_type};
+
+    static constexpr katana::serde::key_table keys{"email", "password", "age"};
+    bool has_email = false;
+    bool has_password = false;
+
+    while (!cur.eof()) {
+        cur.skip_ws();
+        if (cur.try_object_end())
+            break;
+        auto key = cur.string();
+        if (!key || !cur.consume(':'))
+            return validation_error{"", validation_error_code::invalid_type};
+
+        switch (keys.find(*key)) {
+        case 0: { // email
+            has_email = true;
+            if (auto v = cur.unescaped_string(*arena)) {
+                obj.email = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
+            } else {
+                cur.skip_value();
+            }
+            if (obj.email.empty()) {
+                return validation_error{"email", validation_error_code::required_field_missing};
+            }
+            if (!obj.email.empty() && !is_valid_email(obj.email)) {
+                return validation_error{"email", validation_error_code::invalid_email_format};
+            }
+            break;
+        }
+        case 1: { // password
+            has_password = true;
+            if (auto v = cur.unescaped_string(*arena)) {
+                obj.password = arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena));
+            } else {
+                cur.skip_value();
+            }
+            if (obj.password.empty()) {
+                return validation_error{"password", validation_error_code::required_field_missing};
+            }
+            if (!obj.password.empty() &&
+                obj.password.size() < RegisterUserRequest::metadata::PASSWORD_MIN_LENGTH) {
+                return validation_error{"password",
+                                        validation_error_code::string_too_short,
+                                        RegisterUserRequest::metadata::PASSWORD_MIN_LENGTH};
+            }
+            if (obj.password.size() > RegisterUserRequest::metadata::PASSWORD_MAX_LENGTH) {
+                return validation_error{"password",
+                                        validation_error_code::string_too_long,
+                                        RegisterUserRequest::metadata::PASSWORD_MAX_LENGTH};
+            }
+            break;
+        }
+        case 2: { // age
+            if (auto v = katana::serde::parse_int64(cur)) {
+                obj.age = *v;
+            } else {
+                cur.skip_value();
+            }
+            if (obj.age &&
+                static_cast<double>(*obj.age) < RegisterUserRequest::metadata::AGE_MINIMUM) {
+                return validation_error{"age",
+                                        validation_error_code::value_too_small,
+                                        RegisterUserRequest::metadata::AGE_MINIMUM};
+            }
+            if (obj.age &&
+                static_cast<double>(*obj.age) > RegisterUserRequest::metadata::AGE_MAXIMUM) {
+                return validation_error{"age",
+                                        validation_error_code::value_too_large,
+                                        RegisterUserRequest::metadata::AGE_MAXIMUM};
+            }
+            break;
+        }
+        default:
+            cur.skip_value();
+            break;
         }
+        cur.try_comma();
+    }
+    if (!has_email)
+        return validation_error{"email", validation_error_code::required_field_missing};
+    if (!has_password)
+        return validation_error{"password", validation_error_code::required_field_missing};
+    return std::nullopt;
+}
+
+inline size_t json_size_bound_RegisterUserRequest(const RegisterUserRequest& obj) noexcept {
+    size_t n = 29;
+    n += katana::serde::json_string_size_bound(obj.email.size());
+    n += katana::serde::json_string_size_bound(obj.password.size());
+    n += katana::serde::json_int_max_size;
+    return n;
+}
+
+inline char* serialize_RegisterUserRequest_to(const RegisterUserRequest& obj, char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.raw("{\"email\":");
+    w.string(obj.email);
+    w.raw(",\"password\":");
+    w.string(obj.password);
+    w.raw(",\"age\":");
+    if (obj.age) {
+        w.integer(*obj.age);
+    } else {
+        w.null();
     }
-    json.push_back('}');
+    w.put('}');
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_RegisterUserRequest_into(const RegisterUserRequest& obj, Out& out) {
+    return katana::serde::write_json(out, json_size_bound_RegisterUserRequest(obj), [&](char* p) {
+        return serialize_RegisterUserRequest_to(obj, p);
+    });
+}
+
+inline std::string serialize_RegisterUserRequest(const RegisterUserRequest& obj) {
+    std::string json;
+    serialize_RegisterUserRequest_into(obj, json);
     return json;
 }
 
+inline size_t
+json_size_bound_RegisterUserRequest_Email_t(const RegisterUserRequest_Email_t& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_string_size_bound(obj.size());
+    return n;
+}
+
+inline char* serialize_RegisterUserRequest_Email_t_to(const RegisterUserRequest_Email_t& obj,
+                                                      char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.string(obj);
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_RegisterUserRequest_Email_t_into(const RegisterUserRequest_Email_t& obj,
+                                                       Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_RegisterUserRequest_Email_t(obj), [&](char* p) {
+            return serialize_RegisterUserRequest_Email_t_to(obj, p);
+        });
+}
+
 inline std::string serialize_RegisterUserRequest_Email_t(const RegisterUserRequest_Email_t& obj) {
-    return std::string("\"") + katana::serde::escape_json_string(obj) + "\"";
+    std::string json;
+    serialize_RegisterUserRequest_Email_t_into(obj, json);
+    return json;
+}
+
+inline size_t
+json_size_bound_RegisterUserRequest_Password_t(const RegisterUserRequest_Password_t& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_string_size_bound(obj.size());
+    return n;
+}
+
+inline char* serialize_RegisterUserRequest_Password_t_to(const RegisterUserRequest_Password_t& obj,
+                                                         char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.string(obj);
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_RegisterUserRequest_Password_t_into(const RegisterUserRequest_Password_t& obj,
+                                                          Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_RegisterUserRequest_Password_t(obj), [&](char* p) {
+            return serialize_RegisterUserRequest_Password_t_to(obj, p);
+        });
 }
 
 inline std::string
 serialize_RegisterUserRequest_Password_t(const RegisterUserRequest_Password_t& obj) {
-    return std::string("\"") + katana::serde::escape_json_string(obj) + "\"";
+    std::string json;
+    serialize_RegisterUserRequest_Password_t_into(obj, json);
+    return json;
+}
+
+inline size_t json_size_bound_RegisterUserRequest_Age_t(
+    [[maybe_unused]] const RegisterUserRequest_Age_t& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_int_max_size;
+    return n;
+}
+
+inline char* serialize_RegisterUserRequest_Age_t_to(const RegisterUserRequest_Age_t& obj,
+                                                    char* out) noexcept {
+    katana::serde::json_out w{out};
+    if (obj) {
+        w.integer(*obj);
+    } else {
+        w.null();
+    }
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_RegisterUserRequest_Age_t_into(const RegisterUserRequest_Age_t& obj,
+                                                     Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_RegisterUserRequest_Age_t(obj), [&](char* p) {
+            return serialize_RegisterUserRequest_Age_t_to(obj, p);
+        });
 }
 
 inline std::string serialize_RegisterUserRequest_Age_t(const RegisterUserRequest_Age_t& obj) {
-    if (!obj)
-        return std::string("null");
-    char buf[32];
-    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), *obj);
-    return std::string(buf, static_cast<size_t>(ptr - buf));
+    std::string json;
+    serialize_RegisterUserRequest_Age_t_into(obj, json);
+    return json;
+}
+
+inline size_t
+json_size_bound_register_user_resp_200_0(const register_user_resp_200_0& obj) noexcept {
+    size_t n = 0;
+    n += katana::serde::json_string_size_bound(obj.size());
+    return n;
+}
+
+inline char* serialize_register_user_resp_200_0_to(const register_user_resp_200_0& obj,
+                                                   char* out) noexcept {
+    katana::serde::json_out w{out};
+    w.string(obj);
+    return w.pos;
+}
+
+template <typename Out>
+inline auto serialize_register_user_resp_200_0_into(const register_user_resp_200_0& obj, Out& out) {
+    return katana::serde::write_json(
+        out, json_size_bound_register_user_resp_200_0(obj), [&](char* p) {
+            return serialize_register_user_resp_200_0_to(obj, p);
+        });
 }
 
 inline std::string serialize_register_user_resp_200_0(const register_user_resp_200_0& obj) {
-    return std::string("\"") + katana::serde::escape_json_string(obj) + "\"";
+    std::string json;
+    serialize_register_user_resp_200_0_into(obj, json);
+    return json;
 }
 
 inline std::optional<std::vector<RegisterUserRequest>>
 parse_RegisterUserRequest_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -242,8 +469,8 @@ parse_RegisterUserRequest_array(std::string_view json, monotonic_arena* arena) {
 
 inline std::optional<std::vector<RegisterUserRequest_Email_t>>
 parse_RegisterUserRequest_Email_t_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -271,8 +498,8 @@ parse_RegisterUserRequest_Email_t_array(std::string_view json, monotonic_arena*
 
 inline std::optional<std::vector<RegisterUserRequest_Password_t>>
 parse_RegisterUserRequest_Password_t_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -300,8 +527,8 @@ parse_RegisterUserRequest_Password_t_array(std::string_view json, monotonic_aren
 
 inline std::optional<std::vector<RegisterUserRequest_Age_t>>
 parse_RegisterUserRequest_Age_t_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -329,8 +556,8 @@ parse_RegisterUserRequest_Age_t_array(std::string_view json, monotonic_arena* ar
 
 inline std::optional<std::vector<register_user_resp_200_0>>
 parse_register_user_resp_200_0_array(std::string_view json, monotonic_arena* arena) {
-    using katana::serde::json_cursor;
-    json_cursor cur{json.data(), json.data() + json.size()};
+    katana::serde::indexed_json_scope indexed(json);
+    auto cur = indexed.cursor();
     if (!cur.try_array_start())
         return std::nullopt;
 
@@ -358,120 +585,230 @@ parse_register_user_resp_200_0_array(std::string_view json, monotonic_arena* are
 
 inline std::string
 serialize_RegisterUserRequest_array(const std::vector<RegisterUserRequest>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string
 serialize_RegisterUserRequest_array(const arena_vector<RegisterUserRequest>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_RegisterUserRequest_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_RegisterUserRequest,
+                                            &serialize_RegisterUserRequest_to);
+}
+
 inline std::string
 serialize_RegisterUserRequest_Email_t_array(const std::vector<RegisterUserRequest_Email_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Email_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Email_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Email_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string
 serialize_RegisterUserRequest_Email_t_array(const arena_vector<RegisterUserRequest_Email_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Email_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Email_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Email_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_RegisterUserRequest_Email_t_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_RegisterUserRequest_Email_t,
+                                            &serialize_RegisterUserRequest_Email_t_to);
+}
+
 inline std::string serialize_RegisterUserRequest_Password_t_array(
     const std::vector<RegisterUserRequest_Password_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Password_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Password_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Password_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string serialize_RegisterUserRequest_Password_t_array(
     const arena_vector<RegisterUserRequest_Password_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Password_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Password_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Password_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_RegisterUserRequest_Password_t_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_RegisterUserRequest_Password_t,
+                                            &serialize_RegisterUserRequest_Password_t_to);
+}
+
 inline std::string
 serialize_RegisterUserRequest_Age_t_array(const std::vector<RegisterUserRequest_Age_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Age_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Age_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Age_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string
 serialize_RegisterUserRequest_Age_t_array(const arena_vector<RegisterUserRequest_Age_t>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_RegisterUserRequest_Age_t(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_RegisterUserRequest_Age_t(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_RegisterUserRequest_Age_t_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
+template <typename Range> inline auto stream_RegisterUserRequest_Age_t_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_RegisterUserRequest_Age_t,
+                                            &serialize_RegisterUserRequest_Age_t_to);
+}
+
 inline std::string
 serialize_register_user_resp_200_0_array(const std::vector<register_user_resp_200_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_register_user_resp_200_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_register_user_resp_200_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_register_user_resp_200_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
 
 inline std::string
 serialize_register_user_resp_200_0_array(const arena_vector<register_user_resp_200_0>& arr) {
-    std::string json = "[";
-    for (size_t i = 0; i < arr.size(); ++i) {
-        json += serialize_register_user_resp_200_0(arr[i]);
-        if (i < arr.size() - 1)
-            json += ",";
+    size_t bound = 2 + arr.size();
+    for (const auto& item : arr) {
+        bound += json_size_bound_register_user_resp_200_0(item);
     }
-    json += "]";
+    std::string json;
+    katana::serde::write_json(json, bound, [&](char* p) {
+        *p++ = '[';
+        for (size_t i = 0; i < arr.size(); ++i) {
+            if (i > 0)
+                *p++ = ',';
+            p = serialize_register_user_resp_200_0_to(arr[i], p);
+        }
+        *p++ = ']';
+        return p;
+    });
     return json;
 }
+
+template <typename Range> inline auto stream_register_user_resp_200_0_array(Range&& items) {
+    return katana::serde::json_array_stream(std::forward<Range>(items),
+                                            &json_size_bound_register_user_resp_200_0,
+                                            &serialize_register_user_resp_200_0_to);
+}
@@ -36,52 +36,6 @@
 
 namespace generated {
 
-inline std::optional<std::string_view> query_param(std::string_view uri, std::string_view key) {
-    auto qpos = uri.find('?');
-    if (qpos == std::string_view::npos)
-        return std::nullopt;
-    auto query = uri.substr(qpos + 1);
-    while (!query.empty()) {
-        auto amp = query.find('&');
-        auto part = query.substr(0, amp);
-        auto eq = part.find('=');
-        auto name = part.substr(0, eq);
-        if (name == key) {
-            if (eq == std::string_view::npos)
-                return std::string_view{};
-            return part.substr(eq + 1);
-        }
-        if (amp == std::string_view::npos)
-            break;
-        query.remove_prefix(amp + 1);
-    }
-    return std::nullopt;
-}
-
-inline std::optional<std::string_view> cookie_param(const katana::http::request& req,
-                                                    std::string_view key) {
-    auto cookie = req.headers.get("Cookie");
-    if (!cookie)
-        return std::nullopt;
-    std::string_view rest = *cookie;
-    while (!rest.empty()) {
-        auto sep = rest.find(';');
-        auto token = rest.substr(0, sep);
-        if (sep != std::string_view::npos)
-            rest.remove_prefix(sep + 1);
-        auto eq = token.find('=');
-        if (eq == std::string_view::npos)
-            continue;
-        auto name = katana::serde::trim_view(token.substr(0, eq));
-        auto val = katana::serde::trim_view(token.substr(eq + 1));
-        if (name == key)
-            return val;
-        if (sep == std::string_view::npos)
-            break;
-    }
-    return std::nullopt;
-}
-
 inline std::optional<size_t> find_content_type(std::optional<std::string_view> header,
                                                std::span<const content_type_info> allowed) {
     if (allowed.empty())
@@ -172,47 +126,46 @@ inline const katana::http::router& make_router(api_handler& handler) {
         route_entry{
             katana::http::method::post,
             katana::http::path_pattern::from_literal<"/user/register">(),
-            handler_fn(
-                [&handler](const katana::http::request& req, katana::http::request_context& ctx)
-                    -> katana::result<katana::http::response> {
-                    auto negotiated_response = negotiate_response_type(req, route_0_produces);
-                    if (!negotiated_response) {
-                        return katana::http::response::error(
-                            katana::problem_details::not_acceptable("unsupported Accept header"));
-                    }
-                    auto matched_ct =
-                        find_content_type(req.headers.get("Content-Type"), route_0_consumes);
-                    if (!matched_ct)
-                        return katana::http::response::error(
-                            katana::problem_details::unsupported_media_type(
-                                "unsupported Content-Type"));
-                    std::optional<RegisterUserRequest> parsed_body;
-                    switch (*matched_ct) {
-                    case 0: {
-                        auto candidate = parse_RegisterUserRequest(req.body, &ctx.arena);
-                        if (!candidate)
+            handler_fn([&handler](const katana::http::request& req,
+                                  katana::http::request_context& ctx)
+                           -> katana::result<katana::http::response> {
+                auto negotiated_response = negotiate_response_type(req, route_0_produces);
+                if (!negotiated_response) {
+                    return katana::http::response::error(
+                        katana::problem_details::not_acceptable("unsupported Accept header"));
+                }
+                auto matched_ct =
+                    find_content_type(req.headers.get("Content-Type"), route_0_consumes);
+                if (!matched_ct)
+                    return katana::http::response::error(
+                        katana::problem_details::unsupported_media_type(
+                            "unsupported Content-Type"));
+                std::optional<RegisterUserRequest> parsed_body;
+                switch (*matched_ct) {
+                case 0: {
+                    auto& candidate = parsed_body.emplace(&ctx.arena);
+                    if (auto err =
+                            parse_validated_RegisterUserRequest(req.body, &ctx.arena, candidate)) {
+                        if (err->field.empty())
                             return katana::http::response::error(
                                 katana::problem_details::bad_request("invalid request body"));
-                        parsed_body = std::move(*candidate);
-                        break;
-                    }
-                    default:
-                        return katana::http::response::error(
-                            katana::problem_details::unsupported_media_type(
-                                "unsupported Content-Type"));
+                        return format_validation_error(*err);
                     }
-                    // Automatic validation (optimized: single allocation)
-                    if (auto validation_error = validate_RegisterUserRequest(*parsed_body)) {
-                        return format_validation_error(*validation_error);
-                    }
-                    // Set handler context for zero-boilerplate access
-                    katana::http::handler_context::scope context_scope(req, ctx);
-                    auto generated_response = handler.register_user(*parsed_body);
-                    if (negotiated_response && !generated_response.headers.get("Content-Type")) {
-                        generated_response.set_header("Content-Type", *negotiated_response);
-                    }
-                    return generated_response;
-                })},
+                    break;
+                }
+                default:
+                    return katana::http::response::error(
+                        katana::problem_details::unsupported_media_type(
+                            "unsupported Content-Type"));
+                }
+                // Set handler context for zero-boilerplate access
+                katana::http::handler_context::scope context_scope(req, ctx);
+                auto generated_response = handler.register_user(*parsed_body);
+                if (negotiated_response && !generated_response.headers.get("Content-Type")) {
+                    generated_response.set_header("Content-Type", *negotiated_response);
+                }
+                return generated_response;
+            })},
     };
     static katana::http::router router_instance(route_entries);
     return router_instance;
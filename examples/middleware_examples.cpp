@@ -2,6 +2,7 @@
 #include "katana/core/fd_watch.hpp"
 #include "katana/core/http.hpp"
 #include "katana/core/io_buffer.hpp"
+#include "katana/core/rate_limiter.hpp"
 #include "katana/core/reactor_pool.hpp"
 #include "katana/core/router.hpp"
 #include "katana/core/shutdown.hpp"
@@ -135,57 +136,6 @@ middleware_fn auth_middleware(std::string_view valid_token = "secret-token-123")
     });
 }
 
-// ============================================================================
-// Rate Limiting Middleware (simple in-memory)
-// ============================================================================
-
-class simple_rate_limiter {
-public:
-    explicit simple_rate_limiter(size_t max_requests, milliseconds window)
-        : max_requests_(max_requests), window_(window) {}
-
-    bool allow_request() {
-        auto now = steady_clock::now();
-
-        // Clean old requests outside the window
-        while (!requests_.empty() && (now - requests_.front()) > window_) {
-            requests_.erase(requests_.begin());
-        }
-
-        if (requests_.size() >= max_requests_) {
-            return false;
-        }
-
-        requests_.push_back(now);
-        return true;
-    }
-
-private:
-    size_t max_requests_;
-    milliseconds window_;
-    std::vector<steady_clock::time_point> requests_;
-};
-
-middleware_fn rate_limit_middleware(size_t max_requests = 100,
-                                    milliseconds window = milliseconds(60000)) {
-    // NOTE: In production, this should be per-IP or per-user
-    // This is a global rate limiter for demonstration
-    auto limiter = std::make_shared<simple_rate_limiter>(max_requests, window);
-
-    return middleware_fn([limiter](const request&, request_context&, next_fn next) {
-        if (!limiter->allow_request()) {
-            auto problem = problem_details::service_unavailable(
-                "Rate limit exceeded. Please try again later.");
-
-            auto resp = response::error(problem);
-            resp.set_header("Retry-After", "60");
-            return result<response>(std::move(resp));
-        }
-
-        return next();
-    });
-}
-
 // ============================================================================
 // Content Type Validation Middleware
 // ============================================================================
@@ -376,6 +326,20 @@ int main() {
 
     auto protected_chain = make_middleware_chain(protected_middleware);
 
+    // Rate limited middleware: 10 req/s with bursts of 20 per X-Client-Id
+    rate_limit_config limit_config;
+    limit_config.requests_per_second = 10.0;
+    limit_config.burst = 20;
+    rate_limiter limiter(limit_config);
+
+    std::array<middleware_fn, 3> public_middleware = {
+        error_recovery_middleware(),
+        logging_middleware(),
+        rate_limit_middleware(limiter, rate_limit_key::header("X-Client-Id")),
+    };
+
+    auto public_chain = make_middleware_chain(public_middleware);
+
     // Define routes
     route_entry routes[] = {
         // Public endpoint
@@ -392,7 +356,7 @@ int main() {
          handler_fn([](const request&, request_context&) {
              return response::json("{\"message\":\"This is a public endpoint\"}");
          }),
-         middleware_chain},
+         public_chain},
 
         // Protected endpoint (requires auth token)
         {method::get,
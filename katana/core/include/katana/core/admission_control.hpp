@@ -0,0 +1,71 @@
+#pragma once
+
+#include "metrics.hpp"
+#include "router.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace katana::http {
+
+struct admission_config {
+    // Acceptable time between a readable event and dispatch of its request.
+    std::chrono::microseconds target_delay{5000};
+    // How long the delay must stay above target before normal routes are shed.
+    std::chrono::milliseconds interval{100};
+    uint32_t max_in_flight = 0; // 0 = unlimited
+    std::chrono::seconds retry_after{1};
+};
+
+enum class admission_verdict : uint8_t { admit, shed_delay, shed_in_flight };
+
+/// CoDel-style admission control for one reactor.
+///
+/// Every request is sampled with its queueing delay (readable event -> dispatch). Once the
+/// delay has stayed above target for a full interval the controller enters the shedding
+/// state and rejects normal-priority requests that are themselves late, until a request is
+/// seen below target again. Low-priority requests are rejected whenever they are late;
+/// critical requests are always admitted.
+///
+/// Not thread-safe: each reactor owns its own controller. Metrics may be read from any thread.
+class admission_controller {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit admission_controller(const admission_config& config = {});
+
+    /// Admitted requests must be paired with complete().
+    admission_verdict
+    admit(route_priority priority, clock::time_point ready_at, clock::time_point now) noexcept;
+    void complete() noexcept;
+
+    /// Pre-serialized 503 + Retry-After, written as-is for shed requests.
+    [[nodiscard]] std::string_view shed_response(bool keep_alive) const noexcept {
+        return keep_alive ? shed_keep_alive_ : shed_close_;
+    }
+
+    [[nodiscard]] bool overloaded() const noexcept { return dropping_; }
+    [[nodiscard]] uint32_t in_flight() const noexcept { return in_flight_; }
+    [[nodiscard]] const admission_config& config() const noexcept { return config_; }
+    [[nodiscard]] const admission_metrics& metrics() const noexcept { return metrics_; }
+
+private:
+    void observe(clock::duration delay, clock::time_point now) noexcept;
+
+    admission_config config_;
+    clock::duration target_;
+    clock::duration interval_;
+    clock::time_point first_above_{};
+    uint64_t max_delay_us_ = 0;
+    uint32_t in_flight_ = 0;
+    bool above_target_ = false;
+    bool dropping_ = false;
+
+    std::string shed_keep_alive_;
+    std::string shed_close_;
+    admission_metrics metrics_;
+};
+
+} // namespace katana::http
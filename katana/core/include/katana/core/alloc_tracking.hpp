@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace katana {
+
+/// Stage of request handling that allocations are attributed to
+enum class alloc_phase : uint8_t {
+    other,     // outside any phase_scope
+    parse,     // reading and parsing the request
+    dispatch,  // routing, middleware and the handler
+    serialize, // finishing the response and rendering it into the write buffer
+    write      // flushing the write buffer to the socket
+};
+
+inline constexpr size_t ALLOC_PHASE_COUNT = 5;
+
+[[nodiscard]] constexpr std::string_view alloc_phase_name(alloc_phase phase) noexcept {
+    switch (phase) {
+    case alloc_phase::parse:
+        return "parse";
+    case alloc_phase::dispatch:
+        return "dispatch";
+    case alloc_phase::serialize:
+        return "serialize";
+    case alloc_phase::write:
+        return "write";
+    case alloc_phase::other:
+        break;
+    }
+    return "other";
+}
+
+struct alloc_counters {
+    uint64_t heap_allocations = 0;  // global operator new calls
+    uint64_t heap_bytes = 0;        // bytes those calls asked for
+    uint64_t heap_frees = 0;        // global operator delete calls on non-null pointers
+    uint64_t arena_allocations = 0; // successful monotonic_arena::allocate calls
+    uint64_t arena_bytes = 0;
+
+    alloc_counters& operator+=(const alloc_counters& other) noexcept {
+        heap_allocations += other.heap_allocations;
+        heap_bytes += other.heap_bytes;
+        heap_frees += other.heap_frees;
+        arena_allocations += other.arena_allocations;
+        arena_bytes += other.arena_bytes;
+        return *this;
+    }
+
+    bool operator==(const alloc_counters&) const = default;
+};
+
+using alloc_phase_counters = std::array<alloc_counters, ALLOC_PHASE_COUNT>;
+
+/// Per-thread allocation counters, compiled in with the KATANA_ALLOC_TRACKING build option,
+/// which also replaces the global operator new/delete (see alloc_tracking.cpp). Without it
+/// every function here is a no-op and `enabled` is false, so instrumented code costs nothing.
+namespace alloc_tracking {
+
+#ifdef KATANA_ALLOC_TRACKING
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+struct thread_state {
+    alloc_phase_counters phases{};  // everything counted on the thread, by phase
+    alloc_counters* sink = nullptr; // also receives each count; set by phase_scope
+    alloc_phase phase = alloc_phase::other;
+    uint32_t paused = 0;
+};
+
+// Constant-initialised, so operator new can use it on any thread at any point of its life
+extern constinit thread_local thread_state current;
+
+namespace detail {
+
+template <typename Fn> inline void record(Fn&& fn) noexcept {
+    if constexpr (enabled) {
+        thread_state& state = current;
+        if (state.paused == 0) {
+            fn(state.phases[static_cast<size_t>(state.phase)]);
+            if (state.sink) {
+                fn(*state.sink);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+inline void record_heap_allocation(size_t bytes) noexcept {
+    detail::record([bytes](alloc_counters& c) {
+        ++c.heap_allocations;
+        c.heap_bytes += bytes;
+    });
+}
+
+inline void record_heap_free() noexcept {
+    detail::record([](alloc_counters& c) { ++c.heap_frees; });
+}
+
+inline void record_arena_allocation(size_t bytes) noexcept {
+    detail::record([bytes](alloc_counters& c) {
+        ++c.arena_allocations;
+        c.arena_bytes += bytes;
+    });
+}
+
+/// Everything counted on the calling thread, by phase
+[[nodiscard]] inline const alloc_phase_counters& thread_phases() noexcept {
+    return current.phases;
+}
+
+/// Everything counted on the calling thread, all phases summed
+[[nodiscard]] inline alloc_counters thread_totals() noexcept {
+    alloc_counters total;
+    for (const auto& counters : current.phases) {
+        total += counters;
+    }
+    return total;
+}
+
+/// Attributes the calling thread's allocations to `phase` and adds them to `into[phase]` as
+/// they happen, until enter() moves to another phase or the scope ends. Scopes nest: the
+/// outer phase and target are restored on destruction.
+class phase_scope {
+public:
+    phase_scope(alloc_phase phase, alloc_phase_counters& into) noexcept : into_(&into) {
+        if constexpr (enabled) {
+            previous_phase_ = current.phase;
+            previous_sink_ = current.sink;
+            enter(phase);
+        }
+    }
+
+    ~phase_scope() {
+        if constexpr (enabled) {
+            current.phase = previous_phase_;
+            current.sink = previous_sink_;
+        }
+    }
+
+    phase_scope(const phase_scope&) = delete;
+    phase_scope& operator=(const phase_scope&) = delete;
+
+    void enter(alloc_phase phase) noexcept {
+        if constexpr (enabled) {
+            current.phase = phase;
+            current.sink = &(*into_)[static_cast<size_t>(phase)];
+        }
+    }
+
+private:
+    alloc_phase_counters* into_;
+    alloc_counters* previous_sink_ = nullptr;
+    alloc_phase previous_phase_ = alloc_phase::other;
+};
+
+/// Stops counting on the calling thread while in scope, for bookkeeping that should not show
+/// up in the numbers it keeps
+class pause_scope {
+public:
+    pause_scope() noexcept {
+        if constexpr (enabled) {
+            ++current.paused;
+        }
+    }
+
+    ~pause_scope() {
+        if constexpr (enabled) {
+            --current.paused;
+        }
+    }
+
+    pause_scope(const pause_scope&) = delete;
+    pause_scope& operator=(const pause_scope&) = delete;
+};
+
+} // namespace alloc_tracking
+} // namespace katana
@@ -12,11 +12,107 @@
 
 namespace katana {
 
+struct arena_cache_stats {
+    uint64_t hits = 0;        // blocks served from the cache
+    uint64_t misses = 0;      // blocks that had to come from memory_pool::allocate()
+    uint64_t returns = 0;     // blocks taken back into the cache
+    uint64_t frees = 0;       // blocks given back: too large, over the limit, foreign or trimmed
+    size_t cached_blocks = 0; // currently held
+    size_t cached_bytes = 0;
+};
+
+/// Per-thread cache of free arena blocks, bucketed by power-of-two size class.
+///
+/// monotonic_arena takes its blocks from the calling thread's cache and gives them back when it
+/// is destroyed, so with reactor-per-thread a connection closing on a reactor hands its blocks
+/// to the next one accepted there instead of to malloc. Blocks above MAX_CLASS_SIZE bypass the
+/// cache. Cached bytes are capped by max_cached_bytes(); trim() frees the blocks that stayed
+/// unused since the previous trim(), so a burst of connections does not pin its memory once
+/// the load drops. Blocks may be returned on a different thread than the one they came from.
+/// Underneath, blocks come from the thread's memory_pool when it has one, else from malloc.
+class arena_block_cache {
+public:
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+    static constexpr size_t MIN_CLASS_SIZE = 4096;
+    static constexpr size_t MAX_CLASS_SIZE = 1024UL * 1024UL;
+    static constexpr size_t DEFAULT_MAX_CACHED_BYTES = 16UL * 1024UL * 1024UL;
+
+    /// The calling thread's cache. After the thread has started destroying its thread-locals it
+    /// no longer caches anything, so arenas outliving it still free their blocks.
+    static arena_block_cache& local() noexcept;
+
+    /// Capacity of the block acquire() hands out for a request of `size` bytes
+    [[nodiscard]] static constexpr size_t block_size_for(size_t size) noexcept {
+        if (size <= MIN_CLASS_SIZE) {
+            return MIN_CLASS_SIZE;
+        }
+        if (size <= MAX_CLASS_SIZE) {
+            return std::bit_ceil(size);
+        }
+        return (size + BLOCK_ALIGNMENT - 1) & ~(BLOCK_ALIGNMENT - 1);
+    }
+
+    /// Block of block_size_for(size) bytes aligned to BLOCK_ALIGNMENT, or nullptr
+    [[nodiscard]] void* acquire(size_t size) noexcept;
+
+    /// Give back a block of `size` bytes (its block_size_for() capacity) from acquire()
+    void release(void* data, size_t size) noexcept;
+
+    /// Free the blocks that have not been needed since the previous call. Returns bytes freed.
+    size_t trim() noexcept;
+
+    /// Free every cached block
+    void clear() noexcept;
+
+    [[nodiscard]] size_t max_cached_bytes() const noexcept { return max_cached_bytes_; }
+    void set_max_cached_bytes(size_t bytes) noexcept;
+
+    [[nodiscard]] const arena_cache_stats& stats() const noexcept { return stats_; }
+
+private:
+    static constexpr size_t MIN_CLASS_SHIFT = 12;
+    static constexpr size_t NUM_CLASSES = 9; // 4 KiB .. 1 MiB
+    static_assert(MIN_CLASS_SIZE << (NUM_CLASSES - 1) == MAX_CLASS_SIZE);
+
+    struct free_block {
+        free_block* next;
+    };
+
+    struct size_class {
+        free_block* head = nullptr;
+        size_t count = 0;
+        size_t low_water = 0; // fewest blocks held since the last trim()
+    };
+
+    static constexpr size_t class_index(size_t block_size) noexcept {
+        return static_cast<size_t>(std::countr_zero(block_size)) - MIN_CLASS_SHIFT;
+    }
+
+    void free_cached(size_class& cls, size_t block_size, size_t count) noexcept;
+
+    // Kept trivially destructible so the thread's instance stays valid through thread exit;
+    // local() pairs it with a guard that empties and disables it
+    std::array<size_class, NUM_CLASSES> classes_{};
+    arena_cache_stats stats_{};
+    size_t max_cached_bytes_ = DEFAULT_MAX_CACHED_BYTES;
+    bool enabled_ = true;
+
+    friend struct arena_cache_guard;
+};
+
+/// Bump allocator over a chain of blocks from the thread's arena_block_cache.
+///
+/// The first block is `block_size` bytes; each further one doubles the last, up to
+/// MAX_GROWTH_BLOCK_SIZE, so a request of any size needs O(log n) blocks. An allocation larger
+/// than the next block gets a block of its own, chained behind the current one so the space
+/// left there stays usable. reset() keeps only the largest block (if not above
+/// MAX_GROWTH_BLOCK_SIZE) and starts filling it again, so an arena reused for similar requests
+/// stops acquiring blocks after the first few.
 class monotonic_arena {
 public:
     static constexpr size_t DEFAULT_BLOCK_SIZE = 64UL * 1024UL;
     static constexpr size_t MAX_ALIGNMENT = 64;
-    static constexpr size_t MAX_BLOCKS = 32;
+    static constexpr size_t MAX_GROWTH_BLOCK_SIZE = arena_block_cache::MAX_CLASS_SIZE;
 
     explicit monotonic_arena(size_t block_size = DEFAULT_BLOCK_SIZE) noexcept;
     ~monotonic_arena() noexcept;
@@ -44,36 +140,43 @@ public:
 
     void reset() noexcept;
 
+    /// Bytes handed out since construction or the last reset()
     [[nodiscard]] size_t bytes_allocated() const noexcept { return bytes_allocated_; }
+    /// Most bytes_allocated() has reached over the arena's lifetime
+    [[nodiscard]] size_t peak_bytes_allocated() const noexcept {
+        return peak_bytes_allocated_ > bytes_allocated_ ? peak_bytes_allocated_ : bytes_allocated_;
+    }
+    /// Size of the blocks currently held, headers included
     [[nodiscard]] size_t total_capacity() const noexcept { return total_capacity_; }
+    [[nodiscard]] size_t block_count() const noexcept { return num_blocks_; }
+    /// Blocks taken from the block cache over the arena's lifetime
+    [[nodiscard]] uint64_t blocks_acquired() const noexcept { return blocks_acquired_; }
 
 private:
-    struct block {
-        uint8_t* data;
-        size_t size;
-        size_t used;
-
-        block() noexcept : data(nullptr), size(0), used(0) {}
-        block(size_t s) noexcept;
-        ~block() noexcept;
-
-        block(const block&) = delete;
-        block& operator=(const block&) = delete;
-        block(block&& other) noexcept;
-        block& operator=(block&& other) noexcept;
+    // Lives at the start of each block; the data follows it
+    struct alignas(MAX_ALIGNMENT) block {
+        block* next;
+        size_t size; // whole block, header included
+        size_t used; // from the start of the block, header included
     };
+    static constexpr size_t HEADER_SIZE = sizeof(block);
 
     [[nodiscard]] static constexpr size_t align_up(size_t n, size_t alignment) noexcept {
         return (n + alignment - 1) & ~(alignment - 1);
     }
 
-    [[nodiscard]] bool allocate_new_block(size_t min_size) noexcept;
+    [[nodiscard]] void* allocate_slow(size_t bytes, size_t alignment) noexcept;
+    [[nodiscard]] block* acquire_block(size_t size) noexcept;
+    void release_block(block* b) noexcept;
+    void release_all() noexcept;
 
-    std::array<block, MAX_BLOCKS> blocks_;
+    block* current_ = nullptr; // head of the chain, the block being filled
     size_t num_blocks_ = 0;
     size_t block_size_;
     size_t bytes_allocated_ = 0;
+    size_t peak_bytes_allocated_ = 0;
     size_t total_capacity_ = 0;
+    uint64_t blocks_acquired_ = 0;
 };
 
 template <typename T> class arena_allocator {
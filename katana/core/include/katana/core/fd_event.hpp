@@ -1,6 +1,6 @@
 #pragma once
 
-#include "inplace_function.hpp"
+#include "small_function.hpp"
 
 #include <cstdint>
 
@@ -29,6 +29,6 @@ constexpr bool has_flag(event_type value, event_type flag) noexcept {
     return (static_cast<uint8_t>(value) & static_cast<uint8_t>(flag)) != 0;
 }
 
-using event_callback = inplace_function<void(event_type events), 96>;
+using event_callback = copyable_small_function<void(event_type events), 96>;
 
 } // namespace katana
@@ -0,0 +1,315 @@
+#pragma once
+
+#include "paged_table.hpp"
+#include "small_function.hpp"
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace katana {
+
+/// Hierarchical timing wheel: `Levels` wheels of 2^LevelBits slots each, the first one
+/// advancing every `TickUs` microseconds and each further one 2^LevelBits times slower. With
+/// the defaults that is 1 ms / 256 ms / 65.5 s / 4.7 h per slot and about 49 days before a
+/// timeout has to wait in the overflow list.
+///
+/// A timeout is kept as an absolute deadline tick and placed on the lowest level on which its
+/// slot is still ahead of the current one. When the current time reaches the start of that
+/// slot, the slot is cascaded: its timeouts move to lower levels, each at most once per
+/// level. Insert and cancel are O(1) (timeouts sit in intrusive lists, cancel unlinks
+/// eagerly) and expiring is O(1) per timeout. A callback never runs before its deadline and
+/// at most one tick after it.
+///
+/// Per-level slot bitmaps give the next tick at which anything happens, so tick() jumps over
+/// idle time instead of stepping through it, and time_until_next_expiration() is a few
+/// find-first-set operations. The answer is the earliest deadline unless a cascade comes
+/// first, in which case it is the cascade: early, never late.
+template <size_t LevelBits = 8,
+          size_t Levels = 4,
+          size_t TickUs = 1000,
+          size_t CallbackSize = 128>
+class hierarchical_timer {
+    static_assert(LevelBits >= 1 && LevelBits <= 16, "level size must be 2..65536 slots");
+    static_assert(Levels >= 1 && LevelBits * Levels < 64, "wheel range must fit in 64 bits");
+    static_assert(TickUs > 0, "tick must be positive");
+
+public:
+    using callback_fn = small_function<void(), CallbackSize>;
+    using timeout_id = uint64_t;
+    using clock = std::chrono::steady_clock;
+    using duration = std::chrono::milliseconds;
+
+    static constexpr size_t SLOTS = size_t{1} << LevelBits;
+    static constexpr size_t LEVELS = Levels;
+    static constexpr std::chrono::microseconds TICK{TickUs};
+
+    explicit hierarchical_timer(clock::time_point origin = clock::now()) : origin_(origin) {
+        heads_.fill(NIL);
+    }
+
+    /// Run `cb` once `timeout` has passed since `now`.
+    timeout_id add(clock::duration timeout, callback_fn cb, clock::time_point now = clock::now()) {
+        return add_at(now + timeout, std::move(cb));
+    }
+
+    /// Run `cb` at `deadline`, rounded up to the next tick; deadlines that have already
+    /// passed fire on the next tick.
+    timeout_id add_at(clock::time_point deadline, callback_fn cb) {
+        if (!cb) {
+            throw std::invalid_argument("hierarchical_timer::add: callback must be valid");
+        }
+
+        const auto since_origin = std::chrono::ceil<tick_duration>(deadline - origin_).count();
+        uint64_t tick = since_origin > 0 ? static_cast<uint64_t>(since_origin) : 0;
+        if (tick <= now_tick_) {
+            tick = now_tick_ + 1;
+        }
+
+        const uint32_t index = acquire_entry();
+        auto& entry = entries_[index];
+        entry.callback = std::move(cb);
+        entry.deadline = tick;
+        place(index);
+        return make_id(index, entry.generation);
+    }
+
+    [[nodiscard]] bool cancel(timeout_id id) {
+        const auto index = static_cast<uint32_t>(id & 0xffffffffu);
+        const auto generation = static_cast<uint32_t>(id >> 32);
+        if (index >= entry_count_) {
+            return false;
+        }
+        auto& entry = entries_[index];
+        if (entry.slot == NIL || entry.generation != generation) {
+            return false;
+        }
+        unlink(index);
+        release_entry(index);
+        return true;
+    }
+
+    /// Fire every timeout due by `now`. Callbacks may add and cancel timeouts.
+    void tick(clock::time_point now = clock::now()) {
+        if (now <= origin_) {
+            return;
+        }
+        const auto target =
+            static_cast<uint64_t>(std::chrono::floor<tick_duration>(now - origin_).count());
+        while (now_tick_ < target) {
+            const uint64_t next = pending_entries_ == 0 ? NO_EXPIRY : next_event_tick();
+            if (next > target) {
+                // Nothing is placed relative to the ticks in between, so they can be skipped
+                now_tick_ = target;
+                break;
+            }
+            now_tick_ = next;
+            run_tick();
+        }
+    }
+
+    size_t pending_count() const { return pending_entries_; }
+
+    /// Time until tick() next has work to do, rounded up to whole milliseconds, or
+    /// duration::max() when nothing is pending.
+    duration time_until_next_expiration(clock::time_point now = clock::now()) const {
+        if (pending_entries_ == 0) {
+            return duration::max();
+        }
+        const uint64_t next = next_event_tick();
+        if (next == NO_EXPIRY) {
+            return duration::max();
+        }
+        const auto at = origin_ + tick_duration(static_cast<int64_t>(next));
+        if (at <= now) {
+            return duration::zero();
+        }
+        return std::chrono::ceil<duration>(at - now);
+    }
+
+private:
+    using tick_duration = std::chrono::duration<int64_t, std::ratio<TickUs, 1000000>>;
+
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+    static constexpr uint64_t NO_EXPIRY = std::numeric_limits<uint64_t>::max();
+    static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+    static constexpr size_t OVERFLOW_SLOT = Levels * SLOTS;
+    static constexpr size_t BITMAP_WORDS = (SLOTS + 63) / 64;
+    using slot_bitmap = std::array<uint64_t, BITMAP_WORDS>;
+
+    struct entry_data {
+        callback_fn callback;
+        uint64_t deadline{0}; // absolute tick
+        uint32_t prev{NIL};
+        uint32_t next{NIL};
+        uint32_t slot{NIL}; // level * SLOTS + slot, OVERFLOW_SLOT, or NIL when free
+        uint32_t generation{1};
+    };
+
+    static timeout_id make_id(uint32_t index, uint32_t generation) {
+        return (static_cast<timeout_id>(generation) << 32) | index;
+    }
+
+    static constexpr size_t shift(size_t level) { return level * LevelBits; }
+    static constexpr size_t digit(uint64_t tick, size_t level) {
+        return static_cast<size_t>((tick >> shift(level)) & SLOT_MASK);
+    }
+
+    uint64_t& occupied_word(size_t slot) { return occupied_[slot / SLOTS][slot % SLOTS / 64]; }
+    static uint64_t occupied_bit(size_t slot) { return uint64_t{1} << (slot % SLOTS % 64); }
+
+    // First set slot at or after `from`, or SLOTS
+    static size_t find_from(const slot_bitmap& bits, size_t from) {
+        size_t word = from / 64;
+        if (word >= BITMAP_WORDS) {
+            return SLOTS;
+        }
+        uint64_t w = bits[word] & (~uint64_t{0} << (from % 64));
+        while (true) {
+            if (w != 0) {
+                return word * 64 + static_cast<size_t>(std::countr_zero(w));
+            }
+            if (++word == BITMAP_WORDS) {
+                return SLOTS;
+            }
+            w = bits[word];
+        }
+    }
+
+    // Every timeout on level L shares the current tick's digits above L and has a larger
+    // digit at L, so the first occupied slot after the current one on the lowest such level
+    // is the next event: a deadline on level 0, the start of a cascade above it.
+    uint64_t next_event_tick() const {
+        for (size_t level = 0; level < Levels; ++level) {
+            const size_t slot = find_from(occupied_[level], digit(now_tick_, level) + 1);
+            if (slot != SLOTS) {
+                const uint64_t above = (now_tick_ >> shift(level + 1)) << shift(level + 1);
+                return above | (static_cast<uint64_t>(slot) << shift(level));
+            }
+        }
+        if (heads_[OVERFLOW_SLOT] != NIL) {
+            return ((now_tick_ >> shift(Levels)) + 1) << shift(Levels);
+        }
+        return NO_EXPIRY;
+    }
+
+    void place(uint32_t index) {
+        auto& entry = entries_[index];
+        size_t slot;
+        if (entry.deadline <= now_tick_) {
+            // Only a cascade lands here, for a deadline equal to the tick being run
+            slot = digit(now_tick_, 0);
+        } else {
+            // The highest digit in which the deadline differs from now picks the level
+            const auto level =
+                static_cast<size_t>(std::bit_width(entry.deadline ^ now_tick_) - 1) / LevelBits;
+            slot = level >= Levels ? OVERFLOW_SLOT : level * SLOTS + digit(entry.deadline, level);
+        }
+
+        entry.slot = static_cast<uint32_t>(slot);
+        entry.prev = NIL;
+        entry.next = heads_[slot];
+        if (entry.next != NIL) {
+            entries_[entry.next].prev = index;
+        }
+        heads_[slot] = index;
+        if (slot != OVERFLOW_SLOT) {
+            occupied_word(slot) |= occupied_bit(slot);
+        }
+    }
+
+    void unlink(uint32_t index) {
+        auto& entry = entries_[index];
+        const size_t slot = entry.slot;
+        if (entry.prev != NIL) {
+            entries_[entry.prev].next = entry.next;
+        } else {
+            heads_[slot] = entry.next;
+        }
+        if (entry.next != NIL) {
+            entries_[entry.next].prev = entry.prev;
+        }
+        if (heads_[slot] == NIL && slot != OVERFLOW_SLOT) {
+            occupied_word(slot) &= ~occupied_bit(slot);
+        }
+        entry.slot = NIL;
+    }
+
+    // No callbacks run during a cascade, so the list can be detached up front
+    void cascade(size_t slot) {
+        uint32_t index = heads_[slot];
+        heads_[slot] = NIL;
+        if (slot != OVERFLOW_SLOT) {
+            occupied_word(slot) &= ~occupied_bit(slot);
+        }
+        while (index != NIL) {
+            const uint32_t next = entries_[index].next;
+            place(index);
+            index = next;
+        }
+    }
+
+    void run_tick() {
+        if ((now_tick_ & ((uint64_t{1} << shift(Levels)) - 1)) == 0) {
+            cascade(OVERFLOW_SLOT);
+        }
+        for (size_t level = Levels - 1; level > 0; --level) {
+            if ((now_tick_ & ((uint64_t{1} << shift(level)) - 1)) == 0) {
+                cascade(level * SLOTS + digit(now_tick_, level));
+            }
+        }
+
+        // Callbacks may cancel timeouts in this slot, so take them one at a time
+        const size_t slot = digit(now_tick_, 0);
+        while (heads_[slot] != NIL) {
+            const uint32_t index = heads_[slot];
+            unlink(index);
+            auto cb = std::move(entries_[index].callback);
+            release_entry(index);
+            cb();
+        }
+    }
+
+    uint32_t acquire_entry() {
+        uint32_t index;
+        if (!free_list_.empty()) {
+            index = free_list_.back();
+            free_list_.pop_back();
+        } else {
+            if (entry_count_ == NIL || !entries_.ensure(entry_count_)) {
+                throw std::bad_alloc();
+            }
+            index = entry_count_++;
+        }
+        ++pending_entries_;
+        return index;
+    }
+
+    void release_entry(uint32_t index) {
+        auto& entry = entries_[index];
+        entry.callback = callback_fn{};
+        if (++entry.generation == 0) {
+            ++entry.generation;
+        }
+        free_list_.push_back(index);
+        --pending_entries_;
+    }
+
+    clock::time_point origin_;
+    uint64_t now_tick_{0};
+    size_t pending_entries_{0};
+    // Paged, so adding timeouts never moves the pending ones
+    paged_table<entry_data> entries_;
+    uint32_t entry_count_{0}; // entries ever used; released ones wait on free_list_
+    std::vector<uint32_t> free_list_;
+    std::array<uint32_t, Levels * SLOTS + 1> heads_; // the last list is the overflow
+    std::array<slot_bitmap, Levels> occupied_{};
+};
+
+} // namespace katana
@@ -5,6 +5,7 @@
 #include "problem.hpp"
 #include "result.hpp"
 
+#include <functional>
 #include <optional>
 #include <span>
 #include <string>
@@ -39,12 +40,19 @@ struct request {
     }
 };
 
+/// Producer of a streamed response body. Each call appends the next part of the body to `out`
+/// and returns false once the body is complete.
+using body_stream = std::function<bool(std::string& out)>;
+
 struct response {
     int32_t status = 200;
     std::string reason;
     headers_map headers;
     std::string body;
     bool chunked = false;
+    // When set, the body is pulled from the stream part by part and sent chunked; `body` is
+    // ignored. The stream is consumed by the first serialization.
+    body_stream stream;
 
     response() : headers(nullptr) {}
     response(response&&) noexcept = default;
@@ -98,9 +106,14 @@ struct response {
     void serialize_into(std::string& out) const;
     [[nodiscard]] std::string serialize() const;
     [[nodiscard]] std::string serialize_chunked(size_t chunk_size = 4096) const;
+    /// Status line and headers of a chunked response, without any body chunks
+    void serialize_chunked_head_into(std::string& out) const;
 
     static response ok(std::string body = "", std::string content_type = "text/plain");
     static response json(std::string body);
+    /// 200 application/json response whose body is produced incrementally (see
+    /// serde::json_array_stream), so large collections never sit in memory as one string
+    static response json_stream(body_stream stream);
     static response error(const problem_details& problem);
 };
 
@@ -164,6 +177,11 @@ private:
 method parse_method(std::string_view str);
 std::string_view method_to_string(method m);
 
+/// Pull the next part of `stream` and append it to `out` as one chunk of a chunked body; after
+/// the last part the terminating zero-size chunk follows. Returns false once the body is
+/// complete.
+bool append_stream_chunk(const body_stream& stream, std::string& out);
+
 inline std::span<const uint8_t> as_bytes(std::string_view sv) noexcept {
     return std::span<const uint8_t>(
         static_cast<const uint8_t*>(static_cast<const void*>(sv.data())), sv.size());
@@ -218,8 +218,23 @@ public:
         unknown_entries_.reserve(UNKNOWN_HEADERS_INLINE_SIZE);
     }
 
-    headers_map(headers_map&&) noexcept = default;
-    headers_map& operator=(headers_map&&) noexcept = default;
+    // fallback_arena_ points into this object, so it must be re-targeted on move
+    headers_map(headers_map&& other) noexcept
+        : arena_(other.arena_), fallback_arena_(other.arena_ ? nullptr : &owned_arena_),
+          owned_arena_(std::move(other.owned_arena_)), known_entries_(other.known_entries_),
+          known_size_(other.known_size_), unknown_entries_(std::move(other.unknown_entries_)) {}
+
+    headers_map& operator=(headers_map&& other) noexcept {
+        if (this != &other) {
+            arena_ = other.arena_;
+            owned_arena_ = std::move(other.owned_arena_);
+            fallback_arena_ = arena_ ? nullptr : &owned_arena_;
+            known_entries_ = other.known_entries_;
+            known_size_ = other.known_size_;
+            unknown_entries_ = std::move(other.unknown_entries_);
+        }
+        return *this;
+    }
 
     headers_map(const headers_map&) = delete;
     headers_map& operator=(const headers_map&) = delete;
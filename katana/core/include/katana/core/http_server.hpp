@@ -1,26 +1,60 @@
 #pragma once
 
+#include "katana/core/admission_control.hpp"
+#include "katana/core/alloc_tracking.hpp"
 #include "katana/core/arena.hpp"
 #include "katana/core/fd_watch.hpp"
 #include "katana/core/http.hpp"
 #include "katana/core/io_buffer.hpp"
+#include "katana/core/memory_pool.hpp"
+#include "katana/core/offload_pool.hpp"
 #include "katana/core/reactor_pool.hpp"
 #include "katana/core/router.hpp"
 #include "katana/core/shutdown.hpp"
 #include "katana/core/tcp_listener.hpp"
 #include "katana/core/tcp_socket.hpp"
 
+#include <atomic>
 #include <cerrno>
 #include <chrono>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <optional>
 #include <string>
+#include <sys/socket.h>
 #include <vector>
 
 namespace katana {
 namespace http {
 
+/// Request arena usage summed over all reactors. A request is counted when its connection's
+/// arena is reset for the next one.
+struct arena_snapshot {
+    uint64_t requests = 0;
+    uint64_t block_acquisitions = 0; // arena blocks taken while serving those requests
+    size_t peak_request_bytes = 0;   // most arena bytes a single request used
+};
+
+/// Allocations made while serving one route, summed over all reactors and split by request
+/// phase. Only KATANA_ALLOC_TRACKING builds count them; like arena_snapshot, a request is
+/// counted when its connection is reset for the next one.
+struct route_alloc_snapshot {
+    std::string route; // "GET /users/{id}", or "unmatched" for requests no route took
+    uint64_t requests = 0;
+    alloc_phase_counters phases{};
+
+    [[nodiscard]] alloc_counters total() const noexcept {
+        alloc_counters sum;
+        for (const auto& counters : phases) {
+            sum += counters;
+        }
+        return sum;
+    }
+};
+
 /// High-level HTTP server abstraction
 ///
 /// Encapsulates reactor pool, listener, connection handling, and lifecycle management.
@@ -69,6 +103,12 @@ public:
         return *this;
     }
 
+    /// Pin each reactor thread to its own core (off by default)
+    server& pin_threads(bool enable = true) {
+        pin_threads_ = enable;
+        return *this;
+    }
+
     /// Set graceful shutdown timeout
     server& graceful_shutdown(std::chrono::milliseconds timeout) {
         shutdown_timeout_ = timeout;
@@ -93,28 +133,137 @@ public:
         return *this;
     }
 
+    /// Enable per-reactor admission control (load shedding). Shed requests get a
+    /// pre-serialized 503 with Retry-After and are not reported to on_request.
+    server& admission(const admission_config& config) {
+        admission_config_ = config;
+        return *this;
+    }
+
+    /// Admission counters summed over all reactors (empty until run() starts)
+    [[nodiscard]] admission_snapshot admission_metrics() const;
+
+    /// Run routes marked `offload` on a bounded worker pool instead of the reactor thread.
+    /// The connection is parked until the worker finishes and the response is written back
+    /// on the connection's own reactor. A full queue answers 503. Without this, offload
+    /// routes run inline.
+    server& offload(const offload_pool_config& config) {
+        offload_config_ = config;
+        return *this;
+    }
+
+    /// Offload pool counters (empty until run() starts)
+    [[nodiscard]] offload_snapshot offload_metrics() const;
+
+    /// Request arena counters (empty until run() starts)
+    [[nodiscard]] arena_snapshot arena_metrics() const;
+
+    /// Allocation counters per route, sorted by route (empty unless built with
+    /// KATANA_ALLOC_TRACKING). Handlers run on the offload pool are counted too.
+    [[nodiscard]] std::vector<route_alloc_snapshot> alloc_metrics() const;
+
+    /// Give each reactor its own memory pool for I/O buffers, request arenas and connection
+    /// state, backed by huge pages. `numa_local` binds a pool to the node its reactor starts
+    /// on; combine it with pin_threads() so the reactor stays on that node.
+    server& memory(const memory_pool_config& config) {
+        memory_config_ = config;
+        return *this;
+    }
+
     /// Run the server (blocking)
     /// Returns 0 on success, non-zero on error
     int run();
 
 private:
-    struct connection_state {
+    // Written only by the owning reactor, read by arena_metrics()
+    struct arena_usage {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> block_acquisitions{0};
+        std::atomic<size_t> peak_request_bytes{0};
+    };
+
+    // Per-route allocation counters of one reactor, written by it under the mutex
+    struct alloc_usage {
+        struct route_counters {
+            const route_entry* route; // nullptr for unmatched requests
+            uint64_t requests;
+            alloc_phase_counters phases;
+        };
+
+        mutable std::mutex mutex;
+        std::vector<route_counters> routes;
+    };
+
+    // State of one reactor, set up by run() in pool order before any connection is accepted
+    struct reactor_slot {
+        const reactor* owner = nullptr;
+        size_t index = 0;                                // position in the reactor pool
+        std::unique_ptr<admission_controller> admission; // null without admission control
+        std::unique_ptr<arena_usage> arena;
+        std::unique_ptr<alloc_usage> allocs;
+    };
+
+    // Shared: an offloaded request keeps its connection alive until the worker hands back
+    struct connection_state : std::enable_shared_from_this<connection_state> {
         tcp_socket socket;
         io_buffer read_buffer;
         io_buffer write_buffer;
         monotonic_arena arena;
         parser http_parser;
         std::unique_ptr<fd_watch> watch;
+        char peer_address[INET6_ADDRSTRLEN]{};
+        size_t peer_address_len = 0;
+        admission_controller* admission = nullptr;
+        size_t reactor_index = 0;
+        arena_usage* usage = nullptr;
+        uint64_t arena_blocks_recorded = 0;
+        alloc_usage* allocs = nullptr;
+        // Allocations of the request being served and the route it matched
+        alloc_phase_counters request_allocs{};
+        const route_entry* matched_route = nullptr;
+        bool close_after_write = false;
+
+        // Body of a streamed response still being produced; refilled as write_buffer drains
+        body_stream stream;
+        std::string stream_chunk;
+
+        // Set while the current request runs on the offload pool
+        bool offloaded = false;
+        bool offload_admitted = false;
+        // The connection closed while parked; the worker skips the handler if it has not run yet
+        std::atomic<bool> offload_cancelled{false};
+        std::optional<request_context> offload_ctx;
+        std::optional<response> offload_response;
 
         explicit connection_state(tcp_socket sock)
             : socket(std::move(sock)), read_buffer(8192), write_buffer(8192), arena(8192),
               http_parser(&arena) {}
+
+        void set_peer_address(const sockaddr_storage& addr) noexcept;
     };
 
-    void handle_connection(connection_state& state, reactor& r);
+    // `ready_at`: when the data this call handles became ready, the base for admission delay
+    void on_connection_event(connection_state& state, reactor& r, event_type events);
+    void handle_connection(connection_state& state,
+                           reactor& r,
+                           std::chrono::steady_clock::time_point ready_at);
+    bool queue_response(connection_state& state, response& resp);
+    bool refill_stream(connection_state& state);
+    // Point `state` at the slot of the reactor it was accepted on; false for a reactor run()
+    // did not set up
+    bool bind_reactor(connection_state& state, const reactor& r) noexcept;
+    void reset_request_arena(connection_state& state);
+    void record_request_allocs(connection_state& state);
+    bool start_offload(connection_state& state,
+                       reactor& r,
+                       const route_entry& route,
+                       const request_context& ctx,
+                       bool admitted);
+    void finish_offload(connection_state& state, reactor& r);
+    void abandon_offload(connection_state& state);
     void accept_connection(reactor& r,
                            tcp_listener& listener,
-                           std::vector<std::unique_ptr<connection_state>>& connections);
+                           std::vector<std::shared_ptr<connection_state>>& connections);
 
     const router& router_;
     std::string host_ = "0.0.0.0";
@@ -122,10 +271,16 @@ private:
     size_t worker_count_ = 1;
     int32_t backlog_ = 1024;
     bool reuseport_ = true;
+    bool pin_threads_ = false;
     std::chrono::milliseconds shutdown_timeout_{5000};
     std::function<void()> on_start_callback_;
     std::function<void()> on_stop_callback_;
     std::function<void(const request&, const response&)> on_request_callback_;
+    std::optional<admission_config> admission_config_;
+    std::vector<reactor_slot> reactors_;
+    std::optional<offload_pool_config> offload_config_;
+    std::unique_ptr<offload_pool> offload_pool_;
+    std::optional<memory_pool_config> memory_config_;
 };
 
 } // namespace http
@@ -7,18 +7,47 @@
 
 namespace katana {
 
+namespace detail {
+
+// Instantiated only when a callable does not fit, so the compiler prints both numbers: look
+// for `inline_capacity_exceeded<callable size, capacity>` in the error
+template <size_t Size, size_t Capacity> struct inline_capacity_exceeded {
+    static_assert(Size <= Capacity,
+                  "callable is larger than the inline capacity; raise the capacity or capture "
+                  "less (see the template arguments above for both sizes)");
+    static constexpr bool value = true;
+};
+
+template <typename F, size_t Capacity> constexpr bool check_inline_capacity() {
+    if constexpr (sizeof(F) > Capacity) {
+        return inline_capacity_exceeded<sizeof(F), Capacity>::value;
+    }
+    return true;
+}
+
+} // namespace detail
+
 template <typename Signature, size_t Capacity = 64> class inplace_function;
 
+/// Copyable type-erased callable stored entirely inline. Callables larger than `Capacity` are a
+/// compile error naming both sizes; use small_function when a move-only callable or an
+/// out-of-line fallback is acceptable.
 template <typename R, typename... Args, size_t Capacity>
 class inplace_function<R(Args...), Capacity> {
 public:
+    static constexpr size_t capacity = Capacity;
+
+    /// Whether `F` can be stored; usable in static_asserts at the point where a callback is built
+    template <typename F>
+    static constexpr bool fits = sizeof(std::decay_t<F>) <= Capacity &&
+                                 alignof(std::decay_t<F>) <= alignof(std::max_align_t);
+
     inplace_function() noexcept : vtable_(nullptr) {}
 
     template <typename F,
               typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, inplace_function>>>
     inplace_function(F&& f) {
-        static_assert(sizeof(std::decay_t<F>) <= Capacity,
-                      "Callable too large for inplace storage");
+        static_assert(detail::check_inline_capacity<std::decay_t<F>, Capacity>());
         static_assert(alignof(std::decay_t<F>) <= alignof(std::max_align_t),
                       "Callable alignment too strict");
         static_assert(std::is_invocable_r_v<R, F, Args...>, "Callable not compatible");
@@ -49,8 +49,10 @@ private:
     void compact_if_needed();
 
 public:
+    // Storage comes from memory_pool::allocate(), which needs the size back
     struct aligned_delete {
-        void operator()(uint8_t* p) const noexcept { ::operator delete[](p, std::align_val_t(64)); }
+        size_t size; // value-initialized to 0 by unique_ptr
+        void operator()(uint8_t* p) const noexcept;
     };
 
 private:
@@ -1,25 +1,28 @@
 #pragma once
 
 #include "fd_event.hpp"
+#include "hierarchical_timer.hpp"
 #include "inplace_function.hpp"
 #include "metrics.hpp"
+#include "paged_table.hpp"
 #include "result.hpp"
 #include "ring_buffer_queue.hpp"
+#include "small_function.hpp"
 #include "timeout.hpp"
-#include "wheel_timer.hpp"
 
 #include <atomic>
 #include <chrono>
 #include <exception>
 #include <liburing.h>
-#include <queue>
+#include <span>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace katana {
 
-using task_fn = inplace_function<void(), 128>;
+// Move-only; captures beyond 128 bytes go to the reactor's memory_pool
+using task_fn = small_function<void(), 128>;
 
 struct exception_context {
     std::string_view location;
@@ -68,6 +71,11 @@ public:
 
     bool schedule(task_fn task);
 
+    /// Queue several tasks with a single wakeup. Tasks are taken from the front of `tasks`
+    /// (moved from) until the queue is full; returns how many were taken, the rest are left
+    /// untouched for the caller to retry or drop.
+    size_t schedule_batch(std::span<task_fn> tasks);
+
     bool schedule_after(std::chrono::milliseconds delay, task_fn task);
 
     void set_exception_handler(exception_handler handler);
@@ -76,8 +84,19 @@ public:
 
     [[nodiscard]] uint64_t get_load_score() const noexcept;
 
+    /// Time the current batch of I/O events was returned by the kernel. Callbacks compare it
+    /// with now() to see how long their event waited behind the rest of the batch.
+    [[nodiscard]] std::chrono::steady_clock::time_point poll_time() const noexcept {
+        return poll_time_;
+    }
+
 private:
-    using fd_wheel_timer = wheel_timer<2048, 8>;
+    // fd timeouts and schedule_after() tasks share one wheel; its callbacks have room for a
+    // task_fn plus the reactor pointer
+    using reactor_timer = hierarchical_timer<8, 4, 1000, sizeof(task_fn) + alignof(task_fn)>;
+
+    // Tasks taken off the queue per pop_batch() in process_tasks()
+    static constexpr size_t TASK_BATCH_SIZE = 64;
 
     enum class op_type : uint8_t {
         poll_add,
@@ -89,14 +108,11 @@ private:
         // Hot data - frequently accessed
         event_callback callback;
         event_type events;
-        fd_wheel_timer::timeout_id timeout_id = 0;
+        reactor_timer::timeout_id timeout_id = 0;
         bool has_timeout = false;
         bool registered = false;
 
         // Cold data - rarely accessed
-        char padding1[64 - sizeof(event_callback) - sizeof(event_type) -
-                      sizeof(fd_wheel_timer::timeout_id) - sizeof(bool) * 2];
-
         timeout_config timeouts;
         Timeout activity_timer;
     };
@@ -104,16 +120,14 @@ private:
     struct timer_entry {
         std::chrono::steady_clock::time_point deadline;
         task_fn task;
-
-        bool operator>(const timer_entry& other) const { return deadline > other.deadline; }
     };
 
     result<void> submit_poll_add(int32_t fd, event_type events);
     result<void> submit_poll_remove(int32_t fd);
     result<void> process_completions(int32_t timeout_ms);
     void process_tasks();
+    void wake_if_sleeping(std::string_view location);
     void process_timers();
-    void process_wheel_timer();
     int32_t calculate_timeout() const;
     void
     handle_exception(std::string_view location, std::exception_ptr ex, int32_t fd = -1) noexcept;
@@ -121,6 +135,11 @@ private:
     void cancel_fd_timeout(fd_state& state);
     std::chrono::milliseconds fd_timeout_for(const fd_state& state) const;
     result<void> ensure_fd_capacity(int32_t fd);
+
+    // Slot of `fd`, or nullptr when no fd on its page was ever registered
+    fd_state* find_fd_state(int32_t fd) noexcept {
+        return fd < 0 ? nullptr : fd_states_.find(static_cast<size_t>(fd));
+    }
     std::chrono::milliseconds
     time_until_graceful_deadline(std::chrono::steady_clock::time_point now) const;
 
@@ -129,19 +148,22 @@ private:
     std::atomic<bool> running_;
     std::atomic<bool> graceful_shutdown_;
     std::chrono::steady_clock::time_point graceful_shutdown_deadline_;
+    std::chrono::steady_clock::time_point poll_time_{};
 
-    std::vector<fd_state> fd_states_;
+    // Paged by fd: sparse fds cost only their pages, and growth never moves a live fd_state
+    paged_table<fd_state> fd_states_;
     ring_buffer_queue<task_fn> pending_tasks_;
-    std::priority_queue<timer_entry, std::vector<timer_entry>, std::greater<timer_entry>> timers_;
     ring_buffer_queue<timer_entry> pending_timers_;
 
     alignas(64) std::atomic<size_t> active_fds_{0};
     alignas(64) std::atomic<bool> needs_wakeup_{false};
+    // Set while the loop may block in the kernel; producers skip the eventfd write otherwise
+    alignas(64) std::atomic<bool> sleeping_{false};
     alignas(64) std::atomic<uint32_t> pending_count_{0};
     exception_handler exception_handler_;
     reactor_metrics metrics_;
 
-    fd_wheel_timer wheel_timer_;
+    reactor_timer timers_;
 
     mutable int32_t cached_timeout_ = -1;
     mutable std::chrono::steady_clock::time_point timeout_cached_at_;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace katana::serde {
+
+/// Stage-1 structural index of a JSON document, in the spirit of simdjson.
+///
+/// build() classifies the input 64 bytes at a time (AVX2 or SSE2 when available) into quote,
+/// backslash and structural bitmasks, resolves escapes and string interiors with bit tricks,
+/// and records the offset of every structural character ({ } [ ] : ,) and every unescaped
+/// quote. Each opening bracket also stores the entry index of its matching closer, so a
+/// cursor can step over a whole subtree in O(1).
+///
+/// Storage grows with the number of entries and is reused across build() calls; keep one
+/// index per thread to avoid steady-state allocations.
+class json_structural_index {
+public:
+    /// Index `json`. Returns false (and leaves the index empty) for unterminated strings,
+    /// unbalanced brackets or inputs over 4 GiB; callers then fall back to scalar parsing.
+    bool build(std::string_view json);
+
+    void clear() noexcept;
+
+    /// Free the entry storage if it has grown past `max_entries`, so one unusually large
+    /// document does not keep its index alive for the rest of the thread.
+    void shrink(size_t max_entries) noexcept;
+
+    [[nodiscard]] bool valid() const noexcept { return valid_; }
+    [[nodiscard]] const char* base() const noexcept { return base_; }
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    /// Entries the current storage holds without growing.
+    [[nodiscard]] size_t capacity() const noexcept { return positions_.size(); }
+
+    /// Whether [first, last) lies inside the indexed document.
+    [[nodiscard]] bool covers(const char* first, const char* last) const noexcept {
+        return valid_ && first >= base_ && last <= base_ + length_;
+    }
+
+    [[nodiscard]] uint32_t position(size_t entry) const noexcept { return positions_[entry]; }
+    /// Entry of the bracket closing `entry`; only meaningful when `entry` is '{' or '['.
+    [[nodiscard]] uint32_t match(size_t entry) const noexcept { return matches_[entry]; }
+
+    /// First entry whose offset is >= `offset`; size() when there is none. `hint` is the
+    /// caller's previous answer and makes forward scans amortised O(1).
+    [[nodiscard]] size_t seek(uint32_t offset, size_t hint) const noexcept;
+
+private:
+    void grow(size_t entries);
+
+    std::vector<uint32_t> positions_;
+    std::vector<uint32_t> matches_;
+    std::vector<uint32_t> stack_;
+    size_t count_ = 0; // positions_/matches_ are not cleared, so a reused index never refills them
+    const char* base_ = nullptr;
+    size_t length_ = 0;
+    bool valid_ = false;
+};
+
+/// Inputs shorter than this are parsed without an index. For a parser that visits every key,
+/// building the index costs about what it saves below this size (see json_benchmark); it
+/// pays off sooner when large subtrees get skipped.
+inline constexpr size_t json_index_min_size = 16 * 1024;
+
+/// Entries a thread's index keeps between documents (1 MiB of positions and matches). Storage
+/// grown past this for a larger document is freed when its outermost indexed_json_scope ends.
+inline constexpr size_t json_index_retained_entries = 128 * 1024;
+
+namespace detail {
+
+struct thread_json_index {
+    json_structural_index index;
+    bool active = false; // owned by an indexed_json_scope further up the stack
+};
+
+thread_json_index& thread_json_index_slot() noexcept;
+
+} // namespace detail
+
+} // namespace katana::serde
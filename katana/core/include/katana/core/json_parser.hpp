@@ -84,7 +84,7 @@ std::optional<validation_error> parse_string_field(serde::json_cursor& cur,
                                                    T& obj,
                                                    monotonic_arena* arena,
                                                    const field_descriptor<T>& desc) {
-    auto v = cur.string();
+    auto v = cur.unescaped_string(*arena);
     if (!v) {
         return validation_error{desc.json_name, validation_error_code::invalid_type};
     }
@@ -113,11 +113,11 @@ std::optional<validation_error> parse_integer_field(serde::json_cursor& cur,
                                                     T& obj,
                                                     monotonic_arena*,
                                                     const field_descriptor<T>& desc) {
-    auto v = katana::serde::parse_size(cur);
+    auto v = katana::serde::parse_int64(cur);
     if (!v) {
         return validation_error{desc.json_name, validation_error_code::invalid_type};
     }
-    int64_t value = static_cast<int64_t>(*v);
+    int64_t value = *v;
     const double dv = static_cast<double>(value);
     if (desc.num.exclusive_minimum) {
         if (dv <= desc.num.minimum) {
@@ -238,7 +238,7 @@ std::optional<validation_error> parse_string_array(serde::json_cursor& cur,
     auto& target = offset_ref<Vector>(&obj, desc.offset);
     auto parse_elem = [&](std::string_view sv) -> std::optional<validation_error> {
         serde::json_cursor item_cur{sv.data(), sv.data() + sv.size()};
-        auto val = item_cur.string();
+        auto val = item_cur.unescaped_string(*arena);
         if (!val) {
             return validation_error{desc.json_name, validation_error_code::invalid_type};
         }
@@ -261,7 +261,7 @@ std::optional<validation_error> parse_integer_array(serde::json_cursor& cur,
     auto& target = offset_ref<Vector>(&obj, desc.offset);
     auto parse_elem = [&](std::string_view sv) -> std::optional<validation_error> {
         serde::json_cursor item_cur{sv.data(), sv.data() + sv.size()};
-        auto val = katana::serde::parse_size(item_cur);
+        auto val = katana::serde::parse_int64(item_cur);
         if (!val) {
             return validation_error{desc.json_name, validation_error_code::invalid_type};
         }
@@ -429,13 +429,39 @@ inline field_descriptor<T> boolean_array_field(std::string_view name,
                                &parse_bool_array<T, Vector>};
 }
 
-// Main object parser
-template <typename T, size_t N>
-std::optional<validation_error> parse_object(std::string_view json,
-                                             const std::array<field_descriptor<T>, N>& fields,
-                                             T& out,
-                                             monotonic_arena* arena,
-                                             std::array<bool, N>& seen) {
+// Field set plus a perfect hash over its JSON names, so parse_object finds each key with one
+// hash and one compare instead of comparing against every field. Build it once, next to the
+// descriptor array: descriptors are not constant expressions, so unlike generated parsers the
+// table cannot be computed at compile time.
+template <typename T, size_t N> struct object_descriptor {
+    std::array<field_descriptor<T>, N> fields;
+    serde::key_table<N> keys;
+
+    explicit object_descriptor(const std::array<field_descriptor<T>, N>& f)
+        : fields(f), keys(json_names(f)) {}
+
+private:
+    static std::array<std::string_view, N>
+    json_names(const std::array<field_descriptor<T>, N>& f) noexcept {
+        std::array<std::string_view, N> names{};
+        for (size_t i = 0; i < N; ++i) {
+            names[i] = f[i].json_name;
+        }
+        return names;
+    }
+};
+
+namespace detail {
+
+// `find_field(key)` returns the index into `fields`, or N for unknown keys
+template <typename T, size_t N, typename FindField>
+std::optional<validation_error>
+parse_object_fields(std::string_view json,
+                    const std::array<field_descriptor<T>, N>& fields,
+                    FindField&& find_field,
+                    T& out,
+                    monotonic_arena* arena,
+                    std::array<bool, N>& seen) {
     serde::json_cursor cur{json.data(), json.data() + json.size()};
     if (!cur.try_object_start()) {
         return validation_error{"", validation_error_code::invalid_type};
@@ -451,19 +477,14 @@ std::optional<validation_error> parse_object(std::string_view json,
             return validation_error{"", validation_error_code::invalid_type};
         }
 
-        bool matched = false;
-        for (size_t i = 0; i < N; ++i) {
+        const size_t i = find_field(*key);
+        if (i < N) {
             const auto& desc = fields[i];
-            if (*key == desc.json_name) {
-                matched = true;
-                seen[i] = true;
-                if (auto err = desc.parse(cur, out, arena, desc)) {
-                    return err;
-                }
-                break;
+            seen[i] = true;
+            if (auto err = desc.parse(cur, out, arena, desc)) {
+                return err;
             }
-        }
-        if (!matched) {
+        } else {
             cur.skip_value();
         }
         cur.try_comma();
@@ -478,11 +499,42 @@ std::optional<validation_error> parse_object(std::string_view json,
     return std::nullopt;
 }
 
+} // namespace detail
+
+// Main object parser
 template <typename T, size_t N>
-std::optional<T> parse_object(std::string_view json,
-                              const std::array<field_descriptor<T>, N>& fields,
-                              monotonic_arena* arena,
-                              validation_error* error_out = nullptr) {
+std::optional<validation_error> parse_object(std::string_view json,
+                                             const std::array<field_descriptor<T>, N>& fields,
+                                             T& out,
+                                             monotonic_arena* arena,
+                                             std::array<bool, N>& seen) {
+    auto find_field = [&](std::string_view key) {
+        size_t i = 0;
+        while (i < N && fields[i].json_name != key) {
+            ++i;
+        }
+        return i;
+    };
+    return detail::parse_object_fields(json, fields, find_field, out, arena, seen);
+}
+
+template <typename T, size_t N>
+std::optional<validation_error> parse_object(std::string_view json,
+                                             const object_descriptor<T, N>& desc,
+                                             T& out,
+                                             monotonic_arena* arena,
+                                             std::array<bool, N>& seen) {
+    auto find_field = [&](std::string_view key) { return desc.keys.find(key); };
+    return detail::parse_object_fields(json, desc.fields, find_field, out, arena, seen);
+}
+
+namespace detail {
+
+template <typename T, size_t N, typename Fields>
+std::optional<T> parse_new_object(std::string_view json,
+                                  const Fields& fields,
+                                  monotonic_arena* arena,
+                                  validation_error* error_out) {
     std::array<bool, N> seen{};
     T obj(arena);
     if (auto err = parse_object(json, fields, obj, arena, seen)) {
@@ -494,4 +546,22 @@ std::optional<T> parse_object(std::string_view json,
     return obj;
 }
 
+} // namespace detail
+
+template <typename T, size_t N>
+std::optional<T> parse_object(std::string_view json,
+                              const std::array<field_descriptor<T>, N>& fields,
+                              monotonic_arena* arena,
+                              validation_error* error_out = nullptr) {
+    return detail::parse_new_object<T, N>(json, fields, arena, error_out);
+}
+
+template <typename T, size_t N>
+std::optional<T> parse_object(std::string_view json,
+                              const object_descriptor<T, N>& desc,
+                              monotonic_arena* arena,
+                              validation_error* error_out = nullptr) {
+    return detail::parse_new_object<T, N>(json, desc, arena, error_out);
+}
+
 } // namespace katana::json
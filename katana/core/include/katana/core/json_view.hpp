@@ -0,0 +1,219 @@
+#pragma once
+
+#include "arena.hpp"
+#include "serde.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace katana::serde {
+
+enum class json_type : uint8_t { invalid, object, array, string, number, boolean, null };
+
+/// Lazy, non-owning view of one JSON value inside a document.
+///
+/// Nothing is parsed up front: operator[] walks the object or array it is applied to, skipping
+/// the values it passes over without allocating, and the as_* accessors parse only the value
+/// they are called on. A missing key, an out-of-range index or a value of the wrong type gives
+/// an invalid view or nullopt, so lookups chain without checks in between:
+///
+/// @code
+///   json_view doc(req.body);
+///   auto id = doc["user"]["id"].as_int64(); // std::optional<int64_t>
+/// @endcode
+///
+/// Only the parts of the document that are walked are checked for well-formedness. Keys are
+/// compared as written, without decoding escapes. The view refers to the document text, which
+/// must outlive it.
+class json_view {
+public:
+    json_view() noexcept = default;
+    explicit json_view(std::string_view json) noexcept
+        : json_view(json.data(), json.data() + json.size()) {}
+
+    [[nodiscard]] bool valid() const noexcept { return pos_ != nullptr; }
+    explicit operator bool() const noexcept { return valid(); }
+
+    [[nodiscard]] json_type type() const noexcept {
+        if (!pos_) {
+            return json_type::invalid;
+        }
+        switch (*pos_) {
+        case '{':
+            return json_type::object;
+        case '[':
+            return json_type::array;
+        case '\"':
+            return json_type::string;
+        case 't':
+        case 'f':
+            return json_type::boolean;
+        case 'n':
+            return json_type::null;
+        default:
+            return json_type::number;
+        }
+    }
+    [[nodiscard]] bool is_object() const noexcept { return type() == json_type::object; }
+    [[nodiscard]] bool is_array() const noexcept { return type() == json_type::array; }
+    [[nodiscard]] bool is_null() const noexcept { return type() == json_type::null; }
+
+    /// Member `key` of an object; invalid when this is not an object or has no such member.
+    [[nodiscard]] json_view operator[](std::string_view key) const noexcept {
+        json_view found;
+        for_each_member([&](std::string_view k, json_view value) {
+            if (k != key) {
+                return true;
+            }
+            found = value;
+            return false;
+        });
+        return found;
+    }
+
+    /// Element `index` of an array; invalid when this is not an array or is too short.
+    [[nodiscard]] json_view operator[](size_t index) const noexcept {
+        json_view found;
+        for_each_element([&](json_view value) {
+            if (index-- != 0) {
+                return true;
+            }
+            found = value;
+            return false;
+        });
+        return found;
+    }
+
+    /// Call `fn(key, value)` for each member until it returns false. Returns false when this
+    /// is not an object or the walk hits malformed JSON.
+    template <typename Fn> bool for_each_member(Fn&& fn) const noexcept {
+        if (type() != json_type::object) {
+            return false;
+        }
+        json_cursor cur{pos_ + 1, end_};
+        if (cur.try_object_end()) {
+            return true;
+        }
+        while (true) {
+            auto key = cur.string();
+            if (!key || !cur.consume(':')) {
+                return false;
+            }
+            cur.skip_ws();
+            const json_view value(cur.ptr, end_);
+            if (!fn(*key, value)) {
+                return true;
+            }
+            if (!skip(cur)) {
+                return false;
+            }
+            if (cur.try_object_end()) {
+                return true;
+            }
+            if (!cur.try_comma()) {
+                return false;
+            }
+        }
+    }
+
+    /// Call `fn(value)` for each element until it returns false. Returns false when this is
+    /// not an array or the walk hits malformed JSON.
+    template <typename Fn> bool for_each_element(Fn&& fn) const noexcept {
+        if (type() != json_type::array) {
+            return false;
+        }
+        json_cursor cur{pos_ + 1, end_};
+        if (cur.try_array_end()) {
+            return true;
+        }
+        while (true) {
+            cur.skip_ws();
+            const json_view value(cur.ptr, end_);
+            if (!fn(value)) {
+                return true;
+            }
+            if (!skip(cur)) {
+                return false;
+            }
+            if (cur.try_array_end()) {
+                return true;
+            }
+            if (!cur.try_comma()) {
+                return false;
+            }
+        }
+    }
+
+    [[nodiscard]] std::optional<int64_t> as_int64() const noexcept {
+        if (type() != json_type::number) {
+            return std::nullopt;
+        }
+        auto cur = cursor();
+        return parse_int64(cur);
+    }
+
+    [[nodiscard]] std::optional<double> as_double() const noexcept {
+        if (type() != json_type::number) {
+            return std::nullopt;
+        }
+        auto cur = cursor();
+        return parse_double(cur);
+    }
+
+    [[nodiscard]] std::optional<bool> as_bool() const noexcept {
+        if (type() != json_type::boolean) {
+            return std::nullopt;
+        }
+        auto cur = cursor();
+        return parse_bool(cur);
+    }
+
+    /// String value with escapes decoded. Without escapes it points into the document;
+    /// otherwise the decoded text is allocated from `arena` and lives as long as it does.
+    [[nodiscard]] std::optional<std::string_view> as_string(monotonic_arena& arena) const {
+        if (type() != json_type::string) {
+            return std::nullopt;
+        }
+        auto cur = cursor();
+        return cur.unescaped_string(arena);
+    }
+
+    /// Text of the value as it appears in the document; empty for an invalid view.
+    [[nodiscard]] std::string_view raw() const noexcept {
+        if (!pos_) {
+            return {};
+        }
+        auto cur = cursor();
+        cur.skip_value();
+        const char* last = cur.ptr;
+        while (last > pos_ && is_json_ws(last[-1])) {
+            --last;
+        }
+        return std::string_view(pos_, static_cast<size_t>(last - pos_));
+    }
+
+private:
+    json_view(const char* pos, const char* end) noexcept : end_(end) {
+        while (pos < end && is_json_ws(*pos)) {
+            ++pos;
+        }
+        if (pos < end) {
+            pos_ = pos;
+        }
+    }
+
+    json_cursor cursor() const noexcept { return json_cursor{pos_, end_}; }
+
+    // skip_value() stops at the end of the text on unterminated input instead of failing
+    static bool skip(json_cursor& cur) noexcept {
+        const char* before = cur.ptr;
+        cur.skip_value();
+        return cur.ptr != before && !cur.eof();
+    }
+
+    const char* pos_ = nullptr;
+    const char* end_ = nullptr;
+};
+
+} // namespace katana::serde
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "arena.hpp"
+#include "io_buffer.hpp"
+#include "serde.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace katana::serde {
+
+/// Longest text std::to_chars produces for an int64_t ("-9223372036854775808").
+inline constexpr size_t json_int_max_size = 20;
+/// Longest shortest-round-trip text for a double ("-1.7976931348623157e+308").
+inline constexpr size_t json_double_max_size = 24;
+
+/// Bytes a JSON string literal of `raw` input bytes can take, quotes included.
+constexpr size_t json_string_size_bound(size_t raw) noexcept {
+    return raw * json_escape_max_expansion + 2;
+}
+
+/// Unchecked JSON output cursor for generated serializers.
+///
+/// The caller sizes the destination up front (generated json_size_bound_* functions return
+/// an upper bound), so every write is a plain store or memcpy with no capacity check.
+struct json_out {
+    char* pos;
+
+    void raw(std::string_view s) noexcept {
+        std::memcpy(pos, s.data(), s.size());
+        pos += s.size();
+    }
+    void put(char c) noexcept { *pos++ = c; }
+
+    void string(std::string_view s) noexcept {
+        *pos++ = '"';
+        pos = escape_json_into(s, pos);
+        *pos++ = '"';
+    }
+
+    template <std::integral T>
+        requires(!std::same_as<T, bool> && sizeof(T) <= sizeof(int64_t))
+    void integer(T value) noexcept {
+        pos = std::to_chars(pos, pos + json_int_max_size, value).ptr;
+    }
+
+    // JSON has no NaN or infinity; write null rather than an unparseable token
+    void number(double value) noexcept {
+        if (!std::isfinite(value)) {
+            null();
+            return;
+        }
+        pos = std::to_chars(pos, pos + json_double_max_size, value).ptr;
+    }
+
+    void boolean(bool value) noexcept { value ? raw("true") : raw("false"); }
+    void null() noexcept { raw("null"); }
+};
+
+/// Run `write(char*) -> char*` on `bound` bytes of writable space in `out` and commit what it
+/// wrote. Returns the number of bytes written.
+template <typename Write> size_t write_json(io_buffer& out, size_t bound, Write&& write) {
+    auto span = out.writable_span(bound);
+    char* first = reinterpret_cast<char*>(span.data());
+    const auto written = static_cast<size_t>(write(first) - first);
+    out.commit(written);
+    return written;
+}
+
+/// Append to `out`; one reallocation at most.
+template <typename Write> size_t write_json(std::string& out, size_t bound, Write&& write) {
+    const size_t old_size = out.size();
+    out.resize_and_overwrite(old_size + bound, [&](char* p, size_t) {
+        return static_cast<size_t>(write(p + old_size) - p);
+    });
+    return out.size() - old_size;
+}
+
+/// Serialize into arena memory. The view stays valid until the arena is reset; it is empty
+/// when the arena cannot provide `bound` bytes.
+template <typename Write>
+std::string_view write_json(monotonic_arena& out, size_t bound, Write&& write) {
+    char* first = static_cast<char*>(out.allocate(bound, 1));
+    if (!first) {
+        return {};
+    }
+    return std::string_view(first, static_cast<size_t>(write(first) - first));
+}
+
+/// Bytes json_array_stream aims to produce per call.
+inline constexpr size_t json_stream_chunk_size = 16 * 1024;
+
+/// JSON array serialized incrementally, for http::body_stream.
+///
+/// Each call appends about `chunk_size` bytes of whole elements to `out` and returns false
+/// once the closing bracket has been written, so a response of any length is held in memory
+/// one chunk at a time. Elements are written with the generated pair `bound(item)` /
+/// `write(item, char*)` (json_size_bound_X / serialize_X_to). An rvalue range is moved into
+/// the stream; an lvalue range is referenced and must outlive the response (request arena
+/// memory does: the arena is reset only after the last chunk is written).
+template <std::ranges::input_range Range, typename Bound, typename Write>
+class json_array_stream {
+public:
+    template <typename R>
+    json_array_stream(R&& items,
+                      Bound bound,
+                      Write write,
+                      size_t chunk_size = json_stream_chunk_size)
+        : items_(std::forward<R>(items)), bound_(bound), write_(write), chunk_size_(chunk_size) {}
+
+    bool operator()(std::string& out) {
+        if (!it_) {
+            // Iterators are taken on first use, after the stream has reached its final place
+            it_.emplace(std::ranges::begin(items_));
+            out.push_back('[');
+        }
+        auto& it = *it_;
+        const auto last = std::ranges::end(items_);
+        const size_t limit = out.size() + chunk_size_;
+        for (; it != last && out.size() < limit; ++it) {
+            decltype(auto) item = *it;
+            write_json(out, bound_(item) + 1, [&](char* p) {
+                if (!first_) {
+                    *p++ = ',';
+                }
+                return write_(item, p);
+            });
+            first_ = false;
+        }
+        if (it != last) {
+            return true;
+        }
+        out.push_back(']');
+        return false;
+    }
+
+private:
+    Range items_;
+    Bound bound_;
+    Write write_;
+    size_t chunk_size_;
+    std::optional<std::ranges::iterator_t<Range>> it_;
+    bool first_ = true;
+};
+
+namespace detail {
+
+// Ranges passed as lvalues are referenced, rvalues are moved in
+template <typename R>
+using json_stream_range = std::conditional_t<std::is_lvalue_reference_v<R>,
+                                             std::ranges::ref_view<std::remove_reference_t<R>>,
+                                             std::remove_cvref_t<R>>;
+
+} // namespace detail
+
+template <typename R, typename Bound, typename Write>
+json_array_stream(R&&, Bound, Write)
+    -> json_array_stream<detail::json_stream_range<R>, Bound, Write>;
+
+template <typename R, typename Bound, typename Write>
+json_array_stream(R&&, Bound, Write, size_t)
+    -> json_array_stream<detail::json_stream_range<R>, Bound, Write>;
+
+} // namespace katana::serde
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace katana::serde {
+
+/// Perfect hash from a fixed set of JSON object keys to their position in that set.
+///
+/// The constructor searches for a seed under which every key gets its own slot, so find() is
+/// one hash and at most one string compare instead of a compare per known key. The hash mixes
+/// the key length with its first and last 8 bytes; when that cannot tell the keys apart it
+/// hashes every byte, and if no seed works at all (duplicate keys) find() scans linearly.
+///
+/// Construction is constexpr: generated parsers keep the table in a `static constexpr` local,
+/// so the search runs at compile time.
+template <size_t N> class key_table {
+    static_assert(N < UINT16_MAX, "key_table supports up to 65534 keys");
+
+public:
+    static constexpr size_t npos = N;
+
+    constexpr explicit key_table(const std::array<std::string_view, N>& keys) noexcept
+        : keys_(keys) {
+        for (bool full : {false, true}) {
+            for (size_t slots = min_slots; slots <= slot_capacity; slots *= 2) {
+                for (uint64_t seed = 1; seed <= seed_attempts; ++seed) {
+                    if (try_seed(seed, slots - 1, full)) {
+                        return;
+                    }
+                }
+            }
+        }
+        linear_ = true;
+    }
+
+    template <typename... Keys>
+        requires(sizeof...(Keys) == N && (std::convertible_to<Keys, std::string_view> && ...))
+    constexpr explicit key_table(Keys... keys) noexcept
+        : key_table(std::array<std::string_view, N>{std::string_view(keys)...}) {}
+
+    /// Position of `key` in the constructor's key list, or npos.
+    [[nodiscard]] constexpr size_t find(std::string_view key) const noexcept {
+        if (linear_) {
+            for (size_t i = 0; i < N; ++i) {
+                if (keys_[i] == key) {
+                    return i;
+                }
+            }
+            return npos;
+        }
+        const size_t index = slots_[static_cast<size_t>(hash(key, seed_, full_) & mask_)];
+        return index < N && keys_[index] == key ? index : npos;
+    }
+
+    [[nodiscard]] static constexpr size_t size() noexcept { return N; }
+    [[nodiscard]] constexpr std::string_view key(size_t index) const noexcept {
+        return keys_[index];
+    }
+
+private:
+    using slot_type = std::conditional_t<(N < UINT8_MAX), uint8_t, uint16_t>;
+
+    // Start at load factor <= 1/2 and allow the table to grow to 1/8 before giving up
+    static constexpr size_t min_slots = std::bit_ceil(N == 0 ? size_t{1} : N) * 2;
+    static constexpr size_t slot_capacity = min_slots * 4;
+    static constexpr uint64_t seed_attempts = 64;
+
+    // Little-endian load of n <= 8 bytes; identical at compile time and at runtime
+    static constexpr uint64_t load(const char* p, size_t n) noexcept {
+        if !consteval {
+            if (n == 8 && std::endian::native == std::endian::little) {
+                uint64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                return v;
+            }
+        }
+        uint64_t v = 0;
+        for (size_t i = 0; i < n; ++i) {
+            v |= uint64_t{static_cast<unsigned char>(p[i])} << (8 * i);
+        }
+        return v;
+    }
+
+    static constexpr uint64_t hash(std::string_view key, uint64_t seed, bool full) noexcept {
+        uint64_t h = seed ^ (uint64_t{key.size()} * 0x9E3779B97F4A7C15ULL);
+        if (full) {
+            for (char c : key) {
+                h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+            }
+        } else {
+            const size_t n = key.size() < 8 ? key.size() : 8;
+            h = (h ^ load(key.data(), n)) * 0xFF51AFD7ED558CCDULL;
+            h = (h ^ load(key.data() + key.size() - n, n)) * 0xC4CEB9FE1A85EC53ULL;
+        }
+        return h ^ (h >> 32);
+    }
+
+    constexpr bool try_seed(uint64_t seed, size_t mask, bool full) noexcept {
+        for (size_t s = 0; s <= mask; ++s) {
+            slots_[s] = static_cast<slot_type>(N);
+        }
+        for (size_t i = 0; i < N; ++i) {
+            auto& slot = slots_[static_cast<size_t>(hash(keys_[i], seed, full) & mask)];
+            if (slot != N) {
+                return false;
+            }
+            slot = static_cast<slot_type>(i);
+        }
+        seed_ = seed;
+        mask_ = mask;
+        full_ = full;
+        return true;
+    }
+
+    std::array<std::string_view, N> keys_{};
+    std::array<slot_type, slot_capacity> slots_{};
+    uint64_t seed_ = 0;
+    size_t mask_ = 0;
+    bool full_ = false;
+    bool linear_ = false;
+};
+
+template <typename... Keys> key_table(Keys...) -> key_table<sizeof...(Keys)>;
+
+} // namespace katana::serde
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace katana {
+
+enum class huge_page_mode : uint8_t {
+    none,        // regular 4 KiB pages
+    transparent, // madvise(MADV_HUGEPAGE), the kernel promotes chunks when it can
+    explicit_2m  // MAP_HUGETLB from the reserved 2 MiB pages, transparent when none are left
+};
+
+struct memory_pool_config {
+    size_t reserve_bytes = 256UL * 1024UL * 1024UL; // address space, committed a chunk at a time
+    huge_page_mode huge_pages = huge_page_mode::transparent;
+    bool numa_local = true; // bind chunks to the node of the CPU the pool is created on
+};
+
+struct memory_pool_stats {
+    uint64_t allocations = 0;  // blocks served by the pool
+    uint64_t fallbacks = 0;    // too large or pool exhausted, served by the heap instead
+    uint64_t remote_frees = 0; // blocks freed on another thread, collected by the owner
+    size_t committed_bytes = 0;
+    size_t huge_page_chunks = 0; // chunks mapped with MAP_HUGETLB
+};
+
+/// Per-reactor memory: one reserved range of address space, committed in 2 MiB chunks that are
+/// backed by huge pages and bound to the NUMA node of the reactor's core.
+///
+/// A reactor thread installs its pool with set_current(); from then on io_buffer storage,
+/// arena blocks (through arena_block_cache) and connection states allocated on that thread come
+/// from it, via memory_pool::allocate()/deallocate(). Threads without a pool, requests above
+/// MAX_BLOCK_SIZE and an exhausted reserve fall back to the heap, so callers never need to know
+/// where a block came from. Blocks are carved per power-of-two size class and recycled, never
+/// returned to the system while the pool lives.
+///
+/// Only the owning thread allocates. Any thread may free: blocks freed elsewhere go onto a
+/// lock-free list that the owner collects when a size class runs dry. The pool must outlive
+/// every block it handed out.
+class memory_pool {
+public:
+    static constexpr size_t CHUNK_SIZE = 2UL * 1024UL * 1024UL;
+    static constexpr size_t MIN_BLOCK_SIZE = 64;
+    static constexpr size_t MAX_BLOCK_SIZE = CHUNK_SIZE;
+    static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    explicit memory_pool(const memory_pool_config& config = {});
+    ~memory_pool();
+
+    memory_pool(const memory_pool&) = delete;
+    memory_pool& operator=(const memory_pool&) = delete;
+
+    /// The calling thread's pool, or nullptr
+    [[nodiscard]] static memory_pool* current() noexcept { return current_; }
+    static void set_current(memory_pool* pool) noexcept { current_ = pool; }
+
+    /// `size` bytes aligned to BLOCK_ALIGNMENT from the calling thread's pool, or from the heap
+    /// when there is none or it cannot serve the request. nullptr if both fail.
+    [[nodiscard]] static void* allocate(size_t size) noexcept;
+
+    /// Like allocate(), but nullptr instead of heap memory. For callers with a cheaper fallback
+    /// of their own; such blocks are told apart from the pool's with owner_of().
+    [[nodiscard]] static void* try_allocate(size_t size) noexcept;
+
+    /// Free a block from allocate(); `size` must be the size it was allocated with
+    static void deallocate(void* data, size_t size) noexcept;
+
+    /// Pool whose range contains `data`, or nullptr for heap memory
+    [[nodiscard]] static memory_pool* owner_of(const void* data) noexcept;
+
+    [[nodiscard]] bool contains(const void* data) const noexcept {
+        const auto p = reinterpret_cast<uintptr_t>(data);
+        return p >= begin_ && p < end_;
+    }
+
+    /// False when the address range could not be reserved; every allocation then falls back
+    [[nodiscard]] bool valid() const noexcept { return begin_ != 0; }
+    [[nodiscard]] size_t reserved_bytes() const noexcept { return end_ - begin_; }
+    /// NUMA node the chunks are bound to, or -1
+    [[nodiscard]] int numa_node() const noexcept { return numa_node_; }
+    [[nodiscard]] const memory_pool_stats& stats() const noexcept { return stats_; }
+
+private:
+    static constexpr size_t MIN_CLASS_SHIFT = 6;
+    static constexpr size_t NUM_CLASSES = 16; // 64 B .. 2 MiB
+    static_assert(MIN_BLOCK_SIZE << (NUM_CLASSES - 1) == MAX_BLOCK_SIZE);
+
+    struct free_block {
+        free_block* next;
+        size_t size_class; // only read for remote frees
+    };
+
+    struct size_class {
+        free_block* head = nullptr;
+        uintptr_t carve = 0; // unused part of the chunk last committed for this class
+        uintptr_t carve_end = 0;
+    };
+
+    static constexpr size_t class_of(size_t size) noexcept {
+        const size_t block = size <= MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : std::bit_ceil(size);
+        return static_cast<size_t>(std::countr_zero(block)) - MIN_CLASS_SHIFT;
+    }
+
+    void* allocate_block(size_t cls) noexcept;
+    void free_block_local(void* data, size_t cls) noexcept;
+    void free_block_remote(void* data, size_t cls) noexcept;
+    void collect_remote_frees() noexcept;
+    bool commit_chunk(uintptr_t chunk) noexcept;
+
+    static thread_local memory_pool* current_;
+
+    memory_pool_config config_;
+    uintptr_t mapping_ = 0; // whole reservation, including alignment slack
+    size_t mapping_size_ = 0;
+    uintptr_t begin_ = 0; // CHUNK_SIZE-aligned usable range
+    uintptr_t end_ = 0;
+    uintptr_t next_chunk_ = 0;
+    int numa_node_ = -1;
+    std::array<size_class, NUM_CLASSES> classes_{};
+    memory_pool_stats stats_{};
+    alignas(64) std::atomic<free_block*> remote_frees_{nullptr};
+};
+
+/// Allocator drawing from the calling thread's memory_pool, e.g. for std::allocate_shared
+template <typename T> class pool_allocator {
+public:
+    using value_type = T;
+
+    pool_allocator() noexcept = default;
+    template <typename U> pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    [[nodiscard]] T* allocate(size_t n) {
+        static_assert(alignof(T) <= memory_pool::BLOCK_ALIGNMENT);
+        void* p = memory_pool::allocate(n * sizeof(T));
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept { memory_pool::deallocate(p, n * sizeof(T)); }
+
+    template <typename U> bool operator==(const pool_allocator<U>&) const noexcept { return true; }
+};
+
+} // namespace katana
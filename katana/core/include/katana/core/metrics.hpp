@@ -56,4 +56,94 @@ struct reactor_metrics {
     }
 };
 
+struct admission_snapshot {
+    uint64_t requests_admitted = 0;
+    uint64_t requests_shed = 0;      // Shed because queueing delay exceeded target
+    uint64_t shed_in_flight = 0;     // Shed because the in-flight limit was reached
+    uint64_t overload_episodes = 0;  // Transitions into the shedding state
+    uint64_t queue_delay_max_us = 0; // Worst observed event-to-dispatch delay
+    uint64_t in_flight = 0;
+
+    admission_snapshot& operator+=(const admission_snapshot& other) {
+        requests_admitted += other.requests_admitted;
+        requests_shed += other.requests_shed;
+        shed_in_flight += other.shed_in_flight;
+        overload_episodes += other.overload_episodes;
+        queue_delay_max_us = queue_delay_max_us > other.queue_delay_max_us
+                                 ? queue_delay_max_us
+                                 : other.queue_delay_max_us;
+        in_flight += other.in_flight;
+        return *this;
+    }
+};
+
+struct admission_metrics {
+    std::atomic<uint64_t> requests_admitted{0};
+    std::atomic<uint64_t> requests_shed{0};
+    std::atomic<uint64_t> shed_in_flight{0};
+    std::atomic<uint64_t> overload_episodes{0};
+    std::atomic<uint64_t> queue_delay_max_us{0};
+    std::atomic<uint64_t> in_flight{0};
+
+    void reset() {
+        requests_admitted.store(0, std::memory_order_relaxed);
+        requests_shed.store(0, std::memory_order_relaxed);
+        shed_in_flight.store(0, std::memory_order_relaxed);
+        overload_episodes.store(0, std::memory_order_relaxed);
+        queue_delay_max_us.store(0, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] admission_snapshot snapshot() const {
+        return admission_snapshot{requests_admitted.load(std::memory_order_relaxed),
+                                  requests_shed.load(std::memory_order_relaxed),
+                                  shed_in_flight.load(std::memory_order_relaxed),
+                                  overload_episodes.load(std::memory_order_relaxed),
+                                  queue_delay_max_us.load(std::memory_order_relaxed),
+                                  in_flight.load(std::memory_order_relaxed)};
+    }
+};
+
+struct offload_snapshot {
+    uint64_t jobs_submitted = 0;
+    uint64_t jobs_rejected = 0; // Queue full
+    uint64_t jobs_completed = 0;
+    uint64_t queue_depth = 0;
+    uint64_t queue_depth_max = 0;
+    uint64_t wait_time_total_us = 0; // Enqueue -> worker pickup
+    uint64_t wait_time_max_us = 0;
+
+    offload_snapshot& operator+=(const offload_snapshot& other) {
+        jobs_submitted += other.jobs_submitted;
+        jobs_rejected += other.jobs_rejected;
+        jobs_completed += other.jobs_completed;
+        queue_depth += other.queue_depth;
+        queue_depth_max =
+            queue_depth_max > other.queue_depth_max ? queue_depth_max : other.queue_depth_max;
+        wait_time_total_us += other.wait_time_total_us;
+        wait_time_max_us =
+            wait_time_max_us > other.wait_time_max_us ? wait_time_max_us : other.wait_time_max_us;
+        return *this;
+    }
+};
+
+struct offload_metrics {
+    std::atomic<uint64_t> jobs_submitted{0};
+    std::atomic<uint64_t> jobs_rejected{0};
+    std::atomic<uint64_t> jobs_completed{0};
+    std::atomic<uint64_t> queue_depth{0};
+    std::atomic<uint64_t> queue_depth_max{0};
+    std::atomic<uint64_t> wait_time_total_us{0};
+    std::atomic<uint64_t> wait_time_max_us{0};
+
+    [[nodiscard]] offload_snapshot snapshot() const {
+        return offload_snapshot{jobs_submitted.load(std::memory_order_relaxed),
+                                jobs_rejected.load(std::memory_order_relaxed),
+                                jobs_completed.load(std::memory_order_relaxed),
+                                queue_depth.load(std::memory_order_relaxed),
+                                queue_depth_max.load(std::memory_order_relaxed),
+                                wait_time_total_us.load(std::memory_order_relaxed),
+                                wait_time_max_us.load(std::memory_order_relaxed)};
+    }
+};
+
 } // namespace katana
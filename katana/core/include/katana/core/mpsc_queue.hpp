@@ -1,11 +1,18 @@
 #pragma once
 
 #include <atomic>
+#include <bit>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <optional>
+#include <type_traits>
 
 namespace katana {
 
+/// Unbounded MPSC queue that allocates a node per element. max_size > 0 makes try_push()
+/// refuse elements beyond it; push() never refuses. For hot paths prefer intrusive_mpsc_queue
+/// (caller-owned nodes) or bounded_mpsc_queue (fixed array), neither of which allocates.
 template <typename T> class mpsc_queue {
 public:
     explicit mpsc_queue(size_t max_size = 0) : max_size_(max_size) {
@@ -24,30 +31,22 @@ public:
     mpsc_queue& operator=(const mpsc_queue&) = delete;
 
     void push(T value) {
-        auto new_node = new node();
-        new_node->data = std::move(value);
-
-        node* prev = head_.exchange(new_node, std::memory_order_acq_rel);
-        prev->next.store(new_node, std::memory_order_release);
-
         if (max_size_ > 0) {
             size_.fetch_add(1, std::memory_order_relaxed);
         }
+        link(new node(std::move(value)));
     }
 
     bool try_push(T value) {
         if (max_size_ > 0) {
-            size_t old_size = size_.load(std::memory_order_acquire);
-            do {
-                if (old_size >= max_size_) {
-                    return false;
-                }
-            } while (!size_.compare_exchange_weak(
-                old_size, old_size + 1, std::memory_order_acq_rel, std::memory_order_acquire));
-            push_impl(std::move(value));
-        } else {
-            push(std::move(value));
+            // Reserve a place with one RMW and hand it back on overflow instead of a CAS loop;
+            // a racing try_push may see the brief overshoot and fail, never the other way round
+            if (size_.fetch_add(1, std::memory_order_relaxed) >= max_size_) {
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
         }
+        link(new node(std::move(value)));
         return true;
     }
 
@@ -75,23 +74,184 @@ public:
     [[nodiscard]] size_t size() const { return size_.load(std::memory_order_relaxed); }
 
 private:
-    void push_impl(T value) {
-        auto new_node = new node();
-        new_node->data = std::move(value);
-
-        node* prev = head_.exchange(new_node, std::memory_order_acq_rel);
-        prev->next.store(new_node, std::memory_order_release);
-    }
-
     struct node {
+        node() = default;
+        explicit node(T&& value) : data(std::move(value)) {}
+
         std::atomic<node*> next{nullptr};
         std::optional<T> data;
     };
 
+    void link(node* new_node) {
+        node* prev = head_.exchange(new_node, std::memory_order_acq_rel);
+        prev->next.store(new_node, std::memory_order_release);
+    }
+
     alignas(64) std::atomic<node*> head_;
     alignas(64) node* tail_;
     alignas(64) std::atomic<size_t> size_{0};
     alignas(64) const size_t max_size_; // 0 means unlimited
 };
 
+/// Link embedded in elements of an intrusive_mpsc_queue
+struct mpsc_hook {
+    std::atomic<mpsc_hook*> next{nullptr};
+};
+
+/// Vyukov's intrusive MPSC queue: elements derive from mpsc_hook, so pushing links the caller's
+/// object and nothing is allocated or freed. An element must stay alive and must not be pushed
+/// again until pop() has returned it.
+///
+/// push() is wait-free (one exchange). pop() belongs to a single consumer; while a producer is
+/// between its exchange and its link it can return nullptr although the queue is not empty,
+/// and the element shows up on a later pop().
+template <typename T> class intrusive_mpsc_queue {
+    static_assert(std::is_base_of_v<mpsc_hook, T>, "elements must derive from mpsc_hook");
+
+public:
+    intrusive_mpsc_queue() noexcept : head_(&stub_), tail_(&stub_) {}
+
+    intrusive_mpsc_queue(const intrusive_mpsc_queue&) = delete;
+    intrusive_mpsc_queue& operator=(const intrusive_mpsc_queue&) = delete;
+
+    void push(T& item) noexcept { link(static_cast<mpsc_hook*>(&item)); }
+
+    [[nodiscard]] T* pop() noexcept {
+        mpsc_hook* tail = tail_;
+        mpsc_hook* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+
+        // `tail` is the last element; it can only be handed out once something follows it
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        link(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return tail_ == &stub_ && !stub_.next.load(std::memory_order_acquire);
+    }
+
+private:
+    void link(mpsc_hook* hook) noexcept {
+        hook->next.store(nullptr, std::memory_order_relaxed);
+        mpsc_hook* prev = head_.exchange(hook, std::memory_order_acq_rel);
+        prev->next.store(hook, std::memory_order_release);
+    }
+
+    alignas(64) std::atomic<mpsc_hook*> head_;
+    alignas(64) mpsc_hook* tail_;
+    mpsc_hook stub_;
+};
+
+/// Fixed-capacity MPSC queue over an array of sequenced slots. Producers claim a slot with a
+/// CAS on the tail as in ring_buffer_queue; the single consumer needs no atomic RMW at all and
+/// pop_n() drains every ready slot in one pass, publishing the new head once. Nothing is
+/// allocated after construction.
+template <typename T> class bounded_mpsc_queue {
+public:
+    explicit bounded_mpsc_queue(size_t capacity = 1024)
+        : capacity_(capacity < 2 ? 2 : std::bit_ceil(capacity)), mask_(capacity_ - 1),
+          slots_(new slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~bounded_mpsc_queue() {
+        T value;
+        while (try_pop(value)) {
+        }
+    }
+
+    bounded_mpsc_queue(const bounded_mpsc_queue&) = delete;
+    bounded_mpsc_queue& operator=(const bounded_mpsc_queue&) = delete;
+
+    /// False when the queue is full
+    bool try_push(T&& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot& s = slots_[tail & mask_];
+            const size_t seq = s.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - tail);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    new (&s.storage) T(std::move(value));
+                    s.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_push(const T& value) {
+        T copy = value;
+        return try_push(std::move(copy));
+    }
+
+    bool try_pop(T& value) { return pop_n(&value, 1) == 1; }
+
+    /// Move up to `max_count` ready elements to `out`; returns how many. Consumer only.
+    template <typename OutputIt> size_t pop_n(OutputIt out, size_t max_count) {
+        size_t count = 0;
+        for (; count < max_count; ++count) {
+            slot& s = slots_[(head_ + count) & mask_];
+            if (s.sequence.load(std::memory_order_acquire) != head_ + count + 1) {
+                break;
+            }
+            T* item = std::launder(reinterpret_cast<T*>(&s.storage));
+            *out++ = std::move(*item);
+            item->~T();
+            s.sequence.store(head_ + count + capacity_, std::memory_order_release);
+        }
+        if (count > 0) {
+            head_ += count;
+            head_published_.store(head_, std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t head = head_published_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+private:
+    struct slot {
+        std::atomic<size_t> sequence{0};
+        alignas(T) std::byte storage[sizeof(T)];
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<slot[]> slots_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) size_t head_ = 0; // consumer's own
+    std::atomic<size_t> head_published_{0}; // for size() from other threads
+};
+
 } // namespace katana
@@ -0,0 +1,437 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace katana::serde {
+
+/// MessagePack has no registered media type; accept the names in common use.
+constexpr bool is_msgpack_media_type(std::string_view media_type) noexcept {
+    return media_type == "application/msgpack" || media_type == "application/x-msgpack" ||
+           media_type == "application/vnd.msgpack";
+}
+
+/// Longest encoding of an integer (0xd3 + 8 bytes) and of a double (0xcb + 8 bytes).
+inline constexpr size_t msgpack_int_max_size = 9;
+inline constexpr size_t msgpack_double_max_size = 9;
+/// Longest array or map header (0xdd / 0xdf + 4 bytes).
+inline constexpr size_t msgpack_header_max_size = 5;
+
+/// Bytes a MessagePack string of `raw` bytes can take, header included.
+constexpr size_t msgpack_string_size_bound(size_t raw) noexcept {
+    return raw + msgpack_header_max_size;
+}
+
+namespace detail {
+
+template <std::unsigned_integral T> inline T load_be(const char* p) noexcept {
+    T v;
+    std::memcpy(&v, p, sizeof(v));
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) > 1) {
+        v = std::byteswap(v);
+    }
+    return v;
+}
+
+template <std::unsigned_integral T> inline char* store_be(char* p, T v) noexcept {
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) > 1) {
+        v = std::byteswap(v);
+    }
+    std::memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+} // namespace detail
+
+/// Unchecked MessagePack output cursor for generated serializers; the msgpack counterpart of
+/// json_out. The caller sizes the destination with the generated msgpack_size_bound_* function.
+struct msgpack_out {
+    char* pos;
+
+    void raw(std::string_view s) noexcept {
+        std::memcpy(pos, s.data(), s.size());
+        pos += s.size();
+    }
+    void put(uint8_t b) noexcept { *pos++ = static_cast<char>(b); }
+
+    void nil() noexcept { put(0xc0); }
+    void boolean(bool value) noexcept { put(value ? 0xc3 : 0xc2); }
+
+    /// Smallest encoding that holds `value`.
+    template <std::integral T>
+        requires(!std::same_as<T, bool> && sizeof(T) <= sizeof(int64_t))
+    void integer(T value) noexcept {
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                const auto v = static_cast<int64_t>(value);
+                if (v >= -32) {
+                    put(static_cast<uint8_t>(v));
+                } else if (v >= INT8_MIN) {
+                    put(0xd0);
+                    put(static_cast<uint8_t>(v));
+                } else if (v >= INT16_MIN) {
+                    put(0xd1);
+                    pos = detail::store_be(pos, static_cast<uint16_t>(v));
+                } else if (v >= INT32_MIN) {
+                    put(0xd2);
+                    pos = detail::store_be(pos, static_cast<uint32_t>(v));
+                } else {
+                    put(0xd3);
+                    pos = detail::store_be(pos, static_cast<uint64_t>(v));
+                }
+                return;
+            }
+        }
+        const auto v = static_cast<uint64_t>(value);
+        if (v <= 0x7f) {
+            put(static_cast<uint8_t>(v));
+        } else if (v <= UINT8_MAX) {
+            put(0xcc);
+            put(static_cast<uint8_t>(v));
+        } else if (v <= UINT16_MAX) {
+            put(0xcd);
+            pos = detail::store_be(pos, static_cast<uint16_t>(v));
+        } else if (v <= UINT32_MAX) {
+            put(0xce);
+            pos = detail::store_be(pos, static_cast<uint32_t>(v));
+        } else {
+            put(0xcf);
+            pos = detail::store_be(pos, v);
+        }
+    }
+
+    // Always float 64: narrowing to float 32 would need a round-trip check per value
+    void number(double value) noexcept {
+        put(0xcb);
+        pos = detail::store_be(pos, std::bit_cast<uint64_t>(value));
+    }
+
+    void string(std::string_view s) noexcept {
+        const size_t n = s.size();
+        if (n <= 31) {
+            put(static_cast<uint8_t>(0xa0 | n));
+        } else if (n <= UINT8_MAX) {
+            put(0xd9);
+            put(static_cast<uint8_t>(n));
+        } else if (n <= UINT16_MAX) {
+            put(0xda);
+            pos = detail::store_be(pos, static_cast<uint16_t>(n));
+        } else {
+            put(0xdb);
+            pos = detail::store_be(pos, static_cast<uint32_t>(n));
+        }
+        raw(s);
+    }
+
+    void array_header(size_t n) noexcept { header(n, 0x90, 0xdc); }
+    void map_header(size_t n) noexcept { header(n, 0x80, 0xde); }
+
+private:
+    // fix form below 16 entries, then 16- and 32-bit lengths (`wide` and `wide` + 1)
+    void header(size_t n, uint8_t fix, uint8_t wide) noexcept {
+        if (n <= 15) {
+            put(static_cast<uint8_t>(fix | n));
+        } else if (n <= UINT16_MAX) {
+            put(wide);
+            pos = detail::store_be(pos, static_cast<uint16_t>(n));
+        } else {
+            put(static_cast<uint8_t>(wide + 1));
+            pos = detail::store_be(pos, static_cast<uint32_t>(n));
+        }
+    }
+};
+
+/// Forward-only MessagePack reader for generated parsers.
+///
+/// Every read checks the remaining length and returns nullopt (leaving the cursor where it
+/// was) when the next value is of another type or truncated. Strings are views into the input,
+/// so decoding allocates nothing. Extension, binary and float 32 values are skipped by
+/// skip_value(); number() also accepts float 32 and integers.
+struct msgpack_cursor {
+    const char* ptr;
+    const char* end;
+
+    msgpack_cursor(const char* p, const char* e) noexcept : ptr(p), end(e) {}
+    explicit msgpack_cursor(std::string_view data) noexcept
+        : ptr(data.data()), end(data.data() + data.size()) {}
+
+    bool eof() const noexcept { return ptr >= end; }
+    size_t remaining() const noexcept { return static_cast<size_t>(end - ptr); }
+
+    uint8_t peek() const noexcept { return static_cast<uint8_t>(*ptr); }
+
+    bool try_nil() noexcept {
+        if (eof() || peek() != 0xc0) {
+            return false;
+        }
+        ++ptr;
+        return true;
+    }
+
+    std::optional<bool> boolean() noexcept {
+        if (eof() || (peek() != 0xc2 && peek() != 0xc3)) {
+            return std::nullopt;
+        }
+        return *ptr++ == static_cast<char>(0xc3);
+    }
+
+    std::optional<size_t> array_header() noexcept { return header(0x90, 0xdc); }
+    std::optional<size_t> map_header() noexcept { return header(0x80, 0xde); }
+
+    std::optional<std::string_view> string() noexcept {
+        if (eof()) {
+            return std::nullopt;
+        }
+        const uint8_t b = peek();
+        size_t n;
+        size_t skip;
+        if ((b & 0xe0) == 0xa0) {
+            n = b & 0x1f;
+            skip = 1;
+        } else if (b == 0xd9 && remaining() >= 2) {
+            n = static_cast<uint8_t>(ptr[1]);
+            skip = 2;
+        } else if (b == 0xda && remaining() >= 3) {
+            n = detail::load_be<uint16_t>(ptr + 1);
+            skip = 3;
+        } else if (b == 0xdb && remaining() >= 5) {
+            n = detail::load_be<uint32_t>(ptr + 1);
+            skip = 5;
+        } else {
+            return std::nullopt;
+        }
+        if (remaining() - skip < n) {
+            return std::nullopt;
+        }
+        std::string_view s(ptr + skip, n);
+        ptr += skip + n;
+        return s;
+    }
+
+    std::optional<int64_t> int64() noexcept {
+        if (eof()) {
+            return std::nullopt;
+        }
+        const uint8_t b = peek();
+        if (b <= 0x7f) {
+            ++ptr;
+            return int64_t{b};
+        }
+        if (b >= 0xe0) {
+            ++ptr;
+            return int64_t{static_cast<int8_t>(b)};
+        }
+        switch (b) {
+        case 0xcc:
+            return fixed<uint8_t>();
+        case 0xcd:
+            return fixed<uint16_t>();
+        case 0xce:
+            return fixed<uint32_t>();
+        case 0xcf:
+            // uint 64 above INT64_MAX does not fit
+            if (remaining() < 9 || static_cast<uint8_t>(ptr[1]) > 0x7f) {
+                return std::nullopt;
+            }
+            return fixed<int64_t>();
+        case 0xd0:
+            return fixed<int8_t>();
+        case 0xd1:
+            return fixed<int16_t>();
+        case 0xd2:
+            return fixed<int32_t>();
+        case 0xd3:
+            return fixed<int64_t>();
+        default:
+            return std::nullopt;
+        }
+    }
+
+    std::optional<double> number() noexcept {
+        if (eof()) {
+            return std::nullopt;
+        }
+        const uint8_t b = peek();
+        if (b == 0xcb && remaining() >= 9) {
+            const auto bits = detail::load_be<uint64_t>(ptr + 1);
+            ptr += 9;
+            return std::bit_cast<double>(bits);
+        }
+        if (b == 0xca && remaining() >= 5) {
+            const auto bits = detail::load_be<uint32_t>(ptr + 1);
+            ptr += 5;
+            return static_cast<double>(std::bit_cast<float>(bits));
+        }
+        if (b == 0xcf && remaining() >= 9) {
+            const auto v = detail::load_be<uint64_t>(ptr + 1);
+            ptr += 9;
+            return static_cast<double>(v);
+        }
+        auto v = int64();
+        return v ? std::optional<double>(static_cast<double>(*v)) : std::nullopt;
+    }
+
+    /// Skip one complete value, containers included. Returns false on malformed or truncated
+    /// input. Iterative, so hostile nesting depth cannot overflow the stack.
+    bool skip_value() noexcept {
+        size_t pending = 1;
+        while (pending > 0) {
+            if (eof()) {
+                return false;
+            }
+            --pending;
+            const uint8_t b = peek();
+            size_t size = 1;   // bytes of the value itself
+            size_t length = 0; // payload length for str/bin/ext
+            size_t children = 0;
+            if (b <= 0x7f || b >= 0xe0 || (b >= 0xc0 && b <= 0xc3)) {
+                // positive/negative fixint, nil, (never used), false, true
+            } else if (b <= 0x8f) {
+                children = size_t{b & 0x0fu} * 2;
+            } else if (b <= 0x9f) {
+                children = b & 0x0fu;
+            } else if (b <= 0xbf) {
+                length = b & 0x1fu;
+            } else {
+                switch (b) {
+                case 0xcc:
+                case 0xd0:
+                    size = 2;
+                    break;
+                case 0xcd:
+                case 0xd1:
+                    size = 3;
+                    break;
+                case 0xca:
+                case 0xce:
+                case 0xd2:
+                    size = 5;
+                    break;
+                case 0xcb:
+                case 0xcf:
+                case 0xd3:
+                    size = 9;
+                    break;
+                case 0xd4: // fixext 1, 2, 4, 8, 16: type byte + data
+                case 0xd5:
+                case 0xd6:
+                case 0xd7:
+                case 0xd8:
+                    size = 2 + (size_t{1} << (b - 0xd4));
+                    break;
+                case 0xc4:
+                case 0xd9:
+                    if (!prefixed<uint8_t>(size, length, 0)) {
+                        return false;
+                    }
+                    break;
+                case 0xc5:
+                case 0xda:
+                    if (!prefixed<uint16_t>(size, length, 0)) {
+                        return false;
+                    }
+                    break;
+                case 0xc6:
+                case 0xdb:
+                    if (!prefixed<uint32_t>(size, length, 0)) {
+                        return false;
+                    }
+                    break;
+                case 0xc7:
+                    if (!prefixed<uint8_t>(size, length, 1)) {
+                        return false;
+                    }
+                    break;
+                case 0xc8:
+                    if (!prefixed<uint16_t>(size, length, 1)) {
+                        return false;
+                    }
+                    break;
+                case 0xc9:
+                    if (!prefixed<uint32_t>(size, length, 1)) {
+                        return false;
+                    }
+                    break;
+                case 0xdc:
+                case 0xdd: {
+                    auto n = array_header();
+                    if (!n) {
+                        return false;
+                    }
+                    pending += *n;
+                    continue;
+                }
+                case 0xde:
+                case 0xdf: {
+                    auto n = map_header();
+                    if (!n) {
+                        return false;
+                    }
+                    pending += *n * 2;
+                    continue;
+                }
+                default:
+                    return false;
+                }
+            }
+            if (remaining() < size || remaining() - size < length) {
+                return false;
+            }
+            ptr += size + length;
+            pending += children;
+        }
+        return true;
+    }
+
+private:
+    template <typename T> std::optional<int64_t> fixed() noexcept {
+        if (remaining() < 1 + sizeof(T)) {
+            return std::nullopt;
+        }
+        using U = std::make_unsigned_t<T>;
+        const auto v = static_cast<T>(detail::load_be<U>(ptr + 1));
+        ptr += 1 + sizeof(T);
+        return static_cast<int64_t>(v);
+    }
+
+    // Header of a str/bin (`extra` = 0) or ext (`extra` = 1 type byte) value
+    template <typename Len> bool prefixed(size_t& size, size_t& length, size_t extra) noexcept {
+        if (remaining() < 1 + sizeof(Len)) {
+            return false;
+        }
+        length = detail::load_be<Len>(ptr + 1);
+        size = 1 + sizeof(Len) + extra;
+        return true;
+    }
+
+    std::optional<size_t> header(uint8_t fix, uint8_t wide) noexcept {
+        if (eof()) {
+            return std::nullopt;
+        }
+        const uint8_t b = peek();
+        if ((b & 0xf0) == fix) {
+            ++ptr;
+            return size_t{b & 0x0fu};
+        }
+        if (b == wide && remaining() >= 3) {
+            const size_t n = detail::load_be<uint16_t>(ptr + 1);
+            ptr += 3;
+            return n;
+        }
+        if (b == wide + 1 && remaining() >= 5) {
+            const size_t n = detail::load_be<uint32_t>(ptr + 1);
+            ptr += 5;
+            return n;
+        }
+        return std::nullopt;
+    }
+};
+
+} // namespace katana::serde
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "metrics.hpp"
+#include "ring_buffer_queue.hpp"
+#include "small_function.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace katana {
+
+struct offload_pool_config {
+    size_t worker_count = 0; // 0 = half of the cores, at least one
+    size_t queue_capacity = 1024;
+};
+
+/// Bounded worker pool for CPU-heavy work that must not run on a reactor thread.
+///
+/// submit() never blocks: when the queue is full it returns false and the caller decides how
+/// to degrade (typically a 503). Jobs hand their results back to the reactor themselves,
+/// usually with reactor::schedule().
+class offload_pool {
+public:
+    using job_fn = small_function<void(), 128>;
+
+    explicit offload_pool(const offload_pool_config& config = {});
+    ~offload_pool();
+
+    offload_pool(const offload_pool&) = delete;
+    offload_pool& operator=(const offload_pool&) = delete;
+
+    [[nodiscard]] bool submit(job_fn job);
+
+    /// Run queued jobs to completion and join the workers. Idempotent.
+    void stop();
+
+    /// True once stop() started; long-running jobs can use it to bail out early.
+    [[nodiscard]] bool stopping() const noexcept {
+        return stopping_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t worker_count() const noexcept { return workers_.size(); }
+    [[nodiscard]] const offload_metrics& metrics() const noexcept { return metrics_; }
+
+private:
+    struct queued_job {
+        job_fn fn;
+        std::chrono::steady_clock::time_point enqueued{};
+        bool stop = false;
+    };
+
+    void worker_loop();
+
+    ring_buffer_queue<queued_job> queue_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> stopping_{false};
+    offload_metrics metrics_;
+};
+
+} // namespace katana
@@ -56,6 +56,8 @@ struct schema {
     bool nullable = false;
     bool deprecated = false;
     bool unique_items = false;
+    // x-katana-partial: generate a lazy view over the JSON instead of a materialized DTO
+    bool x_katana_partial = false;
     std::optional<double> minimum;
     std::optional<double> maximum;
     std::optional<double> exclusive_minimum;
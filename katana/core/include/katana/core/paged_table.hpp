@@ -0,0 +1,157 @@
+#pragma once
+
+#include "memory_pool.hpp"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace katana {
+
+/// Index-addressed table stored in pages of 2^PageBits elements. A page is allocated, with its
+/// elements value-initialised, the first time an index in it is ensure()d and stays where it is
+/// until the table is destroyed, so element references survive any later growth and growing
+/// never moves, copies or pauses on live elements: only the page directory (one pointer per
+/// page) is reallocated. Memory follows the pages in use, not the highest index, which suits
+/// sparse keys such as file descriptors.
+///
+/// Pages come from the calling thread's memory_pool (the heap on threads without one), so a
+/// reactor's tables sit in its NUMA-local memory. Not thread-safe.
+template <typename T, size_t PageBits = 8> class paged_table {
+    static_assert(PageBits >= 1 && PageBits <= 20, "page must hold 2..1M elements");
+    static_assert(alignof(T) <= memory_pool::BLOCK_ALIGNMENT, "element alignment too strict");
+    static_assert(std::is_nothrow_destructible_v<T>);
+
+public:
+    static constexpr size_t PAGE_SIZE = size_t{1} << PageBits;
+
+    paged_table() = default;
+
+    paged_table(paged_table&& other) noexcept
+        : pages_(std::move(other.pages_)), page_count_(std::exchange(other.page_count_, 0)) {
+        other.pages_.clear();
+    }
+
+    paged_table& operator=(paged_table&& other) noexcept {
+        if (this != &other) {
+            release();
+            pages_ = std::move(other.pages_);
+            other.pages_.clear();
+            page_count_ = std::exchange(other.page_count_, 0);
+        }
+        return *this;
+    }
+
+    paged_table(const paged_table&) = delete;
+    paged_table& operator=(const paged_table&) = delete;
+
+    ~paged_table() { release(); }
+
+    /// Element at `index`, or nullptr when its page has not been allocated
+    [[nodiscard]] T* find(size_t index) noexcept {
+        const size_t page = index >> PageBits;
+        if (page >= pages_.size() || !pages_[page]) {
+            return nullptr;
+        }
+        return &pages_[page][index & (PAGE_SIZE - 1)];
+    }
+
+    [[nodiscard]] const T* find(size_t index) const noexcept {
+        return const_cast<paged_table*>(this)->find(index);
+    }
+
+    /// Element at `index`, allocating its page first if needed; nullptr when out of memory
+    [[nodiscard]] T* ensure(size_t index) {
+        if (T* element = find(index)) {
+            return element;
+        }
+        const size_t page = index >> PageBits;
+        try {
+            if (page >= pages_.size()) {
+                pages_.resize(page + 1, nullptr);
+            }
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+
+        void* block = memory_pool::allocate(PAGE_BYTES);
+        if (!block) {
+            return nullptr;
+        }
+        T* elements = static_cast<T*>(block);
+        size_t constructed = 0;
+        try {
+            for (; constructed < PAGE_SIZE; ++constructed) {
+                new (elements + constructed) T();
+            }
+        } catch (...) {
+            destroy_page(elements, constructed);
+            throw;
+        }
+        pages_[page] = elements;
+        ++page_count_;
+        return &elements[index & (PAGE_SIZE - 1)];
+    }
+
+    /// Element at an index that has been ensure()d
+    [[nodiscard]] T& operator[](size_t index) noexcept {
+        return pages_[index >> PageBits][index & (PAGE_SIZE - 1)];
+    }
+
+    [[nodiscard]] const T& operator[](size_t index) const noexcept {
+        return pages_[index >> PageBits][index & (PAGE_SIZE - 1)];
+    }
+
+    /// Call `fn(index, element)` for every element of every allocated page, in index order.
+    /// `fn` may ensure() further indices; elements on pages added meanwhile may be skipped.
+    template <typename Fn> void for_each(Fn&& fn) {
+        for (size_t page = 0; page < pages_.size(); ++page) {
+            for (size_t i = 0; i < PAGE_SIZE && pages_[page]; ++i) {
+                fn((page << PageBits) | i, pages_[page][i]);
+            }
+        }
+    }
+
+    template <typename Fn> void for_each(Fn&& fn) const {
+        for (size_t page = 0; page < pages_.size(); ++page) {
+            for (size_t i = 0; i < PAGE_SIZE && pages_[page]; ++i) {
+                fn((page << PageBits) | i, static_cast<const T&>(pages_[page][i]));
+            }
+        }
+    }
+
+    [[nodiscard]] size_t page_count() const noexcept { return page_count_; }
+    /// Elements on allocated pages
+    [[nodiscard]] size_t capacity() const noexcept { return page_count_ * PAGE_SIZE; }
+    /// Bytes held by pages and the directory
+    [[nodiscard]] size_t memory_bytes() const noexcept {
+        return page_count_ * PAGE_BYTES + pages_.capacity() * sizeof(T*);
+    }
+
+private:
+    static constexpr size_t PAGE_BYTES = PAGE_SIZE * sizeof(T);
+
+    static void destroy_page(T* elements, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            elements[i].~T();
+        }
+        memory_pool::deallocate(elements, PAGE_BYTES);
+    }
+
+    void release() noexcept {
+        for (T* elements : pages_) {
+            if (elements) {
+                destroy_page(elements, PAGE_SIZE);
+            }
+        }
+        pages_.clear();
+        page_count_ = 0;
+    }
+
+    std::vector<T*> pages_; // directory, nullptr for pages not allocated yet
+    size_t page_count_ = 0;
+};
+
+} // namespace katana
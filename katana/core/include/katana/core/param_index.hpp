@@ -0,0 +1,80 @@
+#pragma once
+
+#include "arena.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace katana::http {
+
+/// Name/value index over a query string or a Cookie header.
+///
+/// assign() only records the source; the first lookup splits it once into an arena-backed
+/// table, so a handler reading eight parameters scans the input once instead of eight times.
+/// Query names and values are percent-decoded ('+' as space) into the arena, but only when
+/// they actually contain an escape; otherwise entries are views into the source.
+class param_index {
+public:
+    enum class format : uint8_t { query, cookie };
+    using entry = std::pair<std::string_view, std::string_view>;
+
+    void assign(std::string_view source, format fmt, monotonic_arena* arena) noexcept {
+        source_ = source;
+        arena_ = arena;
+        entries_ = nullptr;
+        size_ = 0;
+        format_ = fmt;
+        built_ = false;
+    }
+
+    [[nodiscard]] std::optional<std::string_view> get(std::string_view name) const noexcept {
+        build();
+        for (size_t i = 0; i < size_; ++i) {
+            if (entries_[i].first == name) {
+                return entries_[i].second;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        build();
+        return size_;
+    }
+
+    [[nodiscard]] std::span<const entry> entries() const noexcept {
+        build();
+        return std::span<const entry>(entries_, size_);
+    }
+
+    [[nodiscard]] std::string_view source() const noexcept { return source_; }
+
+private:
+    void build() const noexcept {
+        if (!built_) {
+            parse();
+        }
+    }
+    void parse() const noexcept;
+
+    std::string_view source_{};
+    monotonic_arena* arena_{nullptr};
+    mutable const entry* entries_{nullptr};
+    mutable size_t size_{0};
+    format format_{format::query};
+    mutable bool built_{false};
+};
+
+/// The part of a request target between '?' and '#', empty when there is none.
+[[nodiscard]] std::string_view query_string(std::string_view uri) noexcept;
+
+/// Percent-decode a query component ('+' becomes a space). Returns `in` unchanged when it has
+/// no escapes or a malformed one; otherwise the decoded copy lives in `arena`.
+[[nodiscard]] std::string_view percent_decode(std::string_view in,
+                                              monotonic_arena& arena) noexcept;
+
+} // namespace katana::http
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "router.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace katana {
+
+struct rate_limit_config {
+    double requests_per_second = 100.0;
+    uint32_t burst = 100;
+    size_t shard_count = 0;          // 0 = one shard per core; match the server's workers
+    size_t buckets_per_shard = 4096; // rounded up to a power of two
+    size_t global_slots = 16384;     // rounded up to a power of two
+    // How often a bucket folds in consumption observed on other shards.
+    // Zero disables cross-shard reconciliation (each shard enforces the full limit).
+    std::chrono::milliseconds reconcile_interval{100};
+    bool deny_when_full = false; // policy when a shard has no free or idle bucket
+};
+
+struct rate_limit_decision {
+    bool allowed = true;
+    uint32_t remaining = 0;
+    std::chrono::milliseconds retry_after{0};
+};
+
+struct rate_limiter_stats {
+    uint64_t allowed = 0;
+    uint64_t rejected = 0;
+    uint64_t table_full = 0;
+    uint64_t reconciliations = 0;
+
+    rate_limiter_stats& operator+=(const rate_limiter_stats& other) {
+        allowed += other.allowed;
+        rejected += other.rejected;
+        table_full += other.table_full;
+        reconciliations += other.reconciliations;
+        return *this;
+    }
+};
+
+/// Per-key token bucket rate limiter.
+///
+/// Buckets live in fixed-size, cache-line aligned, open-addressed tables, one per shard.
+/// Callers pick the shard, normally the index of the reactor serving the request (as
+/// rate_limit_middleware does with request_context::reactor_index), so with one shard per
+/// reactor the hot path touches only memory owned by that reactor. Buckets use GCRA (a single
+/// "theoretical arrival time" per key), which is equivalent to a token bucket but needs one CAS
+/// and no floating point.
+///
+/// Limits are per shard by default. With a non-zero reconcile_interval every bucket
+/// periodically publishes its local consumption to a shared table and charges itself for
+/// what other shards consumed for the same key, giving an approximate global limit.
+///
+/// check() never allocates; all tables are sized at construction.
+class rate_limiter {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit rate_limiter(const rate_limit_config& config = {});
+    ~rate_limiter();
+
+    rate_limiter(const rate_limiter&) = delete;
+    rate_limiter& operator=(const rate_limiter&) = delete;
+
+    /// Consume one token for key on shard 0.
+    rate_limit_decision check(std::string_view key) noexcept;
+    rate_limit_decision check(std::string_view key, clock::time_point now) noexcept;
+    /// Consume one token for key on `shard % shard_count()`. Shards may be shared between
+    /// threads; keeping one per reactor only avoids cross-core contention.
+    rate_limit_decision check(std::string_view key, clock::time_point now, size_t shard) noexcept;
+
+    /// Fold cross-shard consumption into every occupied bucket (e.g. from a reactor timer).
+    void reconcile(clock::time_point now = clock::now()) noexcept;
+
+    [[nodiscard]] rate_limiter_stats stats() const noexcept;
+    [[nodiscard]] size_t shard_count() const noexcept { return shard_count_; }
+    [[nodiscard]] const rate_limit_config& config() const noexcept { return config_; }
+
+private:
+    struct alignas(64) bucket {
+        std::atomic<uint64_t> key{0};
+        std::atomic<int64_t> tat{0}; // theoretical arrival time, steady-clock ns
+        std::atomic<int64_t> last_sync{0};
+        std::atomic<uint64_t> seen_global{0};
+        std::atomic<uint32_t> pending{0}; // local consumption not yet published
+    };
+
+    struct alignas(64) global_slot {
+        std::atomic<uint64_t> key{0};
+        std::atomic<uint64_t> consumed{0};
+        std::atomic<int64_t> last_update{0};
+    };
+
+    struct alignas(64) shard {
+        std::unique_ptr<bucket[]> buckets;
+        std::atomic<uint64_t> allowed{0};
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> table_full{0};
+        std::atomic<uint64_t> reconciliations{0};
+    };
+
+    static constexpr size_t MAX_PROBES = 8;
+    static constexpr uint64_t SEEN_UNSET = ~uint64_t{0};
+
+    rate_limit_decision check_hash(shard& sh, uint64_t hash, int64_t now_ns) noexcept;
+    bucket* find_or_claim(shard& sh, uint64_t hash, int64_t now_ns) noexcept;
+    global_slot* find_or_claim_global(uint64_t hash, int64_t now_ns) noexcept;
+    void sync_bucket(shard& sh, bucket& b, int64_t now_ns) noexcept;
+
+    rate_limit_config config_;
+    size_t shard_count_;
+    size_t bucket_mask_;
+    size_t global_mask_;
+    int64_t emission_ns_;
+    int64_t burst_ns_;
+    int64_t reconcile_ns_;
+    int64_t global_stale_ns_;
+    std::unique_ptr<shard[]> shards_;
+    std::unique_ptr<global_slot[]> global_;
+};
+
+namespace http {
+
+enum class rate_limit_key_kind : uint8_t { client_address, header, path_param };
+
+/// Selects the request attribute a rate limit is keyed on. Requests where the attribute is
+/// missing share the bucket of the empty key.
+struct rate_limit_key {
+    rate_limit_key_kind kind = rate_limit_key_kind::client_address;
+    std::string_view name{};
+
+    static constexpr rate_limit_key client_address() noexcept { return {}; }
+    static constexpr rate_limit_key header(std::string_view header_name) noexcept {
+        return {rate_limit_key_kind::header, header_name};
+    }
+    static constexpr rate_limit_key path_param(std::string_view param_name) noexcept {
+        return {rate_limit_key_kind::path_param, param_name};
+    }
+};
+
+std::string_view extract_rate_limit_key(const request& req,
+                                        const request_context& ctx,
+                                        rate_limit_key key) noexcept;
+
+/// Middleware that answers 429 + Retry-After once the key's bucket is empty. Requests are
+/// checked on the shard of the reactor serving them (request_context::reactor_index); routes
+/// run on the offload pool use their connection's reactor's shard.
+/// The limiter must outlive every route that uses the middleware.
+middleware_fn rate_limit_middleware(rate_limiter& limiter,
+                                    rate_limit_key key = rate_limit_key::client_address());
+
+} // namespace http
+} // namespace katana
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory_pool.hpp"
 #include "metrics.hpp"
 #include "reactor.hpp"
 #include "reactor_impl.hpp"
@@ -7,6 +8,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -18,11 +20,15 @@ struct reactor_pool_config {
     size_t max_pending_tasks = 65536;
     bool enable_adaptive_balancing = true;
     bool enable_thread_pinning = false;
+    // Per-reactor memory pool, created on the reactor thread after pinning
+    std::optional<memory_pool_config> memory;
 };
 
 class reactor_pool {
 private:
     struct reactor_context {
+        // Declared first so it outlives everything the reactor allocated from it
+        std::unique_ptr<memory_pool> memory;
         std::unique_ptr<reactor_impl> reactor;
         std::thread thread;
         std::atomic<bool> running{false};
@@ -245,6 +245,7 @@ enum class error_code : int {
     method_not_allowed = 8,
     openapi_parse_error = 9,
     openapi_invalid_spec = 10,
+    request_shed = 11,
 };
 
 class error_category : public std::error_category {
@@ -276,6 +277,8 @@ public:
             return "failed to parse OpenAPI document";
         case ec::openapi_invalid_spec:
             return "invalid or unsupported OpenAPI document";
+        case ec::request_shed:
+            return "request shed by admission control";
         default:
             return "unknown error";
         }
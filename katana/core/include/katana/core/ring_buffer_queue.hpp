@@ -153,6 +153,10 @@ public:
             return 0;
         }
 
+        // Claims slots with a CAS like the MPMC path, so the SPSC fast path must not assume it
+        // is the only producer any more
+        mark_producer(current_thread_id());
+
         size_t head = head_.value.load(std::memory_order_relaxed);
 
         for (;;) {
@@ -168,6 +172,12 @@ public:
                     head, head + to_push, std::memory_order_acq_rel)) {
                 for (size_t i = 0; i < to_push; ++i, ++begin) {
                     slot& s = buffer_[(head + i) & mask_];
+                    // A consumer that has already advanced the tail may still be moving the
+                    // previous element out of this slot
+                    for (size_t spins = 0;
+                         s.sequence.load(std::memory_order_acquire) != head + i;) {
+                        adaptive_pause(spins++);
+                    }
                     new (&s.storage) T(std::move(*begin));
                     s.sequence.store(head + i + 1, std::memory_order_release);
                 }
@@ -3,12 +3,14 @@
 #include "arena.hpp"
 #include "function_ref.hpp"
 #include "http.hpp"
-#include "inplace_function.hpp"
+#include "param_index.hpp"
 #include "problem.hpp"
 #include "result.hpp"
+#include "small_function.hpp"
 
 #include <algorithm>
 #include <array>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -30,9 +32,13 @@ template <size_t N> struct fixed_string {
 
 enum class segment_kind : uint8_t { literal, parameter };
 
+/// Constraint of a `{name:type}` segment, checked while matching.
+enum class param_type : uint8_t { any, integer, uuid };
+
 struct path_segment {
     segment_kind kind{segment_kind::literal};
     std::string_view value{};
+    param_type type{param_type::any};
 };
 
 struct path_params {
@@ -45,6 +51,15 @@ struct path_params {
         }
     }
 
+    /// Add a `{name:int}` parameter whose value was already converted during matching.
+    void add_int(std::string_view name, std::string_view value, int64_t converted) noexcept {
+        if (size_ < MAX_PATH_PARAMS) {
+            ints_[size_] = converted;
+            int_mask_ |= 1u << size_;
+            add(name, value);
+        }
+    }
+
     [[nodiscard]] std::optional<std::string_view> get(std::string_view name) const noexcept {
         for (size_t i = 0; i < size_; ++i) {
             if (entries_[i].first == name) {
@@ -54,6 +69,48 @@ struct path_params {
         return std::nullopt;
     }
 
+    /// Integer value of a parameter: free for `{name:int}` segments, parsed on demand otherwise.
+    [[nodiscard]] std::optional<int64_t> get_int(std::string_view name) const noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            if (entries_[i].first != name) {
+                continue;
+            }
+            if (int_mask_ & (1u << i)) {
+                return ints_[i];
+            }
+            return parse_int(entries_[i].second);
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] static std::optional<int64_t> parse_int(std::string_view text) noexcept {
+        int64_t value = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (ec != std::errc{} || ptr != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /// Canonical 8-4-4-4-12 hex form.
+    [[nodiscard]] static constexpr bool is_uuid(std::string_view text) noexcept {
+        if (text.size() != 36) {
+            return false;
+        }
+        for (size_t i = 0; i < text.size(); ++i) {
+            const char c = text[i];
+            if (i == 8 || i == 13 || i == 18 || i == 23) {
+                if (c != '-') {
+                    return false;
+                }
+            } else if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+                         (c >= 'A' && c <= 'F'))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     [[nodiscard]] size_t size() const noexcept { return size_; }
     [[nodiscard]] std::span<const param_entry> entries() const noexcept {
         return std::span<const param_entry>(entries_.data(), size_);
@@ -61,12 +118,19 @@ struct path_params {
 
 private:
     std::array<param_entry, MAX_PATH_PARAMS> entries_{};
+    std::array<int64_t, MAX_PATH_PARAMS> ints_{};
+    uint32_t int_mask_{0};
     size_t size_{0};
 };
 
 struct request_context {
     monotonic_arena& arena;
     path_params params{};
+    std::string_view client_address{}; // peer IP as text; empty when unknown
+    param_index query{};               // query string pairs, indexed on first lookup
+    param_index cookies{};             // Cookie header pairs, indexed on first lookup
+    std::string_view response_type{};  // media type negotiated from Accept by generated bindings
+    size_t reactor_index{0};           // reactor serving the connection; keys per-reactor state
 };
 
 struct path_pattern {
@@ -75,6 +139,7 @@ struct path_pattern {
     size_t segment_count{0};
     size_t param_count{0};
     size_t literal_count{0};
+    size_t typed_count{0};
 
     template <fixed_string Str> static consteval path_pattern from_literal() {
         path_pattern pattern{};
@@ -122,8 +187,24 @@ struct path_pattern {
                 }
 
                 auto name = segment.substr(1, segment.size() - 2);
+                auto type = param_type::any;
+                if (auto colon = name.find(':'); colon != std::string_view::npos) {
+                    auto type_name = name.substr(colon + 1);
+                    name = name.substr(0, colon);
+                    if (name.empty()) {
+                        throw "parameter name cannot be empty";
+                    }
+                    if (type_name == "int") {
+                        type = param_type::integer;
+                    } else if (type_name == "uuid") {
+                        type = param_type::uuid;
+                    } else {
+                        throw "unknown parameter type (expected int or uuid)";
+                    }
+                    ++pattern.typed_count;
+                }
                 pattern.segments[segment_index] =
-                    path_segment{segment_kind::parameter, std::string_view{name}};
+                    path_segment{segment_kind::parameter, std::string_view{name}, type};
                 pattern.param_names[param_index] = name;
                 ++param_index;
                 ++pattern.param_count;
@@ -191,7 +272,25 @@ struct path_pattern {
                 if (actual.empty()) {
                     return false;
                 }
-                out.add(param_names[param_index], actual);
+                switch (segment.type) {
+                case param_type::integer: {
+                    auto value = path_params::parse_int(actual);
+                    if (!value) {
+                        return false;
+                    }
+                    out.add_int(param_names[param_index], actual, *value);
+                    break;
+                }
+                case param_type::uuid:
+                    if (!path_params::is_uuid(actual)) {
+                        return false;
+                    }
+                    out.add(param_names[param_index], actual);
+                    break;
+                case param_type::any:
+                    out.add(param_names[param_index], actual);
+                    break;
+                }
                 ++param_index;
             }
         }
@@ -215,15 +314,18 @@ struct path_pattern {
         return match_segments(parts, split.count, out);
     }
 
+    /// Literals dominate, then typed parameters (so `/users/{id:int}` wins over
+    /// `/users/{name}` for `/users/42`), then fewer parameters.
     [[nodiscard]] int specificity_score() const noexcept {
-        return static_cast<int>(literal_count * 16 + (MAX_ROUTE_SEGMENTS - param_count));
+        return static_cast<int>(literal_count * 1024 + typed_count * 32 +
+                                (MAX_ROUTE_SEGMENTS - param_count));
     }
 };
 
-using handler_fn = inplace_function<result<response>(const request&, request_context&), 160>;
+using handler_fn = copyable_small_function<result<response>(const request&, request_context&), 160>;
 using next_fn = function_ref<result<response>()>;
 using middleware_fn =
-    inplace_function<result<response>(const request&, request_context&, next_fn), 160>;
+    copyable_small_function<result<response>(const request&, request_context&, next_fn), 160>;
 
 struct middleware_chain {
     const middleware_fn* ptr{nullptr};
@@ -265,11 +367,19 @@ constexpr middleware_chain make_middleware_chain(const std::array<middleware_fn,
     return middleware_chain{middlewares.data(), N};
 }
 
+/// Admission class of a route. Under overload `low` routes are shed first, `normal` routes
+/// once queueing delay stays above target, `critical` routes (health checks, control plane)
+/// are never shed.
+enum class route_priority : uint8_t { critical, normal, low };
+
 struct route_entry {
     http::method method;
     path_pattern pattern;
     handler_fn handler;
     middleware_chain middleware{};
+    route_priority priority{route_priority::normal};
+    // Run on the server's offload pool instead of the reactor thread (CPU-heavy handlers)
+    bool offload{false};
 };
 
 inline constexpr uint32_t method_bit(http::method m) noexcept {
@@ -323,6 +433,16 @@ public:
     explicit router(std::span<const route_entry> routes) : routes_(routes) {}
 
     dispatch_result dispatch_with_info(const request& req, request_context& ctx) const {
+        return dispatch_with_info(req, ctx, [](const route_entry&) noexcept { return true; });
+    }
+
+    /// Same as above, but asks `admit(route)` before running the matched route. A rejected
+    /// request returns error_code::request_shed without touching middleware or handler;
+    /// ctx.params, ctx.query and ctx.cookies are already set up so the caller may still run
+    /// the route elsewhere.
+    template <typename AdmitFn>
+    dispatch_result
+    dispatch_with_info(const request& req, request_context& ctx, AdmitFn&& admit) const {
         auto path = strip_query(req.uri);
         auto split = path_pattern::split_path(path);
         if (split.overflow) {
@@ -369,6 +489,16 @@ public:
         }
 
         ctx.params = best_params;
+        ctx.query.assign(query_string(req.uri), param_index::format::query, &ctx.arena);
+        ctx.cookies.assign(
+            req.headers.get(field::cookie).value_or(std::string_view{}),
+            param_index::format::cookie,
+            &ctx.arena);
+        if (!admit(*best_route)) {
+            return dispatch_result{
+                std::unexpected(make_error_code(error_code::request_shed)), true, 0};
+        }
+
         return dispatch_result{
             best_route->middleware.run(req, ctx, best_route->handler), true, allowed_methods_mask};
     }
@@ -409,6 +539,8 @@ inline response map_dispatch_error(dispatch_result result) {
         }
         return res;
     }
+    case error_code::request_shed:
+        return response::error(problem_details::service_unavailable());
     default:
         return response::error(problem_details::internal_server_error());
     }
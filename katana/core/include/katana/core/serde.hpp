@@ -1,9 +1,16 @@
 #pragma once
 
+#include "arena.hpp"
+#include "json_index.hpp"
+#include "key_table.hpp"
+#include "simd_utils.hpp"
+
 #include <algorithm>
 #include <cctype>
 #include <charconv>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,19 +31,30 @@ inline std::string_view trim_view(std::string_view sv) noexcept {
     return sv;
 }
 
+inline constexpr bool is_json_ws(char c) noexcept {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/// Forward-only JSON reader. With a structural index (see json_index.hpp) string() finds the
+/// closing quote and skip_value() jumps over whole objects/arrays without touching their bytes;
+/// without one it scans, using SIMD to find string terminators.
 struct json_cursor {
     const char* ptr;
     const char* end;
     const char* start; // Track start for position calculation
+    const json_structural_index* index = nullptr;
+    size_t hint = 0; // last structural entry looked up, speeds up forward seeks
 
     json_cursor(const char* p, const char* e) : ptr(p), end(e), start(p) {}
+    json_cursor(const char* p, const char* e, const json_structural_index* idx) noexcept
+        : ptr(p), end(e), start(p), index(idx && idx->covers(p, e) ? idx : nullptr) {}
 
     bool eof() const noexcept { return ptr >= end; }
 
     size_t pos() const noexcept { return static_cast<size_t>(ptr - start); }
 
     void skip_ws() noexcept {
-        while (!eof() && std::isspace(static_cast<unsigned char>(*ptr))) {
+        while (!eof() && is_json_ws(*ptr)) {
             ++ptr;
         }
     }
@@ -50,28 +68,49 @@ struct json_cursor {
         return true;
     }
 
+    /// Raw body of the next string, escapes left as written. Use it for keys and other text
+    /// that is only compared; unescaped_string() decodes values.
     std::optional<std::string_view> string() noexcept {
         skip_ws();
         if (eof() || *ptr != '\"') {
             return std::nullopt;
         }
-        ++ptr;
-        const char* str_start = ptr;
-        while (!eof() && *ptr != '\"') {
-            if (*ptr == '\\' && (ptr + 1) < end) {
-                ptr += 2;
-                continue;
+        const char* str_start = ptr + 1;
+        if (index) {
+            // The entry after an opening quote is always its closing quote
+            size_t entry = entry_at_ptr();
+            if (entry + 1 < index->size()) {
+                const char* stop = index->base() + index->position(entry + 1);
+                if (stop >= end) {
+                    ptr = end;
+                    return std::nullopt;
+                }
+                ptr = stop + 1;
+                hint = entry + 2;
+                return std::string_view(str_start, static_cast<size_t>(stop - str_start));
             }
-            ++ptr;
         }
-        if (eof()) {
-            return std::nullopt;
+
+        ptr = str_start;
+        while (!eof()) {
+            const char* hit = simd::find_quote_or_backslash(ptr, static_cast<size_t>(end - ptr));
+            if (!hit) {
+                ptr = end;
+                return std::nullopt;
+            }
+            if (*hit == '\\') {
+                ptr = std::min(hit + 2, end);
+                continue;
+            }
+            ptr = hit + 1; // consume closing quote
+            return std::string_view(str_start, static_cast<size_t>(hit - str_start));
         }
-        const char* stop = ptr;
-        ++ptr; // consume closing quote
-        return std::string_view(str_start, static_cast<size_t>(stop - str_start));
+        return std::nullopt;
     }
 
+    /// Next string with escapes decoded; see unescape_json_string() for where the text lives.
+    std::optional<std::string_view> unescaped_string(monotonic_arena& arena);
+
     bool try_object_start() noexcept { return consume('{'); }
     bool try_object_end() noexcept { return consume('}'); }
     bool try_array_start() noexcept { return consume('['); }
@@ -80,33 +119,39 @@ struct json_cursor {
 
     void skip_value() noexcept {
         skip_ws();
-        if (try_object_start()) {
-            int depth = 1;
-            while (!eof() && depth > 0) {
-                if (try_object_start()) {
-                    ++depth;
-                } else if (try_object_end()) {
-                    --depth;
-                } else {
-                    ++ptr;
-                }
-            }
+        if (eof()) {
             return;
         }
-        if (try_array_start()) {
-            int depth = 1;
-            while (!eof() && depth > 0) {
-                if (try_array_start()) {
+        if (*ptr == '{' || *ptr == '[') {
+            if (index) {
+                size_t entry = entry_at_ptr();
+                if (entry < index->size()) {
+                    const uint32_t close = index->match(entry);
+                    const char* stop = index->base() + index->position(close);
+                    ptr = stop < end ? stop + 1 : end;
+                    hint = close + 1;
+                    return;
+                }
+            }
+            int depth = 0;
+            while (!eof()) {
+                const char c = *ptr;
+                if (c == '\"') {
+                    if (!string()) {
+                        return;
+                    }
+                    continue;
+                }
+                ++ptr;
+                if (c == '{' || c == '[') {
                     ++depth;
-                } else if (try_array_end()) {
-                    --depth;
-                } else {
-                    ++ptr;
+                } else if ((c == '}' || c == ']') && --depth == 0) {
+                    return;
                 }
             }
             return;
         }
-        if (!eof() && *ptr == '\"') {
+        if (*ptr == '\"') {
             (void)string();
             return;
         }
@@ -114,6 +159,71 @@ struct json_cursor {
             ++ptr;
         }
     }
+
+private:
+    // Index entry of the structural character under ptr; index->size() when ptr is not on one.
+    size_t entry_at_ptr() noexcept {
+        const auto offset = static_cast<uint32_t>(ptr - index->base());
+        hint = index->seek(offset, hint);
+        if (hint < index->size() && index->position(hint) == offset) {
+            return hint;
+        }
+        return index->size();
+    }
+};
+
+/// Cursor over `json` backed by the calling thread's structural index.
+///
+/// The outermost scope on a thread indexes the document (when it is at least
+/// json_index_min_size bytes); nested scopes over a slice of the same document, as generated
+/// parsers create for sub-objects and array items, reuse that index instead of rebuilding it.
+class indexed_json_scope {
+public:
+    explicit indexed_json_scope(std::string_view json) noexcept : json_(json) {
+        auto& slot = detail::thread_json_index_slot();
+        if (slot.active) {
+            if (slot.index.covers(json.data(), json.data() + json.size())) {
+                index_ = &slot.index;
+            }
+            return;
+        }
+        if (json.size() < json_index_min_size) {
+            return;
+        }
+        try {
+            if (slot.index.build(json)) {
+                slot.active = true;
+                owner_ = true;
+                index_ = &slot.index;
+                return;
+            }
+        } catch (...) {
+            // Out of memory while indexing: parse unindexed
+        }
+        slot.index.shrink(json_index_retained_entries);
+    }
+
+    ~indexed_json_scope() {
+        if (owner_) {
+            auto& slot = detail::thread_json_index_slot();
+            slot.active = false;
+            slot.index.shrink(json_index_retained_entries);
+        }
+    }
+
+    indexed_json_scope(const indexed_json_scope&) = delete;
+    indexed_json_scope& operator=(const indexed_json_scope&) = delete;
+
+    [[nodiscard]] json_cursor cursor() const noexcept {
+        return json_cursor{json_.data(), json_.data() + json_.size(), index_};
+    }
+
+    [[nodiscard]] bool indexed() const noexcept { return index_ != nullptr; }
+
+private:
+    std::string_view json_;
+    const json_structural_index* index_ = nullptr;
+    bool owner_ = false;
 };
 
 inline std::optional<size_t> parse_size(json_cursor& cur) noexcept {
@@ -151,6 +261,64 @@ inline std::optional<size_t> parse_size(json_cursor& cur) noexcept {
     return value;
 }
 
+/// Signed integer at the cursor, parsed in place. Values outside int64_t and numbers with a
+/// fraction or exponent are rejected without moving the cursor, so the caller can
+/// skip_value(). Quoted integers ("42") are accepted like in parse_size().
+inline std::optional<int64_t> parse_int64(json_cursor& cur) noexcept {
+    cur.skip_ws();
+    if (cur.eof()) {
+        return std::nullopt;
+    }
+    if (*cur.ptr == '\"') {
+        if (auto sv = cur.string()) {
+            int64_t value = 0;
+            const char* last = sv->data() + sv->size();
+            auto fc = std::from_chars(sv->data(), last, value);
+            if (fc.ec == std::errc() && fc.ptr == last) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+    const char* p = cur.ptr;
+    const bool negative = *p == '-';
+    if (negative) {
+        ++p;
+    }
+    const char* digits = p;
+    uint64_t magnitude = 0;
+    for (; p < cur.end && static_cast<unsigned char>(*p - '0') <= 9; ++p) {
+        if (__builtin_mul_overflow(magnitude, uint64_t{10}, &magnitude) ||
+            __builtin_add_overflow(magnitude, static_cast<uint64_t>(*p - '0'), &magnitude)) {
+            return std::nullopt;
+        }
+    }
+    if (p == digits || (p < cur.end && (*p == '.' || *p == 'e' || *p == 'E'))) {
+        return std::nullopt;
+    }
+    const uint64_t limit = negative ? uint64_t{1} << 63 : uint64_t{INT64_MAX};
+    if (magnitude > limit) {
+        return std::nullopt;
+    }
+    cur.ptr = p;
+    return negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+}
+
+namespace detail {
+
+inline constexpr double exact_powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+} // namespace detail
+
+/// Number at the cursor, parsed in place: no locale, no NUL terminator, no strtod. Decimals
+/// with at most 18 significant digits, a mantissa below 2^53 and |exponent| <= 22 are
+/// converted exactly with a single multiply or divide (Clinger's fast path), which covers
+/// typical telemetry values. Anything else goes to std::from_chars, whose libstdc++
+/// implementation is fast_float's Eisel-Lemire with a big-number fallback. Input that is not
+/// a JSON number, and values outside the range of double, yield nullopt.
 inline std::optional<double> parse_double(json_cursor& cur) noexcept {
     cur.skip_ws();
     if (cur.eof()) {
@@ -159,26 +327,92 @@ inline std::optional<double> parse_double(json_cursor& cur) noexcept {
     if (*cur.ptr == '\"') {
         if (auto sv = cur.string()) {
             double val = 0.0;
-            auto [p, ec] = std::from_chars(sv->data(), sv->data() + sv->size(), val);
-            if (ec == std::errc()) {
-                return val;
-            }
-            char* endptr = nullptr;
-            val = std::strtod(sv->data(), &endptr);
-            if (endptr != sv->data()) {
+            const char* last = sv->data() + sv->size();
+            auto [p, ec] = std::from_chars(sv->data(), last, val);
+            if (ec == std::errc() && p == last) {
                 return val;
             }
         }
         return std::nullopt;
     }
-    const char* start = cur.ptr;
-    char* endptr = nullptr;
-    double v = std::strtod(start, &endptr);
-    if (endptr == start) {
+
+    // -?digits(.digits)?([eE][+-]?digits)?
+    constexpr uint64_t mantissa_cap = 100'000'000'000'000'000ULL; // 10^17: room for one more
+    const char* const end = cur.end;
+    const char* const start = cur.ptr;
+    const char* p = start;
+    const bool negative = *p == '-';
+    if (negative) {
+        ++p;
+    }
+    auto is_digit = [end](const char* q) {
+        return q < end && static_cast<unsigned char>(*q - '0') <= 9;
+    };
+
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+    bool truncated = false;
+    const char* int_digits = p;
+    for (; is_digit(p); ++p) {
+        if (mantissa < mantissa_cap) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        } else {
+            truncated = true;
+        }
+    }
+    if (p == int_digits) {
         return std::nullopt;
     }
-    cur.ptr = endptr;
-    return v;
+    if (p < end && *p == '.') {
+        const char* frac_digits = ++p;
+        for (; is_digit(p); ++p) {
+            if (mantissa < mantissa_cap) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                --exponent;
+            } else {
+                truncated = true;
+            }
+        }
+        if (p == frac_digits) {
+            return std::nullopt;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negative_exponent = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        const char* exp_digits = p;
+        int64_t e = 0;
+        for (; is_digit(p); ++p) {
+            e = std::min<int64_t>(e * 10 + (*p - '0'), 100'000);
+        }
+        if (p == exp_digits) {
+            return std::nullopt;
+        }
+        exponent += negative_exponent ? -e : e;
+    }
+
+    double value = 0.0;
+    if (!truncated && mantissa <= (uint64_t{1} << 53) && exponent >= -22 && exponent <= 22) {
+        value = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            value /= detail::exact_powers_of_ten[-exponent];
+        } else {
+            value *= detail::exact_powers_of_ten[exponent];
+        }
+        if (negative) {
+            value = -value;
+        }
+    } else {
+        auto [last, ec] = std::from_chars(start, p, value);
+        if (ec != std::errc() || last != p) {
+            return std::nullopt;
+        }
+    }
+    cur.ptr = p;
+    return value;
 }
 
 inline std::optional<bool> parse_bool(json_cursor& cur) noexcept {
@@ -254,31 +488,204 @@ struct yaml_node {
     }
 };
 
-inline std::string escape_json_string(std::string_view sv) {
-    std::string out;
-    out.reserve(sv.size() + 8);
-    for (char c : sv) {
+/// Worst-case growth of escape_json_into: a control character becomes a six-byte \u00XX.
+inline constexpr size_t json_escape_max_expansion = 6;
+
+/// Write `sv` escaped for use inside a JSON string (no surrounding quotes) to `out`, which
+/// must have room for sv.size() * json_escape_max_expansion bytes. Returns the end. Runs
+/// without anything to escape, found 16-32 bytes at a time, are copied with one memcpy.
+inline char* escape_json_into(std::string_view sv, char* out) noexcept {
+    static constexpr char hex[] = "0123456789abcdef";
+    const char* p = sv.data();
+    const char* const end = p + sv.size();
+    while (p < end) {
+        const char* hit = simd::find_json_escape_char(p, static_cast<size_t>(end - p));
+        const char* run_end = hit ? hit : end;
+        std::memcpy(out, p, static_cast<size_t>(run_end - p));
+        out += run_end - p;
+        if (!hit) {
+            break;
+        }
+        p = hit + 1;
+        *out++ = '\\';
+        const auto c = static_cast<unsigned char>(*hit);
         switch (c) {
         case '\\':
-            out += "\\\\";
-            break;
-        case '\"':
-            out += "\\\"";
+        case '"':
+            *out++ = static_cast<char>(c);
             break;
         case '\n':
-            out += "\\n";
+            *out++ = 'n';
             break;
         case '\r':
-            out += "\\r";
+            *out++ = 'r';
             break;
         case '\t':
-            out += "\\t";
+            *out++ = 't';
+            break;
+        case '\b':
+            *out++ = 'b';
+            break;
+        case '\f':
+            *out++ = 'f';
             break;
         default:
-            out.push_back(c);
+            std::memcpy(out, "u00", 3);
+            out[3] = hex[c >> 4];
+            out[4] = hex[c & 0xF];
+            out += 5;
+            break;
+        }
+    }
+    return out;
+}
+
+namespace detail {
+
+inline bool parse_hex4(const char* p, const char* end, uint32_t& out) noexcept {
+    if (end - p < 4) {
+        return false;
+    }
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) {
+        const auto c = static_cast<unsigned char>(p[i]);
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+            digit = (c | 0x20U) - 'a' + 10;
+        } else {
+            return false;
+        }
+        v = (v << 4) | digit;
+    }
+    out = v;
+    return true;
+}
+
+inline char* encode_utf8(uint32_t cp, char* out) noexcept {
+    if (cp < 0x80) {
+        *out++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (cp >> 6));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<char>(0xF0 | (cp >> 18));
+        *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+} // namespace detail
+
+/// Decode the escapes in the body of a JSON string (as returned by json_cursor::string()) into
+/// `out`, which needs raw.size() bytes: no escape decodes to more bytes than it spans. \uXXXX
+/// becomes UTF-8 and surrogate pairs are combined. Returns the end, or nullptr for an unknown
+/// escape, bad hex digits or an unpaired surrogate.
+inline char* unescape_json_into(std::string_view raw, char* out) noexcept {
+    const char* p = raw.data();
+    const char* const end = p + raw.size();
+    while (p < end) {
+        const auto* slash = static_cast<const char*>(
+            std::memchr(p, '\\', static_cast<size_t>(end - p)));
+        const char* run_end = slash ? slash : end;
+        std::memcpy(out, p, static_cast<size_t>(run_end - p));
+        out += run_end - p;
+        if (!slash) {
             break;
         }
+        p = slash + 1;
+        if (p == end) {
+            return nullptr;
+        }
+        switch (*p++) {
+        case '"':
+            *out++ = '"';
+            break;
+        case '\\':
+            *out++ = '\\';
+            break;
+        case '/':
+            *out++ = '/';
+            break;
+        case 'b':
+            *out++ = '\b';
+            break;
+        case 'f':
+            *out++ = '\f';
+            break;
+        case 'n':
+            *out++ = '\n';
+            break;
+        case 'r':
+            *out++ = '\r';
+            break;
+        case 't':
+            *out++ = '\t';
+            break;
+        case 'u': {
+            uint32_t cp;
+            if (!detail::parse_hex4(p, end, cp)) {
+                return nullptr;
+            }
+            p += 4;
+            if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                return nullptr;
+            }
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                uint32_t low;
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u' ||
+                    !detail::parse_hex4(p + 2, end, low) || low < 0xDC00 || low > 0xDFFF) {
+                    return nullptr;
+                }
+                p += 6;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            }
+            out = detail::encode_utf8(cp, out);
+            break;
+        }
+        default:
+            return nullptr;
+        }
+    }
+    return out;
+}
+
+/// Decoded value of a raw JSON string body. Without escapes this is `raw` itself and nothing
+/// is copied; otherwise the text is decoded into `arena` and lives as long as it does.
+/// nullopt for malformed escapes.
+inline std::optional<std::string_view> unescape_json_string(std::string_view raw,
+                                                            monotonic_arena& arena) {
+    if (std::memchr(raw.data(), '\\', raw.size()) == nullptr) {
+        return raw;
     }
+    char* first = static_cast<char*>(arena.allocate(raw.size(), 1));
+    char* last = first ? unescape_json_into(raw, first) : nullptr;
+    if (!last) {
+        return std::nullopt;
+    }
+    return std::string_view(first, static_cast<size_t>(last - first));
+}
+
+inline std::optional<std::string_view> json_cursor::unescaped_string(monotonic_arena& arena) {
+    auto raw = string();
+    if (!raw) {
+        return std::nullopt;
+    }
+    return unescape_json_string(*raw, arena);
+}
+
+inline std::string escape_json_string(std::string_view sv) {
+    std::string out;
+    out.resize_and_overwrite(sv.size() * json_escape_max_expansion, [sv](char* p, size_t) {
+        return static_cast<size_t>(escape_json_into(sv, p) - p);
+    });
     return out;
 }
 
@@ -100,6 +100,89 @@ inline const char* find_crlf(const char* data, size_t len) noexcept {
 #endif
 }
 
+/// First '"' or '\\' in [data, data + len), nullptr if none. Used to scan JSON strings.
+inline const char* find_quote_or_backslash(const char* data, size_t len) noexcept {
+    size_t i = 0;
+#ifdef KATANA_HAS_AVX2
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32),
+                                       _mm256_cmpeq_epi8(chunk, backslash32));
+        const auto mask_bits = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+        if (mask_bits != 0U) {
+            return data + i + static_cast<size_t>(__builtin_ctz(mask_bits));
+        }
+    }
+#endif
+#ifdef KATANA_HAS_SSE2
+    const __m128i quote16 = _mm_set1_epi8('"');
+    const __m128i backslash16 = _mm_set1_epi8('\\');
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits =
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote16), _mm_cmpeq_epi8(chunk, backslash16));
+        const auto mask_bits = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+        if (mask_bits != 0U) {
+            return data + i + static_cast<size_t>(__builtin_ctz(mask_bits));
+        }
+    }
+#endif
+    for (; i < len; ++i) {
+        if (data[i] == '"' || data[i] == '\\') {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
+/// First byte that must be escaped inside a JSON string ('"', '\\' or a control character
+/// below 0x20) in [data, data + len), nullptr if none.
+inline const char* find_json_escape_char(const char* data, size_t len) noexcept {
+    size_t i = 0;
+#ifdef KATANA_HAS_AVX2
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i control32 = _mm256_set1_epi8(0x1F);
+    for (; i + 32 <= len; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        // max(c, 0x1F) == 0x1F exactly for the unsigned bytes 0x00..0x1F
+        __m256i control = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control32), control32);
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote32),
+                                                       _mm256_cmpeq_epi8(chunk, backslash32)),
+                                       control);
+        const auto mask_bits = static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+        if (mask_bits != 0U) {
+            return data + i + static_cast<size_t>(__builtin_ctz(mask_bits));
+        }
+    }
+#endif
+#ifdef KATANA_HAS_SSE2
+    const __m128i quote16 = _mm_set1_epi8('"');
+    const __m128i backslash16 = _mm_set1_epi8('\\');
+    const __m128i control16 = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control16), control16);
+        __m128i hits = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote16), _mm_cmpeq_epi8(chunk, backslash16)),
+            control);
+        const auto mask_bits = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+        if (mask_bits != 0U) {
+            return data + i + static_cast<size_t>(__builtin_ctz(mask_bits));
+        }
+    }
+#endif
+    for (; i < len; ++i) {
+        const auto c = static_cast<unsigned char>(data[i]);
+        if (c == '"' || c == '\\' || c < 0x20) {
+            return data + i;
+        }
+    }
+    return nullptr;
+}
+
 inline const void*
 find_pattern(const void* haystack, size_t hlen, const void* needle, size_t nlen) noexcept {
     if (nlen == 0 || hlen < nlen)
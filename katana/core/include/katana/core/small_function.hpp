@@ -0,0 +1,262 @@
+#pragma once
+
+#include "inplace_function.hpp"
+#include "memory_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace katana {
+
+enum class overflow_policy : uint8_t {
+    pool, // callables that do not fit inline go to a block from memory_pool
+    error // compile error naming the callable size and the capacity
+};
+
+enum class copy_policy : uint8_t {
+    move_only, // accepts move-only callables; the function itself can only be moved
+    copyable   // copies the callable, a pooled one into a block of its own
+};
+
+namespace detail {
+
+/// Out-of-line blocks for threads without a memory_pool: a per-thread free list per power-of-two
+/// size class, so a steady stream of large captures stops reaching operator new. Blocks may be
+/// freed on any thread and join that thread's list.
+void* allocate_function_block(size_t size);
+void free_function_block(void* block, size_t size) noexcept;
+
+} // namespace detail
+
+template <typename Signature,
+          size_t Capacity = 64,
+          overflow_policy Overflow = overflow_policy::pool,
+          copy_policy Copy = copy_policy::move_only>
+class small_function;
+
+/// Copyable small_function, for callbacks that are stored in tables and copied
+template <typename Signature, size_t Capacity = 64>
+using copyable_small_function =
+    small_function<Signature, Capacity, overflow_policy::pool, copy_policy::copyable>;
+
+/// Type-erased callable. Callables of up to `Capacity` bytes that are nothrow-movable live
+/// inline; larger ones are moved into a block from the calling thread's memory_pool, or from a
+/// per-thread block cache on threads without one, so a capture that outgrows the capacity
+/// costs a free-list pop instead of a compile error or a make_shared around the state. Pooled
+/// blocks may be released on any thread.
+///
+/// Move-only by default, which also accepts callables that own move-only state (unique_ptr,
+/// buffers) that inplace_function rejects; copy_policy::copyable requires copyable callables
+/// instead. Like inplace_function it invokes the callable as const.
+template <typename R, typename... Args, size_t Capacity, overflow_policy Overflow, copy_policy Copy>
+class small_function<R(Args...), Capacity, Overflow, Copy> {
+    static_assert(Capacity >= sizeof(void*), "capacity must hold at least a pointer");
+
+    static constexpr bool copyable = Copy == copy_policy::copyable;
+
+public:
+    static constexpr size_t capacity = Capacity;
+
+    /// Whether `F` is stored inline rather than in a pooled block
+    template <typename F>
+    static constexpr bool stored_inline =
+        sizeof(std::decay_t<F>) <= Capacity &&
+        alignof(std::decay_t<F>) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<std::decay_t<F>>;
+
+    small_function() noexcept = default;
+    small_function(std::nullptr_t) noexcept {}
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_function> &&
+                                          !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    small_function(F&& f) {
+        using T = std::decay_t<F>;
+        static_assert(std::is_invocable_r_v<R, const T&, Args...>, "Callable not compatible");
+        static_assert(!copyable || std::is_copy_constructible_v<T>,
+                      "Callable must be copy constructible");
+
+        if constexpr (stored_inline<T>) {
+            new (&storage_) T(std::forward<F>(f));
+            vtable_ = &inline_vtable<T>;
+        } else {
+            if constexpr (Overflow == overflow_policy::error) {
+                static_assert(detail::check_inline_capacity<T, Capacity>());
+                static_assert(alignof(T) <= alignof(std::max_align_t),
+                              "Callable alignment too strict for inline storage");
+                static_assert(std::is_nothrow_move_constructible_v<T>,
+                              "Inline callables must be nothrow move constructible");
+            }
+            static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                          "Callable alignment too strict for an out-of-line block");
+
+            new (&storage_) T*(make_pooled<T>(std::forward<F>(f)));
+            vtable_ = &pooled_vtable<T>;
+        }
+    }
+
+    small_function(small_function&& other) noexcept { take(other); }
+
+    small_function(const small_function& other)
+        requires copyable
+    {
+        if (other.vtable_) {
+            other.vtable_->copy(&storage_, &other.storage_);
+            vtable_ = other.vtable_;
+        }
+    }
+
+    ~small_function() { reset(); }
+
+    small_function& operator=(const small_function& other)
+        requires copyable
+    {
+        if (this != &other) {
+            small_function copy(other);
+            reset();
+            take(copy);
+        }
+        return *this;
+    }
+
+    small_function& operator=(small_function&& other) noexcept {
+        if (this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    small_function& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, small_function> &&
+                                          !std::is_same_v<std::decay_t<F>, std::nullptr_t>>>
+    small_function& operator=(F&& f) {
+        *this = small_function(std::forward<F>(f));
+        return *this;
+    }
+
+    R operator()(Args... args) const {
+        return vtable_->invoke(&storage_, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+    /// False for an empty function and for callables kept in a pooled block
+    [[nodiscard]] bool is_inline() const noexcept { return vtable_ && vtable_->inline_storage; }
+
+private:
+    using copy_fn = void (*)(void* dst, const void* src);
+
+    struct vtable_t {
+        R (*invoke)(const void* storage, Args... args);
+        void (*move)(void* dst, void* src) noexcept; // leaves `src` destroyed
+        void (*destroy)(void* storage) noexcept;
+        copy_fn copy; // nullptr unless copyable
+        bool inline_storage;
+    };
+
+    // glibc's aligned_alloc is several times slower than malloc, and callables rarely need more
+    // than the default alignment, so threads without a pool use the operator new backed cache
+    static void* allocate_block(size_t size) {
+        if (void* block = memory_pool::try_allocate(size)) {
+            return block;
+        }
+        return detail::allocate_function_block(size);
+    }
+
+    static void deallocate_block(void* block, size_t size) noexcept {
+        if (memory_pool::owner_of(block)) {
+            memory_pool::deallocate(block, size);
+        } else {
+            detail::free_function_block(block, size);
+        }
+    }
+
+    template <typename T, typename... CtorArgs> static T* make_pooled(CtorArgs&&... args) {
+        void* block = allocate_block(sizeof(T));
+        try {
+            return new (block) T(std::forward<CtorArgs>(args)...);
+        } catch (...) {
+            deallocate_block(block, sizeof(T));
+            throw;
+        }
+    }
+
+    template <typename T> static constexpr copy_fn inline_copy() noexcept {
+        if constexpr (copyable) {
+            return [](void* dst, const void* src) { new (dst) T(*static_cast<const T*>(src)); };
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename T> static constexpr copy_fn pooled_copy() noexcept {
+        if constexpr (copyable) {
+            return [](void* dst, const void* src) {
+                new (dst) T*(make_pooled<T>(std::as_const(*pooled<T>(src))));
+            };
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename T>
+    static constexpr vtable_t inline_vtable = {
+        [](const void* storage, Args... args) -> R {
+            return (*static_cast<const T*>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        },
+        [](void* storage) noexcept { static_cast<T*>(storage)->~T(); },
+        inline_copy<T>(),
+        true};
+
+    template <typename T> static T* pooled(const void* storage) noexcept {
+        return *static_cast<T* const*>(storage);
+    }
+
+    // The storage holds only the pointer, so moving never touches the callable
+    template <typename T>
+    static constexpr vtable_t pooled_vtable = {
+        [](const void* storage, Args... args) -> R {
+            return (*pooled<T>(storage))(std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept { new (dst) T*(pooled<T>(src)); },
+        [](void* storage) noexcept {
+            T* callable = pooled<T>(storage);
+            callable->~T();
+            deallocate_block(callable, sizeof(T));
+        },
+        pooled_copy<T>(),
+        false};
+
+    void take(small_function& other) noexcept {
+        if (other.vtable_) {
+            other.vtable_->move(&storage_, &other.storage_);
+            vtable_ = other.vtable_;
+            other.vtable_ = nullptr;
+        }
+    }
+
+    void reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy(&storage_);
+            vtable_ = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) std::byte storage_[Capacity];
+    const vtable_t* vtable_ = nullptr;
+};
+
+} // namespace katana
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <string_view>
+#include <type_traits>
 
 namespace katana {
 
@@ -76,4 +80,189 @@ struct validation_error {
     }
 };
 
+// Checks behind the OpenAPI string formats the generated validators and parsers enforce.
+
+inline constexpr bool is_valid_email(std::string_view v) noexcept {
+    auto at = v.find('@');
+    if (at == std::string_view::npos || at == 0 || at + 1 >= v.size()) {
+        return false;
+    }
+    auto domain = v.substr(at + 1);
+    auto dot = domain.find('.');
+    return dot != std::string_view::npos && dot != 0 && dot + 1 < domain.size();
+}
+
+inline constexpr bool is_valid_uuid(std::string_view v) noexcept {
+    if (v.size() != 36) {
+        return false;
+    }
+    for (size_t i = 0; i < v.size(); ++i) {
+        const char c = v[i];
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (c != '-') {
+                return false;
+            }
+        } else if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace detail {
+
+constexpr bool is_digit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_datetime(std::string_view v, bool fraction_needs_digit) noexcept {
+    if (v.size() < 20) {
+        return false;
+    }
+    for (size_t i : {0u, 1u, 2u, 3u, 5u, 6u, 8u, 9u, 11u, 12u, 14u, 15u, 17u, 18u}) {
+        if (!is_digit(v[i])) {
+            return false;
+        }
+    }
+    if (v[4] != '-' || v[7] != '-' || v[10] != 'T' || v[13] != ':' || v[16] != ':') {
+        return false;
+    }
+    size_t pos = 19;
+    if (v[pos] == '.') {
+        ++pos;
+        if (pos >= v.size() || (fraction_needs_digit && !is_digit(v[pos]))) {
+            return false;
+        }
+        while (pos < v.size() && is_digit(v[pos])) {
+            ++pos;
+        }
+    }
+    if (pos >= v.size()) {
+        return false;
+    }
+    if (v[pos] == 'Z') {
+        return pos + 1 == v.size();
+    }
+    if (v[pos] == '+' || v[pos] == '-') {
+        return pos + 6 == v.size() && is_digit(v[pos + 1]) && is_digit(v[pos + 2]) &&
+               v[pos + 3] == ':' && is_digit(v[pos + 4]) && is_digit(v[pos + 5]);
+    }
+    return false;
+}
+
+} // namespace detail
+
+// RFC 3339 date-time: YYYY-MM-DDTHH:MM:SS[.frac](Z|+HH:MM|-HH:MM)
+inline constexpr bool is_valid_datetime(std::string_view v) noexcept {
+    return detail::is_datetime(v, false);
+}
+
+// Fixed-shape checkers katana_gen emits in place of a `pattern` that matches exactly the same
+// strings (besides is_valid_uuid, is_valid_email and is_valid_datetime above).
+
+// [0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}
+inline constexpr bool is_lowercase_uuid(std::string_view v) noexcept {
+    if (!is_valid_uuid(v)) {
+        return false;
+    }
+    for (const char c : v) {
+        if (c >= 'A' && c <= 'F') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// \d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d+)?(Z|[+-]\d{2}:\d{2})
+inline constexpr bool is_strict_datetime(std::string_view v) noexcept {
+    return detail::is_datetime(v, true);
+}
+
+// \d{4}-\d{2}-\d{2}
+inline constexpr bool is_iso_date(std::string_view v) noexcept {
+    return v.size() == 10 && detail::is_digit(v[0]) && detail::is_digit(v[1]) &&
+           detail::is_digit(v[2]) && detail::is_digit(v[3]) && v[4] == '-' &&
+           detail::is_digit(v[5]) && detail::is_digit(v[6]) && v[7] == '-' &&
+           detail::is_digit(v[8]) && detail::is_digit(v[9]);
+}
+
+// [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}
+inline constexpr bool is_common_email(std::string_view v) noexcept {
+    auto is_alpha = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+    const auto at = v.find('@');
+    if (at == 0 || at == std::string_view::npos) {
+        return false;
+    }
+    for (const char c : v.substr(0, at)) {
+        if (!is_alpha(c) && !detail::is_digit(c) && c != '.' && c != '_' && c != '%' &&
+            c != '+' && c != '-') {
+            return false;
+        }
+    }
+    // The top-level domain has no dots, so it starts after the last one
+    const auto domain = v.substr(at + 1);
+    const auto dot = domain.rfind('.');
+    if (dot == 0 || dot == std::string_view::npos || domain.size() - dot - 1 < 2) {
+        return false;
+    }
+    for (size_t i = 0; i < domain.size(); ++i) {
+        const char c = domain[i];
+        const bool allowed = i > dot ? is_alpha(c)
+                                     : is_alpha(c) || detail::is_digit(c) || c == '.' || c == '-';
+        if (!allowed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Byte range mapped to one input class of a pattern_dfa.
+struct pattern_byte_range {
+    uint8_t first;
+    uint8_t last;
+    uint8_t byte_class;
+};
+
+/// Deterministic automaton for an OpenAPI `pattern`, built by katana_gen at generation time.
+///
+/// Bytes are first mapped to one of `Classes` input classes (bytes outside every listed range
+/// are class 0), then the transition table is indexed by state and class. State 0 is the dead
+/// state and state 1 the start state, so matching is one table load per byte, stops at the
+/// first byte no match can continue from and never allocates.
+template <size_t States, size_t Classes> class pattern_dfa {
+public:
+    using state_type = std::conditional_t<(States <= 256), uint8_t, uint16_t>;
+
+    constexpr pattern_dfa(std::initializer_list<pattern_byte_range> ranges,
+                          const std::array<state_type, States * Classes>& next,
+                          std::initializer_list<state_type> accepting) noexcept
+        : next_(next) {
+        for (const auto& r : ranges) {
+            for (size_t b = r.first; b <= r.last; ++b) {
+                byte_class_[b] = r.byte_class;
+            }
+        }
+        for (const auto s : accepting) {
+            accepting_[s] = true;
+        }
+    }
+
+    /// Whole-string match, as std::regex_match.
+    [[nodiscard]] constexpr bool matches(std::string_view s) const noexcept {
+        size_t state = 1;
+        for (const char c : s) {
+            state = next_[state * Classes + byte_class_[static_cast<unsigned char>(c)]];
+            if (state == 0) {
+                return false;
+            }
+        }
+        return accepting_[state];
+    }
+
+private:
+    std::array<uint8_t, 256> byte_class_{};
+    std::array<state_type, States * Classes> next_{};
+    std::array<bool, States> accepting_{};
+};
+
 } // namespace katana
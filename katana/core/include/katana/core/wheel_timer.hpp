@@ -1,11 +1,14 @@
 #pragma once
 
-#include "inplace_function.hpp"
+#include "small_function.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <vector>
 
@@ -13,7 +16,7 @@ namespace katana {
 
 template <size_t NumSlots = 512, size_t SlotMs = 100> class wheel_timer {
 public:
-    using callback_fn = inplace_function<void(), 128>;
+    using callback_fn = small_function<void(), 128>;
     using timeout_id = uint64_t;
     using clock = std::chrono::steady_clock;
     using duration = std::chrono::milliseconds;
@@ -45,6 +48,10 @@ public:
         size_t slot_offset = ticks % WHEEL_SIZE;
         size_t target_slot = (current_slot_ + slot_offset) % WHEEL_SIZE;
         size_t rounds = ticks / WHEEL_SIZE;
+        // The current slot has been processed already; its next visit is a full turn away
+        if (slot_offset == 0) {
+            --rounds;
+        }
 
         uint32_t index = acquire_entry();
         auto& entry = entries_[index];
@@ -54,7 +61,16 @@ public:
         entry.active = true;
 
         slot_handle handle{index, entry.generation};
-        slots_[target_slot].handles.push_back(handle);
+        auto& bucket = slots_[target_slot];
+        bucket.handles.push_back(handle);
+        bucket.min_rounds = std::min(bucket.min_rounds, rounds);
+        set_bit(occupied_, target_slot);
+        if (rounds == 0) {
+            set_bit(due_, target_slot);
+        }
+        if (next_expiry_valid_) {
+            next_expiry_tick_ = std::min(next_expiry_tick_, tick_count_ + ticks);
+        }
 
         return make_id(handle);
     }
@@ -95,43 +111,32 @@ public:
 
     size_t pending_count() const { return pending_entries_; }
 
+    // Upper bound on the time until the next callback is due: cancellation is lazy, so a
+    // cancelled timeout can make the answer early, never late. The earliest expiry is cached
+    // as an absolute tick until it passes; recomputing it finds the nearest slot with a
+    // timeout due this turn in the `due_` bitmap, and only when there is none walks the
+    // occupied slots' minimum rounds. No call looks at individual timeouts.
     duration time_until_next_expiration(clock::time_point now = clock::now()) const {
         if (pending_entries_ == 0) {
             return duration::max();
         }
 
-        auto since_last_tick =
-            now > last_tick_ ? std::chrono::duration_cast<duration>(now - last_tick_) : duration{0};
-        auto base = duration(TICK_MS) - std::min(duration(TICK_MS), since_last_tick);
-
-        duration best = duration::max();
-        for (size_t slot = 0; slot < slots_.size(); ++slot) {
-            if (slots_[slot].handles.empty()) {
-                continue;
-            }
-
-            auto offset = slot >= current_slot_ ? slot - current_slot_
-                                                : (WHEEL_SIZE - (current_slot_ - slot));
-
-            for (const auto& handle : slots_[slot].handles) {
-                if (handle.index >= entries_.size()) {
-                    continue;
-                }
-                const auto& entry = entries_[handle.index];
-                if (!entry.active || entry.generation != handle.generation) {
-                    continue;
-                }
-
-                size_t total_ticks = offset + entry.remaining_rounds * WHEEL_SIZE;
-                duration candidate = base + duration(static_cast<int64_t>(total_ticks) *
-                                                     static_cast<int64_t>(TICK_MS));
-                if (candidate < best) {
-                    best = candidate;
-                }
+        if (!next_expiry_valid_) {
+            const size_t ticks = ticks_until_next_expiry();
+            if (ticks == NO_EXPIRY) {
+                return duration::max();
             }
+            next_expiry_tick_ = tick_count_ + ticks;
+            next_expiry_valid_ = true;
         }
 
-        return best;
+        auto since_last_tick =
+            now > last_tick_ ? std::chrono::duration_cast<duration>(now - last_tick_) : duration{0};
+        auto base = duration(TICK_MS) - std::min(duration(TICK_MS), since_last_tick);
+        // The first tick happens `base` from now and processes the next slot
+        const size_t ticks = next_expiry_tick_ - tick_count_;
+        return base +
+               duration(static_cast<int64_t>(ticks - 1) * static_cast<int64_t>(TICK_MS));
     }
 
 private:
@@ -142,8 +147,63 @@ private:
 
     struct slot_bucket {
         std::vector<slot_handle> handles;
+        // Fewest rounds left among the slot's live timeouts
+        size_t min_rounds{NO_EXPIRY};
     };
 
+    static constexpr size_t NO_EXPIRY = std::numeric_limits<size_t>::max();
+    static constexpr size_t BITMAP_WORDS = (WHEEL_SIZE + 63) / 64;
+    using slot_bitmap = std::array<uint64_t, BITMAP_WORDS>;
+
+    static void set_bit(slot_bitmap& bits, size_t slot) {
+        bits[slot / 64] |= uint64_t{1} << (slot % 64);
+    }
+    static void clear_bit(slot_bitmap& bits, size_t slot) {
+        bits[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    }
+
+    // First set slot at or after `from`, or WHEEL_SIZE
+    static size_t find_from(const slot_bitmap& bits, size_t from) {
+        size_t word = from / 64;
+        if (word >= BITMAP_WORDS) {
+            return WHEEL_SIZE;
+        }
+        uint64_t w = bits[word] & (~uint64_t{0} << (from % 64));
+        while (true) {
+            if (w != 0) {
+                return word * 64 + static_cast<size_t>(std::countr_zero(w));
+            }
+            if (++word == BITMAP_WORDS) {
+                return WHEEL_SIZE;
+            }
+            w = bits[word];
+        }
+    }
+
+    // Ticks until `slot` is processed: 1 for the next slot, a full turn for the current one
+    size_t slot_distance(size_t slot) const {
+        return (slot + WHEEL_SIZE - current_slot_ - 1) % WHEEL_SIZE + 1;
+    }
+
+    size_t ticks_until_next_expiry() const {
+        size_t slot = find_from(due_, current_slot_ + 1);
+        if (slot == WHEEL_SIZE) {
+            slot = find_from(due_, 0);
+        }
+        if (slot != WHEEL_SIZE) {
+            return slot_distance(slot);
+        }
+        // Nothing due this turn: the slot needing the fewest extra turns wins
+        size_t best = NO_EXPIRY;
+        for (size_t s = find_from(occupied_, 0); s < WHEEL_SIZE; s = find_from(occupied_, s + 1)) {
+            const size_t rounds = slots_[s].min_rounds;
+            if (rounds != NO_EXPIRY) {
+                best = std::min(best, slot_distance(s) + rounds * WHEEL_SIZE);
+            }
+        }
+        return best;
+    }
+
     struct entry_data {
         callback_fn callback;
         size_t remaining_rounds{0};
@@ -196,6 +256,10 @@ private:
 
     void advance_slot() {
         current_slot_ = (current_slot_ + 1) % WHEEL_SIZE;
+        ++tick_count_;
+        if (next_expiry_valid_ && tick_count_ >= next_expiry_tick_) {
+            next_expiry_valid_ = false;
+        }
         auto& bucket = slots_[current_slot_];
 
         if ((current_slot_ + 1) < WHEEL_SIZE) {
@@ -209,6 +273,9 @@ private:
         auto handles = std::move(bucket.handles);
         bucket.handles.clear();
         bucket.handles.reserve(handles.size());
+        // Callbacks below may add to this slot again; add() keeps min_rounds up to date
+        bucket.min_rounds = NO_EXPIRY;
+        size_t min_rounds = NO_EXPIRY;
 
         bool should_compact = (++compact_tick_counter_ % COMPACT_INTERVAL_TICKS) == 0;
 
@@ -238,6 +305,7 @@ private:
 
             if (entry.remaining_rounds > 0) {
                 --entry.remaining_rounds;
+                min_rounds = std::min(min_rounds, entry.remaining_rounds);
                 bucket.handles.push_back(handle);
                 continue;
             }
@@ -246,6 +314,16 @@ private:
             release_entry(handle.index);
             cb();
         }
+
+        bucket.min_rounds = std::min(bucket.min_rounds, min_rounds);
+        if (bucket.handles.empty()) {
+            clear_bit(occupied_, current_slot_);
+        }
+        if (bucket.min_rounds == 0) {
+            set_bit(due_, current_slot_);
+        } else {
+            clear_bit(due_, current_slot_);
+        }
     }
 
     std::vector<slot_bucket> slots_;
@@ -255,6 +333,11 @@ private:
     clock::time_point last_tick_;
     size_t pending_entries_{0};
     size_t compact_tick_counter_{0};
+    size_t tick_count_{0};
+    slot_bitmap occupied_{}; // slots with any handles, cancelled ones included
+    slot_bitmap due_{};      // slots with a live timeout that fires on their next visit
+    mutable size_t next_expiry_tick_{0};
+    mutable bool next_expiry_valid_{false};
 };
 
 } // namespace katana
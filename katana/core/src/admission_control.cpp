@@ -0,0 +1,85 @@
+#include "katana/core/admission_control.hpp"
+
+#include "katana/core/http.hpp"
+#include "katana/core/problem.hpp"
+
+#include <charconv>
+
+namespace katana::http {
+
+namespace {
+
+std::string serialize_shed_response(std::chrono::seconds retry_after, bool keep_alive) {
+    auto res =
+        response::error(problem_details::service_unavailable("Server overloaded, retry later"));
+    char retry_buf[21];
+    auto [ptr, ec] = std::to_chars(retry_buf, retry_buf + sizeof(retry_buf), retry_after.count());
+    res.set_header("Retry-After",
+                   std::string_view(retry_buf, static_cast<size_t>(ptr - retry_buf)));
+    res.set_header("Connection", keep_alive ? "keep-alive" : "close");
+    return res.serialize();
+}
+
+} // namespace
+
+admission_controller::admission_controller(const admission_config& config)
+    : config_(config), target_(config.target_delay), interval_(config.interval),
+      shed_keep_alive_(serialize_shed_response(config.retry_after, true)),
+      shed_close_(serialize_shed_response(config.retry_after, false)) {}
+
+void admission_controller::observe(clock::duration delay, clock::time_point now) noexcept {
+    if (delay < target_) {
+        above_target_ = false;
+        dropping_ = false;
+        return;
+    }
+    if (!above_target_) {
+        above_target_ = true;
+        first_above_ = now + interval_;
+        return;
+    }
+    if (!dropping_ && now >= first_above_) {
+        dropping_ = true;
+        metrics_.overload_episodes.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+admission_verdict admission_controller::admit(route_priority priority,
+                                              clock::time_point ready_at,
+                                              clock::time_point now) noexcept {
+    const auto delay = now > ready_at ? now - ready_at : clock::duration::zero();
+    observe(delay, now);
+
+    const auto delay_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(delay).count());
+    if (delay_us > max_delay_us_) {
+        max_delay_us_ = delay_us;
+        metrics_.queue_delay_max_us.store(delay_us, std::memory_order_relaxed);
+    }
+
+    if (priority != route_priority::critical) {
+        if (config_.max_in_flight != 0 && in_flight_ >= config_.max_in_flight) {
+            metrics_.shed_in_flight.fetch_add(1, std::memory_order_relaxed);
+            return admission_verdict::shed_in_flight;
+        }
+        const bool late = delay >= target_;
+        if (late && (dropping_ || priority == route_priority::low)) {
+            metrics_.requests_shed.fetch_add(1, std::memory_order_relaxed);
+            return admission_verdict::shed_delay;
+        }
+    }
+
+    ++in_flight_;
+    metrics_.in_flight.store(in_flight_, std::memory_order_relaxed);
+    metrics_.requests_admitted.fetch_add(1, std::memory_order_relaxed);
+    return admission_verdict::admit;
+}
+
+void admission_controller::complete() noexcept {
+    if (in_flight_ > 0) {
+        --in_flight_;
+    }
+    metrics_.in_flight.store(in_flight_, std::memory_order_relaxed);
+}
+
+} // namespace katana::http
@@ -0,0 +1,131 @@
+#include "katana/core/alloc_tracking.hpp"
+
+#ifdef KATANA_ALLOC_TRACKING
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace katana {
+namespace alloc_tracking {
+
+constinit thread_local thread_state current{};
+
+} // namespace alloc_tracking
+} // namespace katana
+
+#ifdef KATANA_ALLOC_TRACKING
+
+// Replacements for every form of the global operator new/delete. They allocate with malloc
+// (aligned_alloc above the default alignment) and count each call on the calling thread; the
+// library being static, they take over the whole program it is linked into.
+
+namespace {
+
+void* counted_malloc(std::size_t size, std::size_t alignment) noexcept {
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                    ? std::malloc(size)
+                    : std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+    if (ptr) {
+        katana::alloc_tracking::record_heap_allocation(size);
+    }
+    return ptr;
+}
+
+void* counted_new(std::size_t size, std::size_t alignment) {
+    while (true) {
+        if (void* ptr = counted_malloc(size, alignment)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* counted_new_nothrow(std::size_t size, std::size_t alignment) noexcept {
+    try {
+        return counted_new(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void counted_free(void* ptr) noexcept {
+    if (ptr) {
+        katana::alloc_tracking::record_heap_free();
+        std::free(ptr);
+    }
+}
+
+constexpr std::size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    return counted_new(size, DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t size) {
+    return counted_new(size, DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_new_nothrow(size, DEFAULT_ALIGNMENT);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return counted_new_nothrow(size, DEFAULT_ALIGNMENT);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_new(size, static_cast<std::size_t>(alignment));
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_new_nothrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return counted_new_nothrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    counted_free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    counted_free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    counted_free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    counted_free(ptr);
+}
+
+#endif // KATANA_ALLOC_TRACKING
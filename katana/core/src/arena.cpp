@@ -1,54 +1,122 @@
 #include "katana/core/arena.hpp"
+#include "katana/core/alloc_tracking.hpp"
+#include "katana/core/memory_pool.hpp"
 
 #include <algorithm>
-#include <cstdlib>
+#include <bit>
+#include <limits>
 #include <memory>
 #include <new>
 
 namespace katana {
 
-monotonic_arena::block::block(size_t s) noexcept : data(nullptr), size(s), used(0) {
-    constexpr size_t alignment = 64;
-    size_t aligned_size = (s + alignment - 1) & ~(alignment - 1);
-    data = static_cast<uint8_t*>(std::aligned_alloc(alignment, aligned_size));
+struct arena_cache_guard {
+    arena_block_cache& cache;
+
+    ~arena_cache_guard() {
+        cache.enabled_ = false;
+        cache.clear();
+    }
+};
+
+arena_block_cache& arena_block_cache::local() noexcept {
+    thread_local constinit arena_block_cache cache;
+    thread_local arena_cache_guard guard{cache};
+    (void)guard;
+    return cache;
 }
 
-monotonic_arena::block::~block() noexcept {
-    if (data) {
-        std::free(data);
+void* arena_block_cache::acquire(size_t size) noexcept {
+    const size_t block_size = block_size_for(size);
+    if (block_size <= MAX_CLASS_SIZE) {
+        auto& cls = classes_[class_index(block_size)];
+        if (cls.head) {
+            free_block* b = cls.head;
+            cls.head = b->next;
+            --cls.count;
+            cls.low_water = std::min(cls.low_water, cls.count);
+            --stats_.cached_blocks;
+            stats_.cached_bytes -= block_size;
+            ++stats_.hits;
+            return b;
+        }
     }
+    ++stats_.misses;
+    return memory_pool::allocate(block_size);
 }
 
-monotonic_arena::block::block(block&& other) noexcept
-    : data(other.data), size(other.size), used(other.used) {
-    other.data = nullptr;
-    other.size = 0;
-    other.used = 0;
+void arena_block_cache::release(void* data, size_t size) noexcept {
+    if (!data) {
+        return;
+    }
+    const bool cacheable =
+        size >= MIN_CLASS_SIZE && size <= MAX_CLASS_SIZE && std::has_single_bit(size);
+    // A block from another reactor's memory pool goes back to it instead of staying here
+    const bool local = memory_pool::owner_of(data) == memory_pool::current();
+    if (!enabled_ || !cacheable || !local || stats_.cached_bytes + size > max_cached_bytes_) {
+        ++stats_.frees;
+        memory_pool::deallocate(data, size);
+        return;
+    }
+    auto& cls = classes_[class_index(size)];
+    cls.head = new (data) free_block{cls.head};
+    ++cls.count;
+    ++stats_.cached_blocks;
+    stats_.cached_bytes += size;
+    ++stats_.returns;
 }
 
-monotonic_arena::block& monotonic_arena::block::operator=(block&& other) noexcept {
-    if (this != &other) {
-        if (data) {
-            std::free(data);
-        }
-        data = other.data;
-        size = other.size;
-        used = other.used;
-        other.data = nullptr;
-        other.size = 0;
-        other.used = 0;
+void arena_block_cache::free_cached(size_class& cls, size_t block_size, size_t count) noexcept {
+    for (; count > 0 && cls.head; --count) {
+        free_block* b = cls.head;
+        cls.head = b->next;
+        --cls.count;
+        --stats_.cached_blocks;
+        stats_.cached_bytes -= block_size;
+        ++stats_.frees;
+        memory_pool::deallocate(b, block_size);
+    }
+    cls.low_water = std::min(cls.low_water, cls.count);
+}
+
+size_t arena_block_cache::trim() noexcept {
+    const size_t before = stats_.cached_bytes;
+    for (size_t i = 0; i < NUM_CLASSES; ++i) {
+        auto& cls = classes_[i];
+        free_cached(cls, MIN_CLASS_SIZE << i, cls.low_water);
+        cls.low_water = cls.count;
+    }
+    return before - stats_.cached_bytes;
+}
+
+void arena_block_cache::clear() noexcept {
+    for (size_t i = 0; i < NUM_CLASSES; ++i) {
+        free_cached(classes_[i], MIN_CLASS_SIZE << i, classes_[i].count);
+    }
+}
+
+void arena_block_cache::set_max_cached_bytes(size_t bytes) noexcept {
+    max_cached_bytes_ = bytes;
+    // Largest blocks go first
+    for (size_t i = NUM_CLASSES; i-- > 0 && stats_.cached_bytes > bytes;) {
+        const size_t block_size = MIN_CLASS_SIZE << i;
+        const size_t excess = (stats_.cached_bytes - bytes + block_size - 1) / block_size;
+        free_cached(classes_[i], block_size, excess);
     }
-    return *this;
 }
 
 monotonic_arena::monotonic_arena(size_t block_size) noexcept : block_size_(block_size) {}
 
-monotonic_arena::~monotonic_arena() noexcept = default;
+monotonic_arena::~monotonic_arena() noexcept {
+    release_all();
+}
 
 monotonic_arena::monotonic_arena(monotonic_arena&& other) noexcept
-    : blocks_(std::move(other.blocks_)), num_blocks_(other.num_blocks_),
-      block_size_(other.block_size_), bytes_allocated_(other.bytes_allocated_),
-      total_capacity_(other.total_capacity_) {
+    : current_(other.current_), num_blocks_(other.num_blocks_), block_size_(other.block_size_),
+      bytes_allocated_(other.bytes_allocated_),
+      peak_bytes_allocated_(other.peak_bytes_allocated_), total_capacity_(other.total_capacity_),
+      blocks_acquired_(other.blocks_acquired_) {
+    other.current_ = nullptr;
     other.num_blocks_ = 0;
     other.bytes_allocated_ = 0;
     other.total_capacity_ = 0;
@@ -56,11 +124,15 @@ monotonic_arena::monotonic_arena(monotonic_arena&& other) noexcept
 
 monotonic_arena& monotonic_arena::operator=(monotonic_arena&& other) noexcept {
     if (this != &other) {
-        blocks_ = std::move(other.blocks_);
+        release_all();
+        current_ = other.current_;
         num_blocks_ = other.num_blocks_;
         block_size_ = other.block_size_;
         bytes_allocated_ = other.bytes_allocated_;
+        peak_bytes_allocated_ = other.peak_bytes_allocated_;
         total_capacity_ = other.total_capacity_;
+        blocks_acquired_ = other.blocks_acquired_;
+        other.current_ = nullptr;
         other.num_blocks_ = 0;
         other.bytes_allocated_ = 0;
         other.total_capacity_ = 0;
@@ -69,9 +141,26 @@ monotonic_arena& monotonic_arena::operator=(monotonic_arena&& other) noexcept {
 }
 
 void monotonic_arena::reset() noexcept {
-    for (size_t i = 0; i < num_blocks_; ++i) {
-        blocks_[i].used = 0;
+    block* keep = nullptr;
+    for (block* b = current_; b; b = b->next) {
+        if (b->size <= MAX_GROWTH_BLOCK_SIZE && (!keep || b->size > keep->size)) {
+            keep = b;
+        }
     }
+    for (block* b = current_; b;) {
+        block* next = b->next;
+        if (b != keep) {
+            release_block(b);
+        }
+        b = next;
+    }
+
+    current_ = keep;
+    if (keep) {
+        keep->next = nullptr;
+        keep->used = HEADER_SIZE;
+    }
+    peak_bytes_allocated_ = std::max(peak_bytes_allocated_, bytes_allocated_);
     bytes_allocated_ = 0;
 }
 
@@ -84,60 +173,83 @@ void* monotonic_arena::allocate(size_t bytes, size_t alignment) noexcept {
         return nullptr;
     }
 
-    for (size_t i = 0; i < num_blocks_; ++i) {
-        auto& b = blocks_[i];
-        if (b.used >= b.size || !b.data) {
-            continue;
-        }
-
-        uintptr_t current = reinterpret_cast<uintptr_t>(b.data + b.used);
-        uintptr_t aligned = align_up(current, alignment);
-        size_t padding = aligned - current;
-
-        if (b.used + padding + bytes <= b.size) {
-            b.used += padding + bytes;
+    if (current_) {
+        // Block starts are MAX_ALIGNMENT-aligned, so aligning the offset aligns the address
+        const size_t offset = align_up(current_->used, alignment);
+        if (offset <= current_->size && bytes <= current_->size - offset) {
+            current_->used = offset + bytes;
             bytes_allocated_ += bytes;
-            return reinterpret_cast<void*>(aligned);
+            alloc_tracking::record_arena_allocation(bytes);
+            return reinterpret_cast<uint8_t*>(current_) + offset;
         }
     }
 
-    size_t block_size = std::max(block_size_, bytes + MAX_ALIGNMENT);
-    if (!allocate_new_block(block_size)) {
-        return nullptr;
+    void* ptr = allocate_slow(bytes, alignment);
+    if (ptr) {
+        alloc_tracking::record_arena_allocation(bytes);
     }
+    return ptr;
+}
 
-    auto& b = blocks_[num_blocks_ - 1];
-    if (!b.data) {
+void* monotonic_arena::allocate_slow(size_t bytes, size_t alignment) noexcept {
+    if (bytes > std::numeric_limits<size_t>::max() / 2) {
         return nullptr;
     }
 
-    uintptr_t current = reinterpret_cast<uintptr_t>(b.data);
-    uintptr_t aligned = align_up(current, alignment);
-    size_t padding = aligned - current;
+    const size_t needed = align_up(HEADER_SIZE, alignment) + bytes;
+    size_t next_size = block_size_;
+    if (current_) {
+        next_size = std::max(next_size, std::min(current_->size * 2, MAX_GROWTH_BLOCK_SIZE));
+    }
 
-    if (padding + bytes > b.size) {
+    block* b = acquire_block(std::max(needed, next_size));
+    if (!b) {
         return nullptr;
     }
 
-    b.used = padding + bytes;
-    bytes_allocated_ += bytes;
+    if (needed > next_size && current_) {
+        // Oversized allocation: its own block, behind the one still being filled
+        b->next = current_->next;
+        current_->next = b;
+    } else {
+        b->next = current_;
+        current_ = b;
+    }
 
-    return reinterpret_cast<void*>(aligned);
+    const size_t offset = align_up(HEADER_SIZE, alignment);
+    b->used = offset + bytes;
+    bytes_allocated_ += bytes;
+    return reinterpret_cast<uint8_t*>(b) + offset;
 }
 
-bool monotonic_arena::allocate_new_block(size_t min_size) noexcept {
-    if (num_blocks_ >= MAX_BLOCKS) {
-        return false;
-    }
-
-    blocks_[num_blocks_] = block(min_size);
-    if (!blocks_[num_blocks_].data) {
-        return false;
+monotonic_arena::block* monotonic_arena::acquire_block(size_t size) noexcept {
+    const size_t block_size = arena_block_cache::block_size_for(size);
+    void* data = arena_block_cache::local().acquire(block_size);
+    if (!data) {
+        return nullptr;
     }
 
-    total_capacity_ += min_size;
+    auto* b = new (data) block{nullptr, block_size, HEADER_SIZE};
+    total_capacity_ += block_size;
     ++num_blocks_;
-    return true;
+    ++blocks_acquired_;
+    return b;
+}
+
+void monotonic_arena::release_block(block* b) noexcept {
+    const size_t size = b->size;
+    total_capacity_ -= size;
+    --num_blocks_;
+    arena_block_cache::local().release(b, size);
+}
+
+void monotonic_arena::release_all() noexcept {
+    for (block* b = current_; b;) {
+        block* next = b->next;
+        release_block(b);
+        b = next;
+    }
+    current_ = nullptr;
 }
 
 } // namespace katana
@@ -2,6 +2,7 @@
 #include "katana/core/scoped_fd.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <chrono>
 #include <cstring>
@@ -93,7 +94,6 @@ epoll_reactor::epoll_reactor(int32_t max_events, size_t max_pending_tasks)
         throw std::system_error(errno, std::system_category(), "failed to add wakeup fd to epoll");
     }
 
-    fd_states_.reserve(65536);
     events_buffer_.resize(static_cast<size_t>(max_events_));
 
     // Everything succeeded, release ownership from RAII wrappers
@@ -117,47 +117,54 @@ result<void> epoll_reactor::run() {
 
     while (running_.load(std::memory_order_relaxed)) {
         const auto loop_now = std::chrono::steady_clock::now();
-        process_wheel_timer();
         process_timers(loop_now);
         process_tasks();
 
         if (graceful_shutdown_.load(std::memory_order_relaxed)) {
             auto now = loop_now;
             bool has_active_fds = false;
-            for (const auto& state : fd_states_) {
-                if (state.callback) {
-                    has_active_fds = true;
-                    break;
-                }
-            }
+            fd_states_.for_each([&has_active_fds](size_t, const fd_state& state) {
+                has_active_fds = has_active_fds || static_cast<bool>(state.callback);
+            });
             if (!has_active_fds) {
                 running_ = false;
                 break;
             }
             if (now >= graceful_shutdown_deadline_) {
-                for (size_t fd = 0; fd < fd_states_.size(); ++fd) {
-                    if (!fd_states_[fd].callback)
-                        continue;
+                fd_states_.for_each([this](size_t fd, fd_state& state) {
+                    if (!state.callback) {
+                        return;
+                    }
                     try {
-                        fd_states_[fd].callback(event_type::error);
+                        state.callback(event_type::error);
                     } catch (...) {
                         handle_exception("forced_shutdown_callback",
                                          std::current_exception(),
                                          static_cast<int32_t>(fd));
                     }
-                    if (fd_states_[fd].callback) {
+                    if (state.callback) {
                         epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, static_cast<int32_t>(fd), nullptr);
                         close(static_cast<int32_t>(fd));
-                        fd_states_[fd] = fd_state{};
+                        state = fd_state{};
                     }
-                }
+                });
                 running_ = false;
                 break;
             }
         }
 
         int timeout_ms = calculate_timeout(loop_now);
+        if (timeout_ms != 0) {
+            // Producers only write the eventfd once this is set; anything they queued before
+            // seeing it is picked up by the check below instead
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!pending_tasks_.empty() || !pending_timers_.empty()) {
+                timeout_ms = 0;
+            }
+        }
         auto res = process_events(timeout_ms);
+        sleeping_.store(false, std::memory_order_relaxed);
         if (!res) {
             running_ = false;
             return res;
@@ -258,8 +265,8 @@ result<void> epoll_reactor::register_fd_with_timeout(int32_t fd,
 }
 
 result<void> epoll_reactor::modify_fd(int32_t fd, event_type events) {
-    if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size() ||
-        !fd_states_[static_cast<size_t>(fd)].callback) {
+    fd_state* registered = find_fd_state(fd);
+    if (!registered || !registered->callback) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
@@ -271,7 +278,7 @@ result<void> epoll_reactor::modify_fd(int32_t fd, event_type events) {
         return std::unexpected(std::error_code(errno, std::system_category()));
     }
 
-    auto& state = fd_states_[static_cast<size_t>(fd)];
+    auto& state = *registered;
     state.events = events;
     if (state.has_timeout) {
         cancel_fd_timeout(state);
@@ -281,27 +288,26 @@ result<void> epoll_reactor::modify_fd(int32_t fd, event_type events) {
 }
 
 result<void> epoll_reactor::unregister_fd(int32_t fd) {
-    if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size() ||
-        !fd_states_[static_cast<size_t>(fd)].callback) {
+    fd_state* state = find_fd_state(fd);
+    if (!state || !state->callback) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
-    cancel_fd_timeout(fd_states_[static_cast<size_t>(fd)]);
+    cancel_fd_timeout(*state);
 
     if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) < 0) {
         return std::unexpected(std::error_code(errno, std::system_category()));
     }
 
-    fd_states_[static_cast<size_t>(fd)] = fd_state{};
+    *state = fd_state{};
     active_fds_.fetch_sub(1, std::memory_order_relaxed);
     return {};
 }
 
 void epoll_reactor::refresh_fd_timeout(int32_t fd) {
-    if (fd >= 0 && static_cast<size_t>(fd) < fd_states_.size() &&
-        fd_states_[static_cast<size_t>(fd)].has_timeout) {
-        auto& state = fd_states_[static_cast<size_t>(fd)];
-        state.last_activity = std::chrono::steady_clock::now();
+    fd_state* state = find_fd_state(fd);
+    if (state && state->has_timeout) {
+        state->last_activity = std::chrono::steady_clock::now();
     }
 }
 
@@ -311,36 +317,37 @@ bool epoll_reactor::schedule(task_fn task) {
         return false;
     }
     metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
-    uint32_t prev = pending_count_.fetch_add(1, std::memory_order_relaxed);
-
-    if (prev == 0) {
-        bool expected = false;
-        if (needs_wakeup_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-            uint64_t val = 1;
-            ssize_t ret;
-            do {
-                ret = write(wakeup_fd_, &val, sizeof(val));
-            } while (ret < 0 && errno == EINTR);
-
-            if (ret < 0 && errno != EAGAIN) {
-                handle_exception("schedule_wakeup",
-                                 std::make_exception_ptr(std::system_error(
-                                     errno, std::system_category(), "eventfd write failed")));
-            }
-        }
-    }
-
+    pending_count_.fetch_add(1, std::memory_order_relaxed);
+    wake_if_sleeping("schedule_wakeup");
     return true;
 }
 
-bool epoll_reactor::schedule_after(std::chrono::milliseconds delay, task_fn task) {
-    auto deadline = std::chrono::steady_clock::now() + delay;
-    if (!pending_timers_.try_push(timer_entry{deadline, std::move(task)})) {
-        metrics_.tasks_rejected.fetch_add(1, std::memory_order_relaxed);
-        return false;
+size_t epoll_reactor::schedule_batch(std::span<task_fn> tasks) {
+    const size_t pushed = pending_tasks_.push_batch(tasks.begin(), tasks.end());
+    if (pushed < tasks.size()) {
+        metrics_.tasks_rejected.fetch_add(tasks.size() - pushed, std::memory_order_relaxed);
+    }
+    if (pushed == 0) {
+        return 0;
+    }
+    metrics_.tasks_scheduled.fetch_add(pushed, std::memory_order_relaxed);
+    pending_count_.fetch_add(static_cast<uint32_t>(pushed), std::memory_order_relaxed);
+    wake_if_sleeping("schedule_wakeup");
+    return pushed;
+}
+
+// Pairs with the fence in run(): either the loop sees the new work before it blocks, or the
+// producer sees it blocking and writes the eventfd. While the loop is awake nothing is written;
+// it checks the queues again before its next wait.
+void epoll_reactor::wake_if_sleeping(std::string_view location) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    bool expected = false;
+    if (!needs_wakeup_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return; // another producer's wakeup is already on its way
     }
-    metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
-    timeout_dirty_.store(true, std::memory_order_relaxed);
 
     uint64_t val = 1;
     ssize_t ret;
@@ -349,11 +356,21 @@ bool epoll_reactor::schedule_after(std::chrono::milliseconds delay, task_fn task
     } while (ret < 0 && errno == EINTR);
 
     if (ret < 0 && errno != EAGAIN) {
-        handle_exception("schedule_timer_wakeup",
+        handle_exception(location,
                          std::make_exception_ptr(std::system_error(
                              errno, std::system_category(), "eventfd write failed")));
     }
+}
 
+bool epoll_reactor::schedule_after(std::chrono::milliseconds delay, task_fn task) {
+    auto deadline = std::chrono::steady_clock::now() + delay;
+    if (!pending_timers_.try_push(timer_entry{deadline, std::move(task)})) {
+        metrics_.tasks_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
+    timeout_dirty_.store(true, std::memory_order_relaxed);
+    wake_if_sleeping("schedule_timer_wakeup");
     return true;
 }
 
@@ -366,6 +383,9 @@ result<void> epoll_reactor::process_events(int32_t timeout_ms) {
         }
         return std::unexpected(std::error_code(errno, std::system_category()));
     }
+    if (nfds > 0) {
+        poll_time_ = std::chrono::steady_clock::now();
+    }
 
     constexpr int32_t kChunk = 128;
     for (int32_t base = 0; base < nfds; base += kChunk) {
@@ -373,10 +393,7 @@ result<void> epoll_reactor::process_events(int32_t timeout_ms) {
 
         // Prefetch phase: warm up fd_state for this chunk.
         for (int32_t i = base; i < end; ++i) {
-            int32_t fd = events_buffer_[static_cast<size_t>(i)].data.fd;
-            if (fd >= 0 && static_cast<size_t>(fd) < fd_states_.size()) {
-                __builtin_prefetch(&fd_states_[static_cast<size_t>(fd)], 0, 1);
-            }
+            prefetch_fd_state(events_buffer_[static_cast<size_t>(i)].data.fd);
         }
 
         for (int32_t i = base; i < end; ++i) {
@@ -390,22 +407,16 @@ result<void> epoll_reactor::process_events(int32_t timeout_ms) {
                 continue;
             }
 
-            if (fd >= 0 && static_cast<size_t>(fd) < fd_states_.size() &&
-                fd_states_[static_cast<size_t>(fd)].callback) {
+            fd_state* found = find_fd_state(fd);
+            if (found && found->callback) {
                 event_type ev = from_epoll_events(events_buffer_[static_cast<size_t>(i)].events);
-                auto& state = fd_states_[static_cast<size_t>(fd)];
+                auto& state = *found;
 
                 if (i + 1 < end) {
-                    int32_t next_fd = events_buffer_[static_cast<size_t>(i + 1)].data.fd;
-                    if (next_fd >= 0 && static_cast<size_t>(next_fd) < fd_states_.size()) {
-                        __builtin_prefetch(&fd_states_[static_cast<size_t>(next_fd)], 0, 1);
-                    }
+                    prefetch_fd_state(events_buffer_[static_cast<size_t>(i + 1)].data.fd);
                 }
                 if (i + 2 < end && (end - base) >= 16) {
-                    int32_t next_fd2 = events_buffer_[static_cast<size_t>(i + 2)].data.fd;
-                    if (next_fd2 >= 0 && static_cast<size_t>(next_fd2) < fd_states_.size()) {
-                        __builtin_prefetch(&fd_states_[static_cast<size_t>(next_fd2)], 0, 1);
-                    }
+                    prefetch_fd_state(events_buffer_[static_cast<size_t>(i + 2)].data.fd);
                 }
 
                 try {
@@ -424,37 +435,47 @@ result<void> epoll_reactor::process_events(int32_t timeout_ms) {
 void epoll_reactor::process_tasks() {
     uint32_t to_process = pending_count_.exchange(0, std::memory_order_relaxed);
     needs_wakeup_.store(false, std::memory_order_release);
+    if (to_process == 0) {
+        return;
+    }
 
-    for (uint32_t i = 0; i < to_process; ++i) {
-        auto task = pending_tasks_.pop();
-        if (!task)
+    std::array<task_fn, TASK_BATCH_SIZE> batch;
+    while (to_process > 0) {
+        const size_t popped =
+            pending_tasks_.pop_batch(batch.begin(), std::min<size_t>(to_process, batch.size()));
+        if (popped == 0) {
             break;
-        try {
-            (*task)();
-            metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-        } catch (...) {
-            handle_exception("scheduled_task", std::current_exception());
         }
+        to_process -= static_cast<uint32_t>(popped);
+
+        uint64_t executed = 0;
+        for (size_t i = 0; i < popped; ++i) {
+            try {
+                batch[i]();
+                ++executed;
+            } catch (...) {
+                handle_exception("scheduled_task", std::current_exception());
+            }
+            batch[i] = task_fn{};
+        }
+        metrics_.tasks_executed.fetch_add(executed, std::memory_order_relaxed);
     }
 }
 
 void epoll_reactor::process_timers(std::chrono::steady_clock::time_point now) {
     while (auto timer = pending_timers_.pop()) {
-        timers_.push(std::move(*timer));
+        timers_.add_at(timer->deadline, [this, task = std::move(timer->task)]() {
+            try {
+                task();
+                metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
+                metrics_.timers_fired.fetch_add(1, std::memory_order_relaxed);
+            } catch (...) {
+                handle_exception("delayed_task", std::current_exception());
+            }
+        });
     }
 
-    while (!timers_.empty() && timers_.top().deadline <= now) {
-        auto task = std::move(timers_.top().task);
-        timers_.pop();
-
-        try {
-            task();
-            metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-            metrics_.timers_fired.fetch_add(1, std::memory_order_relaxed);
-        } catch (...) {
-            handle_exception("delayed_task", std::current_exception());
-        }
-    }
+    timers_.tick(now);
 }
 
 int32_t epoll_reactor::calculate_timeout(std::chrono::steady_clock::time_point now) const {
@@ -471,26 +492,11 @@ int32_t epoll_reactor::calculate_timeout(std::chrono::steady_clock::time_point n
         }
     }
 
-    auto min_timeout = std::chrono::milliseconds::max();
-
-    if (!timers_.empty()) {
-        auto deadline = timers_.top().deadline;
-        if (deadline <= now) {
-            timeout_dirty_.store(true, std::memory_order_relaxed);
-            return 0;
-        }
-        auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
-        min_timeout = std::min(min_timeout, delta);
-    }
-
-    auto wheel_timeout = wheel_timer_.time_until_next_expiration(now);
-    if (wheel_timeout == std::chrono::milliseconds::zero()) {
+    auto min_timeout = timers_.time_until_next_expiration(now);
+    if (min_timeout == std::chrono::milliseconds::zero()) {
         timeout_dirty_.store(true, std::memory_order_relaxed);
         return 0;
     }
-    if (wheel_timeout != std::chrono::milliseconds::max()) {
-        min_timeout = std::min(min_timeout, wheel_timeout);
-    }
 
     if (graceful_shutdown_.load(std::memory_order_relaxed)) {
         auto graceful_timeout = time_until_graceful_deadline(now);
@@ -529,34 +535,27 @@ uint64_t epoll_reactor::get_load_score() const noexcept {
     return active_fds * 100 + pending_tasks * 50 + pending_timers_count * 10;
 }
 
-void epoll_reactor::process_wheel_timer() {
-    wheel_timer_.tick();
-}
-
 void epoll_reactor::schedule_fd_timeout(int32_t fd, fd_state& state) {
     state.timeout_interval = fd_timeout_for(state);
     state.last_activity = std::chrono::steady_clock::now();
-    state.timeout_id =
-        wheel_timer_.add(state.timeout_interval, [this, fd]() { handle_fd_timeout(fd); });
+    state.timeout_id = timers_.add(
+        state.timeout_interval, [this, fd]() { handle_fd_timeout(fd); }, state.last_activity);
 }
 
 void epoll_reactor::handle_fd_timeout(int32_t fd) {
-    if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size()) {
+    fd_state* found = find_fd_state(fd);
+    if (!found) {
         return;
     }
 
-    auto index = static_cast<size_t>(fd);
-    auto& entry_state = fd_states_[index];
+    auto& entry_state = *found;
     if (!entry_state.callback || !entry_state.has_timeout) {
         return;
     }
 
-    const auto now = std::chrono::steady_clock::now();
-    const auto elapsed_ns =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(now - entry_state.last_activity)
-            .count();
-
-    if (elapsed_ns >= entry_state.timeout_interval.count()) {
+    // Activity only moves last_activity forward, so the deadline is checked here
+    const auto deadline = entry_state.last_activity + entry_state.timeout_interval;
+    if (std::chrono::steady_clock::now() >= deadline) {
         metrics_.fd_timeouts.fetch_add(1, std::memory_order_relaxed);
 
         auto cb = std::move(entry_state.callback);
@@ -575,14 +574,12 @@ void epoll_reactor::handle_fd_timeout(int32_t fd) {
         return;
     }
 
-    const auto remaining_ns = entry_state.timeout_interval.count() - elapsed_ns;
-    entry_state.timeout_id = wheel_timer_.add(std::chrono::milliseconds(remaining_ns / 1'000'000),
-                                              [this, fd]() { handle_fd_timeout(fd); });
+    entry_state.timeout_id = timers_.add_at(deadline, [this, fd]() { handle_fd_timeout(fd); });
 }
 
 void epoll_reactor::cancel_fd_timeout(fd_state& state) {
     if (state.timeout_id != 0) {
-        (void)wheel_timer_.cancel(state.timeout_id);
+        (void)timers_.cancel(state.timeout_id);
         state.timeout_id = 0;
     }
 }
@@ -618,9 +615,8 @@ void epoll_reactor::close_fd_immediate(int32_t fd) {
     (void)epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
     (void)close(fd);
 
-    size_t idx = static_cast<size_t>(fd);
-    if (idx < fd_states_.size()) {
-        fd_states_[idx] = fd_state{};
+    if (fd_state* state = find_fd_state(fd)) {
+        *state = fd_state{};
     }
     active_fds_.fetch_sub(1, std::memory_order_relaxed);
 }
@@ -651,9 +647,8 @@ void epoll_reactor::flush_deferred_closes() {
                              fd);
         }
 
-        size_t idx = static_cast<size_t>(fd);
-        if (idx < fd_states_.size()) {
-            fd_states_[idx] = fd_state{};
+        if (fd_state* state = find_fd_state(fd)) {
+            *state = fd_state{};
         }
         active_fds_.fetch_sub(1, std::memory_order_relaxed);
     }
@@ -682,26 +677,10 @@ result<void> epoll_reactor::ensure_fd_capacity(int32_t fd) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
-    size_t index = static_cast<size_t>(fd);
-    if (index < fd_states_.size()) {
-        return {};
-    }
-
-    size_t new_size = fd_states_.empty() ? 64 : fd_states_.size();
-    while (new_size <= index) {
-        if (new_size > fd_states_.max_size() / 2) {
-            new_size = index + 1;
-            break;
-        }
-        new_size = std::max(new_size * 2, index + 1);
-    }
-
-    try {
-        fd_states_.resize(new_size);
-    } catch (const std::bad_alloc&) {
+    // Allocates the fd's page if needed; live fd_states never move
+    if (!fd_states_.ensure(static_cast<size_t>(fd))) {
         return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
     }
-
     return {};
 }
 
@@ -161,6 +161,35 @@ void response::serialize_into(std::string& out) const {
 }
 
 std::string response::serialize_chunked(size_t chunk_size) const {
+    std::string result;
+    serialize_chunked_head_into(result);
+
+    if (stream) {
+        while (append_stream_chunk(stream, result)) {
+        }
+        return result;
+    }
+
+    result.reserve(result.size() + body.size() + 32);
+    size_t offset = 0;
+    char chunk_size_buf[32];
+    while (offset < body.size()) {
+        size_t current_chunk = std::min(chunk_size, body.size() - offset);
+        auto [chunk_ptr, chunk_ec] = std::to_chars(
+            chunk_size_buf, chunk_size_buf + sizeof(chunk_size_buf), current_chunk, HEX_BASE);
+        result.append(chunk_size_buf, static_cast<size_t>(chunk_ptr - chunk_size_buf));
+        result.append(CRLF);
+        result.append(body.data() + offset, current_chunk);
+        result.append(CRLF);
+        offset += current_chunk;
+    }
+
+    result.append(CHUNKED_TERMINATOR);
+
+    return result;
+}
+
+void response::serialize_chunked_head_into(std::string& result) const {
     size_t headers_size = 0;
     for (const auto& [name, value] : headers) {
         if (name != "Content-Length") {
@@ -168,8 +197,7 @@ std::string response::serialize_chunked(size_t chunk_size) const {
         }
     }
 
-    std::string result;
-    result.reserve(64 + reason.size() + headers_size + body.size() + 32);
+    result.reserve(result.size() + 64 + reason.size() + headers_size);
 
     char status_buf[16];
     auto [ptr, ec] = std::to_chars(status_buf, status_buf + sizeof(status_buf), status);
@@ -190,23 +218,32 @@ std::string response::serialize_chunked(size_t chunk_size) const {
     }
 
     result.append(CHUNKED_ENCODING_HEADER);
+}
 
-    size_t offset = 0;
-    char chunk_size_buf[32];
-    while (offset < body.size()) {
-        size_t current_chunk = std::min(chunk_size, body.size() - offset);
-        auto [chunk_ptr, chunk_ec] = std::to_chars(
-            chunk_size_buf, chunk_size_buf + sizeof(chunk_size_buf), current_chunk, HEX_BASE);
-        result.append(chunk_size_buf, static_cast<size_t>(chunk_ptr - chunk_size_buf));
-        result.append(CRLF);
-        result.append(body.data() + offset, current_chunk);
-        result.append(CRLF);
-        offset += current_chunk;
-    }
+bool append_stream_chunk(const body_stream& stream, std::string& out) {
+    // The part is produced straight into `out` behind a fixed-width size line (leading zeros
+    // are valid chunk-size syntax), which is filled in once the part's length is known
+    constexpr size_t size_digits = 16;
+    const size_t header = out.size();
+    out.append(size_digits, '0');
+    out.append(CRLF);
 
-    result.append(CHUNKED_TERMINATOR);
+    const bool more = stream(out);
+    const size_t part = out.size() - header - size_digits - CRLF.size();
+    if (part == 0) {
+        out.resize(header);
+    } else {
+        char digits[size_digits];
+        auto [ptr, ec] = std::to_chars(digits, digits + size_digits, part, HEX_BASE);
+        const auto len = static_cast<size_t>(ptr - digits);
+        std::memcpy(out.data() + header + size_digits - len, digits, len);
+        out.append(CRLF);
+    }
 
-    return result;
+    if (!more) {
+        out.append(CHUNKED_TERMINATOR);
+    }
+    return more;
 }
 
 response response::ok(std::string body, std::string content_type) {
@@ -225,6 +262,16 @@ response response::json(std::string body) {
     return ok(std::move(body), "application/json");
 }
 
+response response::json_stream(body_stream stream) {
+    response res;
+    res.status = 200;
+    res.reason = "OK";
+    res.chunked = true;
+    res.stream = std::move(stream);
+    res.set_header("Content-Type", "application/json");
+    return res;
+}
+
 response response::error(const problem_details& problem) {
     response res;
     res.status = problem.status;
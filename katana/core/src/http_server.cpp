@@ -1,14 +1,344 @@
 #include "katana/core/http_server.hpp"
 #include "katana/core/problem.hpp"
 
+#include <algorithm>
+#include <arpa/inet.h>
 #include <cerrno>
 #include <iostream>
 #include <sys/socket.h>
+#include <thread>
 
 namespace katana {
 namespace http {
 
-void server::handle_connection(connection_state& state, [[maybe_unused]] reactor& r) {
+namespace {
+
+// Streamed bodies are produced only while less than this much is waiting to be written
+constexpr size_t STREAM_HIGH_WATERMARK = 32 * 1024;
+
+// Each reactor frees the arena blocks its thread cache has not needed for this long
+constexpr std::chrono::seconds ARENA_TRIM_INTERVAL{5};
+
+void schedule_arena_trim(reactor& r) {
+    r.schedule_after(ARENA_TRIM_INTERVAL, [&r]() {
+        arena_block_cache::local().trim();
+        schedule_arena_trim(r);
+    });
+}
+
+// "GET /users/{id:int}"; route_entry keeps only the parsed segments, so rebuild the path
+std::string route_name(const route_entry* route) {
+    if (!route) {
+        return "unmatched";
+    }
+    std::string name(method_to_string(route->method));
+    name += ' ';
+    if (route->pattern.segment_count == 0) {
+        name += '/';
+    }
+    for (size_t i = 0; i < route->pattern.segment_count; ++i) {
+        const auto& segment = route->pattern.segments[i];
+        name += '/';
+        if (segment.kind == segment_kind::literal) {
+            name += segment.value;
+            continue;
+        }
+        name += '{';
+        name += segment.value;
+        if (segment.type == param_type::integer) {
+            name += ":int";
+        } else if (segment.type == param_type::uuid) {
+            name += ":uuid";
+        }
+        name += '}';
+    }
+    return name;
+}
+
+// When the bytes a connection callback handles became ready, for admission control: the poll
+// that reported them, or now when a timer fired the callback and poll_time() is older
+std::chrono::steady_clock::time_point event_ready_time(const reactor& r, event_type events) {
+    return has_flag(events, event_type::timeout) ? std::chrono::steady_clock::now()
+                                                 : r.poll_time();
+}
+
+} // namespace
+
+void server::connection_state::set_peer_address(const sockaddr_storage& addr) noexcept {
+    const char* text = nullptr;
+    if (addr.ss_family == AF_INET) {
+        const auto& v4 = reinterpret_cast<const sockaddr_in&>(addr);
+        text = ::inet_ntop(AF_INET, &v4.sin_addr, peer_address, sizeof(peer_address));
+    } else if (addr.ss_family == AF_INET6) {
+        const auto& v6 = reinterpret_cast<const sockaddr_in6&>(addr);
+        text = ::inet_ntop(AF_INET6, &v6.sin6_addr, peer_address, sizeof(peer_address));
+    }
+    peer_address_len = text ? std::char_traits<char>::length(peer_address) : 0;
+}
+
+admission_snapshot server::admission_metrics() const {
+    admission_snapshot total;
+    for (const auto& slot : reactors_) {
+        if (slot.admission) {
+            total += slot.admission->metrics().snapshot();
+        }
+    }
+    return total;
+}
+
+bool server::bind_reactor(connection_state& state, const reactor& r) noexcept {
+    for (auto& slot : reactors_) {
+        if (slot.owner == &r) {
+            state.admission = slot.admission.get();
+            state.reactor_index = slot.index;
+            state.usage = slot.arena.get();
+            state.allocs = slot.allocs.get();
+            return true;
+        }
+    }
+    return false;
+}
+
+offload_snapshot server::offload_metrics() const {
+    return offload_pool_ ? offload_pool_->metrics().snapshot() : offload_snapshot{};
+}
+
+arena_snapshot server::arena_metrics() const {
+    arena_snapshot total;
+    for (const auto& slot : reactors_) {
+        const arena_usage* usage = slot.arena.get();
+        total.requests += usage->requests.load(std::memory_order_relaxed);
+        total.block_acquisitions += usage->block_acquisitions.load(std::memory_order_relaxed);
+        total.peak_request_bytes = std::max(
+            total.peak_request_bytes, usage->peak_request_bytes.load(std::memory_order_relaxed));
+    }
+    return total;
+}
+
+std::vector<route_alloc_snapshot> server::alloc_metrics() const {
+    std::vector<std::pair<const route_entry*, route_alloc_snapshot>> merged;
+    for (const auto& slot : reactors_) {
+        std::lock_guard lock(slot.allocs->mutex);
+        for (const auto& counters : slot.allocs->routes) {
+            auto it = std::find_if(merged.begin(), merged.end(), [&](const auto& entry) {
+                return entry.first == counters.route;
+            });
+            if (it == merged.end()) {
+                merged.emplace_back(counters.route, route_alloc_snapshot{});
+                it = std::prev(merged.end());
+            }
+            it->second.requests += counters.requests;
+            for (size_t i = 0; i < ALLOC_PHASE_COUNT; ++i) {
+                it->second.phases[i] += counters.phases[i];
+            }
+        }
+    }
+
+    std::vector<route_alloc_snapshot> snapshots;
+    snapshots.reserve(merged.size());
+    for (auto& [route, snapshot] : merged) {
+        snapshot.route = route_name(route);
+        snapshots.push_back(std::move(snapshot));
+    }
+    std::sort(snapshots.begin(), snapshots.end(), [](const auto& a, const auto& b) {
+        return a.route < b.route;
+    });
+    return snapshots;
+}
+
+void server::record_request_allocs(connection_state& state) {
+    if constexpr (alloc_tracking::enabled) {
+        if (auto* usage = state.allocs) {
+            // The table growing is not the request's doing
+            alloc_tracking::pause_scope pause;
+            std::lock_guard lock(usage->mutex);
+            auto it = std::find_if(usage->routes.begin(), usage->routes.end(), [&](const auto& c) {
+                return c.route == state.matched_route;
+            });
+            if (it == usage->routes.end()) {
+                usage->routes.push_back({state.matched_route, 0, {}});
+                it = std::prev(usage->routes.end());
+            }
+            ++it->requests;
+            for (size_t i = 0; i < ALLOC_PHASE_COUNT; ++i) {
+                it->phases[i] += state.request_allocs[i];
+            }
+        }
+        state.request_allocs = {};
+    }
+    state.matched_route = nullptr;
+}
+
+void server::reset_request_arena(connection_state& state) {
+    record_request_allocs(state);
+    if (auto* usage = state.usage) {
+        // Only this reactor writes the counters, so a load and a store are enough
+        constexpr auto relaxed = std::memory_order_relaxed;
+        const uint64_t acquired = state.arena.blocks_acquired();
+        const size_t used = state.arena.bytes_allocated();
+        usage->requests.store(usage->requests.load(relaxed) + 1, relaxed);
+        usage->block_acquisitions.store(
+            usage->block_acquisitions.load(relaxed) + (acquired - state.arena_blocks_recorded),
+            relaxed);
+        state.arena_blocks_recorded = acquired;
+        if (used > usage->peak_request_bytes.load(relaxed)) {
+            usage->peak_request_bytes.store(used, relaxed);
+        }
+    }
+    state.arena.reset();
+    state.http_parser.reset(&state.arena);
+}
+
+bool server::start_offload(connection_state& state,
+                           reactor& r,
+                           const route_entry& route,
+                           const request_context& ctx,
+                           bool admitted) {
+    state.offload_ctx.emplace(ctx);
+    state.offload_admitted = admitted;
+    state.offloaded = true;
+
+    const auto* route_ptr = &route;
+    auto conn = state.shared_from_this();
+    bool submitted = offload_pool_->submit([this, conn, route_ptr, &r]() {
+        if (!conn->offload_cancelled.load(std::memory_order_relaxed)) {
+            const auto& req = conn->http_parser.get_request();
+            // The connection is parked, so the worker has its counters to itself
+            alloc_tracking::phase_scope allocs(alloc_phase::dispatch, conn->request_allocs);
+            try {
+                conn->offload_response.emplace(map_dispatch_error(dispatch_result{
+                    route_ptr->middleware.run(req, *conn->offload_ctx, route_ptr->handler),
+                    true,
+                    0}));
+            } catch (...) {
+                conn->offload_response.emplace(
+                    response::error(problem_details::internal_server_error()));
+            }
+        }
+
+        // The reactor's task queue is bounded; keep retrying rather than strand the connection
+        while (!r.schedule([this, conn, &r]() { finish_offload(*conn, r); })) {
+            if (offload_pool_->stopping()) {
+                // run() stops the pool only once every reactor has exited, so nothing else
+                // touches the connection any more
+                abandon_offload(*conn);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    if (!submitted) {
+        state.offloaded = false;
+        state.offload_ctx.reset();
+        return false;
+    }
+
+    // Parked: no reads until the worker hands the response back; errors and hangups are
+    // still reported, see on_connection_event
+    state.watch->modify(event_type::none);
+    return true;
+}
+
+void server::finish_offload(connection_state& state, reactor& r) {
+    if (state.offload_cancelled.load(std::memory_order_relaxed)) {
+        abandon_offload(state);
+        return;
+    }
+
+    alloc_tracking::phase_scope allocs(alloc_phase::serialize, state.request_allocs);
+    state.offloaded = false;
+    if (state.offload_admitted && state.admission) {
+        state.admission->complete();
+    }
+    state.offload_admitted = false;
+
+    auto resp = std::move(*state.offload_response);
+    state.offload_response.reset();
+    state.offload_ctx.reset();
+
+    if (on_request_callback_) {
+        on_request_callback_(state.http_parser.get_request(), resp);
+    }
+    if (!resp.headers.get("Connection")) {
+        resp.set_header("Connection", state.close_after_write ? "close" : "keep-alive");
+    }
+
+    if (!queue_response(state, resp)) {
+        state.watch.reset();
+        return;
+    }
+    state.watch->modify(event_type::writable);
+    // A task, not a poll: anything still buffered is ready now, not at the last poll
+    handle_connection(state, r, std::chrono::steady_clock::now());
+}
+
+// Ends an offloaded request whose response will never be written
+void server::abandon_offload(connection_state& state) {
+    state.offloaded = false;
+    if (state.offload_admitted && state.admission) {
+        state.admission->complete();
+    }
+    state.offload_admitted = false;
+    state.offload_response.reset();
+    state.offload_ctx.reset();
+    state.watch.reset();
+    state.socket.close();
+}
+
+bool server::queue_response(connection_state& state, response& resp) {
+    if (!resp.stream) {
+        state.write_buffer.append(resp.serialize());
+        return true;
+    }
+    state.stream_chunk.clear();
+    resp.serialize_chunked_head_into(state.stream_chunk);
+    state.write_buffer.append(state.stream_chunk);
+    state.stream = std::move(resp.stream);
+    return refill_stream(state);
+}
+
+bool server::refill_stream(connection_state& state) {
+    try {
+        while (state.stream && state.write_buffer.size() < STREAM_HIGH_WATERMARK) {
+            state.stream_chunk.clear();
+            if (!append_stream_chunk(state.stream, state.stream_chunk)) {
+                state.stream = nullptr;
+            }
+            state.write_buffer.append(state.stream_chunk);
+        }
+    } catch (...) {
+        // The status line is already out; all that is left is to cut the body short
+        state.stream = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void server::on_connection_event(connection_state& state, reactor& r, event_type events) {
+    if (state.offloaded) {
+        // A parked fd is level-triggered on errors and hangups, so close it now rather than
+        // spin until the handler finishes; the worker's reference keeps `state` alive
+        if (has_flag(events, event_type::error) || has_flag(events, event_type::hup)) {
+            state.offload_cancelled.store(true, std::memory_order_relaxed);
+            state.watch.reset();
+            state.socket.close();
+        }
+        return;
+    }
+    handle_connection(state, r, event_ready_time(r, events));
+}
+
+void server::handle_connection(connection_state& state,
+                               reactor& r,
+                               std::chrono::steady_clock::time_point ready_at) {
+    if (state.offloaded) {
+        return;
+    }
+
+    // Whatever is left to write belongs to the request being served
+    alloc_tracking::phase_scope allocs(alloc_phase::write, state.request_allocs);
+
     if (!state.write_buffer.empty()) {
         while (!state.write_buffer.empty()) {
             auto data = state.write_buffer.readable_span();
@@ -28,20 +358,31 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
             }
 
             state.write_buffer.consume(write_result.value());
+            if (state.write_buffer.empty() && state.stream && !refill_stream(state)) {
+                state.watch.reset();
+                return;
+            }
         }
 
         if (!state.write_buffer.empty()) {
             return;
         }
 
-        state.arena.reset();
-        state.http_parser.reset(&state.arena);
+        if (state.close_after_write) {
+            state.watch.reset();
+            return;
+        }
+
+        // The parser's buffer for the next request comes out of the reset
+        allocs.enter(alloc_phase::parse);
+        reset_request_arena(state);
         state.write_buffer.clear();
         state.watch->modify(event_type::readable);
-        return;
+        // Fall through: pipelined requests may already be buffered
     }
 
     while (true) {
+        allocs.enter(alloc_phase::parse);
         if (state.read_buffer.empty()) {
             auto buf = state.read_buffer.writable_span(4096);
             auto read_result = state.socket.read(buf);
@@ -55,9 +396,11 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
                 return;
             }
 
+            // tcp_socket::read() reports EAGAIN as an empty read and end of stream as an error;
+            // closing here dropped keep-alive connections whenever the client was not quick
+            // enough with its next request
             if (read_result->empty()) {
-                state.watch.reset();
-                return;
+                break;
             }
 
             state.read_buffer.commit(read_result->size());
@@ -67,6 +410,7 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
         auto parse_result = state.http_parser.parse(readable);
 
         if (!parse_result) {
+            allocs.enter(alloc_phase::serialize);
             auto resp = response::error(problem_details::bad_request("Invalid HTTP request"));
             state.write_buffer.append(resp.serialize());
             state.watch.reset();
@@ -79,25 +423,81 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
 
         size_t parsed_bytes = state.http_parser.bytes_parsed();
         state.read_buffer.consume(parsed_bytes);
+        allocs.enter(alloc_phase::dispatch);
 
         const auto& req = state.http_parser.get_request();
         request_context ctx{state.arena};
-        auto resp = dispatch_or_problem(router_, req, ctx);
-
-        if (on_request_callback_) {
-            on_request_callback_(req, resp);
-        }
+        ctx.client_address = std::string_view(state.peer_address, state.peer_address_len);
+        ctx.reactor_index = state.reactor_index;
 
         auto connection_header = req.headers.get("Connection");
         bool close_connection =
             connection_header && (*connection_header == "close" || *connection_header == "Close");
+        state.close_after_write = close_connection;
+
+        admission_controller* admission = state.admission;
+        auto verdict = admission_verdict::admit;
+        bool admitted = false;
+        struct admission_release {
+            admission_controller* controller;
+            const bool& admitted;
+            ~admission_release() {
+                if (admitted) {
+                    controller->complete();
+                }
+            }
+        } release{admission, admitted};
+
+        const route_entry* offload_route = nullptr;
+        auto gate = [&](const route_entry& route) noexcept {
+            state.matched_route = &route;
+            if (admission) {
+                verdict =
+                    admission->admit(route.priority, ready_at, std::chrono::steady_clock::now());
+                admitted = verdict == admission_verdict::admit;
+                if (!admitted) {
+                    return false;
+                }
+            }
+            if (route.offload && offload_pool_) {
+                offload_route = &route;
+                return false;
+            }
+            return true;
+        };
+        auto dispatched = router_.dispatch_with_info(req, ctx, gate);
 
-        if (!resp.headers.get("Connection")) {
+        if (offload_route) {
+            if (start_offload(state, r, *offload_route, ctx, admitted)) {
+                admitted = false; // released by finish_offload
+                return;
+            }
+            allocs.enter(alloc_phase::serialize);
+            auto resp = response::error(problem_details::service_unavailable("Offload queue full"));
             resp.set_header("Connection", close_connection ? "close" : "keep-alive");
-        }
+            state.write_buffer.append(resp.serialize());
+        } else if (verdict != admission_verdict::admit) {
+            allocs.enter(alloc_phase::serialize);
+            state.write_buffer.append(admission->shed_response(!close_connection));
+        } else {
+            auto resp = map_dispatch_error(std::move(dispatched));
+
+            if (on_request_callback_) {
+                on_request_callback_(req, resp);
+            }
 
-        state.write_buffer.append(resp.serialize());
+            allocs.enter(alloc_phase::serialize);
+            if (!resp.headers.get("Connection")) {
+                resp.set_header("Connection", close_connection ? "close" : "keep-alive");
+            }
+
+            if (!queue_response(state, resp)) {
+                state.watch.reset();
+                return;
+            }
+        }
 
+        allocs.enter(alloc_phase::write);
         while (!state.write_buffer.empty()) {
             auto data = state.write_buffer.readable_span();
             auto write_result = state.socket.write(data);
@@ -117,6 +517,10 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
             }
 
             state.write_buffer.consume(write_result.value());
+            if (state.write_buffer.empty() && state.stream && !refill_stream(state)) {
+                state.watch.reset();
+                return;
+            }
         }
 
         if (!state.write_buffer.empty()) {
@@ -129,26 +533,35 @@ void server::handle_connection(connection_state& state, [[maybe_unused]] reactor
             return;
         }
 
-        state.arena.reset();
-        state.http_parser.reset(&state.arena);
+        allocs.enter(alloc_phase::parse);
+        reset_request_arena(state);
     }
 }
 
 void server::accept_connection(reactor& r,
                                tcp_listener& listener,
-                               std::vector<std::unique_ptr<connection_state>>& connections) {
+                               std::vector<std::shared_ptr<connection_state>>& connections) {
     auto accept_result = listener.accept();
     if (!accept_result) {
         return;
     }
 
-    auto state = std::make_unique<connection_state>(std::move(*accept_result));
+    auto state = std::make_shared<connection_state>(std::move(*accept_result));
     int32_t fd = state->socket.native_handle();
 
+    sockaddr_storage peer{};
+    socklen_t peer_len = sizeof(peer);
+    if (::getpeername(fd, reinterpret_cast<sockaddr*>(&peer), &peer_len) == 0) {
+        state->set_peer_address(peer);
+    }
+    if (!bind_reactor(*state, r)) {
+        return;
+    }
+
     auto* state_ptr = state.get();
-    state->watch =
-        std::make_unique<fd_watch>(r, fd, event_type::readable, [this, state_ptr, &r](event_type) {
-            handle_connection(*state_ptr, r);
+    state->watch = std::make_unique<fd_watch>(
+        r, fd, event_type::readable, [this, state_ptr, &r](event_type ev) {
+            on_connection_event(*state_ptr, r, ev);
         });
 
     connections.push_back(std::move(state));
@@ -158,13 +571,40 @@ int server::run() {
     reactor_pool_config config;
     config.reactor_count = static_cast<uint32_t>(worker_count_);
     config.enable_adaptive_balancing = true;
+    config.memory = memory_config_;
+    config.enable_thread_pinning = pin_threads_;
     reactor_pool pool(config);
 
+    if (offload_config_) {
+        offload_pool_ = std::make_unique<offload_pool>(*offload_config_);
+    }
+
+    reactors_.clear();
+    reactors_.reserve(pool.size());
+    for (size_t i = 0; i < pool.size(); ++i) {
+        auto& r = pool.get_reactor(i);
+        reactor_slot slot;
+        slot.owner = &r;
+        slot.index = i;
+        if (admission_config_) {
+            slot.admission = std::make_unique<admission_controller>(*admission_config_);
+        }
+        slot.arena = std::make_unique<arena_usage>();
+        slot.allocs = std::make_unique<alloc_usage>();
+        reactors_.push_back(std::move(slot));
+        schedule_arena_trim(r);
+    }
+
     std::vector<std::shared_ptr<fd_watch>> accept_watches;
 
     auto accept_handler = [this](reactor& r, int listener_fd) {
         while (true) {
-            int fd = ::accept4(listener_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            sockaddr_storage peer{};
+            socklen_t peer_len = sizeof(peer);
+            int fd = ::accept4(listener_fd,
+                               reinterpret_cast<sockaddr*>(&peer),
+                               &peer_len,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
             if (fd < 0) {
                 if (errno == EAGAIN || errno == EWOULDBLOCK) {
                     break;
@@ -172,12 +612,18 @@ int server::run() {
                 return;
             }
 
-            auto state = std::make_shared<connection_state>(tcp_socket(fd));
+            auto state = std::allocate_shared<connection_state>(
+                pool_allocator<connection_state>{}, tcp_socket(fd));
+            state->set_peer_address(peer);
+            if (!bind_reactor(*state, r)) {
+                // Only the pool's reactors listen, so this does not happen; the socket closes
+                continue;
+            }
             auto state_ptr = state.get();
 
             state->watch = std::make_unique<fd_watch>(
-                r, fd, event_type::readable, [this, state, state_ptr, &r](event_type) {
-                    handle_connection(*state_ptr, r);
+                r, fd, event_type::readable, [this, state, state_ptr, &r](event_type ev) {
+                    on_connection_event(*state_ptr, r, ev);
                 });
         }
     };
@@ -227,6 +673,9 @@ int server::run() {
 
     pool.start();
     pool.wait();
+    if (offload_pool_) {
+        offload_pool_->stop();
+    }
     return 0;
 }
 
@@ -1,4 +1,5 @@
 #include "katana/core/io_buffer.hpp"
+#include "katana/core/memory_pool.hpp"
 
 #include <algorithm>
 #include <cassert>
@@ -20,12 +21,21 @@ std::unique_ptr<uint8_t[], io_buffer::aligned_delete> allocate_raw(size_t n) {
     if (n == 0) {
         return nullptr;
     }
-    // Align to 64 bytes to keep memcpy in the fast path for AVX loads/stores.
-    return std::unique_ptr<uint8_t[], io_buffer::aligned_delete>(
-        static_cast<uint8_t*>(::operator new[](n, std::align_val_t(64))));
+    // Aligned to 64 bytes to keep memcpy in the fast path for AVX loads/stores; from the
+    // reactor's memory pool when it has one.
+    void* p = memory_pool::allocate(n);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return std::unique_ptr<uint8_t[], io_buffer::aligned_delete>(static_cast<uint8_t*>(p),
+                                                                  io_buffer::aligned_delete{n});
 }
 } // namespace
 
+void io_buffer::aligned_delete::operator()(uint8_t* p) const noexcept {
+    memory_pool::deallocate(p, size);
+}
+
 alignas(64) thread_local uint8_t io_buffer::static_scratch_[io_buffer::STATIC_SCRATCH_CAPACITY];
 
 io_buffer::io_buffer() {
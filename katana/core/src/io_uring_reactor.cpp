@@ -2,6 +2,7 @@
 #include "katana/core/scoped_fd.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstring>
 #include <iostream>
@@ -83,7 +84,6 @@ io_uring_reactor::io_uring_reactor(size_t ring_size, size_t max_pending_tasks)
         throw std::system_error(errno, std::system_category(), "eventfd failed");
     }
 
-    fd_states_.reserve(65536);
 
     // Everything succeeded, release ownership from RAII wrapper
     wakeup_fd_ = wakeup_fd.release();
@@ -114,47 +114,54 @@ result<void> io_uring_reactor::run() {
     }
 
     while (running_.load(std::memory_order_relaxed)) {
-        process_wheel_timer();
         process_timers();
         process_tasks();
 
         if (graceful_shutdown_.load(std::memory_order_relaxed)) {
             auto now = std::chrono::steady_clock::now();
             bool has_active_fds = false;
-            for (const auto& state : fd_states_) {
-                if (state.callback) {
-                    has_active_fds = true;
-                    break;
-                }
-            }
+            fd_states_.for_each([&has_active_fds](size_t, const fd_state& state) {
+                has_active_fds = has_active_fds || static_cast<bool>(state.callback);
+            });
             if (!has_active_fds) {
                 running_ = false;
                 break;
             }
             if (now >= graceful_shutdown_deadline_) {
-                for (size_t fd = 0; fd < fd_states_.size(); ++fd) {
-                    if (!fd_states_[fd].callback)
-                        continue;
+                fd_states_.for_each([this](size_t fd, fd_state& state) {
+                    if (!state.callback) {
+                        return;
+                    }
                     try {
-                        fd_states_[fd].callback(event_type::error);
+                        state.callback(event_type::error);
                     } catch (...) {
                         handle_exception("forced_shutdown_callback",
                                          std::current_exception(),
                                          static_cast<int32_t>(fd));
                     }
-                    if (fd_states_[fd].callback) {
+                    if (state.callback) {
                         submit_poll_remove(static_cast<int32_t>(fd));
                         close(static_cast<int32_t>(fd));
-                        fd_states_[fd] = fd_state{};
+                        state = fd_state{};
                     }
-                }
+                });
                 running_ = false;
                 break;
             }
         }
 
         int timeout_ms = calculate_timeout();
+        if (timeout_ms != 0) {
+            // Producers only write the eventfd once this is set; anything they queued before
+            // seeing it is picked up by the check below instead
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!pending_tasks_.empty() || !pending_timers_.empty()) {
+                timeout_ms = 0;
+            }
+        }
         auto res = process_completions(timeout_ms);
+        sleeping_.store(false, std::memory_order_relaxed);
         if (!res) {
             running_ = false;
             return res;
@@ -242,12 +249,12 @@ result<void> io_uring_reactor::register_fd_with_timeout(int32_t fd,
 }
 
 result<void> io_uring_reactor::modify_fd(int32_t fd, event_type events) {
-    if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size() ||
-        !fd_states_[static_cast<size_t>(fd)].callback) {
+    fd_state* registered = find_fd_state(fd);
+    if (!registered || !registered->callback) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
-    auto& state = fd_states_[static_cast<size_t>(fd)];
+    auto& state = *registered;
 
     auto res = submit_poll_remove(fd);
     if (!res) {
@@ -268,27 +275,27 @@ result<void> io_uring_reactor::modify_fd(int32_t fd, event_type events) {
 }
 
 result<void> io_uring_reactor::unregister_fd(int32_t fd) {
-    if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size() ||
-        !fd_states_[static_cast<size_t>(fd)].callback) {
+    fd_state* state = find_fd_state(fd);
+    if (!state || !state->callback) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
-    cancel_fd_timeout(fd_states_[static_cast<size_t>(fd)]);
+    cancel_fd_timeout(*state);
 
     auto res = submit_poll_remove(fd);
     if (!res) {
         return res;
     }
 
-    fd_states_[static_cast<size_t>(fd)] = fd_state{};
+    *state = fd_state{};
     active_fds_.fetch_sub(1, std::memory_order_relaxed);
     return {};
 }
 
 void io_uring_reactor::refresh_fd_timeout(int32_t fd) {
-    if (fd >= 0 && static_cast<size_t>(fd) < fd_states_.size() &&
-        fd_states_[static_cast<size_t>(fd)].has_timeout) {
-        auto& state = fd_states_[static_cast<size_t>(fd)];
+    fd_state* found = find_fd_state(fd);
+    if (found && found->has_timeout) {
+        auto& state = *found;
         cancel_fd_timeout(state);
         setup_fd_timeout(fd, state);
     }
@@ -300,36 +307,37 @@ bool io_uring_reactor::schedule(task_fn task) {
         return false;
     }
     metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
-    uint32_t prev = pending_count_.fetch_add(1, std::memory_order_relaxed);
-
-    if (prev == 0) {
-        bool expected = false;
-        if (needs_wakeup_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-            uint64_t val = 1;
-            ssize_t ret;
-            do {
-                ret = write(wakeup_fd_, &val, sizeof(val));
-            } while (ret < 0 && errno == EINTR);
-
-            if (ret < 0 && errno != EAGAIN) {
-                handle_exception("schedule_wakeup",
-                                 std::make_exception_ptr(std::system_error(
-                                     errno, std::system_category(), "eventfd write failed")));
-            }
-        }
-    }
-
+    pending_count_.fetch_add(1, std::memory_order_relaxed);
+    wake_if_sleeping("schedule_wakeup");
     return true;
 }
 
-bool io_uring_reactor::schedule_after(std::chrono::milliseconds delay, task_fn task) {
-    auto deadline = std::chrono::steady_clock::now() + delay;
-    if (!pending_timers_.try_push(timer_entry{deadline, std::move(task)})) {
-        metrics_.tasks_rejected.fetch_add(1, std::memory_order_relaxed);
-        return false;
+size_t io_uring_reactor::schedule_batch(std::span<task_fn> tasks) {
+    const size_t pushed = pending_tasks_.push_batch(tasks.begin(), tasks.end());
+    if (pushed < tasks.size()) {
+        metrics_.tasks_rejected.fetch_add(tasks.size() - pushed, std::memory_order_relaxed);
+    }
+    if (pushed == 0) {
+        return 0;
+    }
+    metrics_.tasks_scheduled.fetch_add(pushed, std::memory_order_relaxed);
+    pending_count_.fetch_add(static_cast<uint32_t>(pushed), std::memory_order_relaxed);
+    wake_if_sleeping("schedule_wakeup");
+    return pushed;
+}
+
+// Pairs with the fence in run(): either the loop sees the new work before it blocks, or the
+// producer sees it blocking and writes the eventfd. While the loop is awake nothing is written;
+// it checks the queues again before its next wait.
+void io_uring_reactor::wake_if_sleeping(std::string_view location) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!sleeping_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    bool expected = false;
+    if (!needs_wakeup_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return; // another producer's wakeup is already on its way
     }
-    metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
-    timeout_dirty_.store(true, std::memory_order_relaxed);
 
     uint64_t val = 1;
     ssize_t ret;
@@ -338,11 +346,21 @@ bool io_uring_reactor::schedule_after(std::chrono::milliseconds delay, task_fn t
     } while (ret < 0 && errno == EINTR);
 
     if (ret < 0 && errno != EAGAIN) {
-        handle_exception("schedule_timer_wakeup",
+        handle_exception(location,
                          std::make_exception_ptr(std::system_error(
                              errno, std::system_category(), "eventfd write failed")));
     }
+}
 
+bool io_uring_reactor::schedule_after(std::chrono::milliseconds delay, task_fn task) {
+    auto deadline = std::chrono::steady_clock::now() + delay;
+    if (!pending_timers_.try_push(timer_entry{deadline, std::move(task)})) {
+        metrics_.tasks_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    metrics_.tasks_scheduled.fetch_add(1, std::memory_order_relaxed);
+    timeout_dirty_.store(true, std::memory_order_relaxed);
+    wake_if_sleeping("schedule_timer_wakeup");
     return true;
 }
 
@@ -398,6 +416,7 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
     if (ret < 0 && ret != -ETIME && ret != -EAGAIN) {
         return std::unexpected(std::error_code(-ret, std::system_category()));
     }
+    poll_time_ = std::chrono::steady_clock::now();
 
     unsigned count = 0;
     io_uring_cqe* current_cqe;
@@ -405,8 +424,8 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
         int32_t fd =
             static_cast<int32_t>(reinterpret_cast<uintptr_t>(io_uring_cqe_get_data(current_cqe)));
 
-        if (fd >= 0 && static_cast<size_t>(fd) < fd_states_.size() &&
-            fd_states_[static_cast<size_t>(fd)].callback) {
+        fd_state* found = find_fd_state(fd);
+        if (found && found->callback) {
 
             int res = current_cqe->res;
 
@@ -414,7 +433,7 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
                 if (res == -ECANCELED) {
                     continue;
                 }
-                event_callback callback_copy = fd_states_[static_cast<size_t>(fd)].callback;
+                event_callback callback_copy = found->callback;
                 if (callback_copy) {
                     try {
                         callback_copy(event_type::error);
@@ -425,7 +444,7 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
                 }
             } else {
                 event_type ev = from_poll_events(static_cast<uint32_t>(res));
-                event_callback callback_copy = fd_states_[static_cast<size_t>(fd)].callback;
+                event_callback callback_copy = found->callback;
 
                 if (!callback_copy) {
                     continue;
@@ -438,9 +457,9 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
                     handle_exception("fd_callback", std::current_exception(), fd);
                 }
 
-                if (fd_states_[static_cast<size_t>(fd)].registered &&
-                    !has_flag(fd_states_[static_cast<size_t>(fd)].events, event_type::oneshot)) {
-                    submit_poll_add(fd, fd_states_[static_cast<size_t>(fd)].events);
+                // The slot stays put even if the callback registered other fds
+                if (found->registered && !has_flag(found->events, event_type::oneshot)) {
+                    submit_poll_add(fd, found->events);
                 }
             }
         }
@@ -456,39 +475,47 @@ result<void> io_uring_reactor::process_completions(int32_t timeout_ms) {
 void io_uring_reactor::process_tasks() {
     uint32_t to_process = pending_count_.exchange(0, std::memory_order_relaxed);
     needs_wakeup_.store(false, std::memory_order_release);
+    if (to_process == 0) {
+        return;
+    }
 
-    for (uint32_t i = 0; i < to_process; ++i) {
-        auto task = pending_tasks_.pop();
-        if (!task)
+    std::array<task_fn, TASK_BATCH_SIZE> batch;
+    while (to_process > 0) {
+        const size_t popped =
+            pending_tasks_.pop_batch(batch.begin(), std::min<size_t>(to_process, batch.size()));
+        if (popped == 0) {
             break;
-        try {
-            (*task)();
-            metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-        } catch (...) {
-            handle_exception("scheduled_task", std::current_exception());
         }
+        to_process -= static_cast<uint32_t>(popped);
+
+        uint64_t executed = 0;
+        for (size_t i = 0; i < popped; ++i) {
+            try {
+                batch[i]();
+                ++executed;
+            } catch (...) {
+                handle_exception("scheduled_task", std::current_exception());
+            }
+            batch[i] = task_fn{};
+        }
+        metrics_.tasks_executed.fetch_add(executed, std::memory_order_relaxed);
     }
 }
 
 void io_uring_reactor::process_timers() {
     while (auto timer = pending_timers_.pop()) {
-        timers_.push(std::move(*timer));
+        timers_.add_at(timer->deadline, [this, task = std::move(timer->task)]() {
+            try {
+                task();
+                metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
+                metrics_.timers_fired.fetch_add(1, std::memory_order_relaxed);
+            } catch (...) {
+                handle_exception("delayed_task", std::current_exception());
+            }
+        });
     }
 
-    auto now = std::chrono::steady_clock::now();
-
-    while (!timers_.empty() && timers_.top().deadline <= now) {
-        auto task = std::move(timers_.top().task);
-        timers_.pop();
-
-        try {
-            task();
-            metrics_.tasks_executed.fetch_add(1, std::memory_order_relaxed);
-            metrics_.timers_fired.fetch_add(1, std::memory_order_relaxed);
-        } catch (...) {
-            handle_exception("delayed_task", std::current_exception());
-        }
-    }
+    timers_.tick();
 }
 
 int32_t io_uring_reactor::calculate_timeout() const {
@@ -507,26 +534,11 @@ int32_t io_uring_reactor::calculate_timeout() const {
         }
     }
 
-    auto min_timeout = std::chrono::milliseconds::max();
-
-    if (!timers_.empty()) {
-        auto deadline = timers_.top().deadline;
-        if (deadline <= now) {
-            timeout_dirty_.store(true, std::memory_order_relaxed);
-            return 0;
-        }
-        auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
-        min_timeout = std::min(min_timeout, delta);
-    }
-
-    auto wheel_timeout = wheel_timer_.time_until_next_expiration(now);
-    if (wheel_timeout == std::chrono::milliseconds::zero()) {
+    auto min_timeout = timers_.time_until_next_expiration(now);
+    if (min_timeout == std::chrono::milliseconds::zero()) {
         timeout_dirty_.store(true, std::memory_order_relaxed);
         return 0;
     }
-    if (wheel_timeout != std::chrono::milliseconds::max()) {
-        min_timeout = std::min(min_timeout, wheel_timeout);
-    }
 
     if (graceful_shutdown_.load(std::memory_order_relaxed)) {
         auto graceful_timeout = time_until_graceful_deadline(now);
@@ -565,10 +577,6 @@ uint64_t io_uring_reactor::get_load_score() const noexcept {
     return active_fds * 100 + pending_tasks * 50 + pending_timers_count * 10;
 }
 
-void io_uring_reactor::process_wheel_timer() {
-    wheel_timer_.tick();
-}
-
 void io_uring_reactor::setup_fd_timeout(int32_t fd, fd_state& state) {
     auto timeout = fd_timeout_for(state);
 
@@ -578,13 +586,13 @@ void io_uring_reactor::setup_fd_timeout(int32_t fd, fd_state& state) {
         state.activity_timer.reset();
     }
 
-    state.timeout_id = wheel_timer_.add(timeout, [this, fd]() {
-        if (fd < 0 || static_cast<size_t>(fd) >= fd_states_.size()) {
+    state.timeout_id = timers_.add(timeout, [this, fd]() {
+        fd_state* found = find_fd_state(fd);
+        if (!found) {
             return;
         }
 
-        auto index = static_cast<size_t>(fd);
-        auto& entry_state = fd_states_[index];
+        auto& entry_state = *found;
         if (!entry_state.callback) {
             entry_state.timeout_id = 0;
             entry_state.activity_timer = Timeout{};
@@ -610,13 +618,13 @@ void io_uring_reactor::setup_fd_timeout(int32_t fd, fd_state& state) {
             handle_exception("timeout_handler", std::current_exception(), fd);
         }
 
-        fd_states_[index] = fd_state{};
+        entry_state = fd_state{};
     });
 }
 
 void io_uring_reactor::cancel_fd_timeout(fd_state& state) {
     if (state.timeout_id != 0) {
-        (void)wheel_timer_.cancel(state.timeout_id);
+        (void)timers_.cancel(state.timeout_id);
         state.timeout_id = 0;
     }
     state.activity_timer = Timeout{};
@@ -645,26 +653,10 @@ result<void> io_uring_reactor::ensure_fd_capacity(int32_t fd) {
         return std::unexpected(make_error_code(error_code::invalid_fd));
     }
 
-    size_t index = static_cast<size_t>(fd);
-    if (index < fd_states_.size()) {
-        return {};
-    }
-
-    size_t new_size = fd_states_.empty() ? 64 : fd_states_.size();
-    while (new_size <= index) {
-        if (new_size > fd_states_.max_size() / 2) {
-            new_size = index + 1;
-            break;
-        }
-        new_size = std::max(new_size * 2, index + 1);
-    }
-
-    try {
-        fd_states_.resize(new_size);
-    } catch (const std::bad_alloc&) {
+    // Allocates the fd's page if needed; live fd_states never move
+    if (!fd_states_.ensure(static_cast<size_t>(fd))) {
         return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
     }
-
     return {};
 }
 
@@ -0,0 +1,286 @@
+#include "katana/core/json_index.hpp"
+
+#include "katana/core/simd_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace katana::serde {
+
+namespace {
+
+constexpr size_t block_size = 64;
+constexpr size_t min_entries = 1024;
+constexpr uint64_t even_bits = 0x5555555555555555ULL;
+constexpr uint64_t odd_bits = ~even_bits;
+
+// '[' | 0x20 == '{' and ']' | 0x20 == '}', so one OR folds both bracket kinds together
+constexpr char open_folded = '{';
+constexpr char close_folded = '}';
+
+struct block_masks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t open;  // { [
+    uint64_t close; // } ]
+    uint64_t punct; // : ,
+};
+
+inline block_masks classify_scalar(const char* p) noexcept {
+    block_masks m{0, 0, 0, 0, 0};
+    for (size_t i = 0; i < block_size; ++i) {
+        const uint64_t bit = uint64_t{1} << i;
+        switch (p[i]) {
+        case '"':
+            m.quote |= bit;
+            break;
+        case '\\':
+            m.backslash |= bit;
+            break;
+        case '{':
+        case '[':
+            m.open |= bit;
+            break;
+        case '}':
+        case ']':
+            m.close |= bit;
+            break;
+        case ':':
+        case ',':
+            m.punct |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+    return m;
+}
+
+#if defined(KATANA_HAS_AVX2)
+inline uint64_t movemask64(__m256i lo, __m256i hi) noexcept {
+    const auto lo_bits = static_cast<uint32_t>(_mm256_movemask_epi8(lo));
+    const auto hi_bits = static_cast<uint32_t>(_mm256_movemask_epi8(hi));
+    return uint64_t{lo_bits} | (uint64_t{hi_bits} << 32);
+}
+
+inline uint64_t eq64(__m256i lo, __m256i hi, char c) noexcept {
+    const __m256i needle = _mm256_set1_epi8(c);
+    return movemask64(_mm256_cmpeq_epi8(lo, needle), _mm256_cmpeq_epi8(hi, needle));
+}
+
+inline block_masks classify(const char* p) noexcept {
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    const __m256i case_bit = _mm256_set1_epi8(0x20);
+    const __m256i lo_folded = _mm256_or_si256(lo, case_bit);
+    const __m256i hi_folded = _mm256_or_si256(hi, case_bit);
+    return block_masks{
+        eq64(lo, hi, '"'),
+        eq64(lo, hi, '\\'),
+        eq64(lo_folded, hi_folded, open_folded),
+        eq64(lo_folded, hi_folded, close_folded),
+        eq64(lo, hi, ':') | eq64(lo, hi, ','),
+    };
+}
+#elif defined(KATANA_HAS_SSE2)
+inline uint64_t movemask16(__m128i v, int shift) noexcept {
+    return uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(v))} << shift;
+}
+
+inline block_masks classify(const char* p) noexcept {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i open = _mm_set1_epi8(open_folded);
+    const __m128i close = _mm_set1_epi8(close_folded);
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    block_masks m{0, 0, 0, 0, 0};
+    for (int i = 0; i < 4; ++i) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+        const __m128i folded = _mm_or_si128(v, case_bit);
+        m.quote |= movemask16(_mm_cmpeq_epi8(v, quote), i * 16);
+        m.backslash |= movemask16(_mm_cmpeq_epi8(v, backslash), i * 16);
+        m.open |= movemask16(_mm_cmpeq_epi8(folded, open), i * 16);
+        m.close |= movemask16(_mm_cmpeq_epi8(folded, close), i * 16);
+        m.punct |= movemask16(
+            _mm_or_si128(_mm_cmpeq_epi8(v, colon), _mm_cmpeq_epi8(v, comma)), i * 16);
+    }
+    return m;
+}
+#else
+inline block_masks classify(const char* p) noexcept {
+    return classify_scalar(p);
+}
+#endif
+
+// Bits of characters preceded by an odd-length run of backslashes, i.e. escaped ones.
+// `prev_odd` carries a run that reaches the end of the previous block.
+inline uint64_t escaped_mask(uint64_t backslash, uint64_t& prev_odd) noexcept {
+    const uint64_t start_edges = backslash & ~(backslash << 1);
+    const uint64_t even_start_mask = even_bits ^ prev_odd;
+    const uint64_t even_starts = start_edges & even_start_mask;
+    const uint64_t odd_starts = start_edges & ~even_start_mask;
+    const uint64_t even_carries = backslash + even_starts;
+
+    uint64_t odd_carries = 0;
+    const bool ends_odd = __builtin_add_overflow(backslash, odd_starts, &odd_carries);
+    odd_carries |= prev_odd;
+    prev_odd = ends_odd ? 1 : 0;
+
+    const uint64_t even_carry_ends = even_carries & ~backslash;
+    const uint64_t odd_carry_ends = odd_carries & ~backslash;
+    return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+}
+
+// Bit i = XOR of bits 0..i: 1 from an opening quote up to (not including) its closing quote.
+inline uint64_t prefix_xor(uint64_t x) noexcept {
+#if defined(__PCLMUL__)
+    const __m128i all_ones = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i value = _mm_set_epi64x(0, static_cast<long long>(x));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_clmulepi64_si128(value, all_ones, 0)));
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+} // namespace
+
+void json_structural_index::clear() noexcept {
+    count_ = 0;
+    stack_.clear();
+    base_ = nullptr;
+    length_ = 0;
+    valid_ = false;
+}
+
+void json_structural_index::shrink(size_t max_entries) noexcept {
+    if (positions_.size() > max_entries) {
+        std::vector<uint32_t>().swap(positions_);
+        std::vector<uint32_t>().swap(matches_);
+    }
+}
+
+void json_structural_index::grow(size_t entries) {
+    const size_t size = std::max({entries, positions_.size() * 2, min_entries});
+    positions_.resize(size);
+    matches_.resize(size);
+}
+
+bool json_structural_index::build(std::string_view json) {
+    clear();
+    if (json.size() >= UINT32_MAX) {
+        return false;
+    }
+
+    uint64_t prev_odd_backslash = 0;
+    uint64_t prev_in_string = 0;
+    const size_t full_blocks = json.size() / block_size;
+    const size_t tail = json.size() % block_size;
+
+    bool balanced = true;
+
+    auto process = [&](const block_masks& raw, const char* block, uint32_t offset) {
+        const uint64_t escaped = escaped_mask(raw.backslash, prev_odd_backslash);
+        const uint64_t quotes = raw.quote & ~escaped;
+        const uint64_t in_string = prefix_xor(quotes) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        const uint64_t brackets = (raw.open | raw.close) & ~in_string;
+        const uint64_t entries = brackets | (raw.punct & ~in_string) | quotes;
+        // A block adds at most one entry per byte; most documents have far fewer entries than
+        // bytes, so storage follows the entry count rather than the input size
+        if (positions_.size() < count_ + block_size) {
+            grow(count_ + block_size);
+        }
+        uint64_t bits = entries;
+        const size_t first = count_;
+        uint32_t* out = positions_.data() + first;
+        count_ += static_cast<size_t>(__builtin_popcountll(bits));
+        while (bits != 0) {
+            *out++ = offset + static_cast<uint32_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+
+        // Pair brackets so a cursor can jump over whole subtrees. A bracket's entry index is
+        // the block's first entry plus the number of entries below it in this block.
+        for (uint64_t pending = brackets; pending != 0; pending &= pending - 1) {
+            const int bit = __builtin_ctzll(pending);
+            const uint64_t below = entries & ((uint64_t{1} << bit) - 1);
+            const auto entry = static_cast<uint32_t>(first) +
+                               static_cast<uint32_t>(__builtin_popcountll(below));
+            if ((raw.open >> bit) & 1) {
+                stack_.push_back(entry);
+                continue;
+            }
+            if (stack_.empty()) {
+                balanced = false;
+                return;
+            }
+            const uint32_t open = stack_.back();
+            stack_.pop_back();
+            // Same kind iff both are curly or both square: they differ only in bit 0x20
+            if (((block[bit] ^ json[positions_[open]]) & 0x20) != 0) {
+                balanced = false;
+                return;
+            }
+            matches_[open] = entry;
+        }
+    };
+
+    for (size_t b = 0; b < full_blocks && balanced; ++b) {
+        const char* block = json.data() + b * block_size;
+        process(classify(block), block, static_cast<uint32_t>(b * block_size));
+    }
+    if (tail != 0 && balanced) {
+        char padded[block_size];
+        std::memset(padded, ' ', sizeof(padded));
+        std::memcpy(padded, json.data() + full_blocks * block_size, tail);
+        process(classify_scalar(padded), padded, static_cast<uint32_t>(full_blocks * block_size));
+    }
+
+    if (!balanced || prev_in_string != 0 || !stack_.empty()) {
+        clear();
+        return false;
+    }
+
+    base_ = json.data();
+    length_ = json.size();
+    valid_ = true;
+    return true;
+}
+
+size_t json_structural_index::seek(uint32_t offset, size_t hint) const noexcept {
+    const size_t n = count_;
+    if (hint > n || (hint > 0 && positions_[hint - 1] >= offset)) {
+        hint = 0;
+    }
+    // Cursors mostly move to the next few entries; fall back to binary search for jumps
+    for (size_t steps = 0; hint < n && steps < 8; ++steps, ++hint) {
+        if (positions_[hint] >= offset) {
+            return hint;
+        }
+    }
+    if (hint >= n) {
+        return n;
+    }
+    const uint32_t* first = positions_.data();
+    return static_cast<size_t>(std::lower_bound(first + hint, first + n, offset) - first);
+}
+
+namespace detail {
+
+thread_json_index& thread_json_index_slot() noexcept {
+    thread_local thread_json_index slot;
+    return slot;
+}
+
+} // namespace detail
+
+} // namespace katana::serde
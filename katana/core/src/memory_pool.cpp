@@ -0,0 +1,258 @@
+#include "katana/core/memory_pool.hpp"
+
+#include <mutex>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace katana {
+
+namespace {
+
+constexpr size_t MAX_POOLS = 256;
+
+// Pools by slot, so any thread can find the owner of a block it frees
+std::array<std::atomic<memory_pool*>, MAX_POOLS> registry{};
+std::atomic<size_t> registry_size{0};
+std::mutex registry_mutex;
+
+bool register_pool(memory_pool* pool) {
+    std::lock_guard lock(registry_mutex);
+    const size_t size = registry_size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size; ++i) {
+        if (!registry[i].load(std::memory_order_relaxed)) {
+            registry[i].store(pool, std::memory_order_release);
+            return true;
+        }
+    }
+    if (size == MAX_POOLS) {
+        return false;
+    }
+    registry[size].store(pool, std::memory_order_release);
+    registry_size.store(size + 1, std::memory_order_release);
+    return true;
+}
+
+void unregister_pool(memory_pool* pool) {
+    std::lock_guard lock(registry_mutex);
+    const size_t size = registry_size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < size; ++i) {
+        if (registry[i].load(std::memory_order_relaxed) == pool) {
+            registry[i].store(nullptr, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+#ifdef __linux__
+constexpr int MPOL_PREFERRED_MODE = 1; // <numaif.h> comes with libnuma, which is not required
+constexpr int HUGETLB_2MB_FLAG = 21 << MAP_HUGE_SHIFT;
+
+int current_numa_node() {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return -1;
+    }
+    return static_cast<int>(node);
+}
+#endif
+
+} // namespace
+
+thread_local memory_pool* memory_pool::current_ = nullptr;
+
+memory_pool::memory_pool(const memory_pool_config& config) : config_(config) {
+#ifdef __linux__
+    const size_t usable = (config_.reserve_bytes + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+    if (usable == 0 || usable < config_.reserve_bytes) {
+        return;
+    }
+
+    // Address space only: nothing is committed or counted against overcommit until a chunk is
+    // mapped over it. The extra chunk leaves room to align the range to CHUNK_SIZE.
+    mapping_size_ = usable + CHUNK_SIZE;
+    constexpr int reserve_flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    void* mapping = ::mmap(nullptr, mapping_size_, PROT_NONE, reserve_flags, -1, 0);
+    if (mapping == MAP_FAILED) {
+        mapping_size_ = 0;
+        return;
+    }
+    mapping_ = reinterpret_cast<uintptr_t>(mapping);
+    begin_ = (mapping_ + CHUNK_SIZE - 1) & ~(CHUNK_SIZE - 1);
+    end_ = begin_ + usable;
+    next_chunk_ = begin_;
+
+    if (config_.numa_local) {
+        numa_node_ = current_numa_node();
+    }
+
+    if (!register_pool(this)) {
+        ::munmap(mapping, mapping_size_);
+        mapping_ = begin_ = end_ = next_chunk_ = 0;
+        mapping_size_ = 0;
+    }
+#endif
+}
+
+memory_pool::~memory_pool() {
+    if (current_ == this) {
+        current_ = nullptr;
+    }
+#ifdef __linux__
+    if (mapping_ != 0) {
+        unregister_pool(this);
+        ::munmap(reinterpret_cast<void*>(mapping_), mapping_size_);
+    }
+#endif
+}
+
+void* memory_pool::try_allocate(size_t size) noexcept {
+    memory_pool* pool = current_;
+    if (!pool) {
+        return nullptr;
+    }
+    if (pool->valid() && size <= MAX_BLOCK_SIZE) {
+        if (void* p = pool->allocate_block(class_of(size))) {
+            ++pool->stats_.allocations;
+            return p;
+        }
+    }
+    ++pool->stats_.fallbacks;
+    return nullptr;
+}
+
+void* memory_pool::allocate(size_t size) noexcept {
+    if (void* p = try_allocate(size)) {
+        return p;
+    }
+    // Through the global operator new, so the heap fallback is seen by a replacement of it,
+    // alloc tracking included
+    return ::operator new(size, std::align_val_t{BLOCK_ALIGNMENT}, std::nothrow);
+}
+
+void memory_pool::deallocate(void* data, size_t size) noexcept {
+    if (!data) {
+        return;
+    }
+    memory_pool* pool = current_;
+    if (pool && pool->contains(data)) {
+        pool->free_block_local(data, class_of(size));
+        return;
+    }
+    if (memory_pool* owner = owner_of(data)) {
+        owner->free_block_remote(data, class_of(size));
+        return;
+    }
+    ::operator delete(data, std::align_val_t{BLOCK_ALIGNMENT});
+}
+
+memory_pool* memory_pool::owner_of(const void* data) noexcept {
+    if (current_ && current_->contains(data)) {
+        return current_;
+    }
+    const size_t size = registry_size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; ++i) {
+        memory_pool* pool = registry[i].load(std::memory_order_acquire);
+        if (pool && pool->contains(data)) {
+            return pool;
+        }
+    }
+    return nullptr;
+}
+
+void* memory_pool::allocate_block(size_t cls) noexcept {
+    auto& c = classes_[cls];
+    if (!c.head) {
+        collect_remote_frees();
+    }
+    if (c.head) {
+        free_block* b = c.head;
+        c.head = b->next;
+        return b;
+    }
+
+    if (c.carve == c.carve_end) {
+        if (next_chunk_ == end_ || !commit_chunk(next_chunk_)) {
+            return nullptr;
+        }
+        c.carve = next_chunk_;
+        c.carve_end = next_chunk_ + CHUNK_SIZE;
+        next_chunk_ += CHUNK_SIZE;
+    }
+    // Blocks sit at multiples of their size in a CHUNK_SIZE-aligned chunk, so they are aligned
+    // to their size as well
+    void* p = reinterpret_cast<void*>(c.carve);
+    c.carve += MIN_BLOCK_SIZE << cls;
+    return p;
+}
+
+void memory_pool::free_block_local(void* data, size_t cls) noexcept {
+    classes_[cls].head = new (data) free_block{classes_[cls].head, cls};
+}
+
+void memory_pool::free_block_remote(void* data, size_t cls) noexcept {
+    auto* b = new (data) free_block{nullptr, cls};
+    free_block* head = remote_frees_.load(std::memory_order_relaxed);
+    do {
+        b->next = head;
+    } while (!remote_frees_.compare_exchange_weak(
+        head, b, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// Only the owner takes the list, and it takes all of it, so there is no ABA problem
+void memory_pool::collect_remote_frees() noexcept {
+    free_block* b = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+    while (b) {
+        free_block* next = b->next;
+        free_block_local(b, b->size_class);
+        ++stats_.remote_frees;
+        b = next;
+    }
+}
+
+bool memory_pool::commit_chunk(uintptr_t chunk) noexcept {
+#ifdef __linux__
+    void* addr = reinterpret_cast<void*>(chunk);
+    constexpr int prot = PROT_READ | PROT_WRITE;
+    constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED;
+
+    bool huge = false;
+    if (config_.huge_pages == huge_page_mode::explicit_2m) {
+        // Fails when no huge pages are reserved (vm.nr_hugepages); then the chunk is remapped
+        // with regular pages below
+        huge = ::mmap(addr, CHUNK_SIZE, prot, flags | MAP_HUGETLB | HUGETLB_2MB_FLAG, -1, 0) !=
+               MAP_FAILED;
+    }
+    if (!huge) {
+        if (::mmap(addr, CHUNK_SIZE, prot, flags, -1, 0) == MAP_FAILED) {
+            return false;
+        }
+        if (config_.huge_pages != huge_page_mode::none) {
+            (void)::madvise(addr, CHUNK_SIZE, MADV_HUGEPAGE);
+        }
+    }
+
+    // Before the first touch, so the pages are faulted in on the reactor's node. Preferred
+    // rather than bound: a full node falls back to another instead of failing.
+    if (numa_node_ >= 0 && numa_node_ < 63) {
+        const unsigned long mask = 1UL << numa_node_;
+        (void)::syscall(SYS_mbind, addr, CHUNK_SIZE, MPOL_PREFERRED_MODE, &mask, 64UL, 0U);
+    }
+
+    stats_.committed_bytes += CHUNK_SIZE;
+    if (huge) {
+        ++stats_.huge_page_chunks;
+    }
+    return true;
+#else
+    (void)chunk;
+    return false;
+#endif
+}
+
+} // namespace katana
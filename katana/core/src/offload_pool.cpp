@@ -0,0 +1,96 @@
+#include "katana/core/offload_pool.hpp"
+#include "katana/core/cpu_info.hpp"
+
+#include <algorithm>
+
+namespace katana {
+
+namespace {
+
+void update_max(std::atomic<uint64_t>& target, uint64_t value) noexcept {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+offload_pool::offload_pool(const offload_pool_config& config)
+    : queue_(std::max<size_t>(config.queue_capacity, 1), false) {
+    size_t workers = config.worker_count;
+    if (workers == 0) {
+        workers = std::max<size_t>(cpu_info::core_count() / 2, 1);
+    }
+
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+offload_pool::~offload_pool() {
+    stop();
+}
+
+bool offload_pool::submit(job_fn job) {
+    if (stopping_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // Count before pushing so a fast worker never drives the depth below zero
+    uint64_t depth = metrics_.queue_depth.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (!queue_.try_push(queued_job{std::move(job), std::chrono::steady_clock::now(), false})) {
+        metrics_.queue_depth.fetch_sub(1, std::memory_order_relaxed);
+        metrics_.jobs_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    metrics_.jobs_submitted.fetch_add(1, std::memory_order_relaxed);
+    update_max(metrics_.queue_depth_max, depth);
+    return true;
+}
+
+void offload_pool::stop() {
+    if (stopping_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    // One sentinel per worker, queued behind the real jobs so they all run
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        queue_.push_wait(queued_job{job_fn{}, {}, true});
+    }
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void offload_pool::worker_loop() {
+    queued_job job;
+    for (;;) {
+        queue_.pop_wait(job);
+        if (job.stop) {
+            return;
+        }
+
+        metrics_.queue_depth.fetch_sub(1, std::memory_order_relaxed);
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - job.enqueued)
+                          .count();
+        auto waited_us = static_cast<uint64_t>(std::max<int64_t>(waited, 0));
+        metrics_.wait_time_total_us.fetch_add(waited_us, std::memory_order_relaxed);
+        update_max(metrics_.wait_time_max_us, waited_us);
+
+        try {
+            job.fn();
+        } catch (...) {
+            // Jobs report their own failures; never let one take down a worker
+        }
+        job.fn = job_fn{};
+        metrics_.jobs_completed.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace katana
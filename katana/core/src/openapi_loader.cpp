@@ -487,7 +487,8 @@ schema* parse_schema_object(json_cursor& cur,
             }
         } else if (*key == "pattern") {
             auto* s = ensure_schema(schema_kind::string);
-            if (auto v = cur.string()) {
+            // Decoded: a regex is all backslashes, which JSON escapes
+            if (auto v = cur.unescaped_string(*pool.arena)) {
                 s->pattern =
                     arena_string<>(v->begin(), v->end(), arena_allocator<char>(pool.arena));
             } else {
@@ -509,6 +510,13 @@ schema* parse_schema_object(json_cursor& cur,
             } else {
                 cur.skip_value();
             }
+        } else if (*key == "x-katana-partial") {
+            auto* s = ensure_schema(schema_kind::object);
+            if (auto v = parse_bool(cur)) {
+                s->x_katana_partial = *v;
+            } else {
+                cur.skip_value();
+            }
         } else if (*key == "enum") {
             auto* s = ensure_schema(schema_kind::string);
             if (cur.try_array_start()) {
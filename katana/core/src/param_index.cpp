@@ -0,0 +1,116 @@
+#include "katana/core/param_index.hpp"
+
+#include "katana/core/serde.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace katana::http {
+
+namespace {
+
+int hex_value(char c) noexcept {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+std::string_view query_string(std::string_view uri) noexcept {
+    auto qpos = uri.find('?');
+    if (qpos == std::string_view::npos) {
+        return {};
+    }
+    auto query = uri.substr(qpos + 1);
+    return query.substr(0, query.find('#'));
+}
+
+std::string_view percent_decode(std::string_view in, monotonic_arena& arena) noexcept {
+    if (in.find_first_of("%+") == std::string_view::npos) {
+        return in;
+    }
+
+    // Decoding only ever shrinks the input
+    auto* out = static_cast<char*>(arena.allocate(in.size(), 1));
+    if (!out) {
+        return in;
+    }
+
+    size_t len = 0;
+    for (size_t i = 0; i < in.size(); ++i) {
+        char c = in[i];
+        if (c == '+') {
+            out[len++] = ' ';
+        } else if (c == '%') {
+            if (i + 2 >= in.size()) {
+                return in;
+            }
+            int hi = hex_value(in[i + 1]);
+            int lo = hex_value(in[i + 2]);
+            if (hi < 0 || lo < 0) {
+                return in;
+            }
+            out[len++] = static_cast<char>((hi << 4) | lo);
+            i += 2;
+        } else {
+            out[len++] = c;
+        }
+    }
+    return std::string_view(out, len);
+}
+
+void param_index::parse() const noexcept {
+    built_ = true;
+    if (source_.empty() || !arena_) {
+        return;
+    }
+
+    const char separator = format_ == format::query ? '&' : ';';
+    const auto capacity =
+        static_cast<size_t>(std::count(source_.begin(), source_.end(), separator)) + 1;
+    auto* table = arena_->allocate_array<entry>(capacity);
+    if (!table) {
+        return;
+    }
+
+    size_t count = 0;
+    std::string_view rest = source_;
+    while (!rest.empty()) {
+        auto sep = rest.find(separator);
+        auto part = rest.substr(0, sep);
+        rest = sep == std::string_view::npos ? std::string_view{} : rest.substr(sep + 1);
+
+        auto eq = part.find('=');
+        std::string_view name = part.substr(0, eq);
+        std::string_view value =
+            eq == std::string_view::npos ? std::string_view{} : part.substr(eq + 1);
+
+        if (format_ == format::query) {
+            if (part.empty()) {
+                continue;
+            }
+            name = percent_decode(name, *arena_);
+            value = percent_decode(value, *arena_);
+        } else {
+            if (eq == std::string_view::npos) {
+                continue;
+            }
+            name = serde::trim_view(name);
+            value = serde::trim_view(value);
+        }
+        new (&table[count++]) entry(name, value);
+    }
+
+    entries_ = table;
+    size_ = count;
+}
+
+} // namespace katana::http
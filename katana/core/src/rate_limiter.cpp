@@ -0,0 +1,300 @@
+#include "katana/core/rate_limiter.hpp"
+#include "katana/core/cpu_info.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+namespace katana {
+
+namespace {
+
+constexpr uint64_t hash_key(std::string_view key) noexcept {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    // 0 marks an empty slot
+    return hash == 0 ? 1 : hash;
+}
+
+int64_t to_ns(rate_limiter::clock::time_point tp) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+} // namespace
+
+rate_limiter::rate_limiter(const rate_limit_config& config) : config_(config) {
+    shard_count_ = config_.shard_count != 0 ? config_.shard_count : cpu_info::core_count();
+    shard_count_ = std::max<size_t>(shard_count_, 1);
+
+    const size_t buckets = std::bit_ceil(std::max<size_t>(config_.buckets_per_shard, MAX_PROBES));
+    const size_t globals = std::bit_ceil(std::max<size_t>(config_.global_slots, MAX_PROBES));
+    bucket_mask_ = buckets - 1;
+    global_mask_ = globals - 1;
+
+    const double rps = config_.requests_per_second > 0.0 ? config_.requests_per_second : 1.0;
+    emission_ns_ = std::max<int64_t>(static_cast<int64_t>(std::llround(1e9 / rps)), 1);
+    burst_ns_ = emission_ns_ * static_cast<int64_t>(std::max<uint32_t>(config_.burst, 1));
+    reconcile_ns_ =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config_.reconcile_interval).count();
+    // A global slot untouched for this long is treated as free: every bucket that fed it
+    // would have refilled completely in the meantime.
+    global_stale_ns_ = burst_ns_ + 4 * reconcile_ns_;
+
+    shards_ = std::make_unique<shard[]>(shard_count_);
+    for (size_t i = 0; i < shard_count_; ++i) {
+        shards_[i].buckets = std::make_unique<bucket[]>(buckets);
+    }
+    if (reconcile_ns_ > 0) {
+        global_ = std::make_unique<global_slot[]>(globals);
+    }
+}
+
+rate_limiter::~rate_limiter() = default;
+
+rate_limit_decision rate_limiter::check(std::string_view key) noexcept {
+    return check(key, clock::now(), 0);
+}
+
+rate_limit_decision rate_limiter::check(std::string_view key, clock::time_point now) noexcept {
+    return check(key, now, 0);
+}
+
+rate_limit_decision
+rate_limiter::check(std::string_view key, clock::time_point now, size_t shard_index) noexcept {
+    return check_hash(shards_[shard_index % shard_count_], hash_key(key), to_ns(now));
+}
+
+rate_limit_decision rate_limiter::check_hash(shard& sh, uint64_t hash, int64_t now_ns) noexcept {
+    bucket* b = find_or_claim(sh, hash, now_ns);
+    if (!b) [[unlikely]] {
+        sh.table_full.fetch_add(1, std::memory_order_relaxed);
+        if (config_.deny_when_full) {
+            sh.rejected.fetch_add(1, std::memory_order_relaxed);
+            return {false, 0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::nanoseconds(emission_ns_))};
+        }
+        sh.allowed.fetch_add(1, std::memory_order_relaxed);
+        return {true, 0, std::chrono::milliseconds{0}};
+    }
+
+    if (reconcile_ns_ > 0) {
+        int64_t last = b->last_sync.load(std::memory_order_relaxed);
+        if (now_ns - last >= reconcile_ns_ &&
+            b->last_sync.compare_exchange_strong(last, now_ns, std::memory_order_acq_rel)) {
+            sync_bucket(sh, *b, now_ns);
+        }
+    }
+
+    int64_t tat = b->tat.load(std::memory_order_relaxed);
+    for (;;) {
+        const int64_t new_tat = std::max(tat, now_ns) + emission_ns_;
+        const int64_t debt = new_tat - now_ns;
+        if (debt > burst_ns_) {
+            sh.rejected.fetch_add(1, std::memory_order_relaxed);
+            const auto wait = std::chrono::nanoseconds(debt - burst_ns_);
+            auto retry = std::chrono::ceil<std::chrono::milliseconds>(wait);
+            return {false, 0, retry};
+        }
+        if (b->tat.compare_exchange_weak(tat, new_tat, std::memory_order_acq_rel)) {
+            if (reconcile_ns_ > 0) {
+                b->pending.fetch_add(1, std::memory_order_relaxed);
+            }
+            sh.allowed.fetch_add(1, std::memory_order_relaxed);
+            auto remaining = static_cast<uint32_t>((burst_ns_ - debt) / emission_ns_);
+            return {true, remaining, std::chrono::milliseconds{0}};
+        }
+    }
+}
+
+rate_limiter::bucket* rate_limiter::find_or_claim(shard& sh, uint64_t hash, int64_t now_ns) noexcept {
+    bucket* idle = nullptr;
+    uint64_t idle_key = 0;
+
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        bucket& b = sh.buckets[(hash + probe) & bucket_mask_];
+        uint64_t current = b.key.load(std::memory_order_acquire);
+        if (current == hash) {
+            return &b;
+        }
+        if (current == 0) {
+            if (b.key.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+                idle = &b;
+                break;
+            }
+            if (current == hash) {
+                return &b;
+            }
+        }
+        // A bucket whose TAT has passed is full again and carries no state worth keeping.
+        if (!idle && b.tat.load(std::memory_order_relaxed) <= now_ns) {
+            idle = &b;
+            idle_key = current;
+        }
+    }
+
+    if (!idle) {
+        return nullptr;
+    }
+    if (idle_key != 0 &&
+        !idle->key.compare_exchange_strong(idle_key, hash, std::memory_order_acq_rel)) {
+        return idle_key == hash ? idle : nullptr;
+    }
+
+    idle->tat.store(0, std::memory_order_relaxed);
+    idle->pending.store(0, std::memory_order_relaxed);
+    idle->seen_global.store(SEEN_UNSET, std::memory_order_relaxed);
+    idle->last_sync.store(now_ns, std::memory_order_relaxed);
+    if (reconcile_ns_ > 0) {
+        // Start from the current global count so earlier consumption on other shards is
+        // not charged to this bucket.
+        if (global_slot* g = find_or_claim_global(hash, now_ns)) {
+            idle->seen_global.store(g->consumed.load(std::memory_order_acquire),
+                                    std::memory_order_relaxed);
+        }
+    }
+    return idle;
+}
+
+rate_limiter::global_slot* rate_limiter::find_or_claim_global(uint64_t hash,
+                                                              int64_t now_ns) noexcept {
+    global_slot* stale = nullptr;
+    uint64_t stale_key = 0;
+
+    for (size_t probe = 0; probe < MAX_PROBES; ++probe) {
+        global_slot& g = global_[(hash + probe) & global_mask_];
+        uint64_t current = g.key.load(std::memory_order_acquire);
+        if (current == hash) {
+            return &g;
+        }
+        if (current == 0) {
+            if (g.key.compare_exchange_strong(current, hash, std::memory_order_acq_rel)) {
+                g.consumed.store(0, std::memory_order_relaxed);
+                g.last_update.store(now_ns, std::memory_order_release);
+                return &g;
+            }
+            if (current == hash) {
+                return &g;
+            }
+        }
+        if (!stale && now_ns - g.last_update.load(std::memory_order_relaxed) > global_stale_ns_) {
+            stale = &g;
+            stale_key = current;
+        }
+    }
+
+    if (!stale || !stale->key.compare_exchange_strong(stale_key, hash, std::memory_order_acq_rel)) {
+        return nullptr;
+    }
+    stale->consumed.store(0, std::memory_order_relaxed);
+    stale->last_update.store(now_ns, std::memory_order_release);
+    return stale;
+}
+
+void rate_limiter::sync_bucket(shard& sh, bucket& b, int64_t now_ns) noexcept {
+    const uint64_t hash = b.key.load(std::memory_order_acquire);
+    if (hash == 0) {
+        return;
+    }
+    global_slot* g = find_or_claim_global(hash, now_ns);
+    if (!g) {
+        return;
+    }
+
+    const uint64_t local = b.pending.exchange(0, std::memory_order_acq_rel);
+    const uint64_t total = g->consumed.fetch_add(local, std::memory_order_acq_rel) + local;
+    g->last_update.store(now_ns, std::memory_order_release);
+
+    const uint64_t seen = b.seen_global.exchange(total, std::memory_order_acq_rel);
+    sh.reconciliations.fetch_add(1, std::memory_order_relaxed);
+    // seen > total means the global slot was recycled; start over without a penalty.
+    if (seen == SEEN_UNSET || seen > total || total - seen <= local) {
+        return;
+    }
+
+    const uint64_t foreign = total - seen - local;
+    const int64_t cap = burst_ns_ + reconcile_ns_ * static_cast<int64_t>(shard_count_);
+    const int64_t penalty = foreign > static_cast<uint64_t>(cap / emission_ns_)
+                                ? cap
+                                : static_cast<int64_t>(foreign) * emission_ns_;
+
+    int64_t tat = b.tat.load(std::memory_order_relaxed);
+    int64_t charged = 0;
+    do {
+        charged = std::min(std::max(tat, now_ns) + penalty, now_ns + cap);
+    } while (!b.tat.compare_exchange_weak(tat, charged, std::memory_order_acq_rel));
+}
+
+void rate_limiter::reconcile(clock::time_point now) noexcept {
+    if (reconcile_ns_ <= 0) {
+        return;
+    }
+    const int64_t now_ns = to_ns(now);
+    for (size_t s = 0; s < shard_count_; ++s) {
+        shard& sh = shards_[s];
+        for (size_t i = 0; i <= bucket_mask_; ++i) {
+            bucket& b = sh.buckets[i];
+            if (b.key.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            int64_t last = b.last_sync.load(std::memory_order_relaxed);
+            if (b.last_sync.compare_exchange_strong(last, now_ns, std::memory_order_acq_rel)) {
+                sync_bucket(sh, b, now_ns);
+            }
+        }
+    }
+}
+
+rate_limiter_stats rate_limiter::stats() const noexcept {
+    rate_limiter_stats total;
+    for (size_t s = 0; s < shard_count_; ++s) {
+        const shard& sh = shards_[s];
+        total.allowed += sh.allowed.load(std::memory_order_relaxed);
+        total.rejected += sh.rejected.load(std::memory_order_relaxed);
+        total.table_full += sh.table_full.load(std::memory_order_relaxed);
+        total.reconciliations += sh.reconciliations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+namespace http {
+
+std::string_view extract_rate_limit_key(const request& req,
+                                        const request_context& ctx,
+                                        rate_limit_key key) noexcept {
+    switch (key.kind) {
+    case rate_limit_key_kind::client_address:
+        return ctx.client_address;
+    case rate_limit_key_kind::header:
+        return req.header(key.name).value_or(std::string_view{});
+    case rate_limit_key_kind::path_param:
+        return ctx.params.get(key.name).value_or(std::string_view{});
+    }
+    return {};
+}
+
+middleware_fn rate_limit_middleware(rate_limiter& limiter, rate_limit_key key) {
+    return [&limiter, key](const request& req, request_context& ctx, next_fn next)
+               -> result<response> {
+        auto decision = limiter.check(
+            extract_rate_limit_key(req, ctx, key), rate_limiter::clock::now(), ctx.reactor_index);
+        if (decision.allowed) {
+            return next();
+        }
+
+        auto seconds = std::chrono::ceil<std::chrono::seconds>(decision.retry_after).count();
+        char retry_buf[21];
+        auto [ptr, ec] =
+            std::to_chars(retry_buf, retry_buf + sizeof(retry_buf), std::max<int64_t>(seconds, 1));
+        auto res = response::error(problem_details::too_many_requests("Rate limit exceeded"));
+        res.set_header("Retry-After",
+                       std::string_view(retry_buf, static_cast<size_t>(ptr - retry_buf)));
+        return res;
+    };
+}
+
+} // namespace http
+} // namespace katana
@@ -122,6 +122,12 @@ void reactor_pool::worker_thread(reactor_context* ctx) {
         }
     }
 
+    if (config_.memory) {
+        // Created here so that with pinning its NUMA node is the one of the reactor's core
+        ctx->memory = std::make_unique<memory_pool>(*config_.memory);
+        memory_pool::set_current(ctx->memory.get());
+    }
+
     auto result = ctx->reactor->run();
     if (!result) {
         std::cerr << "[reactor_pool] Reactor error: " << result.error().message() << "\n";
@@ -0,0 +1,95 @@
+#include "katana/core/small_function.hpp"
+
+#include <array>
+#include <bit>
+#include <new>
+
+namespace katana::detail {
+
+namespace {
+
+constexpr size_t min_block_shift = 6; // 64 bytes
+constexpr size_t num_classes = 6;     // 64 B .. 2 KiB
+constexpr size_t max_block_size = size_t{1} << (min_block_shift + num_classes - 1);
+constexpr size_t max_cached_blocks = 64; // per class, so at most 252 KiB per thread
+
+struct free_block {
+    free_block* next;
+};
+
+struct size_class {
+    free_block* head = nullptr;
+    size_t count = 0;
+};
+
+// Trivially destructible so the thread's instance stays valid through thread exit; the guard
+// empties and disables it, after which blocks go straight back to operator delete
+struct function_block_cache {
+    std::array<size_class, num_classes> classes{};
+    bool enabled = true;
+};
+
+struct function_block_cache_guard {
+    function_block_cache& cache;
+
+    ~function_block_cache_guard() {
+        cache.enabled = false;
+        for (size_t i = 0; i < num_classes; ++i) {
+            auto& cls = cache.classes[i];
+            while (cls.head) {
+                free_block* b = cls.head;
+                cls.head = b->next;
+                ::operator delete(b, size_t{1} << (min_block_shift + i));
+            }
+            cls.count = 0;
+        }
+    }
+};
+
+function_block_cache& local_cache() noexcept {
+    thread_local constinit function_block_cache cache;
+    thread_local function_block_cache_guard guard{cache};
+    (void)guard;
+    return cache;
+}
+
+constexpr size_t class_of(size_t size) noexcept {
+    return size <= (size_t{1} << min_block_shift)
+               ? 0
+               : static_cast<size_t>(std::bit_width(size - 1)) - min_block_shift;
+}
+
+} // namespace
+
+void* allocate_function_block(size_t size) {
+    if (size > max_block_size) {
+        return ::operator new(size);
+    }
+    const size_t cls_index = class_of(size);
+    auto& cls = local_cache().classes[cls_index];
+    if (cls.head) {
+        free_block* b = cls.head;
+        cls.head = b->next;
+        --cls.count;
+        return b;
+    }
+    return ::operator new(size_t{1} << (min_block_shift + cls_index));
+}
+
+void free_function_block(void* block, size_t size) noexcept {
+    if (size > max_block_size) {
+        ::operator delete(block, size);
+        return;
+    }
+    const size_t cls_index = class_of(size);
+    auto& cache = local_cache();
+    auto& cls = cache.classes[cls_index];
+    if (!cache.enabled || cls.count >= max_cached_blocks) {
+        ::operator delete(block, size_t{1} << (min_block_shift + cls_index));
+        return;
+    }
+    cls.head = new (block) free_block{cls.head};
+    ++cls.count;
+}
+
+} // namespace katana::detail
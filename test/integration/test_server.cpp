@@ -0,0 +1,308 @@
+#include "katana/core/http_server.hpp"
+#include "katana/core/router.hpp"
+#include "katana/core/shutdown.hpp"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+#include <string_view>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace katana;
+
+namespace {
+
+// Runs `srv` on its own thread for the lifetime of the object
+class running_server {
+public:
+    explicit running_server(http::server& srv) {
+        srv.graceful_shutdown(std::chrono::milliseconds(200)).on_start([this] { started_ = true; });
+        thread_ = std::thread([&srv] { srv.run(); });
+        while (!started_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    ~running_server() {
+        shutdown_manager::instance().trigger_shutdown();
+        thread_.join();
+    }
+
+    running_server(const running_server&) = delete;
+    running_server& operator=(const running_server&) = delete;
+
+private:
+    std::atomic<bool> started_{false};
+    std::thread thread_;
+};
+
+class test_client {
+public:
+    explicit test_client(uint16_t port) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        timeval timeout{5, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connected_ = ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+    }
+
+    ~test_client() { close(); }
+
+    test_client(const test_client&) = delete;
+    test_client& operator=(const test_client&) = delete;
+
+    [[nodiscard]] bool connected() const noexcept { return connected_; }
+
+    bool send(std::string_view data) {
+        return ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL) ==
+               static_cast<ssize_t>(data.size());
+    }
+
+    // One Content-Length framed response, or "" on timeout or end of stream
+    std::string read_response() {
+        std::string response;
+        size_t expected = std::string::npos;
+        while (response.size() < expected) {
+            char chunk[4096];
+            ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return {};
+            }
+            response.append(chunk, static_cast<size_t>(n));
+
+            auto header_end = response.find("\r\n\r\n");
+            auto length_pos = response.find("Content-Length: ");
+            if (expected == std::string::npos && header_end != std::string::npos &&
+                length_pos < header_end) {
+                expected = header_end + 4 +
+                           std::strtoul(response.c_str() + length_pos + 16, nullptr, 10);
+            }
+        }
+        return response;
+    }
+
+    // Closes with an RST instead of a FIN, so the server sees an error on the socket
+    void reset() {
+        linger abort{1, 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+        close();
+    }
+
+    void close() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_ = -1;
+    bool connected_ = false;
+};
+
+bool is_ok(const std::string& response) {
+    return response.starts_with("HTTP/1.1 200");
+}
+
+constexpr std::string_view GET_ROOT = "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n";
+
+const http::route_entry hello_routes[] = {
+    {http::method::get,
+     http::path_pattern::from_literal<"/">(),
+     http::handler_fn([](const http::request&, http::request_context&) {
+         return http::response::ok("Hello");
+     })},
+};
+
+std::atomic<int> waiting_handlers{0};
+std::atomic<bool> release_waiting{false};
+
+const http::route_entry offload_routes[] = {
+    {http::method::get,
+     http::path_pattern::from_literal<"/">(),
+     http::handler_fn([](const http::request&, http::request_context&) {
+         return http::response::ok("Hello");
+     }),
+     {},
+     http::route_priority::normal,
+     true},
+    {http::method::get,
+     http::path_pattern::from_literal<"/wait">(),
+     http::handler_fn([](const http::request&, http::request_context&) {
+         ++waiting_handlers;
+         // Bounded, so a failed test cannot hang the offload pool's shutdown
+         for (int i = 0; i < 1000 && !release_waiting; ++i) {
+             std::this_thread::sleep_for(std::chrono::milliseconds(5));
+         }
+         return http::response::ok("Released");
+     }),
+     {},
+     http::route_priority::normal,
+     true},
+    {http::method::get,
+     http::path_pattern::from_literal<"/sleep">(),
+     http::handler_fn([](const http::request&, http::request_context&) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(600));
+         return http::response::ok("Slept");
+     }),
+     {},
+     http::route_priority::normal,
+     true},
+};
+
+std::atomic<uint32_t> seen_reactors{0}; // bit i: a request ran with reactor_index i
+
+const http::route_entry reactor_index_routes[] = {
+    {http::method::get,
+     http::path_pattern::from_literal<"/">(),
+     http::handler_fn([](const http::request&, http::request_context& ctx) {
+         seen_reactors |= ctx.reactor_index < 32 ? uint32_t{1} << ctx.reactor_index : 0;
+         return http::response::ok("Hello");
+     })},
+};
+
+// Polls `done` for up to five seconds
+template <typename Pred> bool eventually(Pred done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+}
+
+std::chrono::microseconds process_cpu_time() {
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    auto to_us = [](const timeval& tv) {
+        return std::chrono::seconds(tv.tv_sec) + std::chrono::microseconds(tv.tv_usec);
+    };
+    return to_us(usage.ru_utime) + to_us(usage.ru_stime);
+}
+
+} // namespace
+
+TEST(Server, KeepAliveConnectionWaitsForTheNextRequest) {
+    constexpr uint16_t port = 19181;
+    http::router rt(hello_routes);
+    http::server srv(rt);
+    srv.listen(port).workers(1);
+    running_server running(srv);
+
+    test_client client(port);
+    ASSERT_TRUE(client.connected());
+    ASSERT_TRUE(client.send(GET_ROOT));
+    EXPECT_TRUE(is_ok(client.read_response()));
+
+    // The server has long finished the first request and found the socket empty
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(client.send(GET_ROOT));
+    EXPECT_TRUE(is_ok(client.read_response()));
+}
+
+TEST(Server, OffloadedRouteAnswersOnTheConnection) {
+    constexpr uint16_t port = 19182;
+    http::router rt(offload_routes);
+    http::server srv(rt);
+    srv.listen(port).workers(1).offload({1, 16}).admission({});
+    running_server running(srv);
+
+    test_client client(port);
+    ASSERT_TRUE(client.connected());
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(client.send(GET_ROOT));
+        EXPECT_TRUE(is_ok(client.read_response()));
+    }
+
+    // A job counts as completed once the worker is done with it, just after the hand-back
+    EXPECT_TRUE(eventually([&srv] { return srv.offload_metrics().jobs_completed == 2; }));
+    EXPECT_EQ(srv.admission_metrics().in_flight, 0u);
+}
+
+TEST(Server, PeerResetWhileOffloadedClosesTheParkedConnection) {
+    constexpr uint16_t port = 19183;
+    waiting_handlers = 0;
+    release_waiting = false;
+    http::router rt(offload_routes);
+    http::server srv(rt);
+    srv.listen(port).workers(1).offload({1, 16}).admission({});
+    running_server running(srv);
+
+    {
+        test_client client(port);
+        ASSERT_TRUE(client.connected());
+        ASSERT_TRUE(client.send("GET /wait HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+        ASSERT_TRUE(eventually([] { return waiting_handlers > 0; }));
+        client.reset();
+    }
+
+    // The reset is reported while the handler still runs; a reactor polling the parked
+    // socket over and over would burn a core meanwhile
+    auto cpu_before = process_cpu_time();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LT(process_cpu_time() - cpu_before, std::chrono::microseconds(100000));
+
+    release_waiting = true;
+    ASSERT_TRUE(eventually([&srv] { return srv.offload_metrics().jobs_completed == 1; }));
+
+    test_client next(port);
+    ASSERT_TRUE(next.connected());
+    ASSERT_TRUE(next.send(GET_ROOT));
+    EXPECT_TRUE(is_ok(next.read_response()));
+    EXPECT_EQ(srv.admission_metrics().in_flight, 0u);
+}
+
+TEST(Server, ShutdownClosesAConnectionParkedPastTheDeadline) {
+    constexpr uint16_t port = 19184;
+    http::router rt(offload_routes);
+    http::server srv(rt);
+    srv.listen(port).workers(1).offload({1, 16});
+    auto running = std::make_unique<running_server>(srv);
+
+    test_client client(port);
+    ASSERT_TRUE(client.connected());
+    ASSERT_TRUE(client.send("GET /sleep HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // The handler outlives the 200ms graceful deadline: the reactor closes the parked
+    // connection and the worker's late response is dropped
+    running.reset();
+    EXPECT_EQ(client.read_response(), "");
+}
+
+TEST(Server, RequestsCarryTheIndexOfTheirReactor) {
+    constexpr uint16_t port = 19185;
+    constexpr size_t workers = 4;
+    http::router rt(reactor_index_routes);
+    http::server srv(rt);
+    srv.listen(port).workers(workers);
+    running_server running(srv);
+
+    seen_reactors = 0;
+    for (int i = 0; i < 32; ++i) {
+        test_client client(port);
+        ASSERT_TRUE(client.connected());
+        ASSERT_TRUE(client.send(GET_ROOT));
+        EXPECT_TRUE(is_ok(client.read_response()));
+    }
+
+    // Every index is a pool position, and SO_REUSEPORT spread the connections over several
+    const uint32_t seen = seen_reactors;
+    EXPECT_EQ(seen & ~((uint32_t{1} << workers) - 1), 0u);
+    EXPECT_GT(std::popcount(seen), 1);
+}
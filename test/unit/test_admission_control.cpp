@@ -0,0 +1,211 @@
+#include "katana/core/admission_control.hpp"
+
+#include "katana/core/http.hpp"
+#include "support/virtual_event_loop.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+
+using namespace katana;
+using namespace katana::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+using clock_type = admission_controller::clock;
+
+admission_config test_config() {
+    admission_config config;
+    config.target_delay = 5ms;
+    config.interval = 100ms;
+    config.retry_after = 2s;
+    return config;
+}
+
+request make_request(method m, std::string_view uri) {
+    request req;
+    req.http_method = m;
+    req.uri = uri;
+    req.headers = headers_map(nullptr);
+    return req;
+}
+
+} // namespace
+
+TEST(AdmissionControl, AdmitsWhenDelayBelowTarget) {
+    admission_controller ac(test_config());
+    auto t0 = clock_type::time_point{} + 1s;
+
+    for (int i = 0; i < 100; ++i) {
+        auto now = t0 + std::chrono::milliseconds(i * 10);
+        EXPECT_EQ(ac.admit(route_priority::normal, now - 1ms, now), admission_verdict::admit);
+        ac.complete();
+    }
+    EXPECT_FALSE(ac.overloaded());
+    EXPECT_EQ(ac.metrics().snapshot().requests_admitted, 100u);
+    EXPECT_EQ(ac.metrics().snapshot().requests_shed, 0u);
+}
+
+TEST(AdmissionControl, ShedsNormalOnlyAfterSustainedDelay) {
+    admission_controller ac(test_config());
+    auto t0 = clock_type::time_point{} + 1s;
+
+    // Above target, but not yet for a whole interval
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 - 10ms, t0), admission_verdict::admit);
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 + 40ms, t0 + 50ms), admission_verdict::admit);
+    EXPECT_FALSE(ac.overloaded());
+
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 + 90ms, t0 + 100ms),
+              admission_verdict::shed_delay);
+    EXPECT_TRUE(ac.overloaded());
+    EXPECT_EQ(ac.admit(route_priority::critical, t0 + 90ms, t0 + 100ms), admission_verdict::admit);
+
+    // A request below target ends the episode
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 + 109ms, t0 + 110ms), admission_verdict::admit);
+    EXPECT_FALSE(ac.overloaded());
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 + 110ms, t0 + 120ms), admission_verdict::admit);
+
+    auto snapshot = ac.metrics().snapshot();
+    EXPECT_EQ(snapshot.requests_shed, 1u);
+    EXPECT_EQ(snapshot.overload_episodes, 1u);
+    EXPECT_EQ(snapshot.queue_delay_max_us, 10000u);
+}
+
+TEST(AdmissionControl, LowPriorityShedAsSoonAsLate) {
+    admission_controller ac(test_config());
+    auto t0 = clock_type::time_point{} + 1s;
+
+    EXPECT_EQ(ac.admit(route_priority::low, t0 - 1ms, t0), admission_verdict::admit);
+    EXPECT_EQ(ac.admit(route_priority::low, t0 - 6ms, t0), admission_verdict::shed_delay);
+    EXPECT_EQ(ac.admit(route_priority::normal, t0 - 6ms, t0), admission_verdict::admit);
+}
+
+TEST(AdmissionControl, InFlightLimit) {
+    auto config = test_config();
+    config.max_in_flight = 2;
+    admission_controller ac(config);
+    auto now = clock_type::time_point{} + 1s;
+
+    EXPECT_EQ(ac.admit(route_priority::normal, now, now), admission_verdict::admit);
+    EXPECT_EQ(ac.admit(route_priority::normal, now, now), admission_verdict::admit);
+    EXPECT_EQ(ac.admit(route_priority::normal, now, now), admission_verdict::shed_in_flight);
+    EXPECT_EQ(ac.admit(route_priority::critical, now, now), admission_verdict::admit);
+    EXPECT_EQ(ac.in_flight(), 3u);
+
+    ac.complete();
+    ac.complete();
+    EXPECT_EQ(ac.admit(route_priority::normal, now, now), admission_verdict::admit);
+    EXPECT_EQ(ac.metrics().snapshot().shed_in_flight, 1u);
+    EXPECT_EQ(ac.metrics().snapshot().in_flight, 2u);
+}
+
+TEST(AdmissionControl, ShedResponseIsPreSerialized) {
+    admission_controller ac(test_config());
+
+    std::string keep_alive(ac.shed_response(true));
+    std::string close(ac.shed_response(false));
+    EXPECT_EQ(keep_alive.rfind("HTTP/1.1 503 Service Unavailable\r\n", 0), 0u);
+    EXPECT_NE(keep_alive.find("Retry-After: 2\r\n"), std::string::npos);
+    EXPECT_NE(keep_alive.find("Connection: keep-alive\r\n"), std::string::npos);
+    EXPECT_NE(close.find("Connection: close\r\n"), std::string::npos);
+    EXPECT_NE(keep_alive.find("application/problem+json"), std::string::npos);
+}
+
+TEST(AdmissionControl, RouterGateSkipsHandler) {
+    int calls = 0;
+    route_entry routes[] = {
+        route_entry{method::get,
+                    path_pattern::from_literal<"/report">(),
+                    handler_fn([&calls](const request&, request_context&) {
+                        ++calls;
+                        return response::ok("report");
+                    }),
+                    {},
+                    route_priority::low},
+    };
+    router r(routes);
+    monotonic_arena arena;
+
+    request_context ctx{arena};
+    route_priority seen = route_priority::critical;
+    auto shed = r.dispatch_with_info(
+        make_request(method::get, "/report"), ctx, [&](const route_entry& route) {
+            seen = route.priority;
+            return false;
+        });
+    EXPECT_EQ(seen, route_priority::low);
+    EXPECT_EQ(calls, 0);
+    ASSERT_FALSE(shed.route_response);
+    EXPECT_EQ(shed.route_response.error(), make_error_code(error_code::request_shed));
+    EXPECT_EQ(map_dispatch_error(std::move(shed)).status, 503);
+
+    request_context ctx_ok{arena};
+    auto ok = r.dispatch_with_info(
+        make_request(method::get, "/report"), ctx_ok, [](const route_entry&) { return true; });
+    ASSERT_TRUE(ok.route_response);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(AdmissionControl, BoundsQueueingDelayUnderOverload) {
+    using katana::test_support::VirtualEventLoop;
+
+    VirtualEventLoop loop;
+    admission_controller ac(test_config());
+
+    // One reactor: requests arrive every 1ms but each admitted one costs 2ms of CPU.
+    // Shedding a request costs nothing (pre-serialized response).
+    std::deque<VirtualEventLoop::time_point> queue;
+    bool busy = false;
+    auto max_admitted_delay = VirtualEventLoop::duration::zero();
+    uint64_t admitted = 0;
+
+    std::function<void()> worker = [&]() {
+        while (!queue.empty()) {
+            auto arrived = queue.front();
+            queue.pop_front();
+            auto verdict = ac.admit(route_priority::normal, arrived, loop.now());
+            if (verdict == admission_verdict::admit) {
+                ++admitted;
+                max_admitted_delay = std::max(max_admitted_delay, loop.now() - arrived);
+                ac.complete();
+                loop.post_after(2ms, worker);
+                return;
+            }
+        }
+        busy = false;
+    };
+
+    auto arrive = [&]() {
+        queue.push_back(loop.now());
+        if (!busy) {
+            busy = true;
+            loop.post(worker);
+        }
+    };
+
+    for (int i = 0; i < 1000; ++i) {
+        loop.post_at(loop.now() + std::chrono::milliseconds(i), arrive);
+    }
+    loop.run_all();
+
+    auto overloaded = ac.metrics().snapshot();
+    EXPECT_GT(overloaded.requests_shed, 0u);
+    EXPECT_GT(overloaded.overload_episodes, 0u);
+    EXPECT_GT(admitted, 400u);
+    // Without shedding the last request would wait ~1s
+    EXPECT_LT(max_admitted_delay, 150ms);
+
+    // Load drops below capacity: nothing more is shed
+    auto start = loop.now();
+    for (int i = 0; i < 200; ++i) {
+        loop.post_at(start + std::chrono::milliseconds(i * 5), arrive);
+    }
+    loop.run_all();
+    EXPECT_EQ(ac.metrics().snapshot().requests_shed, overloaded.requests_shed);
+    EXPECT_FALSE(ac.overloaded());
+}
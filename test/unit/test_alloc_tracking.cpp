@@ -0,0 +1,119 @@
+#include "katana/core/alloc_tracking.hpp"
+#include "katana/core/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <new>
+
+using namespace katana;
+
+namespace {
+
+constexpr uint64_t expected(uint64_t count) {
+    return alloc_tracking::enabled ? count : 0;
+}
+
+size_t index(alloc_phase phase) {
+    return static_cast<size_t>(phase);
+}
+
+// A volatile pointer keeps the compiler from pairing up and dropping the calls
+void allocate_and_free(size_t bytes) {
+    void* volatile ptr = ::operator new(bytes);
+    ::operator delete(ptr);
+}
+
+} // namespace
+
+TEST(AllocTracking, PhaseScopeCountsIntoTheCurrentPhase) {
+    alloc_phase_counters counters{};
+    monotonic_arena arena(4096);
+    {
+        alloc_tracking::phase_scope allocs(alloc_phase::parse, counters);
+        allocate_and_free(48);
+        allocate_and_free(16);
+
+        allocs.enter(alloc_phase::dispatch);
+        EXPECT_NE(arena.allocate(100), nullptr);
+    }
+    allocate_and_free(8); // after the scope, not counted into `counters`
+
+    const auto& parse = counters[index(alloc_phase::parse)];
+    EXPECT_EQ(parse.heap_allocations, expected(2));
+    EXPECT_EQ(parse.heap_bytes, expected(64));
+    EXPECT_EQ(parse.heap_frees, expected(2));
+    EXPECT_EQ(parse.arena_allocations, 0u);
+
+    const auto& dispatch = counters[index(alloc_phase::dispatch)];
+    EXPECT_EQ(dispatch.heap_allocations, 0u);
+    EXPECT_EQ(dispatch.arena_allocations, expected(1));
+    EXPECT_EQ(dispatch.arena_bytes, expected(100));
+    EXPECT_TRUE(counters[index(alloc_phase::write)] == alloc_counters{});
+}
+
+TEST(AllocTracking, ThreadCountersFollowThePhase) {
+    const alloc_phase_counters before = alloc_tracking::thread_phases();
+    alloc_phase_counters counters{};
+    {
+        alloc_tracking::phase_scope allocs(alloc_phase::serialize, counters);
+        allocate_and_free(32);
+    }
+    allocate_and_free(32);
+
+    const alloc_phase_counters after = alloc_tracking::thread_phases();
+    const size_t serialize = index(alloc_phase::serialize);
+    const size_t other = index(alloc_phase::other);
+    EXPECT_EQ(after[serialize].heap_allocations - before[serialize].heap_allocations,
+              expected(1));
+    EXPECT_EQ(after[other].heap_allocations - before[other].heap_allocations, expected(1));
+}
+
+TEST(AllocTracking, NestedScopesRestoreTheOuterOne) {
+    alloc_phase_counters outer{};
+    alloc_phase_counters inner{};
+    {
+        alloc_tracking::phase_scope outer_scope(alloc_phase::dispatch, outer);
+        {
+            alloc_tracking::phase_scope inner_scope(alloc_phase::serialize, inner);
+            allocate_and_free(8);
+        }
+        allocate_and_free(8);
+    }
+    EXPECT_EQ(inner[index(alloc_phase::serialize)].heap_allocations, expected(1));
+    EXPECT_EQ(outer[index(alloc_phase::dispatch)].heap_allocations, expected(1));
+    EXPECT_EQ(outer[index(alloc_phase::serialize)].heap_allocations, 0u);
+}
+
+TEST(AllocTracking, CountsArenaBlocksThatMissTheCache) {
+    // Above the block cache's largest class, and no memory pool on this thread: the block
+    // comes from the heap fallback of memory_pool::allocate()
+    constexpr size_t block_size = 2 * arena_block_cache::MAX_CLASS_SIZE;
+    const uint64_t misses = arena_block_cache::local().stats().misses;
+    alloc_phase_counters counters{};
+    {
+        alloc_tracking::phase_scope allocs(alloc_phase::parse, counters);
+        monotonic_arena arena(block_size);
+        EXPECT_NE(arena.allocate(100), nullptr);
+    }
+    EXPECT_EQ(arena_block_cache::local().stats().misses, misses + 1);
+
+    const auto& parse = counters[index(alloc_phase::parse)];
+    EXPECT_EQ(parse.heap_allocations, expected(1));
+    EXPECT_GE(parse.heap_bytes, expected(block_size));
+    EXPECT_EQ(parse.heap_frees, expected(1));
+    EXPECT_EQ(parse.arena_allocations, expected(1));
+}
+
+TEST(AllocTracking, PauseScopeStopsCounting) {
+    alloc_phase_counters counters{};
+    const alloc_counters before = alloc_tracking::thread_totals();
+    {
+        alloc_tracking::phase_scope allocs(alloc_phase::write, counters);
+        alloc_tracking::pause_scope pause;
+        allocate_and_free(64);
+    }
+    const alloc_counters after = alloc_tracking::thread_totals();
+
+    EXPECT_TRUE(counters[index(alloc_phase::write)] == alloc_counters{});
+    EXPECT_EQ(after.heap_allocations, before.heap_allocations);
+}
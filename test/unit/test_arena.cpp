@@ -0,0 +1,172 @@
+#include "katana/core/arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace katana;
+
+namespace {
+
+// Each test runs on its own thread so it starts from an empty cache
+template <typename Fn> void on_fresh_thread(Fn&& fn) {
+    std::thread(std::forward<Fn>(fn)).join();
+}
+
+} // namespace
+
+TEST(MonotonicArena, GrowsGeometricallyWithoutABlockLimit) {
+    monotonic_arena arena(8192);
+    // Far more than the 32 fixed-size blocks the arena used to be limited to
+    for (size_t i = 0; i < 4096; ++i) {
+        auto* p = static_cast<uint8_t*>(arena.allocate(1024));
+        ASSERT_NE(p, nullptr);
+        p[0] = p[1023] = 1;
+    }
+    EXPECT_EQ(arena.bytes_allocated(), 4096u * 1024u);
+    // 8K, 16K, ... 1M, then 1M blocks
+    EXPECT_LE(arena.block_count(), 12u);
+    EXPECT_GE(arena.total_capacity(), 4096u * 1024u);
+}
+
+TEST(MonotonicArena, OversizedAllocationsGetTheirOwnBlock) {
+    monotonic_arena arena(8192);
+    auto* first = static_cast<uint8_t*>(arena.allocate(64, 1));
+    ASSERT_NE(arena.allocate(256 * 1024), nullptr);
+    EXPECT_EQ(arena.block_count(), 2u);
+    // The first block is still being filled
+    EXPECT_EQ(static_cast<uint8_t*>(arena.allocate(64, 1)), first + 64);
+}
+
+TEST(MonotonicArena, ResetKeepsTheLargestBlock) {
+    monotonic_arena arena(8192);
+    auto serve_request = [&] {
+        for (size_t i = 0; i < 100; ++i) {
+            ASSERT_NE(arena.allocate(1000), nullptr);
+        }
+        arena.reset();
+    };
+
+    serve_request();
+    EXPECT_EQ(arena.block_count(), 1u);
+    EXPECT_EQ(arena.bytes_allocated(), 0u);
+    EXPECT_EQ(arena.peak_bytes_allocated(), 100000u);
+
+    // Similar requests stop acquiring blocks after the first few
+    serve_request();
+    serve_request();
+    const auto acquired = arena.blocks_acquired();
+    for (int i = 0; i < 10; ++i) {
+        serve_request();
+    }
+    EXPECT_EQ(arena.blocks_acquired(), acquired);
+    EXPECT_EQ(arena.block_count(), 1u);
+    EXPECT_EQ(arena.peak_bytes_allocated(), 100000u);
+}
+
+TEST(MonotonicArena, MoveTransfersBlocks) {
+    monotonic_arena a(4096);
+    auto* p = static_cast<char*>(a.allocate(10));
+    ASSERT_NE(p, nullptr);
+    monotonic_arena b(std::move(a));
+    EXPECT_EQ(a.block_count(), 0u);
+    EXPECT_EQ(b.block_count(), 1u);
+    EXPECT_EQ(b.bytes_allocated(), 10u);
+    EXPECT_NE(a.allocate(10), nullptr);
+}
+
+TEST(ArenaBlockCache, SizeClasses) {
+    EXPECT_EQ(arena_block_cache::block_size_for(1), 4096u);
+    EXPECT_EQ(arena_block_cache::block_size_for(4096), 4096u);
+    EXPECT_EQ(arena_block_cache::block_size_for(4097), 8192u);
+    EXPECT_EQ(arena_block_cache::block_size_for(64 * 1024 + 64), 128u * 1024u);
+    EXPECT_EQ(arena_block_cache::block_size_for(1024 * 1024), 1024u * 1024u);
+    EXPECT_EQ(arena_block_cache::block_size_for(1024 * 1024 + 1), 1024u * 1024u + 64u);
+}
+
+TEST(ArenaBlockCache, ArenasReuseBlocksOfDestroyedArenas) {
+    on_fresh_thread([] {
+        auto& cache = arena_block_cache::local();
+        void* first = nullptr;
+        {
+            monotonic_arena arena(8192);
+            first = arena.allocate(100);
+            ASSERT_NE(first, nullptr);
+            EXPECT_EQ(arena.total_capacity(), 8192u);
+        }
+        EXPECT_EQ(cache.stats().misses, 1u);
+        EXPECT_EQ(cache.stats().returns, 1u);
+        EXPECT_EQ(cache.stats().cached_bytes, 8192u);
+
+        for (int i = 0; i < 100; ++i) {
+            monotonic_arena arena(8192);
+            EXPECT_EQ(arena.allocate(100), first);
+        }
+        EXPECT_EQ(cache.stats().misses, 1u);
+        EXPECT_EQ(cache.stats().hits, 100u);
+        EXPECT_EQ(cache.stats().cached_blocks, 1u);
+
+        // A different size class does not take the cached block
+        {
+            monotonic_arena arena(4096);
+            ASSERT_NE(arena.allocate(100), nullptr);
+        }
+        EXPECT_EQ(cache.stats().misses, 2u);
+        EXPECT_EQ(cache.stats().cached_blocks, 2u);
+    });
+}
+
+TEST(ArenaBlockCache, LargeBlocksBypassTheCache) {
+    on_fresh_thread([] {
+        auto& cache = arena_block_cache::local();
+        {
+            monotonic_arena arena(4096);
+            ASSERT_NE(arena.allocate(2 * 1024 * 1024), nullptr);
+        }
+        EXPECT_EQ(cache.stats().cached_blocks, 0u);
+        EXPECT_EQ(cache.stats().frees, 1u);
+    });
+}
+
+TEST(ArenaBlockCache, LimitAndTrim) {
+    on_fresh_thread([] {
+        auto& cache = arena_block_cache::local();
+        cache.set_max_cached_bytes(3 * 4096);
+
+        std::vector<void*> blocks;
+        for (int i = 0; i < 5; ++i) {
+            blocks.push_back(cache.acquire(4096));
+        }
+        for (void* b : blocks) {
+            cache.release(b, 4096);
+        }
+        EXPECT_EQ(cache.stats().cached_blocks, 3u);
+        EXPECT_EQ(cache.stats().frees, 2u);
+
+        // Blocks in use at some point since the previous trim survive it
+        (void)cache.trim();
+        void* in_use = cache.acquire(4096);
+        EXPECT_EQ(cache.trim(), 2u * 4096u);
+        EXPECT_EQ(cache.stats().cached_blocks, 0u);
+        cache.release(in_use, 4096);
+        EXPECT_EQ(cache.trim(), 0u);
+        EXPECT_EQ(cache.trim(), 4096u);
+
+        cache.release(cache.acquire(4096), 4096);
+        cache.set_max_cached_bytes(0);
+        EXPECT_EQ(cache.stats().cached_bytes, 0u);
+    });
+}
+
+TEST(ArenaBlockCache, BlocksCanBeReturnedOnAnotherThread) {
+    monotonic_arena arena(8192);
+    const auto returns_before = arena_block_cache::local().stats().returns;
+    on_fresh_thread([&arena] {
+        monotonic_arena local(8192);
+        ASSERT_NE(local.allocate(10), nullptr);
+        arena = std::move(local);
+    });
+    arena = monotonic_arena(8192);
+    EXPECT_EQ(arena_block_cache::local().stats().returns, returns_before + 1);
+}
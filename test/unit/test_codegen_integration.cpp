@@ -159,6 +159,74 @@ components:
     EXPECT_FALSE(json_content.empty());
     EXPECT_NE(json_content.find("parse_Config"), std::string::npos);
     EXPECT_NE(json_content.find("serialize_Config"), std::string::npos);
+
+    // Serializers write straight into a presized buffer, keys as constant prefixes
+    EXPECT_NE(json_content.find("json_size_bound_Config(const Config& obj)"), std::string::npos);
+    EXPECT_NE(json_content.find("serialize_Config_to(const Config& obj, char* out)"),
+              std::string::npos);
+    EXPECT_NE(json_content.find(R"(w.raw("{\"enabled\":");)"), std::string::npos);
+    EXPECT_NE(json_content.find(R"(w.raw(",\"timeout\":");)"), std::string::npos);
+    EXPECT_EQ(json_content.find("json.append("), std::string::npos);
+    EXPECT_NE(json_content.find("inline auto stream_Config_array(Range&& items)"),
+              std::string::npos);
+}
+
+TEST_F(CodegenIntegrationTest, PartialSchemaBecomesLazyView) {
+    const char* spec = R"(
+openapi: 3.0.0
+info:
+  title: Test API
+  version: 1.0.0
+paths: {}
+components:
+  schemas:
+    Order:
+      type: object
+      x-katana-partial: true
+      required: [id]
+      properties:
+        id:
+          type: integer
+        note:
+          type: string
+          maxLength: 64
+        items:
+          type: array
+          items:
+            type: string
+)";
+
+    create_openapi_spec("test.yaml", spec);
+    ASSERT_TRUE(run_codegen("test.yaml", "dto,serdes,validator"));
+
+    auto dto_content = read_generated_file("generated_dtos.hpp");
+    EXPECT_NE(dto_content.find("katana::serde::json_view json_;"), std::string::npos);
+    EXPECT_NE(dto_content.find("std::optional<int64_t> id() const"), std::string::npos);
+    EXPECT_NE(dto_content.find("std::optional<std::string_view> note() const"),
+              std::string::npos);
+    EXPECT_NE(dto_content.find("katana::serde::json_view items() const"), std::string::npos);
+    EXPECT_NE(dto_content.find(R"(json_["note"].as_string(*arena_))"), std::string::npos);
+
+    auto json_content = read_generated_file("generated_json.hpp");
+    EXPECT_NE(json_content.find("obj.json_ = katana::serde::json_view(json);"),
+              std::string::npos);
+    EXPECT_EQ(json_content.find("keys.find"), std::string::npos);
+
+    // Required members are still looked up in the body; value constraints are not checked
+    auto validator_content = read_generated_file("generated_validators.hpp");
+    EXPECT_NE(validator_content.find(R"(obj.json_["id"]; !v || v.is_null())"), std::string::npos);
+    EXPECT_NE(validator_content.find("v.type() != katana::serde::json_type::number"),
+              std::string::npos);
+    EXPECT_EQ(validator_content.find(R"(obj.json_["note"])"), std::string::npos);
+
+    // Escaped strings are decoded into the body's arena with std containers too
+    ASSERT_TRUE(run_codegen("test.yaml", "dto,serdes", "--alloc std"));
+    dto_content = read_generated_file("generated_dtos.hpp");
+    EXPECT_NE(dto_content.find("explicit Order(katana::monotonic_arena* arena)"),
+              std::string::npos);
+    EXPECT_NE(dto_content.find(R"(json_["note"].as_string(*arena_))"), std::string::npos);
+    json_content = read_generated_file("generated_json.hpp");
+    EXPECT_NE(json_content.find("Order obj(arena);"), std::string::npos);
 }
 
 TEST_F(CodegenIntegrationTest, GeneratesRouteTable) {
@@ -277,9 +345,11 @@ paths:
     ASSERT_TRUE(run_codegen("test.yaml", "all"));
 
     auto bindings = read_generated_file("generated_router_bindings.hpp");
-    EXPECT_NE(bindings.find("query_param(req.uri, \"page\")"), std::string::npos);
+    EXPECT_NE(bindings.find("from_literal<\"/items/{id:int}\">"), std::string::npos);
+    EXPECT_NE(bindings.find("ctx.params.get_int(\"id\")"), std::string::npos);
+    EXPECT_NE(bindings.find("ctx.query.get(\"page\")"), std::string::npos);
     EXPECT_NE(bindings.find("req.headers.get(\"X-Trace\")"), std::string::npos);
-    EXPECT_NE(bindings.find("cookie_param(req, \"session\")"), std::string::npos);
+    EXPECT_NE(bindings.find("ctx.cookies.get(\"session\")"), std::string::npos);
     EXPECT_NE(bindings.find("unsupported Content-Type"), std::string::npos);
     EXPECT_NE(bindings.find("not_acceptable"), std::string::npos);
 
@@ -321,6 +391,112 @@ components:
     EXPECT_NE(validator_content.find("invalid date-time format"), std::string::npos);
 }
 
+TEST_F(CodegenIntegrationTest, CompilesPatternsAtGenerationTime) {
+    const char* spec = R"(
+openapi: 3.0.0
+info:
+  title: Pattern API
+  version: 1.0.0
+paths: {}
+components:
+  schemas:
+    Order:
+      type: object
+      properties:
+        code:
+          type: string
+          pattern: '^[A-Z]{3}-\d{4}$'
+        ref:
+          type: string
+          pattern: '^[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}$'
+)";
+
+    create_openapi_spec("patterns.yaml", spec);
+    ASSERT_TRUE(run_codegen("patterns.yaml", "dto,validator"));
+
+    auto dto_content = read_generated_file("generated_dtos.hpp");
+    EXPECT_NE(dto_content.find(R"(CODE_PATTERN = "^[A-Z]{3}-\\d{4}$")"), std::string::npos);
+
+    auto validator_content = read_generated_file("generated_validators.hpp");
+    EXPECT_NE(validator_content.find("static constexpr katana::pattern_dfa<"), std::string::npos);
+    EXPECT_NE(validator_content.find("!dfa_.matches(obj.code)"), std::string::npos);
+    // A pattern with a hand-written equivalent gets the checker instead of a table
+    EXPECT_NE(validator_content.find("!katana::is_lowercase_uuid(obj.ref)"), std::string::npos);
+    EXPECT_EQ(validator_content.find("#include <regex>"), std::string::npos);
+
+    // Backreferences are beyond a finite automaton: std::regex stays for those
+    create_openapi_spec("patterns.yaml", std::string(spec) + R"(        twice:
+          type: string
+          pattern: '^(\w+)-\1$'
+)");
+    ASSERT_TRUE(run_codegen("patterns.yaml", "dto,validator"));
+    validator_content = read_generated_file("generated_validators.hpp");
+    EXPECT_NE(validator_content.find("#include <regex>"), std::string::npos);
+    EXPECT_NE(validator_content.find("std::regex_match(obj.twice, re_)"), std::string::npos);
+    EXPECT_NE(validator_content.find("!dfa_.matches(obj.code)"), std::string::npos);
+}
+
+TEST_F(CodegenIntegrationTest, FusesBodyValidationIntoParser) {
+    const char* spec = R"(
+openapi: 3.0.0
+info:
+  title: Fused API
+  version: 1.0.0
+paths:
+  /users:
+    post:
+      operationId: createUser
+      requestBody:
+        required: true
+        content:
+          application/json:
+            schema:
+              $ref: '#/components/schemas/NewUser'
+      responses:
+        '204':
+          description: created
+components:
+  schemas:
+    NewUser:
+      type: object
+      required: [email]
+      properties:
+        email:
+          type: string
+          format: email
+        nick:
+          type: string
+          maxLength: 16
+)";
+
+    create_openapi_spec("fused.yaml", spec);
+    ASSERT_TRUE(run_codegen("fused.yaml"));
+
+    auto json_content = read_generated_file("generated_json.hpp");
+    auto fused =
+        json_content.find("inline std::optional<validation_error> parse_validated_NewUser(");
+    ASSERT_NE(fused, std::string::npos);
+    // Each value is checked in its own case, before the next key is read
+    auto email_case = json_content.find("case 0: { // email", fused);
+    auto email_check = json_content.find("!is_valid_email(obj.email)", fused);
+    auto nick_case = json_content.find("case 1: { // nick", fused);
+    ASSERT_NE(nick_case, std::string::npos);
+    EXPECT_LT(email_case, email_check);
+    EXPECT_LT(email_check, nick_case);
+    EXPECT_NE(json_content.find("NICK_MAX_LENGTH", nick_case), std::string::npos);
+
+    auto bindings = read_generated_file("generated_router_bindings.hpp");
+    EXPECT_NE(bindings.find("parse_validated_NewUser(req.body, &ctx.arena, candidate)"),
+              std::string::npos);
+    EXPECT_EQ(bindings.find("validate_NewUser("), std::string::npos);
+
+    ASSERT_TRUE(run_codegen("fused.yaml", "all", "--validation separate"));
+    json_content = read_generated_file("generated_json.hpp");
+    EXPECT_EQ(json_content.find("parse_validated_"), std::string::npos);
+    bindings = read_generated_file("generated_router_bindings.hpp");
+    EXPECT_NE(bindings.find("validate_NewUser(*parsed_body)"), std::string::npos);
+}
+
 TEST_F(CodegenIntegrationTest, RouterBindingsUseNegotiation) {
     const char* spec = R"(
 openapi: 3.0.0
@@ -358,6 +534,89 @@ paths:
     EXPECT_NE(bindings.find("set_header(\"Content-Type\""), std::string::npos);
 }
 
+TEST_F(CodegenIntegrationTest, MsgPackMediaTypesSelectMsgPackCodecs) {
+    const char* spec = R"(
+openapi: 3.0.0
+info:
+  title: MessagePack API
+  version: 1.0.0
+paths:
+  /points:
+    post:
+      operationId: createPoint
+      requestBody:
+        required: true
+        content:
+          application/json:
+            schema:
+              $ref: '#/components/schemas/Point'
+          application/msgpack:
+            schema:
+              $ref: '#/components/schemas/Point'
+      responses:
+        '200':
+          description: ok
+          content:
+            application/json:
+              schema:
+                $ref: '#/components/schemas/Point'
+            application/msgpack:
+              schema:
+                $ref: '#/components/schemas/Point'
+components:
+  schemas:
+    Point:
+      type: object
+      required: [x]
+      properties:
+        x:
+          type: integer
+          minimum: 0
+        label:
+          type: string
+)";
+
+    create_openapi_spec("msgpack.yaml", spec);
+    ASSERT_TRUE(run_codegen("msgpack.yaml"));
+
+    auto codecs = read_generated_file("generated_msgpack.hpp");
+    EXPECT_NE(codecs.find("inline std::optional<Point> parse_msgpack_Point("), std::string::npos);
+    EXPECT_NE(codecs.find("inline char* serialize_msgpack_Point_to("), std::string::npos);
+    EXPECT_NE(codecs.find("inline katana::http::response encode_Point("), std::string::npos);
+    // Keys are written as precomputed fixstr headers
+    EXPECT_NE(codecs.find(R"(w.raw("\xa1" "x");)"), std::string::npos);
+
+    // JSON is parsed and checked in one pass; the MessagePack case validates after decoding
+    auto bindings = read_generated_file("generated_router_bindings.hpp");
+    EXPECT_NE(bindings.find("#include \"generated_msgpack.hpp\""), std::string::npos);
+    EXPECT_NE(bindings.find("parse_validated_Point(req.body"), std::string::npos);
+    auto msgpack_case = bindings.find("parse_msgpack_Point(req.body, &ctx.arena)");
+    ASSERT_NE(msgpack_case, std::string::npos);
+    EXPECT_NE(bindings.find("validate_Point(*candidate)", msgpack_case), std::string::npos);
+    EXPECT_NE(bindings.find("ctx.response_type = *negotiated_response;"), std::string::npos);
+
+    // JSON-only specs are unchanged unless the codecs are asked for
+    create_openapi_spec("json_only.yaml", R"(
+openapi: 3.0.0
+info:
+  title: JSON API
+  version: 1.0.0
+paths: {}
+components:
+  schemas:
+    Point:
+      type: object
+      properties:
+        x:
+          type: integer
+)");
+    fs::remove(temp_dir / "generated_msgpack.hpp");
+    ASSERT_TRUE(run_codegen("json_only.yaml"));
+    EXPECT_FALSE(fs::exists(temp_dir / "generated_msgpack.hpp"));
+    ASSERT_TRUE(run_codegen("json_only.yaml", "dto,serdes,msgpack"));
+    EXPECT_TRUE(fs::exists(temp_dir / "generated_msgpack.hpp"));
+}
+
 TEST_F(CodegenIntegrationTest, InlineNamingFlagProducesFlatNames) {
     const char* spec = R"(
 openapi: 3.0.0
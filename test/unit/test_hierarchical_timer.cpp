@@ -0,0 +1,206 @@
+#include "katana/core/hierarchical_timer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace katana;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// Time is driven with explicit time points relative to the timer's origin throughout
+
+TEST(HierarchicalTimer, FiresOnItsDeadlineTick) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<> timer(t0);
+
+    bool called = false;
+    timer.add(milliseconds(5), [&]() { called = true; }, t0);
+    EXPECT_EQ(timer.pending_count(), 1u);
+
+    timer.tick(t0 + microseconds(4999));
+    EXPECT_FALSE(called);
+    timer.tick(t0 + milliseconds(5));
+    EXPECT_TRUE(called);
+    EXPECT_EQ(timer.pending_count(), 0u);
+}
+
+TEST(HierarchicalTimer, SubMillisecondTicks) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<8, 4, 250> timer(t0);
+
+    int fired = 0;
+    timer.add(microseconds(600), [&]() { ++fired; }, t0);
+    timer.add(microseconds(750), [&]() { ++fired; }, t0);
+
+    timer.tick(t0 + microseconds(500));
+    EXPECT_EQ(fired, 0);
+    timer.tick(t0 + microseconds(750));
+    EXPECT_EQ(fired, 2);
+}
+
+TEST(HierarchicalTimer, LongTimeoutsCascadeToTheirExactTick) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<> timer(t0);
+
+    // One timeout on each level, each firing exactly on its millisecond
+    const std::vector<milliseconds> timeouts{milliseconds(200),
+                                             milliseconds(30'000),
+                                             milliseconds(600'000),
+                                             milliseconds(5 * 3'600'000)};
+    std::vector<bool> fired(timeouts.size(), false);
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        timer.add(timeouts[i], [&fired, i]() { fired[i] = true; }, t0);
+    }
+
+    for (size_t i = 0; i < timeouts.size(); ++i) {
+        timer.tick(t0 + timeouts[i] - milliseconds(1));
+        EXPECT_FALSE(fired[i]);
+        timer.tick(t0 + timeouts[i]);
+        EXPECT_TRUE(fired[i]);
+    }
+}
+
+TEST(HierarchicalTimer, TimeoutsBeyondTheTopLevelWaitInOverflow) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<4, 2> timer(t0); // 256 ms of range
+
+    bool called = false;
+    timer.add(milliseconds(1000), [&]() { called = true; }, t0);
+    for (int64_t ms = 100; ms < 1000; ms += 100) {
+        timer.tick(t0 + milliseconds(ms));
+        EXPECT_FALSE(called);
+    }
+    timer.tick(t0 + milliseconds(999));
+    EXPECT_FALSE(called);
+    timer.tick(t0 + milliseconds(1000));
+    EXPECT_TRUE(called);
+}
+
+TEST(HierarchicalTimer, CancelIsImmediate) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<> timer(t0);
+
+    bool called = false;
+    const auto id = timer.add(milliseconds(100), [&]() { called = true; }, t0);
+    const auto other = timer.add(milliseconds(100), []() {}, t0);
+    EXPECT_TRUE(timer.cancel(id));
+    EXPECT_FALSE(timer.cancel(id));
+    EXPECT_EQ(timer.pending_count(), 1u);
+    EXPECT_FALSE(timer.cancel(999));
+
+    timer.tick(t0 + milliseconds(100));
+    EXPECT_FALSE(called);
+    EXPECT_FALSE(timer.cancel(other));
+    EXPECT_EQ(timer.pending_count(), 0u);
+}
+
+TEST(HierarchicalTimer, CallbacksCanCancelAndAdd) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<> timer(t0);
+
+    int fired = 0;
+    hierarchical_timer<>::timeout_id first = 0;
+    hierarchical_timer<>::timeout_id second = 0;
+    // Whichever of the two same-tick timeouts runs first cancels the other
+    first = timer.add(milliseconds(10), [&]() { ++fired, (void)timer.cancel(second); }, t0);
+    second = timer.add(milliseconds(10), [&]() { ++fired, (void)timer.cancel(first); }, t0);
+    timer.add(
+        milliseconds(10),
+        [&]() { timer.add(milliseconds(5), [&]() { fired += 10; }, t0 + milliseconds(10)); },
+        t0);
+
+    timer.tick(t0 + milliseconds(10));
+    EXPECT_EQ(fired, 1);
+    timer.tick(t0 + milliseconds(14));
+    EXPECT_EQ(fired, 1);
+    timer.tick(t0 + milliseconds(15));
+    EXPECT_EQ(fired, 11);
+}
+
+TEST(HierarchicalTimer, NextExpirationNeverLate) {
+    const auto t0 = hierarchical_timer<>::clock::now();
+    hierarchical_timer<> timer(t0);
+    EXPECT_EQ(timer.time_until_next_expiration(t0), milliseconds::max());
+
+    timer.add(milliseconds(40), []() {}, t0);
+    EXPECT_EQ(timer.time_until_next_expiration(t0), milliseconds(40));
+    EXPECT_EQ(timer.time_until_next_expiration(t0 + microseconds(10'500)), milliseconds(30));
+
+    // A far timeout is reported no later than its deadline; waking for a cascade is allowed
+    hierarchical_timer<> far(t0);
+    far.add(milliseconds(100'000), []() {}, t0);
+    const auto wait = far.time_until_next_expiration(t0);
+    EXPECT_GT(wait, milliseconds(0));
+    EXPECT_LE(wait, milliseconds(100'000));
+}
+
+// Random adds, cancels and uneven ticks on a small wheel that cascades and overflows often;
+// every timeout must fire in the first tick() that reaches its deadline, and the predicted
+// wait must never overshoot the next firing.
+TEST(HierarchicalTimer, MatchesReferenceModel) {
+    using timer_type = hierarchical_timer<3, 3>; // 512 ms of range
+    const auto t0 = timer_type::clock::now();
+    timer_type timer(t0);
+
+    std::map<timer_type::timeout_id, int64_t> expected; // id -> deadline in ms
+    std::vector<std::pair<int64_t, int64_t>> firings;   // (deadline, previous tick)
+    uint64_t seed = 12345;
+    auto next_random = [&](uint64_t bound) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return (seed >> 33) % bound;
+    };
+
+    int64_t now = 0;
+    int64_t previous = 0;
+    for (int step = 0; step < 20000; ++step) {
+        const auto op = next_random(10);
+        if (op < 5) {
+            const auto delay = static_cast<int64_t>(next_random(op == 0 ? 3000 : 100) + 1);
+            auto id = std::make_shared<timer_type::timeout_id>(0);
+            *id = timer.add(
+                milliseconds(delay),
+                [&, id]() {
+                    EXPECT_LE(expected[*id], now);
+                    firings.emplace_back(expected[*id], previous);
+                    expected.erase(*id);
+                },
+                t0 + milliseconds(now));
+            expected[*id] = now + delay;
+        } else if (op < 7 && !expected.empty()) {
+            auto it = expected.begin();
+            std::advance(it, static_cast<long>(next_random(expected.size())));
+            EXPECT_TRUE(timer.cancel(it->first));
+            expected.erase(it);
+        } else {
+            const auto wait = timer.time_until_next_expiration(t0 + milliseconds(now));
+            int64_t earliest = INT64_MAX;
+            for (const auto& [id, deadline] : expected) {
+                earliest = std::min(earliest, deadline);
+            }
+            if (expected.empty()) {
+                EXPECT_EQ(wait, milliseconds::max());
+            } else {
+                EXPECT_LE(now + wait.count(), earliest);
+            }
+            previous = now;
+            now += static_cast<int64_t>(next_random(op == 9 ? 600 : 20));
+            timer.tick(t0 + milliseconds(now));
+        }
+        EXPECT_EQ(timer.pending_count(), expected.size());
+    }
+
+    ASSERT_FALSE(firings.empty());
+    for (const auto& [deadline, previous_tick] : firings) {
+        EXPECT_GT(deadline, previous_tick);
+    }
+    for (const auto& [id, deadline] : expected) {
+        EXPECT_GT(deadline, now);
+    }
+}
@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 
+#include <optional>
+
 using namespace katana;
 using namespace katana::http;
 using katana::monotonic_arena;
@@ -303,6 +305,61 @@ TEST(HttpResponse, CustomHeaders) {
     EXPECT_TRUE(serialized.find("X-Request-ID: 12345") != std::string::npos);
 }
 
+TEST(HttpResponse, HeadersSurviveMove) {
+    std::optional<response> slot;
+    {
+        auto resp = response::ok("body");
+        resp.set_header("X-Before", "1");
+        slot.emplace(std::move(resp));
+    }
+    // The moved-to headers must allocate from their own arena, not the destroyed source's
+    slot->set_header("X-After", "2");
+
+    std::string serialized = slot->serialize();
+    EXPECT_TRUE(serialized.find("X-Before: 1") != std::string::npos);
+    EXPECT_TRUE(serialized.find("X-After: 2") != std::string::npos);
+}
+
+TEST(HttpResponse, StreamedBodyIsSentChunked) {
+    int parts_left = 3;
+    auto resp = response::json_stream([&](std::string& out) {
+        out += "[part]";
+        return --parts_left > 0;
+    });
+    std::string serialized = resp.serialize();
+
+    EXPECT_TRUE(serialized.find("Content-Type: application/json") != std::string::npos);
+    EXPECT_TRUE(serialized.find("Transfer-Encoding: chunked") != std::string::npos);
+    EXPECT_EQ(serialized.find("Content-Length"), std::string::npos);
+
+    // Feed the body back through the request parser's chunked decoder
+    auto body_start = serialized.find("\r\n\r\n") + 4;
+    std::string request = "POST /echo HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n" +
+                          serialized.substr(body_start);
+    monotonic_arena arena;
+    parser p(&arena);
+    auto result = p.parse(as_bytes(request));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, parser::state::complete);
+    EXPECT_EQ(p.get_request().body, "[part][part][part]");
+}
+
+TEST(HttpResponse, StreamChunkFraming) {
+    std::string out;
+    body_stream nothing_then_done = [](std::string&) { return false; };
+    EXPECT_FALSE(append_stream_chunk(nothing_then_done, out));
+    EXPECT_EQ(out, "0\r\n\r\n");
+
+    out.clear();
+    body_stream one_part = [](std::string& s) {
+        s += std::string(300, 'x');
+        return true;
+    };
+    EXPECT_TRUE(append_stream_chunk(one_part, out));
+    EXPECT_EQ(out.substr(0, 18), "000000000000012c\r\n");
+    EXPECT_EQ(out.size(), 18u + 300u + 2u);
+}
+
 TEST(HttpMethod, ParseMethod) {
     EXPECT_EQ(parse_method("GET"), method::get);
     EXPECT_EQ(parse_method("POST"), method::post);
@@ -0,0 +1,169 @@
+#include "katana/core/arena.hpp"
+#include "katana/core/json_parser.hpp"
+#include "katana/core/serde.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+using namespace katana;
+using namespace katana::serde;
+
+namespace {
+
+// Character-at-a-time reference for the SIMD escaper
+std::string reference_escape(std::string_view sv) {
+    static constexpr char hex[] = "0123456789abcdef";
+    std::string out;
+    for (char ch : sv) {
+        const auto c = static_cast<unsigned char>(ch);
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        default:
+            if (c < 0x20) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+            } else {
+                out += ch;
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+std::optional<std::string> unescape(std::string_view raw) {
+    monotonic_arena arena;
+    auto v = unescape_json_string(raw, arena);
+    if (!v) {
+        return std::nullopt;
+    }
+    return std::string(*v);
+}
+
+} // namespace
+
+TEST(JsonEscape, MatchesReferenceAcrossVectorWidths) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> byte(0, 255);
+    std::uniform_int_distribution<int> rare(0, 40);
+    for (size_t len = 0; len < 200; ++len) {
+        std::string s(len, 'x');
+        for (auto& c : s) {
+            // Mostly plain text so runs span whole vectors, with the odd special byte
+            c = static_cast<char>(rare(rng) == 0 ? byte(rng) & 0x3F : byte(rng) | 0x40);
+        }
+        EXPECT_EQ(escape_json_string(s), reference_escape(s));
+    }
+}
+
+TEST(JsonEscape, EscapesEveryControlCharacter) {
+    for (int c = 0; c < 0x20; ++c) {
+        std::string s(1, static_cast<char>(c));
+        EXPECT_EQ(escape_json_string(s), reference_escape(s));
+    }
+    EXPECT_EQ(escape_json_string("\x7f\xc3\xa9/"), "\x7f\xc3\xa9/");
+}
+
+TEST(JsonUnescape, ReturnsInputWhenNothingIsEscaped) {
+    monotonic_arena arena;
+    std::string_view raw = "plain text, no escapes";
+    auto v = unescape_json_string(raw, arena);
+    ASSERT_TRUE(v.has_value());
+    EXPECT_EQ(v->data(), raw.data());
+    EXPECT_EQ(arena.bytes_allocated(), 0u);
+}
+
+TEST(JsonUnescape, DecodesSimpleEscapes) {
+    EXPECT_EQ(unescape(R"(a\"b\\c\/d\be\ff\ng\rh\ti)"), "a\"b\\c/d\be\ff\ng\rh\ti");
+}
+
+TEST(JsonUnescape, DecodesUnicodeEscapes) {
+    EXPECT_EQ(unescape(R"(\u0041\u00e9\u20ac)"), "A\xc3\xa9\xe2\x82\xac");
+    EXPECT_EQ(unescape(R"(x\ud83d\ude00y)"), "x\xf0\x9f\x98\x80y");
+    EXPECT_EQ(unescape(R"(\u0000)"), std::string(1, '\0'));
+}
+
+TEST(JsonUnescape, RejectsMalformedEscapes) {
+    EXPECT_FALSE(unescape(R"(\x)"));
+    EXPECT_FALSE(unescape("trailing\\"));
+    EXPECT_FALSE(unescape(R"(\u12)"));
+    EXPECT_FALSE(unescape(R"(\u12g4)"));
+    EXPECT_FALSE(unescape(R"(\ude00)"));       // lone low surrogate
+    EXPECT_FALSE(unescape(R"(\ud83d)"));       // high surrogate at the end
+    EXPECT_FALSE(unescape(R"(\ud83dx)"));      // high surrogate followed by text
+    EXPECT_FALSE(unescape(R"(\ud83d\u0041)")); // high surrogate followed by a non-surrogate
+}
+
+TEST(JsonUnescape, RoundTripsEscapedText) {
+    std::string text = "quote \" slash \\ tab \t nl \n ctl \x01 utf8 \xc3\xa9";
+    EXPECT_EQ(unescape(escape_json_string(text)), text);
+}
+
+TEST(JsonUnescape, CursorDecodesIntoArenaOnlyWhenEscaped) {
+    std::string_view doc = R"(["caf\u00e9", "plain", "a\nb"])";
+    json_cursor cur{doc.data(), doc.data() + doc.size()};
+    ASSERT_TRUE(cur.try_array_start());
+    monotonic_arena arena;
+    auto cafe = cur.unescaped_string(arena);
+    EXPECT_EQ(cafe, std::optional<std::string_view>("caf\xc3\xa9"));
+    ASSERT_TRUE(cur.try_comma());
+    auto plain = cur.unescaped_string(arena);
+    ASSERT_TRUE(plain.has_value());
+    EXPECT_EQ(*plain, "plain");
+    EXPECT_GE(plain->data(), doc.data());
+    EXPECT_LT(plain->data(), doc.data() + doc.size());
+    ASSERT_TRUE(cur.try_comma());
+    auto lines = cur.unescaped_string(arena);
+
+    // Every decoded value keeps its own bytes
+    EXPECT_EQ(cafe, std::optional<std::string_view>("caf\xc3\xa9"));
+    EXPECT_EQ(lines, std::optional<std::string_view>("a\nb"));
+}
+
+namespace {
+
+struct note {
+    std::string text;
+    explicit note(monotonic_arena*) {}
+};
+
+} // namespace
+
+TEST(JsonUnescape, ParseObjectStoresDecodedStrings) {
+    std::array<json::field_descriptor<note>, 1> fields{};
+    fields[0].json_name = "text";
+    fields[0].kind = json::field_kind::string;
+    fields[0].offset = static_cast<std::ptrdiff_t>(offsetof(note, text));
+    fields[0].parse = &json::parse_string_field<note, std::string>;
+    fields[0].str.max_length = 3;
+
+    monotonic_arena arena;
+    // Seven bytes on the wire, three once decoded: the length limit applies to the decoded text
+    auto parsed = json::parse_object<note>(R"({"text":"\u00e9a"})", fields, &arena);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->text, "\xc3\xa9" "a");
+    EXPECT_FALSE(json::parse_object<note>(R"({"text":"\q"})", fields, &arena).has_value());
+}
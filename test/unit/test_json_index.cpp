@@ -0,0 +1,245 @@
+#include "katana/core/json_index.hpp"
+#include "katana/core/serde.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace katana::serde;
+
+namespace {
+
+// Reference: offsets of unescaped quotes and of structural characters outside strings
+std::vector<uint32_t> scalar_structurals(std::string_view json) {
+    std::vector<uint32_t> out;
+    bool in_string = false;
+    for (size_t i = 0; i < json.size(); ++i) {
+        char c = json[i];
+        if (in_string) {
+            if (c == '\\') {
+                ++i;
+            } else if (c == '"') {
+                in_string = false;
+                out.push_back(static_cast<uint32_t>(i));
+            }
+            continue;
+        }
+        if (c == '"') {
+            in_string = true;
+            out.push_back(static_cast<uint32_t>(i));
+        } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
+            out.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return out;
+}
+
+std::vector<uint32_t> indexed_structurals(const json_structural_index& index) {
+    std::vector<uint32_t> out;
+    for (size_t i = 0; i < index.size(); ++i) {
+        out.push_back(index.position(i));
+    }
+    return out;
+}
+
+std::string random_document(std::mt19937& rng, int depth) {
+    static constexpr std::string_view string_pieces[] = {
+        "plain", "with space", "\\\"", "\\\\", "\\\\\\\"", "{[:,]}", "\\n\\t", "\\u00e9",
+    };
+    std::uniform_int_distribution<int> kind(0, depth > 0 ? 4 : 2);
+    std::uniform_int_distribution<int> count(0, 6);
+    std::uniform_int_distribution<size_t> piece(0, std::size(string_pieces) - 1);
+
+    auto random_string = [&]() {
+        std::string s = "\"";
+        for (int i = count(rng); i > 0; --i) {
+            s += string_pieces[piece(rng)];
+        }
+        return s + "\"";
+    };
+
+    switch (kind(rng)) {
+    case 0:
+        return random_string();
+    case 1:
+        return std::to_string(rng() % 100000);
+    case 2:
+        return "true";
+    case 3: {
+        std::string s = "{ ";
+        for (int i = count(rng); i > 0; --i) {
+            s += random_string() + " : " + random_document(rng, depth - 1);
+            if (i > 1) {
+                s += ",\n";
+            }
+        }
+        return s + " }";
+    }
+    default: {
+        std::string s = "[";
+        for (int i = count(rng); i > 0; --i) {
+            s += random_document(rng, depth - 1);
+            if (i > 1) {
+                s += ", ";
+            }
+        }
+        return s + "]";
+    }
+    }
+}
+
+} // namespace
+
+TEST(JsonStructuralIndex, MatchesScalarReferenceOnRandomDocuments) {
+    std::mt19937 rng(1234);
+    json_structural_index index;
+    for (int round = 0; round < 200; ++round) {
+        auto doc = random_document(rng, 5);
+        ASSERT_TRUE(index.build(doc));
+        EXPECT_EQ(indexed_structurals(index), scalar_structurals(doc));
+    }
+}
+
+TEST(JsonStructuralIndex, BackslashRunsAcrossBlockBoundary) {
+    // Put runs of 1..4 backslashes right before a quote that sits on the 64-byte boundary
+    json_structural_index index;
+    for (size_t run = 1; run <= 4; ++run) {
+        for (size_t shift = 0; shift < 4; ++shift) {
+            std::string doc = "[\"";
+            doc.append(64 - 2 - run - shift + 1, 'a');
+            doc.append(run, '\\');
+            doc += (run % 2 == 0) ? "\"]" : "\"\"]";
+            ASSERT_TRUE(index.build(doc));
+            EXPECT_EQ(indexed_structurals(index), scalar_structurals(doc));
+        }
+    }
+}
+
+TEST(JsonStructuralIndex, PairsBrackets) {
+    std::string_view doc = R"({"a":[1,{"b":"]}"}],"c":{}})";
+    json_structural_index index;
+    ASSERT_TRUE(index.build(doc));
+    ASSERT_EQ(doc[index.position(0)], '{');
+    EXPECT_EQ(index.position(index.match(0)), doc.size() - 1);
+
+    auto entry = index.seek(5, 0);
+    ASSERT_EQ(doc[index.position(entry)], '[');
+    EXPECT_EQ(doc[index.position(index.match(entry))], ']');
+    EXPECT_EQ(index.position(index.match(entry)), 18u);
+}
+
+TEST(JsonStructuralIndex, RejectsMalformedInput) {
+    json_structural_index index;
+    EXPECT_FALSE(index.build(R"({"a":"unterminated})"));
+    EXPECT_FALSE(index.build(R"({"a":[1,2})"));
+    EXPECT_FALSE(index.build(R"({"a":1}})"));
+    EXPECT_FALSE(index.valid());
+    EXPECT_TRUE(index.build(R"({"a":1})"));
+}
+
+TEST(JsonStructuralIndex, StorageFollowsEntryCount) {
+    // One long string: 64 KiB of input, two entries
+    const std::string doc = "[\"" + std::string(64 * 1024, 'x') + "\"]";
+    json_structural_index index;
+    ASSERT_TRUE(index.build(doc));
+    EXPECT_EQ(index.size(), 4u);
+    EXPECT_LT(index.capacity(), doc.size() / 16);
+}
+
+TEST(JsonCursor, OutermostScopeFreesOversizedIndex) {
+    auto& slot = katana::serde::detail::thread_json_index_slot();
+
+    std::string large = "[";
+    while (large.size() < 2 * json_index_retained_entries) {
+        large += "1,";
+    }
+    large += "1]";
+    {
+        indexed_json_scope scope(large);
+        ASSERT_TRUE(scope.indexed());
+        EXPECT_GT(slot.index.capacity(), json_index_retained_entries);
+    }
+    EXPECT_EQ(slot.index.capacity(), 0u);
+
+    std::string small = "[";
+    while (small.size() < json_index_min_size) {
+        small += "1,";
+    }
+    small += "1]";
+    {
+        indexed_json_scope scope(small);
+        ASSERT_TRUE(scope.indexed());
+    }
+    // Storage for ordinary documents stays with the thread for the next one
+    EXPECT_GT(slot.index.capacity(), 0u);
+    EXPECT_LE(slot.index.capacity(), json_index_retained_entries);
+}
+
+TEST(JsonCursor, IndexedAndScalarSkipAgree) {
+    std::mt19937 rng(99);
+    json_structural_index index;
+    for (int round = 0; round < 100; ++round) {
+        std::string doc = "[";
+        for (int i = 0; i < 8; ++i) {
+            doc += random_document(rng, 4);
+            doc += i < 7 ? ", " : "]";
+        }
+        ASSERT_TRUE(index.build(doc));
+
+        json_cursor scalar{doc.data(), doc.data() + doc.size()};
+        json_cursor indexed{doc.data(), doc.data() + doc.size(), &index};
+        ASSERT_TRUE(scalar.try_array_start());
+        ASSERT_TRUE(indexed.try_array_start());
+        for (int i = 0; i < 8; ++i) {
+            scalar.skip_value();
+            indexed.skip_value();
+            ASSERT_EQ(scalar.pos(), indexed.pos());
+            scalar.try_comma();
+            indexed.try_comma();
+        }
+        EXPECT_TRUE(scalar.try_array_end());
+        EXPECT_TRUE(indexed.try_array_end());
+    }
+}
+
+TEST(JsonCursor, SkipValueIgnoresBracketsInStrings) {
+    std::string_view doc = R"({"skip":{"x":"}]{[","y":["]"]},"next":1})";
+    json_cursor cur{doc.data(), doc.data() + doc.size()};
+    ASSERT_TRUE(cur.try_object_start());
+    ASSERT_EQ(cur.string(), std::optional<std::string_view>("skip"));
+    ASSERT_TRUE(cur.consume(':'));
+    cur.skip_value();
+    ASSERT_TRUE(cur.try_comma());
+    EXPECT_EQ(cur.string(), std::optional<std::string_view>("next"));
+}
+
+TEST(JsonCursor, StringHandlesEscapes) {
+    std::string_view doc = R"("a\"b\\" "tail)";
+    json_cursor cur{doc.data(), doc.data() + doc.size()};
+    EXPECT_EQ(cur.string(), std::optional<std::string_view>(R"(a\"b\\)"));
+    EXPECT_FALSE(cur.string());
+}
+
+TEST(JsonCursor, NestedScopesReuseThreadIndex) {
+    std::string doc = R"({"items":[)";
+    for (int i = 0; i < 1000; ++i) {
+        doc += R"({"id":)" + std::to_string(i) + R"(,"name":"item"})";
+        doc += i < 999 ? "," : "]}";
+    }
+    ASSERT_GE(doc.size(), json_index_min_size);
+
+    indexed_json_scope small(std::string_view(doc).substr(0, json_index_min_size - 1));
+    EXPECT_FALSE(small.indexed());
+
+    indexed_json_scope outer(doc);
+    ASSERT_TRUE(outer.indexed());
+    auto inner_view = std::string_view(doc).substr(10, 20);
+    indexed_json_scope inner(inner_view);
+    EXPECT_TRUE(inner.indexed());
+
+    std::string other(json_index_min_size, ' ');
+    indexed_json_scope unrelated(other);
+    EXPECT_FALSE(unrelated.indexed());
+}
@@ -0,0 +1,156 @@
+#include "katana/core/json_writer.hpp"
+#include "katana/core/serde.hpp"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace katana::serde;
+
+namespace {
+
+std::optional<int64_t> int64_of(std::string_view text) {
+    json_cursor cur{text.data(), text.data() + text.size()};
+    return parse_int64(cur);
+}
+
+std::optional<double> double_of(std::string_view text) {
+    json_cursor cur{text.data(), text.data() + text.size()};
+    return parse_double(cur);
+}
+
+uint64_t bits_of(double value) {
+    return std::bit_cast<uint64_t>(value);
+}
+
+} // namespace
+
+TEST(JsonNumber, Int64Limits) {
+    EXPECT_EQ(int64_of("0"), std::optional<int64_t>(0));
+    EXPECT_EQ(int64_of("-17"), std::optional<int64_t>(-17));
+    EXPECT_EQ(int64_of("9223372036854775807"),
+              std::optional<int64_t>(std::numeric_limits<int64_t>::max()));
+    EXPECT_EQ(int64_of("-9223372036854775808"),
+              std::optional<int64_t>(std::numeric_limits<int64_t>::min()));
+    EXPECT_EQ(int64_of("\"-42\""), std::optional<int64_t>(-42));
+}
+
+TEST(JsonNumber, Int64RejectsOverflowAndNonIntegers) {
+    EXPECT_FALSE(int64_of("9223372036854775808"));
+    EXPECT_FALSE(int64_of("-9223372036854775809"));
+    EXPECT_FALSE(int64_of("18446744073709551616"));
+    EXPECT_FALSE(int64_of("99999999999999999999999"));
+    EXPECT_FALSE(int64_of("-"));
+    EXPECT_FALSE(int64_of("\"12x\""));
+    EXPECT_FALSE(int64_of("true"));
+
+    std::string_view text = "1.5";
+    json_cursor cur{text.data(), text.data() + text.size()};
+    EXPECT_FALSE(parse_int64(cur));
+    EXPECT_EQ(cur.ptr, text.data());
+    EXPECT_FALSE(int64_of("2e3"));
+}
+
+TEST(JsonNumber, Int64StopsAtDelimiter) {
+    std::string_view text = " -12,34]";
+    json_cursor cur{text.data(), text.data() + text.size()};
+    EXPECT_EQ(parse_int64(cur), std::optional<int64_t>(-12));
+    ASSERT_TRUE(cur.try_comma());
+    EXPECT_EQ(parse_int64(cur), std::optional<int64_t>(34));
+    EXPECT_TRUE(cur.try_array_end());
+}
+
+TEST(JsonNumber, DoubleMatchesFromCharsOnRandomValues) {
+    std::mt19937_64 rng(42);
+    char buf[64];
+    for (int i = 0; i < 100000; ++i) {
+        double value = std::bit_cast<double>(rng());
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+        auto parsed = double_of(std::string_view(buf, static_cast<size_t>(res.ptr - buf)));
+        ASSERT_TRUE(parsed.has_value());
+        ASSERT_EQ(bits_of(*parsed), bits_of(value));
+    }
+}
+
+TEST(JsonNumber, DoubleFastPathValuesAreExact) {
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        // Short decimals like telemetry readings: up to 9 digits, 0..6 after the point
+        const auto mantissa = static_cast<int64_t>(rng() % 1'000'000'000) - 500'000'000;
+        const auto scale = static_cast<int>(rng() % 7);
+        std::string text = std::to_string(mantissa);
+        if (scale > 0) {
+            const bool negative = mantissa < 0;
+            std::string digits = text.substr(negative ? 1 : 0);
+            if (digits.size() <= static_cast<size_t>(scale)) {
+                digits.insert(0, static_cast<size_t>(scale) - digits.size() + 1, '0');
+            }
+            digits.insert(digits.size() - static_cast<size_t>(scale), ".");
+            text = (negative ? "-" : "") + digits;
+        }
+        double expected = 0.0;
+        std::from_chars(text.data(), text.data() + text.size(), expected);
+        auto parsed = double_of(text);
+        ASSERT_TRUE(parsed.has_value());
+        ASSERT_EQ(bits_of(*parsed), bits_of(expected));
+    }
+}
+
+TEST(JsonNumber, DoubleHardCases) {
+    EXPECT_EQ(double_of("1e22"), std::optional<double>(1e22));
+    EXPECT_EQ(double_of("1e23"), std::optional<double>(1e23));
+    EXPECT_EQ(double_of("9007199254740993"), std::optional<double>(9007199254740992.0));
+    EXPECT_EQ(double_of("2.2250738585072014e-308"),
+              std::optional<double>(std::numeric_limits<double>::min()));
+    EXPECT_EQ(double_of("4.9e-324"),
+              std::optional<double>(std::numeric_limits<double>::denorm_min()));
+    EXPECT_EQ(double_of("1.7976931348623157e308"),
+              std::optional<double>(std::numeric_limits<double>::max()));
+    EXPECT_EQ(double_of("0.1"), std::optional<double>(0.1));
+    EXPECT_EQ(double_of("123456789012345678901234567890"),
+              std::optional<double>(123456789012345678901234567890.0));
+    EXPECT_EQ(double_of("\"2.5\""), std::optional<double>(2.5));
+
+    auto negative_zero = double_of("-0");
+    ASSERT_TRUE(negative_zero.has_value());
+    EXPECT_TRUE(std::signbit(*negative_zero));
+}
+
+TEST(JsonNumber, DoubleRejectsNonJsonNumbers) {
+    for (std::string_view text :
+         {"", "-", "+1", ".5", "1.", "1e", "1e+", "NaN", "Infinity", "1e400", "\"1.5x\""}) {
+        EXPECT_FALSE(double_of(text));
+    }
+}
+
+TEST(JsonNumber, DoubleAdvancesCursorPastNumber) {
+    std::string_view text = "[-1.25e+2, 3]";
+    json_cursor cur{text.data(), text.data() + text.size()};
+    ASSERT_TRUE(cur.try_array_start());
+    EXPECT_EQ(parse_double(cur), std::optional<double>(-125.0));
+    EXPECT_EQ(*cur.ptr, ',');
+    ASSERT_TRUE(cur.try_comma());
+    EXPECT_EQ(parse_double(cur), std::optional<double>(3.0));
+    EXPECT_TRUE(cur.try_array_end());
+}
+
+TEST(JsonNumber, WriterUsesShortestRoundTrip) {
+    char buf[json_double_max_size];
+    json_out w{buf};
+    w.number(0.1);
+    EXPECT_EQ(std::string_view(buf, static_cast<size_t>(w.pos - buf)), "0.1");
+
+    w.pos = buf;
+    w.number(1e23);
+    auto text = std::string_view(buf, static_cast<size_t>(w.pos - buf));
+    EXPECT_EQ(double_of(text), std::optional<double>(1e23));
+}
@@ -12,6 +12,7 @@ using katana::validation_error_code;
 using katana::json::array_constraints;
 using katana::json::integer_array_field;
 using katana::json::integer_field;
+using katana::json::object_descriptor;
 using katana::json::parse_object;
 using katana::json::string_array_field;
 using katana::json::string_constraints;
@@ -39,6 +40,8 @@ const auto kUserFields = std::to_array<katana::json::field_descriptor<User>>(
      integer_array_field<User, katana::arena_vector<int64_t>>(
          "scores", &User::scores, false, array_constraints{.min_items = 1, .max_items = 5})});
 
+const object_descriptor<User, 4> kUserObject{kUserFields};
+
 } // namespace
 
 TEST(JsonParser, ParsesValidObject) {
@@ -75,3 +78,93 @@ TEST(JsonParser, EnforcesBounds) {
     EXPECT_EQ(err.code, validation_error_code::string_too_short);
     EXPECT_EQ(err.field, "name");
 }
+
+TEST(JsonParser, ObjectDescriptorMatchesLinearLookup) {
+    const std::string json = R"({"extra":{"name":"ignored"},"scores":[4],)"
+                             R"("email":"bob@example.com","id":7,"name":"bob"})";
+    katana::monotonic_arena arena;
+    auto parsed = parse_object<User>(json, kUserObject, &arena);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->name, "bob");
+    EXPECT_EQ(parsed->id, 7);
+    ASSERT_EQ(parsed->scores.size(), 1u);
+
+    validation_error err;
+    EXPECT_FALSE(parse_object<User>(R"({"id":7})", kUserObject, &arena, &err).has_value());
+    EXPECT_EQ(err.code, validation_error_code::required_field_missing);
+    EXPECT_EQ(err.field, "name");
+}
+
+TEST(KeyTable, FindsEveryKeyAndRejectsOthers) {
+    static constexpr katana::serde::key_table keys{
+        "id", "name", "email", "created_at", "updated_at", "a", "", "prefix_shared_long_tail_1",
+        "prefix_shared_long_tail_2", "prefix_shared_long_tail_3"};
+    static_assert(keys.find("email") == 2);
+    static_assert(keys.find("missing") == keys.npos);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(keys.find(std::string(keys.key(i))), i);
+    }
+    EXPECT_EQ(keys.find("Email"), keys.npos);
+    EXPECT_EQ(keys.find("prefix_shared_long_tail_4"), keys.npos);
+    EXPECT_EQ(keys.find("prefix_shared_long_tail_"), keys.npos);
+
+    // Duplicates cannot be hashed perfectly; lookup still returns the first match
+    constexpr katana::serde::key_table dup{"x", "x", "y"};
+    EXPECT_EQ(dup.find("x"), 0u);
+    EXPECT_EQ(dup.find("y"), 2u);
+}
+
+TEST(Validation, StringFormats) {
+    static_assert(katana::is_valid_email("a@b.co"));
+    EXPECT_FALSE(katana::is_valid_email("@b.co"));
+    EXPECT_FALSE(katana::is_valid_email("a@b"));
+    EXPECT_FALSE(katana::is_valid_email("a@.co"));
+
+    EXPECT_TRUE(katana::is_valid_uuid("123e4567-e89b-12d3-A456-426614174000"));
+    EXPECT_FALSE(katana::is_valid_uuid("123e4567-e89b-12d3-a456-42661417400g"));
+    EXPECT_FALSE(katana::is_valid_uuid("123e4567e89b-12d3-a456-4266141740000"));
+
+    EXPECT_TRUE(katana::is_valid_datetime("2024-02-29T12:30:00Z"));
+    EXPECT_TRUE(katana::is_valid_datetime("2024-02-29T12:30:00.125+05:30"));
+    EXPECT_FALSE(katana::is_valid_datetime("2024-02-29 12:30:00Z"));
+    EXPECT_FALSE(katana::is_valid_datetime("2024-02-29T12:30:00+0530"));
+    EXPECT_FALSE(katana::is_valid_datetime("2024-02-29T12:30:00."));
+}
+
+TEST(Validation, PatternShapes) {
+    static_assert(katana::is_lowercase_uuid("123e4567-e89b-12d3-a456-426614174000"));
+    EXPECT_FALSE(katana::is_lowercase_uuid("123e4567-e89b-12d3-A456-426614174000"));
+
+    EXPECT_TRUE(katana::is_valid_datetime("2024-02-29T12:30:00.Z"));
+    EXPECT_FALSE(katana::is_strict_datetime("2024-02-29T12:30:00.Z"));
+    EXPECT_TRUE(katana::is_strict_datetime("2024-02-29T12:30:00.5-01:00"));
+
+    EXPECT_TRUE(katana::is_iso_date("2024-02-29"));
+    EXPECT_FALSE(katana::is_iso_date("2024-2-29"));
+
+    EXPECT_TRUE(katana::is_common_email("john.doe+tag@mail.example.org"));
+    EXPECT_FALSE(katana::is_common_email("a@b.c"));       // top-level domain too short
+    EXPECT_FALSE(katana::is_common_email("a@b.c0m"));     // digit in the top-level domain
+    EXPECT_FALSE(katana::is_common_email("a@@b.com"));
+    EXPECT_FALSE(katana::is_common_email("a b@c.com"));
+    EXPECT_FALSE(katana::is_common_email("a@.com"));
+}
+
+TEST(Validation, PatternDfa) {
+    // ^[A-Z]{2}\d?$ as katana_gen emits it: class 1 is A-Z, class 2 is 0-9
+    static constexpr katana::pattern_dfa<5, 3> dfa{{{48, 57, 2}, {65, 90, 1}},
+                                                   {0, 0, 0, //
+                                                    0, 2, 0, //
+                                                    0, 3, 0, //
+                                                    0, 0, 4, //
+                                                    0, 0, 0},
+                                                   {3, 4}};
+    static_assert(dfa.matches("AB"));
+    EXPECT_TRUE(dfa.matches("XY7"));
+    EXPECT_FALSE(dfa.matches("A"));
+    EXPECT_FALSE(dfa.matches("ab"));
+    EXPECT_FALSE(dfa.matches("AB77"));
+    EXPECT_FALSE(dfa.matches(std::string_view("AB\0", 3)));
+    EXPECT_FALSE(dfa.matches(""));
+}
@@ -0,0 +1,107 @@
+#include "katana/core/json_view.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace katana;
+using namespace katana::serde;
+
+namespace {
+
+constexpr std::string_view document = R"( {
+    "user": {"id": 42, "name": "Ada \"the\" first", "tags": ["a", "b", "c"]},
+    "skipped": {"deep": [[1, 2, {"x": "}]"}], {"y": null}]},
+    "score": -1.5e2,
+    "active": true,
+    "missing": null
+} )";
+
+} // namespace
+
+TEST(JsonView, LooksUpNestedMembers) {
+    monotonic_arena arena;
+    json_view doc(document);
+    ASSERT_TRUE(doc.is_object());
+    EXPECT_EQ(doc["user"]["id"].as_int64(), std::optional<int64_t>(42));
+    EXPECT_EQ(doc["score"].as_double(), std::optional<double>(-150.0));
+    EXPECT_EQ(doc["active"].as_bool(), std::optional<bool>(true));
+    EXPECT_TRUE(doc["missing"].is_null());
+    EXPECT_EQ(doc["user"]["tags"][2].as_string(arena), std::optional<std::string_view>("c"));
+}
+
+TEST(JsonView, MissingAndMistypedValuesAreEmpty) {
+    monotonic_arena arena;
+    json_view doc(document);
+    EXPECT_FALSE(doc["nope"]);
+    EXPECT_FALSE(doc["nope"]["deeper"]["still"].as_int64());
+    EXPECT_FALSE(doc["user"]["tags"][3]);
+    EXPECT_FALSE(doc["user"][0]);
+    EXPECT_FALSE(doc["user"]["name"].as_int64());
+    EXPECT_FALSE(doc["score"].as_int64());
+    EXPECT_FALSE(doc["active"].as_string(arena));
+    EXPECT_EQ(doc["missing"].type(), json_type::null);
+    EXPECT_EQ(json_view().type(), json_type::invalid);
+    EXPECT_FALSE(json_view(std::string_view("   ")));
+}
+
+TEST(JsonView, DecodesStringsIntoArena) {
+    monotonic_arena arena;
+    json_view doc(document);
+    auto name = doc["user"]["name"].as_string(arena);
+    ASSERT_TRUE(name.has_value());
+    EXPECT_EQ(*name, "Ada \"the\" first");
+}
+
+TEST(JsonView, DecodedStringsStayValidTogether) {
+    monotonic_arena arena;
+    json_view doc(std::string_view(R"({"a": "one\ttab", "b": "two\nlines"})"));
+    auto a = doc["a"].as_string(arena);
+    auto b = doc["b"].as_string(arena);
+    EXPECT_EQ(a, std::optional<std::string_view>("one\ttab"));
+    EXPECT_EQ(b, std::optional<std::string_view>("two\nlines"));
+}
+
+TEST(JsonView, RawCoversExactlyTheValue) {
+    json_view doc(document);
+    EXPECT_EQ(doc["user"]["tags"].raw(), R"(["a", "b", "c"])");
+    EXPECT_EQ(doc["skipped"]["deep"][0].raw(), R"([1, 2, {"x": "}]"}])");
+    EXPECT_EQ(doc["score"].raw(), "-1.5e2");
+    EXPECT_EQ(json_view().raw(), "");
+}
+
+TEST(JsonView, IteratesMembersAndElements) {
+    json_view doc(document);
+    std::vector<std::string> keys;
+    EXPECT_TRUE(doc.for_each_member([&](std::string_view key, json_view) {
+        keys.emplace_back(key);
+        return true;
+    }));
+    EXPECT_EQ(keys, (std::vector<std::string>{"user", "skipped", "score", "active", "missing"}));
+
+    monotonic_arena arena;
+    std::string tags;
+    EXPECT_TRUE(doc["user"]["tags"].for_each_element([&](json_view tag) {
+        tags += *tag.as_string(arena);
+        return true;
+    }));
+    EXPECT_EQ(tags, "abc");
+    int calls = 0;
+    EXPECT_TRUE(json_view(std::string_view("[]")).for_each_element([&](json_view) {
+        ++calls;
+        return true;
+    }));
+    EXPECT_EQ(calls, 0);
+}
+
+TEST(JsonView, StopsOnMalformedInput) {
+    json_view truncated(std::string_view(R"({"a": {"b": 1}, "c": )"));
+    EXPECT_EQ(truncated["a"]["b"].as_int64(), std::optional<int64_t>(1));
+    EXPECT_FALSE(truncated["c"].as_int64());
+    EXPECT_FALSE(truncated["d"]);
+    EXPECT_FALSE(truncated.for_each_member([](std::string_view, json_view) { return true; }));
+
+    json_view no_colon(std::string_view(R"({"a" 1})"));
+    EXPECT_FALSE(no_colon["a"]);
+}
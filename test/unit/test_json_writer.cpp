@@ -0,0 +1,150 @@
+#include "katana/core/json_writer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace katana;
+using namespace katana::serde;
+
+namespace {
+
+std::string write(size_t bound, auto&& fn) {
+    std::string out;
+    write_json(out, bound, [&](char* p) {
+        json_out w{p};
+        fn(w);
+        return w.pos;
+    });
+    return out;
+}
+
+size_t int_bound(int) noexcept {
+    return json_int_max_size;
+}
+
+char* write_int(int value, char* p) noexcept {
+    json_out w{p};
+    w.integer(value);
+    return w.pos;
+}
+
+} // namespace
+
+TEST(JsonWriter, WritesScalars) {
+    EXPECT_EQ(write(64,
+                    [](json_out& w) {
+                        w.raw("{\"a\":");
+                        w.integer(int64_t{-42});
+                        w.raw(",\"b\":");
+                        w.number(1.5);
+                        w.raw(",\"c\":");
+                        w.boolean(true);
+                        w.raw(",\"d\":");
+                        w.null();
+                        w.put('}');
+                    }),
+              R"({"a":-42,"b":1.5,"c":true,"d":null})");
+}
+
+TEST(JsonWriter, EscapesStrings) {
+    std::string_view raw = "a\"b\\c\nd\re\tf\x1f";
+    EXPECT_EQ(write(json_string_size_bound(raw.size()), [&](json_out& w) { w.string(raw); }),
+              R"("a\"b\\c\nd\re\tf\u001f")");
+}
+
+TEST(JsonWriter, WorstCaseValuesFitTheirBounds) {
+    std::string all_escaped(100, '\x01');
+    EXPECT_EQ(write(json_string_size_bound(all_escaped.size()),
+                    [&](json_out& w) { w.string(all_escaped); })
+                  .size(),
+              json_string_size_bound(all_escaped.size()));
+    EXPECT_EQ(write(json_int_max_size,
+                    [](json_out& w) { w.integer(std::numeric_limits<int64_t>::min()); })
+                  .size(),
+              json_int_max_size);
+    EXPECT_LE(write(json_double_max_size,
+                    [](json_out& w) { w.number(-std::numeric_limits<double>::max()); })
+                  .size(),
+              json_double_max_size);
+    EXPECT_LE(write(json_double_max_size,
+                    [](json_out& w) { w.number(-std::numeric_limits<double>::denorm_min()); })
+                  .size(),
+              json_double_max_size);
+}
+
+TEST(JsonWriter, NonFiniteNumbersBecomeNull) {
+    EXPECT_EQ(write(json_double_max_size,
+                    [](json_out& w) { w.number(std::numeric_limits<double>::infinity()); }),
+              "null");
+    EXPECT_EQ(write(json_double_max_size,
+                    [](json_out& w) { w.number(std::numeric_limits<double>::quiet_NaN()); }),
+              "null");
+}
+
+TEST(JsonWriter, WritesIntoEachDestination) {
+    auto fn = [](char* p) {
+        json_out w{p};
+        w.string("hi");
+        return w.pos;
+    };
+
+    std::string str = "[";
+    EXPECT_EQ(write_json(str, 16, fn), 4u);
+    EXPECT_EQ(str, R"(["hi")");
+
+    io_buffer buf;
+    buf.append(std::string_view("["));
+    EXPECT_EQ(write_json(buf, 16, fn), 4u);
+    auto readable = buf.readable_span();
+    EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(readable.data()), readable.size()),
+              R"(["hi")");
+
+    monotonic_arena arena;
+    EXPECT_EQ(write_json(arena, 16, fn), R"("hi")");
+}
+
+TEST(JsonArrayStream, ProducesTheArrayInBoundedParts) {
+    std::vector<int> items;
+    for (int i = 0; i < 10000; ++i) {
+        items.push_back(i * 7 - 3000);
+    }
+    std::string expected = "[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        expected += (i > 0 ? "," : "") + std::to_string(items[i]);
+    }
+    expected += "]";
+
+    json_array_stream stream(items, &int_bound, &write_int, 1024);
+    std::string body;
+    size_t parts = 0;
+    bool more = true;
+    while (more) {
+        const size_t before = body.size();
+        more = stream(body);
+        // A part stops at the first element boundary past the chunk size
+        EXPECT_LE(body.size() - before, 1024u + json_int_max_size + 2);
+        ++parts;
+    }
+    EXPECT_EQ(body, expected);
+    EXPECT_GT(parts, expected.size() / 1024);
+}
+
+TEST(JsonArrayStream, EmptyAndMovedRanges) {
+    json_array_stream empty(std::vector<int>{}, &int_bound, &write_int);
+    std::string body;
+    EXPECT_FALSE(empty(body));
+    EXPECT_EQ(body, "[]");
+
+    // An rvalue range is owned by the stream, so it can outlive the caller's scope
+    std::function<bool(std::string&)> fn =
+        json_array_stream(std::vector<int>{1, 2, 3}, &int_bound, &write_int);
+    body.clear();
+    while (fn(body)) {
+    }
+    EXPECT_EQ(body, "[1,2,3]");
+}
@@ -0,0 +1,169 @@
+#include "katana/core/arena.hpp"
+#include "katana/core/io_buffer.hpp"
+#include "katana/core/memory_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace katana;
+
+namespace {
+
+memory_pool_config small_pool(huge_page_mode huge_pages = huge_page_mode::transparent) {
+    memory_pool_config config;
+    config.reserve_bytes = 8 * memory_pool::CHUNK_SIZE;
+    config.huge_pages = huge_pages;
+    return config;
+}
+
+// Runs `fn` on a fresh thread with `pool` installed, the way a reactor thread runs; the
+// thread's arena block cache is emptied on exit, while the pool is still alive
+template <typename Fn> void on_pool_thread(memory_pool& pool, Fn&& fn) {
+    std::thread([&pool, &fn] {
+        memory_pool::set_current(&pool);
+        fn();
+        memory_pool::set_current(nullptr);
+    }).join();
+}
+
+bool aligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+} // namespace
+
+TEST(MemoryPool, ServesAndRecyclesBlocksFromItsRange) {
+    memory_pool pool(small_pool());
+    ASSERT_TRUE(pool.valid());
+    EXPECT_EQ(pool.reserved_bytes(), 8 * memory_pool::CHUNK_SIZE);
+
+    on_pool_thread(pool, [&] {
+        void* a = memory_pool::allocate(100);
+        void* b = memory_pool::allocate(100);
+        ASSERT_NE(a, nullptr);
+        EXPECT_TRUE(pool.contains(a));
+        EXPECT_EQ(memory_pool::owner_of(b), &pool);
+        EXPECT_TRUE(aligned(a, 128));
+        EXPECT_EQ(static_cast<char*>(b) - static_cast<char*>(a), 128);
+        static_cast<char*>(a)[99] = 1;
+
+        memory_pool::deallocate(a, 100);
+        EXPECT_EQ(memory_pool::allocate(128), a);
+
+        void* chunk = memory_pool::allocate(memory_pool::CHUNK_SIZE);
+        EXPECT_TRUE(pool.contains(chunk));
+        EXPECT_TRUE(aligned(chunk, memory_pool::CHUNK_SIZE));
+        EXPECT_EQ(pool.stats().allocations, 4u);
+        EXPECT_EQ(pool.stats().committed_bytes, 2 * memory_pool::CHUNK_SIZE);
+    });
+}
+
+TEST(MemoryPool, FallsBackToTheHeap) {
+    // No pool on this thread
+    void* p = memory_pool::allocate(100);
+    ASSERT_NE(p, nullptr);
+    EXPECT_TRUE(aligned(p, memory_pool::BLOCK_ALIGNMENT));
+    EXPECT_EQ(memory_pool::owner_of(p), nullptr);
+    memory_pool::deallocate(p, 100);
+
+    memory_pool pool(small_pool());
+    on_pool_thread(pool, [&] {
+        void* large = memory_pool::allocate(memory_pool::CHUNK_SIZE + 1);
+        EXPECT_EQ(memory_pool::owner_of(large), nullptr);
+        memory_pool::deallocate(large, memory_pool::CHUNK_SIZE + 1);
+
+        // Exhausting the reserve moves on to the heap too
+        std::vector<void*> chunks;
+        for (int i = 0; i < 9; ++i) {
+            chunks.push_back(memory_pool::allocate(memory_pool::CHUNK_SIZE));
+        }
+        EXPECT_TRUE(pool.contains(chunks[7]));
+        EXPECT_FALSE(pool.contains(chunks[8]));
+        EXPECT_EQ(pool.stats().fallbacks, 2u);
+        for (void* c : chunks) {
+            memory_pool::deallocate(c, memory_pool::CHUNK_SIZE);
+        }
+    });
+}
+
+TEST(MemoryPool, BlocksFreedOnOtherThreadsReturnToTheOwner) {
+    memory_pool pool(small_pool());
+    std::vector<void*> blocks;
+    on_pool_thread(pool, [&] {
+        for (int i = 0; i < 4; ++i) {
+            blocks.push_back(memory_pool::allocate(4096));
+        }
+    });
+
+    // This thread has no pool, so the blocks go onto the owner's remote list
+    for (void* b : blocks) {
+        memory_pool::deallocate(b, 4096);
+    }
+
+    on_pool_thread(pool, [&] {
+        std::vector<void*> again;
+        for (int i = 0; i < 4; ++i) {
+            again.push_back(memory_pool::allocate(4096));
+        }
+        EXPECT_EQ(pool.stats().remote_frees, 4u);
+        EXPECT_EQ(pool.stats().committed_bytes, memory_pool::CHUNK_SIZE);
+        for (void* b : blocks) {
+            EXPECT_NE(std::find(again.begin(), again.end(), b), again.end());
+        }
+    });
+}
+
+TEST(MemoryPool, HugePageModesAllServeMemory) {
+    for (auto mode :
+         {huge_page_mode::none, huge_page_mode::transparent, huge_page_mode::explicit_2m}) {
+        memory_pool pool(small_pool(mode));
+        on_pool_thread(pool, [&] {
+            auto* p = static_cast<uint8_t*>(memory_pool::allocate(memory_pool::CHUNK_SIZE));
+            ASSERT_TRUE(pool.contains(p));
+            // Without reserved huge pages the explicit mode falls back to regular pages
+            p[0] = p[memory_pool::CHUNK_SIZE - 1] = 1;
+            EXPECT_LE(pool.stats().huge_page_chunks, 1u);
+        });
+    }
+}
+
+TEST(MemoryPool, BuffersArenasAndConnectionsDrawFromThePool) {
+    memory_pool pool(small_pool());
+    on_pool_thread(pool, [&] {
+        io_buffer buffer;
+        buffer.reserve(128 * 1024);
+        EXPECT_TRUE(pool.contains(buffer.writable_span(1).data()));
+
+        {
+            monotonic_arena arena(8192);
+            EXPECT_TRUE(pool.contains(arena.allocate(100)));
+        }
+
+        struct connection {
+            io_buffer read_buffer{8192};
+            uint64_t id = 7;
+        };
+        auto conn = std::allocate_shared<connection>(pool_allocator<connection>{});
+        EXPECT_TRUE(pool.contains(conn.get()));
+        EXPECT_EQ(conn->id, 7u);
+    });
+}
+
+TEST(MemoryPool, ForeignBlocksSkipTheArenaCache) {
+    memory_pool pool(small_pool());
+    monotonic_arena arena(8192);
+    on_pool_thread(pool, [&] {
+        monotonic_arena local(8192);
+        ASSERT_NE(local.allocate(10), nullptr);
+        arena = std::move(local);
+    });
+
+    const auto cached_before = arena_block_cache::local().stats().cached_blocks;
+    arena = monotonic_arena(8192);
+    EXPECT_EQ(arena_block_cache::local().stats().cached_blocks, cached_before);
+}
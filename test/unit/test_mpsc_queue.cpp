@@ -0,0 +1,168 @@
+#include "katana/core/mpsc_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace katana;
+
+namespace {
+
+constexpr int PRODUCERS = 4;
+constexpr int PER_PRODUCER = 20000;
+
+// Runs PRODUCERS threads calling push(producer, i) while the caller drains with `drain`,
+// which returns the values it got; checks every value arrives once and each producer's
+// values arrive in order
+template <typename Push, typename Drain> void run_producers(Push push, Drain drain) {
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&push, p] {
+            for (int i = 0; i < PER_PRODUCER; ++i) {
+                push(p, i);
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        for (int value : drain()) {
+            const int p = value / PER_PRODUCER;
+            EXPECT_EQ(value % PER_PRODUCER, next[static_cast<size_t>(p)]);
+            ++next[static_cast<size_t>(p)];
+            ++received;
+        }
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (int n : next) {
+        EXPECT_EQ(n, PER_PRODUCER);
+    }
+}
+
+struct job : mpsc_hook {
+    int value = 0;
+};
+
+} // namespace
+
+TEST(MpscQueue, TryPushRespectsTheLimit) {
+    mpsc_queue<std::string> queue(2);
+    EXPECT_TRUE(queue.try_push("a"));
+    EXPECT_TRUE(queue.try_push("b"));
+    EXPECT_FALSE(queue.try_push("c"));
+    EXPECT_EQ(queue.size(), 2u);
+
+    EXPECT_EQ(queue.pop().value_or(""), "a");
+    EXPECT_TRUE(queue.try_push("c"));
+    EXPECT_EQ(queue.pop().value_or(""), "b");
+    EXPECT_EQ(queue.pop().value_or(""), "c");
+    EXPECT_FALSE(queue.pop().has_value());
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueue, MultipleProducers) {
+    mpsc_queue<int> queue;
+    run_producers([&](int p, int i) { queue.push(p * PER_PRODUCER + i); },
+                  [&] {
+                      std::vector<int> out;
+                      while (auto v = queue.pop()) {
+                          out.push_back(*v);
+                      }
+                      return out;
+                  });
+}
+
+TEST(IntrusiveMpscQueue, LinksTheCallersObjects) {
+    intrusive_mpsc_queue<job> queue;
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    job a, b;
+    a.value = 1;
+    b.value = 2;
+    queue.push(a);
+    queue.push(b);
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(queue.pop(), &a);
+
+    // Popped elements can be pushed again
+    queue.push(a);
+    EXPECT_EQ(queue.pop(), &b);
+    EXPECT_EQ(queue.pop(), &a);
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+
+    queue.push(b);
+    EXPECT_EQ(queue.pop(), &b);
+}
+
+TEST(IntrusiveMpscQueue, MultipleProducers) {
+    intrusive_mpsc_queue<job> queue;
+    auto jobs = std::make_unique<job[]>(PRODUCERS * PER_PRODUCER);
+    run_producers(
+        [&](int p, int i) {
+            job& j = jobs[static_cast<size_t>(p * PER_PRODUCER + i)];
+            j.value = p * PER_PRODUCER + i;
+            queue.push(j);
+        },
+        [&] {
+            std::vector<int> out;
+            while (job* j = queue.pop()) {
+                out.push_back(j->value);
+            }
+            return out;
+        });
+    EXPECT_EQ(queue.pop(), nullptr);
+}
+
+TEST(BoundedMpscQueue, CapacityAndPopN) {
+    bounded_mpsc_queue<std::string> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.try_push(std::to_string(i)));
+    }
+    EXPECT_FALSE(queue.try_push("full"));
+    EXPECT_EQ(queue.size(), 4u);
+
+    std::vector<std::string> out;
+    EXPECT_EQ(queue.pop_n(std::back_inserter(out), 3), 3u);
+    EXPECT_EQ(out, (std::vector<std::string>{"0", "1", "2"}));
+    EXPECT_EQ(queue.size(), 1u);
+
+    // Wraps around the array
+    EXPECT_TRUE(queue.try_push("4"));
+    EXPECT_TRUE(queue.try_push("5"));
+    std::string value;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, "3");
+    EXPECT_EQ(queue.pop_n(std::back_inserter(out), 10), 2u);
+    EXPECT_EQ(out.back(), "5");
+    EXPECT_FALSE(queue.try_pop(value));
+    EXPECT_TRUE(queue.empty());
+
+    // Leftovers are destroyed with the queue
+    EXPECT_TRUE(queue.try_push(std::string(100, 'x')));
+}
+
+TEST(BoundedMpscQueue, MultipleProducers) {
+    bounded_mpsc_queue<int> queue(64);
+    run_producers(
+        [&](int p, int i) {
+            while (!queue.try_push(p * PER_PRODUCER + i)) {
+                std::this_thread::yield();
+            }
+        },
+        [&] {
+            std::vector<int> out(32);
+            out.resize(queue.pop_n(out.begin(), out.size()));
+            return out;
+        });
+    EXPECT_TRUE(queue.empty());
+}
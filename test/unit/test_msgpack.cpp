@@ -0,0 +1,161 @@
+#include "katana/core/msgpack.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace katana::serde;
+
+namespace {
+
+std::string encode(size_t bound, auto&& fn) {
+    std::string out(bound, '\0');
+    msgpack_out w{out.data()};
+    fn(w);
+    out.resize(static_cast<size_t>(w.pos - out.data()));
+    return out;
+}
+
+std::string bytes(std::initializer_list<unsigned> values) {
+    std::string out;
+    for (unsigned v : values) {
+        out.push_back(static_cast<char>(v));
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(MsgPack, IntegersUseTheSmallestEncoding) {
+    auto int_bytes = [](int64_t v) {
+        return encode(msgpack_int_max_size, [&](msgpack_out& w) { w.integer(v); });
+    };
+    EXPECT_EQ(int_bytes(0), bytes({0x00}));
+    EXPECT_EQ(int_bytes(127), bytes({0x7f}));
+    EXPECT_EQ(int_bytes(128), bytes({0xcc, 0x80}));
+    EXPECT_EQ(int_bytes(-1), bytes({0xff}));
+    EXPECT_EQ(int_bytes(-32), bytes({0xe0}));
+    EXPECT_EQ(int_bytes(-33), bytes({0xd0, 0xdf}));
+    EXPECT_EQ(int_bytes(65535), bytes({0xcd, 0xff, 0xff}));
+    EXPECT_EQ(int_bytes(-129), bytes({0xd1, 0xff, 0x7f}));
+    EXPECT_EQ(int_bytes(std::numeric_limits<int64_t>::min()).size(), msgpack_int_max_size);
+}
+
+TEST(MsgPack, IntegersRoundTrip) {
+    const std::vector<int64_t> values = {0,
+                                         1,
+                                         -1,
+                                         -32,
+                                         -33,
+                                         255,
+                                         256,
+                                         -32768,
+                                         70000,
+                                         -70000,
+                                         int64_t{1} << 40,
+                                         std::numeric_limits<int64_t>::max(),
+                                         std::numeric_limits<int64_t>::min()};
+    for (int64_t v : values) {
+        const auto data = encode(msgpack_int_max_size, [&](msgpack_out& w) { w.integer(v); });
+        msgpack_cursor cur(data);
+        auto decoded = cur.int64();
+        ASSERT_TRUE(decoded.has_value());
+        EXPECT_EQ(*decoded, v);
+        EXPECT_TRUE(cur.eof());
+    }
+    // uint 64 past INT64_MAX is not an int64 but still a number
+    const auto big = encode(msgpack_int_max_size, [](msgpack_out& w) {
+        w.integer(std::numeric_limits<uint64_t>::max());
+    });
+    msgpack_cursor cur(big);
+    EXPECT_FALSE(cur.int64().has_value());
+    auto as_double = cur.number();
+    ASSERT_TRUE(as_double.has_value());
+    EXPECT_EQ(*as_double, 18446744073709551615.0);
+}
+
+TEST(MsgPack, NumbersStringsAndScalars) {
+    const std::string long_text(300, 'x');
+    const auto data = encode(128 + long_text.size(), [&](msgpack_out& w) {
+        w.array_header(6);
+        w.number(-2.5);
+        w.string("hi");
+        w.string(long_text);
+        w.boolean(true);
+        w.nil();
+        w.integer(7);
+    });
+    msgpack_cursor cur(data);
+    EXPECT_EQ(cur.array_header(), std::optional<size_t>(6));
+    EXPECT_EQ(cur.number(), std::optional<double>(-2.5));
+    EXPECT_EQ(cur.string(), std::optional<std::string_view>("hi"));
+    EXPECT_EQ(cur.string(), std::optional<std::string_view>(long_text));
+    EXPECT_EQ(cur.boolean(), std::optional<bool>(true));
+    EXPECT_TRUE(cur.try_nil());
+    // Integers are accepted where a number is expected
+    EXPECT_EQ(cur.number(), std::optional<double>(7.0));
+    EXPECT_TRUE(cur.eof());
+
+    // float 32 1.5
+    msgpack_cursor f32(bytes({0xca, 0x3f, 0xc0, 0x00, 0x00}));
+    EXPECT_EQ(f32.number(), std::optional<double>(1.5));
+}
+
+TEST(MsgPack, WrongTypeLeavesTheCursorInPlace) {
+    const auto data = encode(16, [](msgpack_out& w) { w.string("abc"); });
+    msgpack_cursor cur(data);
+    EXPECT_FALSE(cur.int64().has_value());
+    EXPECT_FALSE(cur.boolean().has_value());
+    EXPECT_FALSE(cur.map_header().has_value());
+    EXPECT_FALSE(cur.try_nil());
+    EXPECT_EQ(cur.string(), std::optional<std::string_view>("abc"));
+}
+
+TEST(MsgPack, TruncatedInputIsRejected) {
+    const auto data = encode(64, [](msgpack_out& w) { w.string(std::string(40, 'y')); });
+    for (size_t n = 0; n < data.size(); ++n) {
+        msgpack_cursor cur(std::string_view(data).substr(0, n));
+        EXPECT_FALSE(cur.string().has_value());
+        msgpack_cursor skip(std::string_view(data).substr(0, n));
+        EXPECT_FALSE(skip.skip_value());
+    }
+    msgpack_cursor cur(bytes({0xcd, 0x01}));
+    EXPECT_FALSE(cur.int64().has_value());
+}
+
+TEST(MsgPack, SkipValueWalksNestedContainers) {
+    const auto data = encode(256, [](msgpack_out& w) {
+        w.map_header(3);
+        w.string("list");
+        w.array_header(20);
+        for (int i = 0; i < 20; ++i) {
+            w.integer(i * 1000);
+        }
+        w.string("nested");
+        w.map_header(1);
+        w.string("x");
+        w.array_header(0);
+        w.string("d");
+        w.number(1.0);
+        w.integer(99); // next value
+    });
+    msgpack_cursor cur(data);
+    EXPECT_TRUE(cur.skip_value());
+    EXPECT_EQ(cur.int64(), std::optional<int64_t>(99));
+
+    // bin 8 and fixext 4 are skipped although nothing decodes them
+    msgpack_cursor other(bytes({0xc4, 0x02, 0xaa, 0xbb, 0xd6, 0x01, 1, 2, 3, 4, 0x05}));
+    EXPECT_TRUE(other.skip_value());
+    EXPECT_TRUE(other.skip_value());
+    EXPECT_EQ(other.int64(), std::optional<int64_t>(5));
+}
+
+TEST(MsgPack, MediaTypes) {
+    EXPECT_TRUE(is_msgpack_media_type("application/msgpack"));
+    EXPECT_TRUE(is_msgpack_media_type("application/x-msgpack"));
+    EXPECT_TRUE(is_msgpack_media_type("application/vnd.msgpack"));
+    EXPECT_FALSE(is_msgpack_media_type("application/json"));
+}
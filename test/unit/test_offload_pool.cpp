@@ -0,0 +1,131 @@
+#include "katana/core/offload_pool.hpp"
+#include "katana/core/reactor_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace katana;
+
+namespace {
+
+template <typename Pred> bool wait_for(Pred pred, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!pred()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(OffloadPoolTest, RunsJobsOffTheCallingThread) {
+    offload_pool_config config;
+    config.worker_count = 2;
+    offload_pool pool(config);
+    EXPECT_EQ(pool.worker_count(), 2u);
+
+    std::atomic<int> ran{0};
+    std::atomic<bool> other_thread{true};
+    auto caller = std::this_thread::get_id();
+    for (int i = 0; i < 16; ++i) {
+        ASSERT_TRUE(pool.submit([&ran, &other_thread, caller]() {
+            if (std::this_thread::get_id() == caller) {
+                other_thread.store(false);
+            }
+            ran.fetch_add(1);
+        }));
+    }
+
+    pool.stop();
+    EXPECT_EQ(ran.load(), 16);
+    EXPECT_TRUE(other_thread.load());
+
+    auto snapshot = pool.metrics().snapshot();
+    EXPECT_EQ(snapshot.jobs_submitted, 16u);
+    EXPECT_EQ(snapshot.jobs_completed, 16u);
+    EXPECT_EQ(snapshot.queue_depth, 0u);
+    EXPECT_GE(snapshot.queue_depth_max, 1u);
+}
+
+TEST(OffloadPoolTest, RejectsWhenQueueIsFull) {
+    offload_pool_config config;
+    config.worker_count = 1;
+    config.queue_capacity = 2;
+    offload_pool pool(config);
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    ASSERT_TRUE(pool.submit([&]() {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    }));
+    ASSERT_TRUE(wait_for([&] { return started.load(); }, std::chrono::seconds(5)));
+
+    EXPECT_TRUE(pool.submit([] {}));
+    EXPECT_TRUE(pool.submit([] {}));
+    EXPECT_FALSE(pool.submit([] {}));
+    EXPECT_EQ(pool.metrics().snapshot().queue_depth, 2u);
+
+    release.store(true);
+    pool.stop();
+
+    auto snapshot = pool.metrics().snapshot();
+    EXPECT_EQ(snapshot.jobs_rejected, 1u);
+    EXPECT_EQ(snapshot.jobs_completed, 3u);
+    EXPECT_GT(snapshot.wait_time_max_us, 0u);
+    EXPECT_FALSE(pool.submit([] {}));
+}
+
+TEST(OffloadPoolTest, SurvivesThrowingJobs) {
+    offload_pool_config config;
+    config.worker_count = 1;
+    offload_pool pool(config);
+
+    std::atomic<int> ran{0};
+    ASSERT_TRUE(pool.submit([]() { throw 42; }));
+    ASSERT_TRUE(pool.submit([&ran]() { ran.fetch_add(1); }));
+    pool.stop();
+
+    EXPECT_EQ(ran.load(), 1);
+    EXPECT_EQ(pool.metrics().snapshot().jobs_completed, 2u);
+}
+
+TEST(OffloadPoolTest, CompletionRunsOnOriginalReactor) {
+    reactor_pool_config reactor_config;
+    reactor_config.reactor_count = 1;
+    reactor_pool reactors(reactor_config);
+    reactors.start();
+
+    auto& r = reactors.get_reactor(0);
+    std::atomic<std::thread::id> reactor_thread{};
+    std::atomic<std::thread::id> worker_thread{};
+    std::atomic<std::thread::id> completion_thread{};
+
+    ASSERT_TRUE(r.schedule([&]() { reactor_thread.store(std::this_thread::get_id()); }));
+
+    {
+        offload_pool_config config;
+        config.worker_count = 1;
+        offload_pool pool(config);
+        ASSERT_TRUE(pool.submit([&]() {
+            worker_thread.store(std::this_thread::get_id());
+            r.schedule([&]() { completion_thread.store(std::this_thread::get_id()); });
+        }));
+
+        ASSERT_TRUE(wait_for([&] { return completion_thread.load() != std::thread::id{}; },
+                             std::chrono::seconds(5)));
+    }
+
+    reactors.stop();
+    reactors.wait();
+
+    EXPECT_NE(worker_thread.load(), reactor_thread.load());
+    EXPECT_EQ(completion_thread.load(), reactor_thread.load());
+}
@@ -268,7 +268,7 @@ paths:
               properties:
                 name:
                   type: string
-                  pattern: "^[a-z]+$"
+                  pattern: '^[a-z]+\d*$'
                 tags:
                   type: array
                   items:
@@ -312,6 +312,7 @@ paths:
         }
     }
     ASSERT_NE(name_schema, nullptr);
+    EXPECT_EQ(name_schema->pattern, "^[a-z]+\\d*$");
     ASSERT_NE(tags, nullptr);
     EXPECT_EQ(tags->kind, schema_kind::array);
     EXPECT_TRUE(tags->unique_items);
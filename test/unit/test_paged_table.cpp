@@ -0,0 +1,92 @@
+#include "katana/core/paged_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace katana;
+
+namespace {
+
+using table = paged_table<int, 4>; // 16 per page
+
+struct tracked {
+    static inline int alive = 0;
+    tracked() noexcept { ++alive; }
+    tracked(const tracked&) = delete;
+    ~tracked() { --alive; }
+    std::unique_ptr<int> value;
+};
+
+} // namespace
+
+TEST(PagedTable, AllocatesOnlyThePagesInUse) {
+    table t;
+    EXPECT_EQ(t.find(0), nullptr);
+    EXPECT_EQ(t.page_count(), 0u);
+
+    int* high = t.ensure(100000);
+    ASSERT_NE(high, nullptr);
+    EXPECT_EQ(*high, 0);
+    EXPECT_EQ(t.page_count(), 1u);
+    EXPECT_EQ(t.capacity(), table::PAGE_SIZE);
+
+    // Same page, nothing allocated; other pages stay absent
+    EXPECT_EQ(t.ensure(100001), high + 1);
+    EXPECT_EQ(t.page_count(), 1u);
+    EXPECT_EQ(t.find(3), nullptr);
+    EXPECT_EQ(t.find(200000), nullptr);
+}
+
+TEST(PagedTable, ElementsNeverMove) {
+    table t;
+    int* first = t.ensure(5);
+    ASSERT_NE(first, nullptr);
+    *first = 42;
+
+    std::vector<int*> seen;
+    for (size_t i = 0; i < 4096; i += 7) {
+        int* p = t.ensure(i);
+        ASSERT_NE(p, nullptr);
+        *p = static_cast<int>(i);
+        seen.push_back(p);
+    }
+    EXPECT_EQ(t.find(5), first);
+    for (size_t i = 0, k = 0; i < 4096; i += 7, ++k) {
+        EXPECT_EQ(t.find(i), seen[k]);
+        EXPECT_EQ(t[i], static_cast<int>(i));
+    }
+}
+
+TEST(PagedTable, ForEachVisitsAllocatedPagesInOrder) {
+    table t;
+    *t.ensure(40) = 1;
+    *t.ensure(3) = 2;
+
+    std::vector<size_t> indices;
+    int sum = 0;
+    t.for_each([&](size_t index, int& value) {
+        indices.push_back(index);
+        sum += value;
+    });
+    ASSERT_EQ(indices.size(), 2 * table::PAGE_SIZE);
+    EXPECT_EQ(indices.front(), 0u);
+    EXPECT_EQ(indices[table::PAGE_SIZE], 32u);
+    EXPECT_EQ(sum, 3);
+}
+
+TEST(PagedTable, DestroysElementsOnce) {
+    tracked::alive = 0;
+    {
+        paged_table<tracked, 2> t;
+        t.ensure(9)->value = std::make_unique<int>(1);
+        EXPECT_EQ(tracked::alive, 4);
+
+        paged_table<tracked, 2> moved = std::move(t);
+        EXPECT_EQ(t.find(9), nullptr);
+        EXPECT_EQ(*moved.find(9)->value, 1);
+        EXPECT_EQ(tracked::alive, 4);
+    }
+    EXPECT_EQ(tracked::alive, 0);
+}
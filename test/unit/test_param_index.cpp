@@ -0,0 +1,83 @@
+#include "katana/core/param_index.hpp"
+#include "katana/core/router.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace katana;
+using namespace katana::http;
+
+TEST(ParamIndex, QueryStringBounds) {
+    EXPECT_EQ(query_string("/items"), "");
+    EXPECT_EQ(query_string("/items?"), "");
+    EXPECT_EQ(query_string("/items?a=1&b=2"), "a=1&b=2");
+    EXPECT_EQ(query_string("/items?a=1#frag"), "a=1");
+}
+
+TEST(ParamIndex, IndexesQueryPairs) {
+    monotonic_arena arena;
+    param_index index;
+    index.assign("page=2&limit=50&flag&&empty=", param_index::format::query, &arena);
+
+    EXPECT_EQ(index.size(), 4u);
+    EXPECT_EQ(index.get("page").value_or(""), "2");
+    EXPECT_EQ(index.get("limit").value_or(""), "50");
+    ASSERT_TRUE(index.get("flag"));
+    EXPECT_TRUE(index.get("flag")->empty());
+    ASSERT_TRUE(index.get("empty"));
+    EXPECT_TRUE(index.get("empty")->empty());
+    EXPECT_FALSE(index.get("missing"));
+}
+
+TEST(ParamIndex, DecodesOnlyWhenNeeded) {
+    monotonic_arena arena;
+    std::string_view source = "q=hello+world%21&plain=abc&na%6De=x&bad=%zz";
+    param_index index;
+    index.assign(source, param_index::format::query, &arena);
+
+    EXPECT_EQ(index.get("q").value_or(""), "hello world!");
+    EXPECT_EQ(index.get("name").value_or(""), "x");
+    EXPECT_EQ(index.get("bad").value_or(""), "%zz");
+
+    // Unescaped values are views into the source, not copies
+    auto plain = index.get("plain");
+    ASSERT_TRUE(plain);
+    EXPECT_GE(plain->data(), source.data());
+    EXPECT_LT(plain->data(), source.data() + source.size());
+}
+
+TEST(ParamIndex, IndexesCookies) {
+    monotonic_arena arena;
+    param_index index;
+    index.assign(" session=abc123 ; theme=dark;junk; id=%41", param_index::format::cookie, &arena);
+
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_EQ(index.get("session").value_or(""), "abc123");
+    EXPECT_EQ(index.get("theme").value_or(""), "dark");
+    EXPECT_EQ(index.get("id").value_or(""), "%41");
+    EXPECT_FALSE(index.get("junk"));
+}
+
+TEST(ParamIndex, RouterFillsRequestContext) {
+    route_entry routes[] = {
+        route_entry{method::get,
+                    path_pattern::from_literal<"/search">(),
+                    handler_fn([](const request&, request_context& ctx) {
+                        auto term = ctx.query.get("term").value_or("");
+                        auto session = ctx.cookies.get("session").value_or("");
+                        return response::ok(std::string(term) + "|" + std::string(session));
+                    })},
+    };
+    router r(routes);
+
+    monotonic_arena arena;
+    request req;
+    req.http_method = method::get;
+    req.uri = "/search?term=a%20b&page=1";
+    req.headers = headers_map(&arena);
+    req.headers.set_view("Cookie", "session=s1; other=2");
+
+    request_context ctx{arena};
+    auto res = r.dispatch(req, ctx);
+    ASSERT_TRUE(res);
+    EXPECT_EQ(res->body, "a b|s1");
+}
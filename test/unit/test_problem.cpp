@@ -248,6 +248,15 @@ TEST(ProblemDetailsTest, ServiceUnavailableWithDetail) {
     EXPECT_EQ(*p.detail, "System is under maintenance");
 }
 
+TEST(ProblemDetailsTest, TooManyRequests) {
+    auto p = problem_details::too_many_requests("Rate limit exceeded");
+
+    EXPECT_EQ(p.status, 429);
+    EXPECT_EQ(p.title, "Too Many Requests");
+    ASSERT_TRUE(p.detail.has_value());
+    EXPECT_EQ(*p.detail, "Rate limit exceeded");
+}
+
 TEST(ProblemDetailsTest, CopyConstructor) {
     problem_details p1;
     p1.type = "test";
@@ -0,0 +1,217 @@
+#include "katana/core/rate_limiter.hpp"
+
+#include "katana/core/http.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <optional>
+
+using namespace katana;
+using namespace katana::http;
+using namespace std::chrono_literals;
+
+namespace {
+
+rate_limit_config single_shard_config(double rps, uint32_t burst) {
+    rate_limit_config config;
+    config.requests_per_second = rps;
+    config.burst = burst;
+    config.shard_count = 1;
+    config.buckets_per_shard = 64;
+    config.global_slots = 64;
+    config.reconcile_interval = 0ms;
+    return config;
+}
+
+request make_request(std::string_view uri) {
+    request req;
+    req.http_method = method::get;
+    req.uri = uri;
+    req.headers = headers_map(nullptr);
+    return req;
+}
+
+} // namespace
+
+TEST(RateLimiter, AllowsBurstThenRejects) {
+    rate_limiter limiter(single_shard_config(10.0, 5));
+    auto now = rate_limiter::clock::now();
+
+    for (uint32_t i = 0; i < 5; ++i) {
+        auto decision = limiter.check("client", now);
+        EXPECT_TRUE(decision.allowed);
+        EXPECT_EQ(decision.remaining, 4 - i);
+    }
+
+    auto rejected = limiter.check("client", now);
+    EXPECT_FALSE(rejected.allowed);
+    EXPECT_EQ(rejected.retry_after, 100ms);
+
+    auto stats = limiter.stats();
+    EXPECT_EQ(stats.allowed, 5u);
+    EXPECT_EQ(stats.rejected, 1u);
+}
+
+TEST(RateLimiter, RefillsOverTime) {
+    rate_limiter limiter(single_shard_config(10.0, 2));
+    auto now = rate_limiter::clock::now();
+
+    EXPECT_TRUE(limiter.check("client", now).allowed);
+    EXPECT_TRUE(limiter.check("client", now).allowed);
+    EXPECT_FALSE(limiter.check("client", now).allowed);
+
+    EXPECT_FALSE(limiter.check("client", now + 50ms).allowed);
+    EXPECT_TRUE(limiter.check("client", now + 100ms).allowed);
+    EXPECT_FALSE(limiter.check("client", now + 100ms).allowed);
+
+    // Idle long enough to refill the whole bucket, but never beyond burst
+    EXPECT_TRUE(limiter.check("client", now + 10s).allowed);
+    EXPECT_TRUE(limiter.check("client", now + 10s).allowed);
+    EXPECT_FALSE(limiter.check("client", now + 10s).allowed);
+}
+
+TEST(RateLimiter, KeysAreIndependent) {
+    rate_limiter limiter(single_shard_config(1.0, 1));
+    auto now = rate_limiter::clock::now();
+
+    EXPECT_TRUE(limiter.check("a", now).allowed);
+    EXPECT_FALSE(limiter.check("a", now).allowed);
+    EXPECT_TRUE(limiter.check("b", now).allowed);
+    EXPECT_TRUE(limiter.check("", now).allowed);
+}
+
+TEST(RateLimiter, FullTableFailsOpenByDefault) {
+    auto config = single_shard_config(1.0, 1);
+    config.buckets_per_shard = 8;
+    rate_limiter open_limiter(config);
+    config.deny_when_full = true;
+    rate_limiter closed_limiter(config);
+
+    auto now = rate_limiter::clock::now();
+    std::array<char, 4> key{'k', '0', '0', '\0'};
+    for (int i = 0; i < 64; ++i) {
+        key[1] = static_cast<char>('a' + i / 8);
+        key[2] = static_cast<char>('a' + i % 8);
+        std::string_view k(key.data(), 3);
+        open_limiter.check(k, now);
+        closed_limiter.check(k, now);
+    }
+
+    EXPECT_GT(open_limiter.stats().table_full, 0u);
+    EXPECT_EQ(open_limiter.stats().rejected, 0u);
+    EXPECT_EQ(closed_limiter.stats().rejected, closed_limiter.stats().table_full);
+    EXPECT_GT(closed_limiter.stats().rejected, 0u);
+}
+
+TEST(RateLimiter, ShardsReconcileConsumption) {
+    rate_limit_config config = single_shard_config(10.0, 10);
+    config.shard_count = 2;
+    config.reconcile_interval = 100ms;
+    rate_limiter limiter(config);
+    auto now = rate_limiter::clock::now();
+
+    EXPECT_TRUE(limiter.check("client", now, 1).allowed);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(limiter.check("client", now, 0).allowed);
+    }
+
+    // Shards are independent until they reconcile
+    EXPECT_TRUE(limiter.check("client", now + 1ms, 1).allowed);
+
+    // Shard 0 publishes its 10 requests, shard 1 then charges itself for them
+    limiter.check("client", now + 100ms, 0);
+    auto decision = limiter.check("client", now + 100ms, 1);
+    EXPECT_FALSE(decision.allowed);
+    EXPECT_GT(decision.retry_after, 0ms);
+    EXPECT_GT(limiter.stats().reconciliations, 0u);
+}
+
+TEST(RateLimiter, WithoutReconciliationShardsAreIndependent) {
+    rate_limit_config config = single_shard_config(10.0, 2);
+    config.shard_count = 2;
+    rate_limiter limiter(config);
+    auto now = rate_limiter::clock::now();
+
+    EXPECT_TRUE(limiter.check("client", now, 0).allowed);
+    EXPECT_TRUE(limiter.check("client", now, 0).allowed);
+    EXPECT_FALSE(limiter.check("client", now, 0).allowed);
+    EXPECT_TRUE(limiter.check("client", now, 1).allowed);
+    limiter.reconcile(now + 1s);
+    EXPECT_EQ(limiter.stats().reconciliations, 0u);
+}
+
+TEST(RateLimitMiddleware, ExtractsKeys) {
+    monotonic_arena arena;
+    request_context ctx{arena};
+    ctx.client_address = "10.0.0.1";
+    ctx.params.add("tenant", "acme");
+
+    auto req = make_request("/");
+    req.headers = headers_map(&arena);
+    req.headers.set_view("X-Api-Key", "secret");
+
+    EXPECT_EQ(extract_rate_limit_key(req, ctx, rate_limit_key::client_address()), "10.0.0.1");
+    EXPECT_EQ(extract_rate_limit_key(req, ctx, rate_limit_key::header("X-Api-Key")), "secret");
+    EXPECT_EQ(extract_rate_limit_key(req, ctx, rate_limit_key::path_param("tenant")), "acme");
+    EXPECT_EQ(extract_rate_limit_key(req, ctx, rate_limit_key::header("X-Missing")), "");
+}
+
+TEST(RateLimitMiddleware, RejectsWithRetryAfter) {
+    rate_limit_config config = single_shard_config(0.5, 1);
+    rate_limiter limiter(config);
+
+    std::array<middleware_fn, 1> middleware{rate_limit_middleware(limiter)};
+    route_entry routes[] = {
+        route_entry{method::get,
+                    path_pattern::from_literal<"/limited">(),
+                    handler_fn([](const request&, request_context&) {
+                        return response::ok("ok", "text/plain");
+                    }),
+                    make_middleware_chain(middleware)},
+    };
+    router r(routes);
+
+    monotonic_arena arena;
+    request_context first{arena};
+    first.client_address = "192.0.2.7";
+    auto ok = r.dispatch(make_request("/limited"), first);
+    ASSERT_TRUE(ok);
+    EXPECT_EQ(ok->status, 200);
+
+    request_context second{arena};
+    second.client_address = "192.0.2.7";
+    auto limited = r.dispatch(make_request("/limited"), second);
+    ASSERT_TRUE(limited);
+    EXPECT_EQ(limited->status, 429);
+    EXPECT_EQ(limited->headers.get("Retry-After"), std::optional<std::string_view>("2"));
+
+    request_context other{arena};
+    other.client_address = "192.0.2.8";
+    auto other_res = r.dispatch(make_request("/limited"), other);
+    ASSERT_TRUE(other_res);
+    EXPECT_EQ(other_res->status, 200);
+}
+
+TEST(RateLimitMiddleware, ChecksTheReactorsShard) {
+    rate_limit_config config = single_shard_config(0.5, 1);
+    config.shard_count = 2;
+    rate_limiter limiter(config);
+
+    auto middleware = rate_limit_middleware(limiter);
+    auto handler = []() -> result<response> { return response::ok("ok", "text/plain"); };
+    auto req = make_request("/");
+
+    monotonic_arena arena;
+    request_context first{arena};
+    first.client_address = "192.0.2.7";
+    EXPECT_EQ(middleware(req, first, handler)->status, 200);
+    EXPECT_EQ(middleware(req, first, handler)->status, 429);
+
+    // Another reactor has its own shard, and without reconciliation its own limit
+    request_context other_reactor{arena};
+    other_reactor.client_address = "192.0.2.7";
+    other_reactor.reactor_index = 1;
+    EXPECT_EQ(middleware(req, other_reactor, handler)->status, 200);
+}
@@ -6,7 +6,9 @@ using reactor_impl = katana::io_uring_reactor;
 using reactor_impl = katana::epoll_reactor;
 #endif
 
+#include <array>
 #include <chrono>
+#include <fcntl.h>
 #include <gtest/gtest.h>
 #include <thread>
 #include <unistd.h>
@@ -472,6 +474,119 @@ TEST_F(ReactorTest, ConcurrentScheduling) {
     EXPECT_EQ(counter.load(), NUM_TASKS);
 }
 
+TEST_F(ReactorTest, ScheduleMoveOnlyAndLargeTasks) {
+    int result = 0;
+    auto value = std::make_unique<int>(7);
+    std::array<int, 64> padding{};
+    padding[63] = 3;
+
+    reactor_->schedule([&result, value = std::move(value)]() { result += *value; });
+    // Larger than task_fn's inline capacity
+    reactor_->schedule([&result, padding]() { result += padding[63]; });
+    reactor_->schedule([this]() { reactor_->stop(); });
+
+    EXPECT_TRUE(reactor_->run().has_value());
+    EXPECT_EQ(result, 10);
+}
+
+TEST_F(ReactorTest, ScheduleBatchRunsTasksInOrder) {
+    std::vector<int> order;
+    std::vector<katana::task_fn> tasks;
+    for (int i = 0; i < 200; ++i) {
+        tasks.emplace_back([&order, i]() { order.push_back(i); });
+    }
+    tasks.emplace_back([this]() { reactor_->stop(); });
+
+    EXPECT_EQ(reactor_->schedule_batch(tasks), tasks.size());
+    EXPECT_TRUE(reactor_->run().has_value());
+
+    ASSERT_EQ(order.size(), 200u);
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(order[static_cast<size_t>(i)], i);
+    }
+    EXPECT_EQ(reactor_->metrics().tasks_executed.load(), 201u);
+}
+
+TEST_F(ReactorTest, ScheduleBatchStopsWhenTheQueueIsFull) {
+    reactor_impl reactor(128, 8);
+    int counter = 0;
+    std::vector<katana::task_fn> tasks;
+    for (int i = 0; i < 12; ++i) {
+        tasks.emplace_back([&counter]() { ++counter; });
+    }
+
+    EXPECT_EQ(reactor.schedule_batch(tasks), 8u);
+    EXPECT_EQ(reactor.metrics().tasks_rejected.load(), 4u);
+    // The tasks that did not fit are left to the caller
+    EXPECT_TRUE(static_cast<bool>(tasks[8]));
+    EXPECT_EQ(reactor.schedule_batch(std::span(tasks).subspan(8)), 0u);
+
+    reactor.schedule_after(10ms, [&reactor]() { reactor.stop(); });
+    reactor.run();
+    EXPECT_EQ(counter, 8);
+}
+
+TEST_F(ReactorTest, ScheduleFromAnotherThreadWakesTheLoop) {
+    // No timers, so the loop blocks in the kernel until a producer writes the eventfd
+    std::atomic<int> counter{0};
+    std::thread producer([this, &counter]() {
+        for (int i = 0; i < 20; ++i) {
+            std::this_thread::sleep_for(1ms);
+            std::vector<katana::task_fn> tasks;
+            tasks.emplace_back([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+            tasks.emplace_back([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+            while (reactor_->schedule_batch(tasks) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        reactor_->schedule([this]() { reactor_->stop(); });
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(reactor_->run().has_value());
+    producer.join();
+
+    EXPECT_EQ(counter.load(), 40);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+}
+
+TEST_F(ReactorTest, SparseFdsRegisteredFromCallbacks) {
+    int pipefd[2];
+    ASSERT_EQ(pipe(pipefd), 0);
+    // Far from every other fd, so its fd_state sits on a page of its own
+    int high_fd = fcntl(pipefd[0], F_DUPFD_CLOEXEC, 1000);
+    ASSERT_GE(high_fd, 1000);
+    int other[2];
+    ASSERT_EQ(pipe(other), 0);
+
+    int calls = 0;
+    auto result = reactor_->register_fd(
+        high_fd, katana::event_type::readable, [&, this](katana::event_type) {
+            ++calls;
+            // Registering a low fd adds a page while this callback's own state is in use
+            ASSERT_TRUE(reactor_
+                            ->register_fd(other[0],
+                                          katana::event_type::readable,
+                                          [](katana::event_type) {})
+                            .has_value());
+            EXPECT_TRUE(reactor_->modify_fd(high_fd, katana::event_type::writable).has_value());
+            EXPECT_TRUE(reactor_->unregister_fd(high_fd).has_value());
+            EXPECT_TRUE(reactor_->unregister_fd(other[0]).has_value());
+            reactor_->stop();
+        });
+    ASSERT_TRUE(result.has_value());
+
+    ASSERT_EQ(write(pipefd[1], "x", 1), 1);
+    reactor_->run();
+    EXPECT_EQ(calls, 1);
+
+    close(high_fd);
+    close(pipefd[0]);
+    close(pipefd[1]);
+    close(other[0]);
+    close(other[1]);
+}
+
 TEST_F(ReactorTest, UnregisterFdDuringCallback) {
     int pipefd[2];
     ASSERT_EQ(pipe(pipefd), 0);
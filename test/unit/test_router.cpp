@@ -163,6 +163,62 @@ TEST(Router, CapturesMultipleParamsAndStripsQuery) {
     EXPECT_EQ(ctx.params.get("itemId"), std::optional<std::string_view>("99"));
 }
 
+TEST(Router, TypedParamsConstrainMatching) {
+    route_entry routes[] = {
+        route_entry{
+            method::get, path_pattern::from_literal<"/users/{id:int}">(), make_handler("int")},
+        route_entry{
+            method::get, path_pattern::from_literal<"/users/{id:uuid}">(), make_handler("uuid")},
+        route_entry{
+            method::get, path_pattern::from_literal<"/users/{name}">(), make_handler("any")},
+        route_entry{
+            method::get, path_pattern::from_literal<"/orders/{id:int}">(), make_handler("order")},
+    };
+
+    router r(routes);
+    monotonic_arena arena;
+
+    request_context ctx_int{arena};
+    auto res_int = r.dispatch(make_request(method::get, "/users/-42"), ctx_int);
+    ASSERT_TRUE(res_int);
+    EXPECT_EQ(res_int->body, "int");
+    EXPECT_EQ(ctx_int.params.get_int("id"), std::optional<int64_t>(-42));
+    EXPECT_EQ(ctx_int.params.get("id"), std::optional<std::string_view>("-42"));
+
+    request_context ctx_uuid{arena};
+    auto res_uuid = r.dispatch(
+        make_request(method::get, "/users/123e4567-e89b-12d3-a456-426614174000"), ctx_uuid);
+    ASSERT_TRUE(res_uuid);
+    EXPECT_EQ(res_uuid->body, "uuid");
+
+    request_context ctx_any{arena};
+    auto res_any = r.dispatch(make_request(method::get, "/users/42abc"), ctx_any);
+    ASSERT_TRUE(res_any);
+    EXPECT_EQ(res_any->body, "any");
+    EXPECT_FALSE(ctx_any.params.get_int("name"));
+
+    // A type mismatch is a routing miss, not a handler error
+    request_context ctx_miss{arena};
+    auto res_miss = r.dispatch(make_request(method::get, "/orders/abc"), ctx_miss);
+    ASSERT_FALSE(res_miss);
+    EXPECT_EQ(res_miss.error(), make_error_code(error_code::not_found));
+
+    request_context ctx_overflow{arena};
+    EXPECT_FALSE(
+        r.dispatch(make_request(method::get, "/orders/99999999999999999999"), ctx_overflow));
+}
+
+TEST(Router, UntypedParamsParseIntOnDemand) {
+    static_assert(path_pattern::from_literal<"/a/{x:int}/{y}">().typed_count == 1);
+
+    path_params params;
+    params.add("page", "7");
+    params.add_int("id", "12", 12);
+    EXPECT_EQ(params.get_int("page"), std::optional<int64_t>(7));
+    EXPECT_EQ(params.get_int("id"), std::optional<int64_t>(12));
+    EXPECT_FALSE(params.get_int("missing"));
+}
+
 TEST(Router, HarnessIntegrationAndProblemDetails) {
     route_entry routes[] = {
         route_entry{method::get,
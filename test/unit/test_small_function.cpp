@@ -0,0 +1,173 @@
+#include "katana/core/inplace_function.hpp"
+#include "katana/core/memory_pool.hpp"
+#include "katana/core/small_function.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+using namespace katana;
+
+namespace {
+
+using fn = small_function<int(int), 32>;
+
+struct counted {
+    static inline int alive = 0;
+    counted() noexcept { ++alive; }
+    counted(const counted&) noexcept { ++alive; }
+    counted(counted&&) noexcept { ++alive; }
+    ~counted() { --alive; }
+};
+
+struct throwing_move {
+    throwing_move() = default;
+    throwing_move(throwing_move&&) noexcept(false) {}
+    int operator()(int x) const { return x + 3; }
+};
+
+auto large_callable() {
+    std::array<int, 64> values{};
+    values[63] = 5;
+    return [values](int x) { return x + values[63]; };
+}
+
+memory_pool_config small_pool() {
+    memory_pool_config config;
+    config.reserve_bytes = 4 * memory_pool::CHUNK_SIZE;
+    return config;
+}
+
+} // namespace
+
+static_assert(inplace_function<void(), 16>::fits<decltype([a = 1L, b = 2L] { (void)(a + b); })>);
+static_assert(!inplace_function<void(), 8>::fits<decltype([a = 1L, b = 2L] { (void)(a + b); })>);
+static_assert(fn::stored_inline<decltype([](int x) { return x; })>);
+static_assert(!fn::stored_inline<decltype(large_callable())>);
+static_assert(!fn::stored_inline<throwing_move>);
+static_assert(!std::is_copy_constructible_v<fn>);
+static_assert(std::is_copy_constructible_v<copyable_small_function<int(int), 32>>);
+
+TEST(SmallFunction, SmallCallablesAreStoredInline) {
+    const int base = 10;
+    fn f = [base](int x) { return base + x; };
+    EXPECT_TRUE(f.is_inline());
+    EXPECT_EQ(f(1), 11);
+
+    fn g = std::move(f);
+    EXPECT_FALSE(static_cast<bool>(f));
+    EXPECT_EQ(g(2), 12);
+
+    g = nullptr;
+    EXPECT_FALSE(static_cast<bool>(g));
+    EXPECT_FALSE(g.is_inline());
+}
+
+TEST(SmallFunction, LargeCallablesGoToThePool) {
+    memory_pool pool(small_pool());
+    std::thread([&pool] {
+        memory_pool::set_current(&pool);
+        {
+            fn f = large_callable();
+            EXPECT_FALSE(f.is_inline());
+            EXPECT_EQ(f(1), 6);
+            EXPECT_EQ(pool.stats().allocations, 1u);
+
+            // Moving hands over the block
+            fn g = std::move(f);
+            EXPECT_EQ(g(2), 7);
+            EXPECT_EQ(pool.stats().allocations, 1u);
+
+            fn h = throwing_move{};
+            EXPECT_FALSE(h.is_inline());
+            EXPECT_EQ(h(1), 4);
+        }
+        // Every out-of-line callable came from the pool, not the heap
+        fn again = large_callable();
+        EXPECT_EQ(pool.stats().allocations, 3u);
+        EXPECT_EQ(pool.stats().fallbacks, 0u);
+        memory_pool::set_current(nullptr);
+    }).join();
+}
+
+TEST(SmallFunction, PooledCallablesCanBeDestroyedOnAnotherThread) {
+    memory_pool pool(small_pool());
+    fn f;
+    std::thread([&pool, &f] {
+        memory_pool::set_current(&pool);
+        f = large_callable();
+        memory_pool::set_current(nullptr);
+    }).join();
+
+    EXPECT_EQ(f(0), 5);
+    f = nullptr;
+
+    std::thread([&pool] {
+        memory_pool::set_current(&pool);
+        fn again = large_callable();
+        EXPECT_EQ(pool.stats().remote_frees, 1u);
+        memory_pool::set_current(nullptr);
+    }).join();
+}
+
+TEST(SmallFunction, MoveOnlyCapturesAreDestroyedOnce) {
+    counted::alive = 0;
+    {
+        small_function<int(), 32> f = [p = std::make_unique<int>(7), c = counted{}] { return *p; };
+        EXPECT_EQ(counted::alive, 1);
+        auto g = std::move(f);
+        EXPECT_EQ(g(), 7);
+        EXPECT_EQ(counted::alive, 1);
+
+        // Same with the callable out of line
+        small_function<int(), 8> h = [p = std::make_unique<int>(8), c = counted{}] { return *p; };
+        EXPECT_FALSE(h.is_inline());
+        auto k = std::move(h);
+        EXPECT_EQ(k(), 8);
+        EXPECT_EQ(counted::alive, 2);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(SmallFunction, CopyableCopiesInlineAndPooledCallables) {
+    using copyable_fn = copyable_small_function<int(int), 32>;
+    counted::alive = 0;
+    {
+        copyable_fn small = [c = counted{}](int x) { return x + 1; };
+        copyable_fn small_copy = small;
+        EXPECT_TRUE(small_copy.is_inline());
+        EXPECT_EQ(small_copy(1), 2);
+        EXPECT_EQ(counted::alive, 2);
+
+        auto large = large_callable();
+        copyable_fn pooled = [large, c = counted{}](int x) { return large(x); };
+        EXPECT_FALSE(pooled.is_inline());
+        copyable_fn pooled_copy;
+        pooled_copy = pooled;
+        EXPECT_EQ(counted::alive, 4);
+        pooled = nullptr;
+        // The copy owns a block of its own
+        EXPECT_EQ(pooled_copy(1), 6);
+        EXPECT_EQ(counted::alive, 3);
+    }
+    EXPECT_EQ(counted::alive, 0);
+}
+
+TEST(SmallFunction, ThreadsWithoutAPoolReuseFreedBlocks) {
+    std::thread([] {
+        ASSERT_EQ(memory_pool::current(), nullptr);
+        void* first = detail::allocate_function_block(300);
+        detail::free_function_block(first, 300);
+        // Same size class: the freed block comes back instead of a new operator new
+        void* second = detail::allocate_function_block(400);
+        EXPECT_EQ(second, first);
+        detail::free_function_block(second, 400);
+
+        fn f = large_callable();
+        EXPECT_FALSE(f.is_inline());
+        EXPECT_EQ(f(1), 6);
+    }).join();
+}
@@ -74,3 +74,65 @@ TEST(WheelTimer, SimpleFlow) {
 
     EXPECT_EQ(counter, 1);
 }
+
+TEST(WheelTimer, NextExpirationWithoutTimeouts) {
+    wheel_timer<64, 10> timer;
+    EXPECT_EQ(timer.time_until_next_expiration(), std::chrono::milliseconds::max());
+}
+
+// Ticks are driven with explicit time points, `k` ticks after the wheel was created
+TEST(WheelTimer, NextExpirationPredictsEachFiring) {
+    wheel_timer<64, 10> timer;
+    const auto t0 = wheel_timer<64, 10>::clock::now();
+    auto at = [&](size_t k) { return t0 + std::chrono::milliseconds(10 * k); };
+
+    size_t fired = 0;
+    const size_t count = 300;
+    for (size_t i = 0; i < count; ++i) {
+        // Up to five turns of the wheel, exact multiples of a turn included
+        const auto ms = static_cast<int64_t>((i * 7919) % 3200 + 1);
+        timer.add(std::chrono::milliseconds(i % 10 == 0 ? 640 * (i % 4 + 1) : ms),
+                  [&]() { ++fired; });
+    }
+
+    size_t k = 0;
+    while (timer.pending_count() > 0) {
+        const auto wait = timer.time_until_next_expiration(at(k));
+        ASSERT_NE(wait, std::chrono::milliseconds::max());
+        const auto ticks = static_cast<size_t>((wait.count() + 9) / 10);
+        ASSERT_GT(ticks, 0u);
+        for (size_t j = 1; j <= ticks; ++j) {
+            const size_t before = fired;
+            timer.tick(at(k + j));
+            EXPECT_EQ(fired > before, j == ticks);
+        }
+        k += ticks;
+    }
+    EXPECT_EQ(fired, count);
+    EXPECT_LE(k, 320u);
+}
+
+TEST(WheelTimer, WholeTurnTimeoutFiresAfterOneTurn) {
+    wheel_timer<64, 10> timer;
+    const auto t0 = wheel_timer<64, 10>::clock::now();
+
+    bool called = false;
+    timer.add(std::chrono::milliseconds(640), [&]() { called = true; });
+    EXPECT_LE(timer.time_until_next_expiration(t0), std::chrono::milliseconds(640));
+    EXPECT_GE(timer.time_until_next_expiration(t0), std::chrono::milliseconds(631));
+
+    timer.tick(t0 + std::chrono::milliseconds(630));
+    EXPECT_FALSE(called);
+    timer.tick(t0 + std::chrono::milliseconds(640));
+    EXPECT_TRUE(called);
+}
+
+TEST(WheelTimer, NearerTimeoutLowersNextExpiration) {
+    wheel_timer<64, 10> timer;
+    const auto t0 = wheel_timer<64, 10>::clock::now();
+
+    timer.add(std::chrono::milliseconds(2000), []() {});
+    EXPECT_GE(timer.time_until_next_expiration(t0), std::chrono::milliseconds(1991));
+    timer.add(std::chrono::milliseconds(50), []() {});
+    EXPECT_LE(timer.time_until_next_expiration(t0), std::chrono::milliseconds(50));
+}
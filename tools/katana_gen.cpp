@@ -39,6 +39,12 @@ int run_openapi(const options& opts) {
         return 1;
     }
 
+    if (opts.validation != "fused" && opts.validation != "separate") {
+        std::cerr << "[openapi] unknown validation mode: " << opts.validation
+                  << " (expected: fused|separate)\n";
+        return 1;
+    }
+
     std::error_code fs_ec;
     fs::create_directories(opts.output, fs_ec);
     if (fs_ec) {
@@ -71,15 +77,22 @@ int run_openapi(const options& opts) {
     }
 
     bool use_pmr = (opts.allocator == "pmr");
+    bool fused_validation = (opts.validation == "fused");
     bool emit_dto = (opts.emit == "all" || opts.emit.find("dto") != std::string::npos);
     bool emit_validator = (opts.emit == "all" || opts.emit.find("validator") != std::string::npos);
     bool emit_serdes = (opts.emit == "all" || opts.emit.find("serdes") != std::string::npos);
+    bool emit_msgpack = opts.emit.find("msgpack") != std::string::npos;
     bool emit_router = (opts.emit == "all" || opts.emit.find("router") != std::string::npos);
     bool emit_handler = (opts.emit == "all" || opts.emit.find("handler") != std::string::npos);
     bool emit_bindings = emit_router && emit_handler;
     if (emit_handler || emit_bindings) {
         emit_serdes = true; // нужно для парсинга body в glue
     }
+    if (emit_msgpack) {
+        emit_serdes = true; // encode_<name> falls back to the JSON serializer
+    } else {
+        emit_msgpack = emit_serdes && uses_msgpack(doc);
+    }
 
     auto with_layer = [&](std::string code) {
         return std::string("// layer: ") + opts.layer + "\n" + code;
@@ -110,7 +123,7 @@ int run_openapi(const options& opts) {
     }
 
     if (emit_serdes) {
-        auto json_code = with_layer(generate_json_parsers(doc, use_pmr));
+        auto json_code = with_layer(generate_json_parsers(doc, use_pmr, fused_validation));
         auto json_path = opts.output / "generated_json.hpp";
         std::ofstream out(json_path, std::ios::binary);
         if (!out) {
@@ -121,6 +134,18 @@ int run_openapi(const options& opts) {
         std::cout << "[codegen] JSON parsers written to " << json_path << "\n";
     }
 
+    if (emit_msgpack) {
+        auto msgpack_code = with_layer(generate_msgpack_codecs(doc, use_pmr));
+        auto msgpack_path = opts.output / "generated_msgpack.hpp";
+        std::ofstream out(msgpack_path, std::ios::binary);
+        if (!out) {
+            std::cerr << "[openapi] failed to write " << msgpack_path << "\n";
+            return 1;
+        }
+        out << msgpack_code;
+        std::cout << "[codegen] MessagePack codecs written to " << msgpack_path << "\n";
+    }
+
     if (emit_router) {
         auto router_code = with_layer(generate_router_table(doc));
         auto router_path = opts.output / "generated_routes.hpp";
@@ -146,7 +171,8 @@ int run_openapi(const options& opts) {
     }
 
     if (emit_bindings) {
-        auto bindings_code = with_layer(generate_router_bindings(doc));
+        auto bindings_code =
+            with_layer(generate_router_bindings(doc, fused_validation, emit_msgpack));
         auto bindings_path = opts.output / "generated_router_bindings.hpp";
         std::ofstream out(bindings_path, std::ios::binary);
         if (!out) {
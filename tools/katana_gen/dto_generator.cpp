@@ -54,6 +54,62 @@ cpp_type_from_schema(const document& doc, const katana::openapi::schema* s, bool
     }
 }
 
+// x-katana-partial: the DTO keeps a json_view of the body and each property becomes an
+// accessor that parses just that member when called. Strings with escapes are decoded into
+// the arena the body was parsed with, so the DTO carries one in both modes.
+void generate_partial_view_members(std::ostream& out,
+                                   const document& doc,
+                                   const katana::openapi::schema& s,
+                                   const std::string& ind) {
+    using katana::openapi::schema_kind;
+    auto struct_name = schema_identifier(doc, &s);
+
+    out << ind << "    explicit " << struct_name
+        << "(katana::monotonic_arena* arena) : arena_(arena) {}\n\n";
+    out << ind << "    katana::monotonic_arena* arena_;\n";
+    out << ind << "    katana::serde::json_view json_;\n\n";
+
+    const std::string arena_arg = "*arena_";
+    for (const auto& prop : s.properties) {
+        const auto* type = prop.type;
+        const auto member = std::string("json_[\"").append(prop.name).append("\"]");
+        out << ind << "    ";
+        if (type && type->kind == schema_kind::string && !type->enum_values.empty()) {
+            auto enum_name = schema_identifier(doc, type) + "_enum";
+            out << "std::optional<" << enum_name << "> " << prop.name << "() const {\n";
+            out << ind << "        auto v = " << member << ".as_string(" << arena_arg << ");\n";
+            out << ind << "        return v ? " << enum_name
+                << "_from_string(*v) : std::nullopt;\n";
+            out << ind << "    }\n";
+            continue;
+        }
+        switch (type ? type->kind : schema_kind::null_type) {
+        case schema_kind::string:
+            out << "std::optional<std::string_view> " << prop.name << "() const { return "
+                << member << ".as_string(" << arena_arg << "); }\n";
+            break;
+        case schema_kind::integer:
+            out << "std::optional<int64_t> " << prop.name << "() const { return " << member
+                << ".as_int64(); }\n";
+            break;
+        case schema_kind::number:
+            out << "std::optional<double> " << prop.name << "() const { return " << member
+                << ".as_double(); }\n";
+            break;
+        case schema_kind::boolean:
+            out << "std::optional<bool> " << prop.name << "() const { return " << member
+                << ".as_bool(); }\n";
+            break;
+        default:
+            // Arrays and nested objects stay lazy too: walk them or hand raw() to parse_*
+            out << "katana::serde::json_view " << prop.name << "() const { return " << member
+                << "; }\n";
+            break;
+        }
+    }
+    out << ind << "};\n\n";
+}
+
 void generate_dto_for_schema(std::ostream& out,
                              const document& doc,
                              const katana::openapi::schema& s,
@@ -109,7 +165,7 @@ void generate_dto_for_schema(std::ostream& out,
             }
             if (!prop.type->pattern.empty()) {
                 out << ind << "        static constexpr std::string_view " << prop_name_upper
-                    << "_PATTERN = \"" << prop.type->pattern << "\";\n";
+                    << "_PATTERN = \"" << escape_cpp_string(prop.type->pattern) << "\";\n";
             }
         }
 
@@ -200,6 +256,11 @@ void generate_dto_for_schema(std::ostream& out,
 
     out << "\n";
 
+    if (s.x_katana_partial) {
+        generate_partial_view_members(out, doc, s, ind);
+        return;
+    }
+
     if (use_pmr) {
         out << ind << "    explicit " << struct_name << "(monotonic_arena* arena = nullptr)\n";
         out << ind << "        : arena_(arena)";
@@ -324,6 +385,13 @@ std::string generate_dtos(const document& doc, bool use_pmr) {
         out << "#include <vector>\n";
         out << "#include <variant>\n\n";
     }
+    bool has_partial = false;
+    for (const auto& schema : doc.schemas) {
+        has_partial = has_partial || (schema.x_katana_partial && !schema.properties.empty());
+    }
+    if (has_partial) {
+        out << "#include \"katana/core/json_view.hpp\"\n";
+    }
     out << "#include <optional>\n";
     out << "#include <string_view>\n";
     out << "#include <cctype>\n\n";
@@ -3,6 +3,8 @@
 #include "katana/core/http.hpp"
 #include "katana/core/openapi_loader.hpp"
 
+#include <iosfwd>
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -13,6 +15,21 @@ using katana::openapi::document;
 std::string escape_json(std::string_view sv);
 std::string escape_cpp_string(std::string_view sv);
 std::string schema_identifier(const document& doc, const katana::openapi::schema* s);
+// Request body objects get parse_validated_<name>, which checks constraints while parsing
+bool has_fused_parser(const document& doc, const katana::openapi::schema* s);
+// Empty object schemas (circular alias placeholders) get no parser or serializer
+bool should_skip_schema(const katana::openapi::schema& s);
+bool is_enum_schema(const document& doc, const katana::openapi::schema* type);
+// True when an operation consumes or produces a MessagePack media type
+bool uses_msgpack(const document& doc);
+// `expr.size()`; nullable values are passed down as "*expr"
+std::string size_of(const std::string& expr);
+// Emit a function taking `const <name>& obj`; bodies that never look at obj mark it unused
+void emit_obj_function(std::ostream& out,
+                       const std::string& signature_head,
+                       const std::string& signature_tail,
+                       const std::string& name,
+                       const std::string& body);
 std::string to_snake_case(std::string_view id);
 std::string sanitize_identifier(std::string_view name);
 std::string method_enum_literal(katana::http::method m);
@@ -21,10 +38,27 @@ void ensure_inline_schema_names(document& doc, std::string_view naming_style);
 std::string dump_ast_summary(const document& doc);
 
 std::string generate_dtos(const document& doc, bool use_pmr);
-std::string generate_json_parsers(const document& doc, bool use_pmr);
+std::string generate_json_parsers(const document& doc, bool use_pmr, bool fused_validation);
+// parse_msgpack_<name> / serialize_msgpack_<name> / encode_<name> next to the JSON codecs
+std::string generate_msgpack_codecs(const document& doc, bool use_pmr);
+bool has_msgpack_codec(const document& doc, const katana::openapi::schema* s);
 std::string generate_validators(const document& doc);
+// A `pattern` compiled at generation time: a fixed-shape checker from validation.hpp when one
+// matches exactly the same strings, else the declaration of a katana::pattern_dfa `dfa_`.
+// nullopt means the pattern needs std::regex (backreferences, lookaround, ...).
+struct compiled_pattern {
+    std::string checker;
+    std::string dfa;
+};
+std::optional<compiled_pattern> compile_pattern(std::string_view pattern);
+// True when a string property of `s` has a pattern compile_pattern cannot handle
+bool needs_std_regex(const katana::openapi::schema& s);
+// validate_<name>'s checks for one property, as statements returning validation_error
+void generate_property_checks(std::ostream& out,
+                              const std::string& struct_name,
+                              const katana::openapi::property& prop);
 std::string generate_router_table(const document& doc);
 std::string generate_handler_interfaces(const document& doc);
-std::string generate_router_bindings(const document& doc);
+std::string generate_router_bindings(const document& doc, bool fused_validation, bool msgpack);
 
 } // namespace katana_gen
@@ -1,8 +1,11 @@
 #include "generator.hpp"
 
 #include "katana/core/arena.hpp"
+#include "katana/core/msgpack.hpp"
 
+#include <algorithm>
 #include <cctype>
+#include <ostream>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -149,6 +152,75 @@ std::string schema_identifier(const document& doc, const katana::openapi::schema
     return "Unnamed_t";
 }
 
+bool has_fused_parser(const document& doc, const katana::openapi::schema* s) {
+    if (!s || s->properties.empty() || s->x_katana_partial ||
+        std::none_of(doc.schemas.begin(), doc.schemas.end(), [&](const auto& named) {
+            return &named == s;
+        })) {
+        return false;
+    }
+    for (const auto& path : doc.paths) {
+        for (const auto& op : path.operations) {
+            if (!op.body) {
+                continue;
+            }
+            for (const auto& media : op.body->content) {
+                if (media.type == s) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool is_enum_schema(const document& doc, const katana::openapi::schema* type) {
+    return type && type->kind == katana::openapi::schema_kind::string &&
+           !type->enum_values.empty() && !schema_identifier(doc, type).empty();
+}
+
+std::string size_of(const std::string& expr) {
+    return expr.starts_with('*') ? expr.substr(1).append("->size()") : expr + ".size()";
+}
+
+void emit_obj_function(std::ostream& out,
+                       const std::string& signature_head,
+                       const std::string& signature_tail,
+                       const std::string& name,
+                       const std::string& body) {
+    auto is_ident = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    bool uses_obj = false;
+    for (size_t at = body.find("obj"); at != std::string::npos && !uses_obj;
+         at = body.find("obj", at + 1)) {
+        uses_obj = (at == 0 || !is_ident(body[at - 1])) &&
+                   (at + 3 == body.size() || !is_ident(body[at + 3]));
+    }
+    out << signature_head << (uses_obj ? "const " : "[[maybe_unused]] const ") << name
+        << "& obj" << signature_tail << " {\n"
+        << body << "}\n\n";
+}
+
+bool uses_msgpack(const document& doc) {
+    for (const auto& path : doc.paths) {
+        for (const auto& op : path.operations) {
+            auto any_msgpack = [](const auto& content) {
+                return std::any_of(content.begin(), content.end(), [](const auto& media) {
+                    return katana::serde::is_msgpack_media_type(media.content_type);
+                });
+            };
+            if (op.body && any_msgpack(op.body->content)) {
+                return true;
+            }
+            for (const auto& resp : op.responses) {
+                if (any_msgpack(resp.content)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
 std::string to_snake_case(std::string_view id) {
     std::string method_name;
     method_name.reserve(id.size() + 4);
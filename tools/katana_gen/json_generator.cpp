@@ -1,5 +1,6 @@
 #include "generator.hpp"
 
+#include <cctype>
 #include <sstream>
 #include <string>
 
@@ -41,15 +42,52 @@ inline std::string ind(int level) {
     return std::string(static_cast<size_t>(level * 4), ' ');
 }
 
+// Reindent text emitted at the top level of a function body by `levels` more levels
+std::string indent_lines(const std::string& text, int levels) {
+    std::string result;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        end = end == std::string::npos ? text.size() : end + 1;
+        result += ind(levels);
+        result.append(text, begin, end - begin);
+        begin = end;
+    }
+    return result;
+}
+
+// With `fused`, emits parse_validated_<name> instead of parse_<name>: the same walk, but each
+// property is checked against its constraints right after it is decoded (the checks
+// validate_<name> would run, see generate_property_checks), and the first violation or
+// structural error is returned at once instead of finishing the parse.
 void generate_json_parser_for_schema(std::ostream& out,
                                      const document& doc,
                                      const katana::openapi::schema& s,
-                                     bool use_pmr) {
+                                     bool use_pmr,
+                                     bool fused = false) {
     auto struct_name = schema_identifier(doc, &s);
-    out << "inline std::optional<" << struct_name << "> parse_" << struct_name
-        << "(std::string_view json, monotonic_arena* arena) {\n";
-    out << "    using katana::serde::json_cursor;\n";
-    out << "    json_cursor cur{json.data(), json.data() + json.size()};\n";
+    const std::string malformed =
+        fused ? "return validation_error{\"\", validation_error_code::invalid_type};"
+              : "return std::nullopt;";
+    if (fused) {
+        out << "inline std::optional<validation_error> parse_validated_" << struct_name
+            << "(std::string_view json, monotonic_arena* arena, " << struct_name << "& obj) {\n";
+    } else {
+        out << "inline std::optional<" << struct_name << "> parse_" << struct_name
+            << "(std::string_view json, monotonic_arena* arena) {\n";
+    }
+    if (s.x_katana_partial && !s.properties.empty()) {
+        // x-katana-partial: only check that the body is an object; properties are parsed by
+        // the DTO's accessors when the handler reads them
+        out << "    " << struct_name << " obj(arena);\n";
+        out << "    obj.json_ = katana::serde::json_view(json);\n";
+        out << "    if (!obj.json_.is_object()) return std::nullopt;\n";
+        out << "    return obj;\n";
+        out << "}\n\n";
+        return;
+    }
+    out << "    katana::serde::indexed_json_scope indexed(json);\n";
+    out << "    auto cur = indexed.cursor();\n";
     if (!use_pmr) {
         out << "    (void)arena;\n";
     }
@@ -59,7 +97,7 @@ void generate_json_parser_for_schema(std::ostream& out,
         using katana::openapi::schema_kind;
         switch (s.kind) {
         case schema_kind::string:
-            out << "    if (auto v = cur.string()) {\n";
+            out << "    if (auto v = cur.unescaped_string(*arena)) {\n";
             if (use_pmr) {
                 out << "        return " << struct_name
                     << "{arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena))};\n";
@@ -72,8 +110,8 @@ void generate_json_parser_for_schema(std::ostream& out,
             return;
         case schema_kind::integer:
             out << "    (void)arena;\n";
-            out << "    if (auto v = katana::serde::parse_size(cur)) return " << struct_name
-                << "{static_cast<int64_t>(*v)};\n";
+            out << "    if (auto v = katana::serde::parse_int64(cur)) return " << struct_name
+                << "{*v};\n";
             out << "    return std::nullopt;\n";
             out << "}\n\n";
             return;
@@ -127,8 +165,17 @@ void generate_json_parser_for_schema(std::ostream& out,
     }
 
     // For empty objects (structures created to break circular aliases)
-    out << "    if (!cur.try_object_start()) return std::nullopt;\n\n";
-    out << "    " << struct_name << " obj(arena);\n";
+    out << "    if (!cur.try_object_start()) " << malformed << "\n\n";
+    if (!fused) {
+        out << "    " << struct_name << " obj(arena);\n";
+    }
+
+    // Perfect hash over the property names, built at compile time
+    out << "    static constexpr katana::serde::key_table keys{";
+    for (size_t i = 0; i < s.properties.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << "\"" << s.properties[i].name << "\"";
+    }
+    out << "};\n";
 
     // track required properties
     for (const auto& prop : s.properties) {
@@ -142,10 +189,12 @@ void generate_json_parser_for_schema(std::ostream& out,
     out << "        cur.skip_ws();\n";
     out << "        if (cur.try_object_end()) break;\n";
     out << "        auto key = cur.string();\n";
-    out << "        if (!key || !cur.consume(':')) break;\n\n";
+    out << "        if (!key || !cur.consume(':')) " << (fused ? malformed : "break;") << "\n\n";
+    out << "        switch (keys.find(*key)) {\n";
 
-    for (const auto& prop : s.properties) {
-        out << "        if (*key == \"" << prop.name << "\") {\n";
+    for (size_t prop_index = 0; prop_index < s.properties.size(); ++prop_index) {
+        const auto& prop = s.properties[prop_index];
+        out << "        case " << prop_index << ": { // " << prop.name << "\n";
         if (prop.required) {
             out << "            has_" << prop.name << " = true;\n";
         }
@@ -156,7 +205,7 @@ void generate_json_parser_for_schema(std::ostream& out,
 
             auto nested_name = schema_identifier(doc, prop.type);
             if (is_enum && !nested_name.empty()) {
-                out << "            if (auto v = cur.string()) {\n";
+                out << "            if (auto v = cur.unescaped_string(*arena)) {\n";
                 out << "                auto enum_val = " << nested_name
                     << "_enum_from_string(std::string_view(v->begin(), v->end()));\n";
                 out << "                if (enum_val) obj." << prop.name << " = *enum_val;\n";
@@ -164,7 +213,7 @@ void generate_json_parser_for_schema(std::ostream& out,
             } else {
                 switch (prop.type->kind) {
                 case schema_kind::string:
-                    out << "            if (auto v = cur.string()) {\n";
+                    out << "            if (auto v = cur.unescaped_string(*arena)) {\n";
                     if (use_pmr) {
                         out << "                obj." << prop.name
                             << " = arena_string<>(v->begin(), v->end(), "
@@ -176,8 +225,8 @@ void generate_json_parser_for_schema(std::ostream& out,
                     out << "            } else { cur.skip_value(); }\n";
                     break;
                 case schema_kind::integer:
-                    out << "            if (auto v = katana::serde::parse_size(cur)) {\n";
-                    out << "                obj." << prop.name << " = static_cast<int64_t>(*v);\n";
+                    out << "            if (auto v = katana::serde::parse_int64(cur)) {\n";
+                    out << "                obj." << prop.name << " = *v;\n";
                     out << "            } else { cur.skip_value(); }\n";
                     break;
                 case schema_kind::number:
@@ -199,7 +248,8 @@ void generate_json_parser_for_schema(std::ostream& out,
                         auto* item = prop.type->items;
                         switch (item->kind) {
                         case schema_kind::string:
-                            out << "                    if (auto v = cur.string()) {\n";
+                            out << "                    if (auto v = "
+                                   "cur.unescaped_string(*arena)) {\n";
                             if (use_pmr) {
                                 out << "                        obj." << prop.name
                                     << ".emplace_back(v->begin(), v->end(), "
@@ -212,9 +262,9 @@ void generate_json_parser_for_schema(std::ostream& out,
                             break;
                         case schema_kind::integer:
                             out << "                    if (auto v = "
-                                   "katana::serde::parse_size(cur)) {\n";
+                                   "katana::serde::parse_int64(cur)) {\n";
                             out << "                        obj." << prop.name
-                                << ".push_back(static_cast<int64_t>(*v));\n";
+                                << ".push_back(*v);\n";
                             out << "                    } else { cur.skip_value(); }\n";
                             break;
                         case schema_kind::number:
@@ -292,287 +342,277 @@ void generate_json_parser_for_schema(std::ostream& out,
         } else {
             out << "            cur.skip_value();\n";
         }
-        out << "        } else ";
+        if (fused) {
+            std::ostringstream checks;
+            generate_property_checks(checks, struct_name, prop);
+            out << indent_lines(checks.str(), 2);
+        }
+        out << "            break;\n";
+        out << "        }\n";
     }
-    out << "{\n";
+    out << "        default:\n";
     out << "            cur.skip_value();\n";
+    out << "            break;\n";
     out << "        }\n";
     out << "        cur.try_comma();\n";
     out << "    }\n";
 
     // required check
     for (const auto& prop : s.properties) {
-        if (prop.required) {
-            out << "    if (!has_" << prop.name << ") return std::nullopt;\n";
+        if (!prop.required) {
+            continue;
+        }
+        out << "    if (!has_" << prop.name << ") return ";
+        if (fused) {
+            out << "validation_error{\"" << prop.name
+                << "\", validation_error_code::required_field_missing};\n";
+        } else {
+            out << "std::nullopt;\n";
         }
     }
 
-    out << "    return obj;\n";
+    out << (fused ? "    return std::nullopt;\n" : "    return obj;\n");
     out << "}\n\n";
 }
 
-void generate_json_serializer_for_schema(std::ostream& out,
-                                         const document& doc,
-                                         const katana::openapi::schema& s) {
-    auto struct_name = schema_identifier(doc, &s);
-    out << "inline std::string serialize_" << struct_name << "(const " << struct_name
-        << "& obj) {\n";
-    if (s.properties.empty()) {
-        using katana::openapi::schema_kind;
-        switch (s.kind) {
-        case schema_kind::string:
-            if (s.nullable) {
-                out << "    if (!obj) return std::string(\"null\");\n";
-                out << "    return std::string(\"\\\"\") + katana::serde::escape_json_string(*obj) "
-                       "+ \"\\\"\";\n";
-            } else {
-                out << "    return std::string(\"\\\"\") + katana::serde::escape_json_string(obj) "
-                       "+ "
-                       "\"\\\"\";\n";
-            }
-            out << "}\n\n";
-            return;
-        case schema_kind::integer:
-            if (s.nullable) {
-                out << "    if (!obj) return std::string(\"null\");\n";
-                out << "    char buf[32];\n";
-                out << "    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), *obj);\n";
-                out << "    return std::string(buf, static_cast<size_t>(ptr - buf));\n";
-            } else {
-                out << "    char buf[32];\n";
-                out << "    auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), obj);\n";
-                out << "    return std::string(buf, static_cast<size_t>(ptr - buf));\n";
-            }
-            out << "}\n\n";
-            return;
-        case schema_kind::number:
-            if (s.nullable) {
-                out << "    if (!obj) return std::string(\"null\");\n";
-                out << "    char buf[64];\n";
-                out << "    auto res = std::to_chars(buf, buf + sizeof(buf), *obj);\n";
-                out << "    if (res.ec == std::errc()) return std::string(buf, "
-                       "static_cast<size_t>(res.ptr - buf));\n";
-                out << "    return {};\n";
-            } else {
-                out << "    char buf[64];\n";
-                out << "    auto res = std::to_chars(buf, buf + sizeof(buf), obj);\n";
-                out << "    if (res.ec == std::errc()) return std::string(buf, "
-                       "static_cast<size_t>(res.ptr - buf));\n";
-                out << "    return {};\n";
-            }
-            out << "}\n\n";
-            return;
-        case schema_kind::boolean:
-            if (s.nullable) {
-                out << "    if (!obj) return std::string(\"null\");\n";
-                out << "    return *obj ? \"true\" : \"false\";\n";
-            } else {
-                out << "    return obj ? \"true\" : \"false\";\n";
-            }
-            out << "}\n\n";
-            return;
-        case schema_kind::array:
-            if (s.nullable) {
-                out << "    if (!obj) return std::string(\"null\");\n";
-            }
-            out << "    const auto& arr = " << (s.nullable ? "*obj" : "obj") << ";\n";
-            out << "    std::string json = \"[\";\n";
-            out << "    for (size_t i = 0; i < arr.size(); ++i) {\n";
-            out << "        if (i > 0) json.push_back(',');\n";
-            out << "        json += serialize_" << schema_identifier(doc, s.items) << "(arr[i]);\n";
-            out << "    }\n";
-            out << "    json.push_back(']');\n";
-            out << "    return json;\n";
-            out << "}\n\n";
-            return;
-        default:
-            out << "    (void)obj;\n";
-            out << "    return {};\n";
-            out << "}\n\n";
-            return;
+// Serializers write through `katana::serde::json_out w` into a buffer sized up front by
+// json_size_bound_<name>, so the emitted code neither allocates nor checks capacity. The two
+// emitters below walk a schema the same way: one sums the worst-case size, the other writes.
+// Worst-case size of a value when it does not depend on the contents, empty otherwise. Each
+// of these is at least as long as "null", so it also covers a nullable value.
+std::string fixed_size_bound(const document& doc, const katana::openapi::schema* type) {
+    using katana::openapi::schema_kind;
+    if (!type) {
+        return "4";
+    }
+    if (is_enum_schema(doc, type)) {
+        return {};
+    }
+    switch (type->kind) {
+    case schema_kind::integer:
+        return "katana::serde::json_int_max_size";
+    case schema_kind::number:
+        return "katana::serde::json_double_max_size";
+    case schema_kind::boolean:
+        return "5";
+    case schema_kind::string:
+    case schema_kind::array:
+    case schema_kind::object:
+        return {};
+    default:
+        return "4";
+    }
+}
+
+std::string element_of(const std::string& expr, const std::string& index) {
+    auto base = expr.starts_with('*') ? std::string("(").append(expr).append(")") : expr;
+    return base.append("[").append(index).append("]");
+}
+
+void emit_size_bound(std::ostream& out,
+                     const document& doc,
+                     const katana::openapi::schema* type,
+                     const std::string& expr,
+                     int indent,
+                     int depth = 0);
+
+void emit_size_bound_value(std::ostream& out,
+                           const document& doc,
+                           const katana::openapi::schema* type,
+                           const std::string& expr,
+                           int indent,
+                           int depth) {
+    using katana::openapi::schema_kind;
+    if (auto fixed = fixed_size_bound(doc, type); !fixed.empty()) {
+        out << ind(indent) << "n += " << fixed << ";\n";
+        return;
+    }
+    if (is_enum_schema(doc, type)) {
+        out << ind(indent) << "n += to_string(" << expr << ").size() + 2;\n";
+        return;
+    }
+    switch (type->kind) {
+    case schema_kind::string:
+        out << ind(indent) << "n += katana::serde::json_string_size_bound(" << size_of(expr)
+            << ");\n";
+        break;
+    case schema_kind::array:
+        if (auto fixed = fixed_size_bound(doc, type->items); !fixed.empty()) {
+            out << ind(indent) << "n += 2 + " << size_of(expr) << " * (" << fixed << " + 1);\n";
+        } else {
+            auto item = "item" + std::to_string(depth);
+            out << ind(indent) << "n += 2 + " << size_of(expr) << ";\n";
+            out << ind(indent) << "for (const auto& " << item << " : " << expr << ") {\n";
+            emit_size_bound(out, doc, type->items, item, indent + 1, depth + 1);
+            out << ind(indent) << "}\n";
         }
+        break;
+    default: // object
+        out << ind(indent) << "n += json_size_bound_" << schema_identifier(doc, type) << "("
+            << expr << ");\n";
+        break;
     }
-    out << "    std::string json;\n";
-    out << "    json.reserve(256);\n";
-    out << "    json.push_back('{');\n";
-    out << "    bool first = true;\n\n";
+}
 
-    for (const auto& prop : s.properties) {
-        out << "    if (!first) json.push_back(',');\n";
-        out << "    first = false;\n";
-        out << "    json.append(\"\\\"" << prop.name << "\\\":\");\n";
+void emit_size_bound(std::ostream& out,
+                     const document& doc,
+                     const katana::openapi::schema* type,
+                     const std::string& expr,
+                     int indent,
+                     int depth) {
+    // Enums are never wrapped in std::optional
+    if (type && type->nullable && !is_enum_schema(doc, type) &&
+        fixed_size_bound(doc, type).empty()) {
+        out << ind(indent) << "if (" << expr << ") {\n";
+        emit_size_bound_value(out, doc, type, "*" + expr, indent + 1, depth);
+        out << ind(indent) << "} else {\n";
+        out << ind(indent + 1) << "n += 4;\n";
+        out << ind(indent) << "}\n";
+        return;
+    }
+    emit_size_bound_value(out, doc, type, expr, indent, depth);
+}
 
-        if (prop.type) {
-            using katana::openapi::schema_kind;
-            bool is_enum =
-                prop.type->kind == schema_kind::string && !prop.type->enum_values.empty();
-            auto nested_name = schema_identifier(doc, prop.type);
-            bool is_optional = prop.type->nullable;
+void emit_write(std::ostream& out,
+                const document& doc,
+                const katana::openapi::schema* type,
+                const std::string& expr,
+                int indent,
+                int depth = 0);
+
+void emit_write_value(std::ostream& out,
+                      const document& doc,
+                      const katana::openapi::schema* type,
+                      const std::string& expr,
+                      int indent,
+                      int depth) {
+    using katana::openapi::schema_kind;
+    if (!type) {
+        out << ind(indent) << "w.null();\n";
+        return;
+    }
+    if (is_enum_schema(doc, type)) {
+        out << ind(indent) << "w.put('\"');\n";
+        out << ind(indent) << "w.raw(to_string(" << expr << "));\n";
+        out << ind(indent) << "w.put('\"');\n";
+        return;
+    }
+    switch (type->kind) {
+    case schema_kind::string:
+        out << ind(indent) << "w.string(" << expr << ");\n";
+        break;
+    case schema_kind::integer:
+        out << ind(indent) << "w.integer(" << expr << ");\n";
+        break;
+    case schema_kind::number:
+        out << ind(indent) << "w.number(" << expr << ");\n";
+        break;
+    case schema_kind::boolean:
+        out << ind(indent) << "w.boolean(" << expr << ");\n";
+        break;
+    case schema_kind::array: {
+        auto i = "i" + std::to_string(depth);
+        out << ind(indent) << "w.put('[');\n";
+        out << ind(indent) << "for (size_t " << i << " = 0; " << i << " < " << size_of(expr)
+            << "; ++" << i << ") {\n";
+        out << ind(indent + 1) << "if (" << i << " > 0) w.put(',');\n";
+        emit_write(out, doc, type->items, element_of(expr, i), indent + 1, depth + 1);
+        out << ind(indent) << "}\n";
+        out << ind(indent) << "w.put(']');\n";
+        break;
+    }
+    case schema_kind::object:
+        out << ind(indent) << "w.pos = serialize_" << schema_identifier(doc, type) << "_to("
+            << expr << ", w.pos);\n";
+        break;
+    default:
+        out << ind(indent) << "w.null();\n";
+        break;
+    }
+}
 
-            if (is_enum && !nested_name.empty()) {
-                out << "    json.push_back('\"');\n";
-                out << "    json.append(to_string(obj." << prop.name << "));\n";
-                out << "    json.push_back('\"');\n";
-            } else {
-                switch (prop.type->kind) {
-                case schema_kind::string:
-                    if (is_optional) {
-                        out << "    if (obj." << prop.name << ") {\n";
-                        out << "        json.push_back('\"');\n";
-                        out << "        json.append(katana::serde::escape_json_string(*obj."
-                            << prop.name << "));\n";
-                        out << "        json.push_back('\"');\n";
-                        out << "    } else {\n";
-                        out << "        json.append(\"null\");\n";
-                        out << "    }\n";
-                    } else {
-                        out << "    json.push_back('\"');\n";
-                        out << "    json.append(katana::serde::escape_json_string(obj." << prop.name
-                            << "));\n";
-                        out << "    json.push_back('\"');\n";
-                    }
-                    break;
-                case schema_kind::integer:
-                    if (is_optional) {
-                        out << "    {\n";
-                        out << "        if (!obj." << prop.name << ") {\n";
-                        out << "            json.append(\"null\");\n";
-                        out << "        } else {\n";
-                        out << "            char buf[32];\n";
-                        out << "            auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), "
-                               "*obj."
-                            << prop.name << ");\n";
-                        out << "            json.append(buf, static_cast<size_t>(ptr - buf));\n";
-                        out << "        }\n";
-                        out << "    }\n";
-                    } else {
-                        out << "    {\n";
-                        out << "        char buf[32];\n";
-                        out << "        auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), obj."
-                            << prop.name << ");\n";
-                        out << "        json.append(buf, static_cast<size_t>(ptr - buf));\n";
-                        out << "    }\n";
-                    }
-                    break;
-                case schema_kind::number:
-                    out << "    {\n";
-                    if (is_optional) {
-                        out << "        if (!obj." << prop.name << ") {\n";
-                        out << "            json.append(\"null\");\n";
-                        out << "        } else {\n";
-                    }
-                    out << "        char buf[64];\n";
-                    out << "        auto res = std::to_chars(buf, buf + sizeof(buf), "
-                        << (is_optional ? "*obj." + prop.name : "obj." + prop.name) << ");\n";
-                    out << "        if (res.ec == std::errc()) json.append(buf, "
-                           "static_cast<size_t>(res.ptr - buf));\n";
-                    if (is_optional) {
-                        out << "        }\n";
-                    }
-                    out << "    }\n";
-                    break;
-                case schema_kind::boolean:
-                    if (is_optional) {
-                        out << "    if (!obj." << prop.name << ") {\n";
-                        out << "        json.append(\"null\");\n";
-                        out << "    } else {\n";
-                        out << "        json.append(*obj." << prop.name
-                            << " ? \"true\" : \"false\");\n";
-                        out << "    }\n";
-                    } else {
-                        out << "    json.append(obj." << prop.name << " ? \"true\" : \"false\");\n";
-                    }
-                    break;
-                case schema_kind::array:
-                    if (is_optional) {
-                        out << "    if (!obj." << prop.name << ") {\n";
-                        out << "        json.append(\"null\");\n";
-                        out << "        break;\n";
-                        out << "    }\n";
-                    }
-                    out << "    json.push_back('[');\n";
-                    out << "    for (size_t i = 0; i < "
-                        << (is_optional ? "obj." + prop.name + "->size()"
-                                        : "obj." + prop.name + ".size()")
-                        << "; ++i) {\n";
-                    out << "        if (i > 0) json.push_back(',');\n";
-                    if (prop.type->items) {
-                        switch (prop.type->items->kind) {
-                        case schema_kind::string:
-                            out << "        json.push_back('\"');\n";
-                            out << "        json.append(katana::serde::escape_json_string("
-                                << (is_optional ? "(*obj." + prop.name + ")[i]"
-                                                : "obj." + prop.name + "[i]")
-                                << "));\n";
-                            out << "        json.push_back('\"');\n";
-                            break;
-                        case schema_kind::integer:
-                            out << "        {\n";
-                            out << "            char buf[32];\n";
-                            out << "            auto [ptr, ec] = std::to_chars(buf, buf + "
-                                   "sizeof(buf), "
-                                << (is_optional ? "(*obj." + prop.name + ")[i]"
-                                                : "obj." + prop.name + "[i]")
-                                << ");\n";
-                            out << "            json.append(buf, static_cast<size_t>(ptr - "
-                                   "buf));\n";
-                            out << "        }\n";
-                            break;
-                        case schema_kind::number:
-                            out << "        {\n";
-                            out << "            char buf[64];\n";
-                            out << "            auto res = std::to_chars(buf, buf + sizeof(buf), "
-                                << (is_optional ? "(*obj." + prop.name + ")[i]"
-                                                : "obj." + prop.name + "[i]")
-                                << ");\n";
-                            out << "            if (res.ec == std::errc()) json.append(buf, "
-                                   "static_cast<size_t>(res.ptr - buf));\n";
-                            out << "        }\n";
-                            break;
-                        case schema_kind::boolean:
-                            out << "        json.append("
-                                << (is_optional ? "(*obj." + prop.name + ")[i]"
-                                                : "obj." + prop.name + "[i]")
-                                << " ? \"true\" : \"false\");\n";
-                            break;
-                        case schema_kind::object: {
-                            auto nested_array_name = schema_identifier(doc, prop.type->items);
-                            out << "        json.append(serialize_" << nested_array_name << "("
-                                << (is_optional ? "(*obj." + prop.name + ")[i]"
-                                                : "obj." + prop.name + "[i]")
-                                << "));\n";
-                            break;
-                        }
-                        case schema_kind::array:
-                        case schema_kind::null_type:
-                            out << "        json.append(\"null\");\n";
-                            break;
-                        default:
-                            out << "        json.append(\"null\");\n";
-                            break;
-                        }
-                    } else {
-                        out << "        json.append(\"null\");\n";
-                    }
-                    out << "    }\n";
-                    out << "    json.push_back(']');\n";
-                    break;
-                case schema_kind::object:
-                    out << "    json.append(serialize_" << nested_name << "(obj." << prop.name
-                        << "));\n";
-                    break;
-                case schema_kind::null_type:
-                    out << "    json.append(\"null\");\n";
-                    break;
-                default:
-                    out << "    json.append(\"null\");\n";
-                    break;
-                }
-            }
+void emit_write(std::ostream& out,
+                const document& doc,
+                const katana::openapi::schema* type,
+                const std::string& expr,
+                int indent,
+                int depth) {
+    if (type && type->nullable && !is_enum_schema(doc, type)) {
+        out << ind(indent) << "if (" << expr << ") {\n";
+        emit_write_value(out, doc, type, "*" + expr, indent + 1, depth);
+        out << ind(indent) << "} else {\n";
+        out << ind(indent + 1) << "w.null();\n";
+        out << ind(indent) << "}\n";
+        return;
+    }
+    emit_write_value(out, doc, type, expr, indent, depth);
+}
+
+void generate_json_serializer_for_schema(std::ostream& out,
+                                         const document& doc,
+                                         const katana::openapi::schema& s) {
+    auto struct_name = schema_identifier(doc, &s);
+
+    std::ostringstream bound;
+    std::ostringstream write;
+    write << "    katana::serde::json_out w{out};\n";
+    if (s.x_katana_partial && !s.properties.empty()) {
+        // A partial DTO is written back as the text it was parsed from
+        bound << "    return obj.json_ ? obj.json_.raw().size() : 4;\n";
+        write << "    if (obj.json_) {\n";
+        write << "        w.raw(obj.json_.raw());\n";
+        write << "    } else {\n";
+        write << "        w.null();\n";
+        write << "    }\n";
+    } else if (!s.properties.empty()) {
+        // Braces plus every key prefix: {"first": ,"second": ... }
+        size_t constant = 1;
+        for (const auto& prop : s.properties) {
+            constant += prop.name.size() + 4;
+        }
+        bound << "    size_t n = " << constant << ";\n";
+        bool first = true;
+        for (const auto& prop : s.properties) {
+            const auto expr = std::string("obj.").append(prop.name);
+            emit_size_bound(bound, doc, prop.type, expr, 1);
+            write << "    w.raw(\"" << (first ? "{" : ",") << "\\\"" << prop.name
+                  << "\\\":\");\n";
+            emit_write(write, doc, prop.type, expr, 1);
+            first = false;
         }
+        write << "    w.put('}');\n";
+    } else {
+        bound << "    size_t n = 0;\n";
+        emit_size_bound(bound, doc, &s, "obj", 1);
+        emit_write(write, doc, &s, "obj", 1);
     }
+    if (!s.x_katana_partial || s.properties.empty()) {
+        bound << "    return n;\n";
+    }
+    write << "    return w.pos;\n";
+
+    emit_obj_function(out,
+                      "inline size_t json_size_bound_" + struct_name + "(",
+                      ") noexcept",
+                      struct_name,
+                      bound.str());
+    // Writes at most json_size_bound_<name>(obj) bytes at `out` and returns their end
+    emit_obj_function(out,
+                      "inline char* serialize_" + struct_name + "_to(",
+                      ", char* out) noexcept",
+                      struct_name,
+                      write.str());
+
+    out << "template <typename Out> inline auto serialize_" << struct_name << "_into(const "
+        << struct_name << "& obj, Out& out) {\n";
+    out << "    return katana::serde::write_json(out, json_size_bound_" << struct_name
+        << "(obj), [&](char* p) { return serialize_" << struct_name << "_to(obj, p); });\n";
+    out << "}\n\n";
 
-    out << "    json.push_back('}');\n";
+    out << "inline std::string serialize_" << struct_name << "(const " << struct_name
+        << "& obj) {\n";
+    out << "    std::string json;\n";
+    out << "    serialize_" << struct_name << "_into(obj, json);\n";
     out << "    return json;\n";
     out << "}\n\n";
 }
@@ -584,8 +624,8 @@ void generate_json_array_parser(std::ostream& out,
     auto struct_name = schema_identifier(doc, &s);
     out << "inline std::optional<std::vector<" << struct_name << ">> parse_" << struct_name
         << "_array(std::string_view json, monotonic_arena* arena) {\n";
-    out << "    using katana::serde::json_cursor;\n";
-    out << "    json_cursor cur{json.data(), json.data() + json.size()};\n";
+    out << "    katana::serde::indexed_json_scope indexed(json);\n";
+    out << "    auto cur = indexed.cursor();\n";
     out << "    if (!cur.try_array_start()) return std::nullopt;\n\n";
     out << "    std::vector<" << struct_name << "> result;\n";
     out << "    while (!cur.eof()) {\n";
@@ -613,34 +653,41 @@ void generate_json_array_serializer(std::ostream& out,
                                     const katana::openapi::schema& s,
                                     bool use_pmr) {
     auto struct_name = schema_identifier(doc, &s);
-    out << "inline std::string serialize_" << struct_name << "_array(const std::vector<"
-        << struct_name << ">& arr) {\n";
-    out << "    std::string json = \"[\";\n";
-    out << "    for (size_t i = 0; i < arr.size(); ++i) {\n";
-    out << "        json += serialize_" << struct_name << "(arr[i]);\n";
-    out << "        if (i < arr.size() - 1) json += \",\";\n";
-    out << "    }\n";
-    out << "    json += \"]\";\n";
-    out << "    return json;\n";
-    out << "}\n\n";
-
-    if (use_pmr) {
-        out << "inline std::string serialize_" << struct_name << "_array(const arena_vector<"
-            << struct_name << ">& arr) {\n";
-        out << "    std::string json = \"[\";\n";
-        out << "    for (size_t i = 0; i < arr.size(); ++i) {\n";
-        out << "        json += serialize_" << struct_name << "(arr[i]);\n";
-        out << "        if (i < arr.size() - 1) json += \",\";\n";
+    auto emit = [&](const std::string& container) {
+        out << "inline std::string serialize_" << struct_name << "_array(const " << container
+            << "<" << struct_name << ">& arr) {\n";
+        out << "    size_t bound = 2 + arr.size();\n";
+        out << "    for (const auto& item : arr) {\n";
+        out << "        bound += json_size_bound_" << struct_name << "(item);\n";
         out << "    }\n";
-        out << "    json += \"]\";\n";
+        out << "    std::string json;\n";
+        out << "    katana::serde::write_json(json, bound, [&](char* p) {\n";
+        out << "        *p++ = '[';\n";
+        out << "        for (size_t i = 0; i < arr.size(); ++i) {\n";
+        out << "            if (i > 0) *p++ = ',';\n";
+        out << "            p = serialize_" << struct_name << "_to(arr[i], p);\n";
+        out << "        }\n";
+        out << "        *p++ = ']';\n";
+        out << "        return p;\n";
+        out << "    });\n";
         out << "    return json;\n";
         out << "}\n\n";
+    };
+    emit("std::vector");
+    if (use_pmr) {
+        emit("arena_vector");
     }
+
+    // Chunk-by-chunk variant for large list responses: http::response::json_stream(...)
+    out << "template <typename Range> inline auto stream_" << struct_name
+        << "_array(Range&& items) {\n";
+    out << "    return katana::serde::json_array_stream(std::forward<Range>(items), "
+        << "&json_size_bound_" << struct_name << ", &serialize_" << struct_name << "_to);\n";
+    out << "}\n\n";
 }
 
 } // namespace
 
-// Check if schema should be skipped (simple type alias or empty object artifact)
 bool should_skip_schema(const katana::openapi::schema& s) {
     using katana::openapi::schema_kind;
 
@@ -656,16 +703,43 @@ bool should_skip_schema(const katana::openapi::schema& s) {
     return false;
 }
 
-std::string generate_json_parsers(const document& doc, bool use_pmr) {
+std::string generate_json_parsers(const document& doc, bool use_pmr, bool fused_validation) {
+    bool any_fused = false;
+    bool any_regex = false;
+    for (const auto& schema : doc.schemas) {
+        if (fused_validation && has_fused_parser(doc, &schema)) {
+            any_fused = true;
+            any_regex = any_regex || needs_std_regex(schema);
+        }
+    }
+
     std::ostringstream out;
     out << "#pragma once\n\n";
     out << "#include \"katana/core/arena.hpp\"\n";
+    out << "#include \"katana/core/json_writer.hpp\"\n";
     out << "#include \"katana/core/serde.hpp\"\n";
+    if (any_fused) {
+        out << "#include \"katana/core/validation.hpp\"\n";
+        out << "#include <cmath>\n";
+    }
     out << "#include <optional>\n";
+    if (any_regex) {
+        out << "#include <regex>\n";
+    }
     out << "#include <string>\n";
     out << "#include <charconv>\n";
+    if (any_fused) {
+        out << "#include <unordered_set>\n";
+    }
     out << "#include <vector>\n\n";
     out << "using katana::monotonic_arena;\n\n";
+    if (any_fused) {
+        out << "using katana::is_valid_datetime;\n";
+        out << "using katana::is_valid_email;\n";
+        out << "using katana::is_valid_uuid;\n";
+        out << "using katana::validation_error;\n";
+        out << "using katana::validation_error_code;\n\n";
+    }
 
     // Forward declarations to allow cross-references between schemas
     for (const auto& schema : doc.schemas) {
@@ -679,6 +753,10 @@ std::string generate_json_parsers(const document& doc, bool use_pmr) {
     for (const auto& schema : doc.schemas) {
         if (!should_skip_schema(schema)) {
             auto name = schema_identifier(doc, &schema);
+            out << "inline size_t json_size_bound_" << name << "(const " << name
+                << "& obj) noexcept;\n";
+            out << "inline char* serialize_" << name << "_to(const " << name
+                << "& obj, char* out) noexcept;\n";
             out << "inline std::string serialize_" << name << "(const " << name << "& obj);\n";
         }
     }
@@ -711,6 +789,14 @@ std::string generate_json_parsers(const document& doc, bool use_pmr) {
         }
     }
 
+    // Fused parse + validate for request bodies; the router calls these instead of
+    // parse_<name> followed by validate_<name>
+    for (const auto& schema : doc.schemas) {
+        if (any_fused && has_fused_parser(doc, &schema)) {
+            generate_json_parser_for_schema(out, doc, schema, use_pmr, true);
+        }
+    }
+
     // Only generate serializers for non-trivial schemas
     for (const auto& schema : doc.schemas) {
         if (!should_skip_schema(schema)) {
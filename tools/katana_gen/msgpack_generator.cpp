@@ -0,0 +1,537 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+namespace katana_gen {
+namespace {
+
+// MessagePack codecs mirror the JSON ones: objects are maps keyed by property name, decoded
+// through the same compile-time key_table, and a value of another type than the schema says
+// is skipped and leaves the default, as parse_<name> does. Strings are read as views into the
+// body, so decoding copies each string once, into the DTO.
+
+inline std::string ind(int level) {
+    return std::string(static_cast<size_t>(level * 4), ' ');
+}
+
+// Leaves `v` as the decoded optional for a scalar of this kind
+std::string scalar_read(katana::openapi::schema_kind kind) {
+    using katana::openapi::schema_kind;
+    switch (kind) {
+    case schema_kind::string:
+        return "cur.string()";
+    case schema_kind::integer:
+        return "cur.int64()";
+    case schema_kind::number:
+        return "cur.number()";
+    case schema_kind::boolean:
+        return "cur.boolean()";
+    default:
+        return {};
+    }
+}
+
+std::string string_value(bool use_pmr) {
+    return use_pmr ? "arena_string<>(v->begin(), v->end(), arena_allocator<char>(arena))"
+                   : "std::string(v->begin(), v->end())";
+}
+
+// Statement storing `value` into `target`: assigned to a property or appended to an array
+std::string store(const std::string& target, bool append, const std::string& value) {
+    return target + (append ? ".push_back(" + value + ");\n" : " = " + value + ";\n");
+}
+
+void emit_skip(std::ostream& out, int indent) {
+    out << ind(indent) << "if (!cur.skip_value()) return std::nullopt;\n";
+}
+
+void emit_read(std::ostream& out,
+               const document& doc,
+               const katana::openapi::schema* type,
+               const std::string& target,
+               bool append,
+               bool use_pmr,
+               int indent,
+               int depth = 0) {
+    using katana::openapi::schema_kind;
+    const auto mismatch = ind(indent) + "} else if (!cur.skip_value()) {\n" + ind(indent + 1) +
+                          "return std::nullopt;\n" + ind(indent) + "}\n";
+    if (!type) {
+        emit_skip(out, indent);
+        return;
+    }
+    if (is_enum_schema(doc, type)) {
+        out << ind(indent) << "if (auto v = cur.string()) {\n";
+        out << ind(indent + 1) << "if (auto e = " << schema_identifier(doc, type)
+            << "_enum_from_string(*v)) " << store(target, append, "*e");
+        out << mismatch;
+        return;
+    }
+    switch (type->kind) {
+    case schema_kind::string:
+    case schema_kind::integer:
+    case schema_kind::number:
+    case schema_kind::boolean:
+        out << ind(indent) << "if (auto v = " << scalar_read(type->kind) << ") {\n";
+        out << ind(indent + 1)
+            << store(target,
+                     append,
+                     type->kind == schema_kind::string ? string_value(use_pmr) : "*v");
+        out << mismatch;
+        break;
+    case schema_kind::array: {
+        // Nested arrays are skipped, as in the JSON parser
+        if (append || !type->items || type->items->kind == schema_kind::array) {
+            emit_skip(out, indent);
+            break;
+        }
+        const auto n = "n" + std::to_string(depth);
+        const auto i = "i" + std::to_string(depth);
+        out << ind(indent) << "if (auto " << n << " = cur.array_header()) {\n";
+        // Each element takes at least a byte, which caps what a hostile count can reserve
+        out << ind(indent + 1) << target << ".reserve(std::min(*" << n
+            << ", cur.remaining()));\n";
+        out << ind(indent + 1) << "for (size_t " << i << " = 0; " << i << " < *" << n << "; ++"
+            << i << ") {\n";
+        emit_read(out, doc, type->items, target, true, use_pmr, indent + 2, depth + 1);
+        out << ind(indent + 1) << "}\n";
+        out << mismatch;
+        break;
+    }
+    case schema_kind::object: {
+        auto nested = schema_identifier(doc, type);
+        if (nested.empty() || should_skip_schema(*type) || type->x_katana_partial) {
+            emit_skip(out, indent);
+            break;
+        }
+        // A nested object that fails to decode is skipped whole
+        const auto start = "start" + std::to_string(depth);
+        out << ind(indent) << "const char* " << start << " = cur.ptr;\n";
+        out << ind(indent) << "if (auto v = read_msgpack_" << nested << "(cur, arena)) {\n";
+        out << ind(indent + 1) << store(target, append, "std::move(*v)");
+        out << ind(indent) << "} else {\n";
+        out << ind(indent + 1) << "cur.ptr = " << start << ";\n";
+        emit_skip(out, indent + 1);
+        out << ind(indent) << "}\n";
+        break;
+    }
+    default:
+        emit_skip(out, indent);
+        break;
+    }
+}
+
+void generate_msgpack_reader(std::ostream& out,
+                             const document& doc,
+                             const katana::openapi::schema& s,
+                             bool use_pmr) {
+    using katana::openapi::schema_kind;
+    auto struct_name = schema_identifier(doc, &s);
+    out << "inline std::optional<" << struct_name << "> read_msgpack_" << struct_name
+        << "(katana::serde::msgpack_cursor& cur, monotonic_arena* arena) {\n";
+    if (!use_pmr) {
+        out << "    (void)arena;\n";
+    }
+
+    if (s.properties.empty()) {
+        if (is_enum_schema(doc, &s)) {
+            if (use_pmr) {
+                out << "    (void)arena;\n";
+            }
+            out << "    if (auto v = cur.string()) return " << struct_name
+                << "_enum_from_string(*v);\n";
+        } else if (auto read = scalar_read(s.kind); !read.empty()) {
+            if (use_pmr && s.kind != schema_kind::string) {
+                out << "    (void)arena;\n";
+            }
+            out << "    if (auto v = " << read << ") return " << struct_name << "{"
+                << (s.kind == schema_kind::string ? string_value(use_pmr) : "*v") << "};\n";
+        } else if (s.kind == schema_kind::array && s.items) {
+            out << "    auto n = cur.array_header();\n";
+            out << "    if (!n) return std::nullopt;\n";
+            if (use_pmr) {
+                out << "    " << struct_name << " result{arena_allocator<"
+                    << schema_identifier(doc, s.items) << ">(arena)};\n";
+            } else {
+                out << "    " << struct_name << " result;\n";
+            }
+            out << "    result.reserve(std::min(*n, cur.remaining()));\n";
+            out << "    for (size_t i = 0; i < *n; ++i) {\n";
+            emit_read(out, doc, s.items, "result", true, use_pmr, 2, 1);
+            out << "    }\n";
+            out << "    return result;\n";
+            out << "}\n\n";
+            return;
+        } else {
+            out << "    (void)cur;\n";
+            if (use_pmr) {
+                out << "    (void)arena;\n";
+            }
+        }
+        out << "    return std::nullopt;\n";
+        out << "}\n\n";
+        return;
+    }
+
+    out << "    auto fields = cur.map_header();\n";
+    out << "    if (!fields) return std::nullopt;\n";
+    out << "    " << struct_name << " obj(arena);\n";
+    out << "    static constexpr katana::serde::key_table keys{";
+    for (size_t i = 0; i < s.properties.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << "\"" << escape_cpp_string(s.properties[i].name) << "\"";
+    }
+    out << "};\n";
+    for (const auto& prop : s.properties) {
+        if (prop.required) {
+            out << "    bool has_" << prop.name << " = false;\n";
+        }
+    }
+    out << "\n";
+    out << "    for (size_t field = 0; field < *fields; ++field) {\n";
+    out << "        auto key = cur.string();\n";
+    out << "        if (!key) return std::nullopt;\n";
+    out << "        switch (keys.find(*key)) {\n";
+    for (size_t prop_index = 0; prop_index < s.properties.size(); ++prop_index) {
+        const auto& prop = s.properties[prop_index];
+        out << "        case " << prop_index << ": { // " << prop.name << "\n";
+        if (prop.required) {
+            out << "            has_" << prop.name << " = true;\n";
+        }
+        emit_read(out, doc, prop.type, std::string("obj.").append(prop.name), false, use_pmr, 3);
+        out << "            break;\n";
+        out << "        }\n";
+    }
+    out << "        default:\n";
+    out << "            if (!cur.skip_value()) return std::nullopt;\n";
+    out << "            break;\n";
+    out << "        }\n";
+    out << "    }\n";
+    for (const auto& prop : s.properties) {
+        if (prop.required) {
+            out << "    if (!has_" << prop.name << ") return std::nullopt;\n";
+        }
+    }
+    out << "    return obj;\n";
+    out << "}\n\n";
+}
+
+// Worst-case encoded size when it does not depend on the value, empty otherwise. Each of
+// these is at least one byte, so it also covers nil for a nullable value.
+std::string fixed_size_bound(const document& doc, const katana::openapi::schema* type) {
+    using katana::openapi::schema_kind;
+    if (!type) {
+        return "1";
+    }
+    if (is_enum_schema(doc, type)) {
+        return {};
+    }
+    switch (type->kind) {
+    case schema_kind::integer:
+        return "katana::serde::msgpack_int_max_size";
+    case schema_kind::number:
+        return "katana::serde::msgpack_double_max_size";
+    case schema_kind::string:
+    case schema_kind::array:
+    case schema_kind::object:
+        return {};
+    default:
+        return "1";
+    }
+}
+
+void emit_size_bound(std::ostream& out,
+                     const document& doc,
+                     const katana::openapi::schema* type,
+                     const std::string& expr,
+                     int indent,
+                     int depth = 0);
+
+void emit_size_bound_value(std::ostream& out,
+                           const document& doc,
+                           const katana::openapi::schema* type,
+                           const std::string& expr,
+                           int indent,
+                           int depth) {
+    using katana::openapi::schema_kind;
+    if (auto fixed = fixed_size_bound(doc, type); !fixed.empty()) {
+        out << ind(indent) << "n += " << fixed << ";\n";
+        return;
+    }
+    if (is_enum_schema(doc, type)) {
+        out << ind(indent) << "n += katana::serde::msgpack_string_size_bound(to_string(" << expr
+            << ").size());\n";
+        return;
+    }
+    switch (type->kind) {
+    case schema_kind::string:
+        out << ind(indent) << "n += katana::serde::msgpack_string_size_bound(" << size_of(expr)
+            << ");\n";
+        break;
+    case schema_kind::array:
+        if (auto fixed = fixed_size_bound(doc, type->items); !fixed.empty()) {
+            out << ind(indent) << "n += katana::serde::msgpack_header_max_size + "
+                << size_of(expr) << " * " << fixed << ";\n";
+        } else {
+            auto item = "item" + std::to_string(depth);
+            out << ind(indent) << "n += katana::serde::msgpack_header_max_size;\n";
+            out << ind(indent) << "for (const auto& " << item << " : " << expr << ") {\n";
+            emit_size_bound(out, doc, type->items, item, indent + 1, depth + 1);
+            out << ind(indent) << "}\n";
+        }
+        break;
+    default: // object
+        out << ind(indent) << "n += msgpack_size_bound_" << schema_identifier(doc, type) << "("
+            << expr << ");\n";
+        break;
+    }
+}
+
+void emit_size_bound(std::ostream& out,
+                     const document& doc,
+                     const katana::openapi::schema* type,
+                     const std::string& expr,
+                     int indent,
+                     int depth) {
+    // Enums are never wrapped in std::optional
+    if (type && type->nullable && !is_enum_schema(doc, type) &&
+        fixed_size_bound(doc, type).empty()) {
+        out << ind(indent) << "if (" << expr << ") {\n";
+        emit_size_bound_value(out, doc, type, "*" + expr, indent + 1, depth);
+        out << ind(indent) << "} else {\n";
+        out << ind(indent + 1) << "n += 1;\n";
+        out << ind(indent) << "}\n";
+        return;
+    }
+    emit_size_bound_value(out, doc, type, expr, indent, depth);
+}
+
+void emit_write(std::ostream& out,
+                const document& doc,
+                const katana::openapi::schema* type,
+                const std::string& expr,
+                int indent,
+                int depth = 0);
+
+void emit_write_value(std::ostream& out,
+                      const document& doc,
+                      const katana::openapi::schema* type,
+                      const std::string& expr,
+                      int indent,
+                      int depth) {
+    using katana::openapi::schema_kind;
+    if (!type) {
+        out << ind(indent) << "w.nil();\n";
+        return;
+    }
+    if (is_enum_schema(doc, type)) {
+        out << ind(indent) << "w.string(to_string(" << expr << "));\n";
+        return;
+    }
+    switch (type->kind) {
+    case schema_kind::string:
+        out << ind(indent) << "w.string(" << expr << ");\n";
+        break;
+    case schema_kind::integer:
+        out << ind(indent) << "w.integer(" << expr << ");\n";
+        break;
+    case schema_kind::number:
+        out << ind(indent) << "w.number(" << expr << ");\n";
+        break;
+    case schema_kind::boolean:
+        out << ind(indent) << "w.boolean(" << expr << ");\n";
+        break;
+    case schema_kind::array: {
+        auto item = "item" + std::to_string(depth);
+        out << ind(indent) << "w.array_header(" << size_of(expr) << ");\n";
+        out << ind(indent) << "for (const auto& " << item << " : " << expr << ") {\n";
+        emit_write(out, doc, type->items, item, indent + 1, depth + 1);
+        out << ind(indent) << "}\n";
+        break;
+    }
+    case schema_kind::object:
+        out << ind(indent) << "w.pos = serialize_msgpack_" << schema_identifier(doc, type)
+            << "_to(" << expr << ", w.pos);\n";
+        break;
+    default:
+        out << ind(indent) << "w.nil();\n";
+        break;
+    }
+}
+
+void emit_write(std::ostream& out,
+                const document& doc,
+                const katana::openapi::schema* type,
+                const std::string& expr,
+                int indent,
+                int depth) {
+    if (type && type->nullable && !is_enum_schema(doc, type)) {
+        out << ind(indent) << "if (" << expr << ") {\n";
+        emit_write_value(out, doc, type, "*" + expr, indent + 1, depth);
+        out << ind(indent) << "} else {\n";
+        out << ind(indent + 1) << "w.nil();\n";
+        out << ind(indent) << "}\n";
+        return;
+    }
+    emit_write_value(out, doc, type, expr, indent, depth);
+}
+
+// Property names are written as a string literal holding the str header and the name; the
+// header byte is never zero, so the literal converts to the right string_view
+std::string encoded_key(std::string_view name) {
+    const auto size = static_cast<unsigned>(name.size());
+    char header[16];
+    if (size <= 31) {
+        std::snprintf(header, sizeof(header), "\\x%02x", 0xa0u | size);
+    } else {
+        std::snprintf(header, sizeof(header), "\\xd9\\x%02x", size);
+    }
+    return std::string("\"").append(header).append("\" \"") + escape_cpp_string(name) + "\"";
+}
+
+size_t encoded_key_size(std::string_view name) {
+    return name.size() + (name.size() <= 31 ? 1 : 2);
+}
+
+size_t map_header_size(size_t entries) {
+    return entries <= 15 ? 1 : entries <= 0xffff ? 3 : 5;
+}
+
+void generate_msgpack_serializer(std::ostream& out,
+                                 const document& doc,
+                                 const katana::openapi::schema& s) {
+    auto struct_name = schema_identifier(doc, &s);
+
+    std::ostringstream bound;
+    std::ostringstream write;
+    write << "    katana::serde::msgpack_out w{out};\n";
+    if (!s.properties.empty()) {
+        size_t constant = map_header_size(s.properties.size());
+        for (const auto& prop : s.properties) {
+            constant += encoded_key_size(prop.name);
+        }
+        bound << "    size_t n = " << constant << ";\n";
+        write << "    w.map_header(" << s.properties.size() << ");\n";
+        for (const auto& prop : s.properties) {
+            const auto expr = std::string("obj.").append(prop.name);
+            emit_size_bound(bound, doc, prop.type, expr, 1);
+            write << "    w.raw(" << encoded_key(prop.name) << ");\n";
+            emit_write(write, doc, prop.type, expr, 1);
+        }
+    } else {
+        bound << "    size_t n = 0;\n";
+        emit_size_bound(bound, doc, &s, "obj", 1);
+        emit_write(write, doc, &s, "obj", 1);
+    }
+    bound << "    return n;\n";
+    write << "    return w.pos;\n";
+
+    emit_obj_function(out,
+                      "inline size_t msgpack_size_bound_" + struct_name + "(",
+                      ") noexcept",
+                      struct_name,
+                      bound.str());
+    emit_obj_function(out,
+                      "inline char* serialize_msgpack_" + struct_name + "_to(",
+                      ", char* out) noexcept",
+                      struct_name,
+                      write.str());
+
+    out << "template <typename Out> inline auto serialize_msgpack_" << struct_name
+        << "_into(const " << struct_name << "& obj, Out& out) {\n";
+    out << "    return katana::serde::write_json(out, msgpack_size_bound_" << struct_name
+        << "(obj), [&](char* p) { return serialize_msgpack_" << struct_name
+        << "_to(obj, p); });\n";
+    out << "}\n\n";
+
+    out << "inline std::string serialize_msgpack_" << struct_name << "(const " << struct_name
+        << "& obj) {\n";
+    out << "    std::string data;\n";
+    out << "    serialize_msgpack_" << struct_name << "_into(obj, data);\n";
+    out << "    return data;\n";
+    out << "}\n\n";
+
+    // Response in whichever format the bindings negotiated (request_context::response_type)
+    out << "inline katana::http::response encode_" << struct_name << "(const " << struct_name
+        << "& obj, std::string_view media_type) {\n";
+    out << "    if (katana::serde::is_msgpack_media_type(media_type)) {\n";
+    out << "        return katana::http::response::ok(serialize_msgpack_" << struct_name
+        << "(obj), std::string(media_type));\n";
+    out << "    }\n";
+    out << "    return katana::http::response::json(serialize_" << struct_name << "(obj));\n";
+    out << "}\n\n";
+}
+
+bool has_codec(const katana::openapi::schema& s) {
+    // Partial DTOs hold a view of JSON text and have nothing to decode MessagePack into
+    return !should_skip_schema(s) && !(s.x_katana_partial && !s.properties.empty());
+}
+
+} // namespace
+
+bool has_msgpack_codec(const document& doc, const katana::openapi::schema* s) {
+    return s && !schema_identifier(doc, s).empty() && has_codec(*s) &&
+           std::any_of(doc.schemas.begin(), doc.schemas.end(), [&](const auto& named) {
+               return &named == s;
+           });
+}
+
+std::string generate_msgpack_codecs(const document& doc, bool use_pmr) {
+    std::ostringstream out;
+    out << "#pragma once\n\n";
+    out << "#include \"katana/core/arena.hpp\"\n";
+    out << "#include \"katana/core/http.hpp\"\n";
+    out << "#include \"katana/core/json_writer.hpp\"\n";
+    out << "#include \"katana/core/key_table.hpp\"\n";
+    out << "#include \"katana/core/msgpack.hpp\"\n";
+    out << "#include <algorithm>\n";
+    out << "#include <optional>\n";
+    out << "#include <string>\n";
+    out << "#include <string_view>\n\n";
+    out << "using katana::monotonic_arena;\n\n";
+
+    for (const auto& schema : doc.schemas) {
+        if (has_codec(schema)) {
+            auto name = schema_identifier(doc, &schema);
+            out << "inline std::optional<" << name << "> read_msgpack_" << name
+                << "(katana::serde::msgpack_cursor& cur, monotonic_arena* arena);\n";
+            out << "inline size_t msgpack_size_bound_" << name << "(const " << name
+                << "& obj) noexcept;\n";
+            out << "inline char* serialize_msgpack_" << name << "_to(const " << name
+                << "& obj, char* out) noexcept;\n";
+        }
+    }
+    out << "\n";
+
+    for (const auto& schema : doc.schemas) {
+        if (has_codec(schema)) {
+            generate_msgpack_reader(out, doc, schema, use_pmr);
+        }
+    }
+
+    // Whole-body entry points: trailing bytes after the value are an error
+    for (const auto& schema : doc.schemas) {
+        if (has_codec(schema)) {
+            auto name = schema_identifier(doc, &schema);
+            out << "inline std::optional<" << name << "> parse_msgpack_" << name
+                << "(std::string_view data, monotonic_arena* arena) {\n";
+            out << "    katana::serde::msgpack_cursor cur(data);\n";
+            out << "    auto result = read_msgpack_" << name << "(cur, arena);\n";
+            out << "    if (!cur.eof()) return std::nullopt;\n";
+            out << "    return result;\n";
+            out << "}\n\n";
+        }
+    }
+
+    for (const auto& schema : doc.schemas) {
+        if (has_codec(schema)) {
+            generate_msgpack_serializer(out, doc, schema);
+        }
+    }
+
+    return out.str();
+}
+
+} // namespace katana_gen
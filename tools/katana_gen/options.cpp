@@ -17,9 +17,12 @@ Options:
   -i, --input <file>         OpenAPI specification path (JSON/YAML)
   -o, --output <dir>         Output directory (default: .)
   --emit <targets>           What to generate: dto,validator,serdes,router,handler,all (default: all)
+                             plus msgpack for MessagePack codecs (implied by msgpack media types)
   --layer <mode>             Architecture: flat,layered (default: flat)
   --alloc <type>             Allocator: pmr,std (default: pmr)
   --inline-naming <style>    Inline schema naming: operation,flat (default: operation)
+  --validation <mode>        Request body checks: fused (while parsing, stop at the first
+                             error), separate (parse, then validate_*) (default: fused)
   --json                     Output as JSON format
   --check                    Validate spec only, no files written
   --strict                   Strict validation, fail on any error
@@ -99,6 +102,11 @@ options parse_args(int argc, char** argv) {
                 print_usage();
             }
             opts.inline_naming = argv[++i];
+        } else if (arg == "--validation") {
+            if (i + 1 >= argc) {
+                print_usage();
+            }
+            opts.validation = argv[++i];
         } else if (arg == "--check") {
             opts.check_only = true;
         } else {
@@ -13,6 +13,7 @@ struct options {
     std::string layer = "flat";              // flat,layered
     std::string allocator = "pmr";           // pmr,std
     std::string inline_naming = "operation"; // operation,flat
+    std::string validation = "fused";        // fused,separate
     bool strict = false;
     bool dump_ast = false;
     bool json_output = false;
@@ -0,0 +1,798 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace katana_gen {
+namespace {
+
+// A pattern is read the way std::regex_match reads it with the ECMAScript grammar, byte by
+// byte: parsed into a syntax tree, built into a Thompson NFA, turned into a DFA by subset
+// construction and minimized. Anchors at either end are implied by whole-string matching.
+// Constructs a finite automaton cannot express (backreferences, lookaround, word boundaries),
+// anything this parser does not know, and patterns whose tables would get too big are left
+// to std::regex.
+
+using byte_set = std::bitset<256>;
+
+constexpr size_t unbounded = static_cast<size_t>(-1);
+constexpr size_t max_repeat = 1000;
+constexpr size_t max_nfa_states = 20000;
+constexpr size_t max_dfa_states = 1024;
+
+struct regex_node {
+    enum class kind { set, concat, alternation, repeat };
+    kind type = kind::concat; // an empty concatenation matches the empty string
+    byte_set chars;
+    std::vector<regex_node> items;
+    size_t min = 0;
+    size_t max = 0;
+};
+
+regex_node set_node(const byte_set& chars) {
+    regex_node n;
+    n.type = regex_node::kind::set;
+    n.chars = chars;
+    return n;
+}
+
+byte_set byte_range(int first, int last) {
+    byte_set s;
+    for (int b = first; b <= last; ++b) {
+        s.set(static_cast<size_t>(b));
+    }
+    return s;
+}
+
+bool is_ascii_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool is_ascii_alnum(char c) {
+    return is_ascii_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+class regex_parser {
+public:
+    explicit regex_parser(std::string_view pattern) : p_(pattern), end_(pattern.size()) {}
+
+    std::optional<regex_node> parse() {
+        if (p_.starts_with('^')) {
+            pos_ = 1;
+        }
+        if (end_ > pos_ && p_.ends_with('$') && !escaped(end_ - 1)) {
+            --end_;
+        }
+        auto root = alternation();
+        if (failed_ || pos_ != end_) {
+            return std::nullopt;
+        }
+        return root;
+    }
+
+private:
+    // An odd run of backslashes before `i` escapes it
+    bool escaped(size_t i) const {
+        size_t slashes = 0;
+        while (i > slashes && p_[i - slashes - 1] == '\\') {
+            ++slashes;
+        }
+        return slashes % 2 == 1;
+    }
+
+    bool at(char c) const { return pos_ < end_ && p_[pos_] == c; }
+    bool eat(char c) {
+        if (!at(c)) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+    regex_node fail() {
+        failed_ = true;
+        return {};
+    }
+
+    regex_node alternation() {
+        regex_node first = sequence();
+        if (!at('|')) {
+            return first;
+        }
+        regex_node alt;
+        alt.type = regex_node::kind::alternation;
+        alt.items.push_back(std::move(first));
+        while (!failed_ && eat('|')) {
+            alt.items.push_back(sequence());
+        }
+        return alt;
+    }
+
+    regex_node sequence() {
+        regex_node seq;
+        while (!failed_ && pos_ < end_ && !at('|') && !at(')')) {
+            regex_node item = atom();
+            quantify(item);
+            seq.items.push_back(std::move(item));
+        }
+        return seq;
+    }
+
+    regex_node atom() {
+        const char c = p_[pos_++];
+        switch (c) {
+        case '(': {
+            if (eat('?') && !eat(':')) {
+                return fail(); // lookahead and lookbehind
+            }
+            regex_node inner = alternation();
+            return eat(')') ? inner : fail();
+        }
+        case '[':
+            return char_class();
+        case '.':
+            return set_node(~(byte_range('\n', '\n') | byte_range('\r', '\r')));
+        case '\\': {
+            auto chars = escape(false);
+            return chars ? set_node(*chars) : fail();
+        }
+        case '^':
+        case '$':
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            return fail();
+        default: {
+            const int b = static_cast<unsigned char>(c);
+            return set_node(byte_range(b, b));
+        }
+        }
+    }
+
+    void quantify(regex_node& item) {
+        size_t min = 0;
+        size_t max = 0;
+        if (eat('*')) {
+            max = unbounded;
+        } else if (eat('+')) {
+            min = 1;
+            max = unbounded;
+        } else if (eat('?')) {
+            max = 1;
+        } else if (at('{')) {
+            if (!bounds(min, max)) {
+                fail();
+                return;
+            }
+        } else {
+            return;
+        }
+        eat('?'); // a lazy quantifier matches the same strings
+        if (min > max_repeat || (max != unbounded && (max > max_repeat || max < min)) ||
+            at('*') || at('+') || at('?') || at('{')) {
+            fail();
+            return;
+        }
+        regex_node rep;
+        rep.type = regex_node::kind::repeat;
+        rep.min = min;
+        rep.max = max;
+        rep.items.push_back(std::move(item));
+        item = std::move(rep);
+    }
+
+    bool bounds(size_t& min, size_t& max) {
+        ++pos_;
+        if (!number(min)) {
+            return false;
+        }
+        max = min;
+        if (eat(',')) {
+            max = unbounded;
+            if (pos_ < end_ && is_ascii_digit(p_[pos_]) && !number(max)) {
+                return false;
+            }
+        }
+        return eat('}');
+    }
+
+    bool number(size_t& out) {
+        const size_t start = pos_;
+        out = 0;
+        while (pos_ < end_ && is_ascii_digit(p_[pos_])) {
+            out = std::min(out * 10 + static_cast<size_t>(p_[pos_++] - '0'), max_repeat + 1);
+        }
+        return pos_ != start;
+    }
+
+    std::optional<byte_set> escape(bool in_class) {
+        if (pos_ >= end_) {
+            return std::nullopt;
+        }
+        const byte_set digits = byte_range('0', '9');
+        const byte_set word = digits | byte_range('a', 'z') | byte_range('A', 'Z') |
+                              byte_range('_', '_');
+        const byte_set space = byte_range('\t', '\r') | byte_range(' ', ' ');
+        const char c = p_[pos_++];
+        switch (c) {
+        case 'd':
+            return digits;
+        case 'D':
+            return ~digits;
+        case 'w':
+            return word;
+        case 'W':
+            return ~word;
+        case 's':
+            return space;
+        case 'S':
+            return ~space;
+        case 't':
+            return byte_range('\t', '\t');
+        case 'n':
+            return byte_range('\n', '\n');
+        case 'r':
+            return byte_range('\r', '\r');
+        case 'f':
+            return byte_range('\f', '\f');
+        case 'v':
+            return byte_range('\v', '\v');
+        case 'b':
+            // A word boundary outside a class
+            return in_class ? std::optional(byte_range('\b', '\b')) : std::nullopt;
+        case '0':
+            return at_digit() ? std::nullopt : std::optional(byte_range(0, 0));
+        case 'x':
+            return hex(2);
+        case 'u':
+            return hex(4);
+        case 'c':
+            if (pos_ < end_ && is_ascii_alnum(p_[pos_]) && !is_ascii_digit(p_[pos_])) {
+                const int letter = p_[pos_++] % 32;
+                return byte_range(letter, letter);
+            }
+            return std::nullopt;
+        default:
+            // Backreferences, \B, \p{...} and bytes of multi-byte characters
+            if (is_ascii_alnum(c) || static_cast<unsigned char>(c) >= 0x80) {
+                return std::nullopt;
+            }
+            return byte_range(c, c);
+        }
+    }
+
+    bool at_digit() const { return pos_ < end_ && is_ascii_digit(p_[pos_]); }
+
+    // Code points past ASCII are several bytes in the UTF-8 input
+    std::optional<byte_set> hex(size_t digits) {
+        int value = 0;
+        for (size_t i = 0; i < digits; ++i, ++pos_) {
+            if (pos_ >= end_) {
+                return std::nullopt;
+            }
+            const char c = p_[pos_];
+            if (is_ascii_digit(c)) {
+                value = value * 16 + (c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value = value * 16 + (c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value = value * 16 + (c - 'A' + 10);
+            } else {
+                return std::nullopt;
+            }
+        }
+        return value < 0x80 ? std::optional(byte_range(value, value)) : std::nullopt;
+    }
+
+    struct class_atom {
+        byte_set chars;
+        int single = -1; // the byte, when the atom can bound a range
+    };
+
+    std::optional<class_atom> class_item() {
+        const char c = p_[pos_++];
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            return std::nullopt;
+        }
+        if (c == '[' && (at(':') || at('.') || at('='))) {
+            return std::nullopt; // [:alpha:], [.a.] and [=a=]
+        }
+        if (c != '\\') {
+            return class_atom{byte_range(c, c), c};
+        }
+        const bool shorthand = pos_ < end_ && std::string_view("dDwWsS").find(p_[pos_]) !=
+                                                  std::string_view::npos;
+        auto chars = escape(true);
+        if (!chars) {
+            return std::nullopt;
+        }
+        class_atom item{*chars, -1};
+        if (!shorthand) {
+            for (int b = 0; b < 256; ++b) {
+                if (chars->test(static_cast<size_t>(b))) {
+                    item.single = b;
+                }
+            }
+        }
+        return item;
+    }
+
+    regex_node char_class() {
+        const bool negate = eat('^');
+        if (at(']')) {
+            return fail(); // [] and [^]
+        }
+        byte_set chars;
+        while (!eat(']')) {
+            if (pos_ >= end_) {
+                return fail();
+            }
+            auto first = class_item();
+            if (!first) {
+                return fail();
+            }
+            if (pos_ + 1 < end_ && p_[pos_] == '-' && p_[pos_ + 1] != ']') {
+                ++pos_;
+                auto last = class_item();
+                if (!last || first->single < 0 || last->single < first->single) {
+                    return fail();
+                }
+                chars |= byte_range(first->single, last->single);
+            } else {
+                chars |= first->chars;
+            }
+        }
+        return set_node(negate ? ~chars : chars);
+    }
+
+    std::string_view p_;
+    size_t pos_ = 0;
+    size_t end_;
+    bool failed_ = false;
+};
+
+// Thompson NFA: each state has at most one byte-set edge plus epsilon edges
+struct nfa {
+    struct state {
+        byte_set chars;
+        int next = -1;
+        std::vector<int> eps;
+    };
+    struct fragment {
+        int start;
+        int accept;
+    };
+
+    std::vector<state> states;
+
+    std::optional<int> add() {
+        if (states.size() >= max_nfa_states) {
+            return std::nullopt;
+        }
+        states.emplace_back();
+        return static_cast<int>(states.size() - 1);
+    }
+
+    void link(int from, int to) { states[static_cast<size_t>(from)].eps.push_back(to); }
+
+    std::optional<fragment> build(const regex_node& n) {
+        switch (n.type) {
+        case regex_node::kind::set: {
+            auto s = add();
+            auto t = add();
+            if (!s || !t) {
+                return std::nullopt;
+            }
+            states[static_cast<size_t>(*s)].chars = n.chars;
+            states[static_cast<size_t>(*s)].next = *t;
+            return fragment{*s, *t};
+        }
+        case regex_node::kind::concat: {
+            auto s = add();
+            if (!s) {
+                return std::nullopt;
+            }
+            int tail = *s;
+            for (const auto& item : n.items) {
+                auto f = build(item);
+                if (!f) {
+                    return std::nullopt;
+                }
+                link(tail, f->start);
+                tail = f->accept;
+            }
+            return fragment{*s, tail};
+        }
+        case regex_node::kind::alternation: {
+            auto s = add();
+            auto t = add();
+            if (!s || !t) {
+                return std::nullopt;
+            }
+            for (const auto& item : n.items) {
+                auto f = build(item);
+                if (!f) {
+                    return std::nullopt;
+                }
+                link(*s, f->start);
+                link(f->accept, *t);
+            }
+            return fragment{*s, *t};
+        }
+        case regex_node::kind::repeat:
+            break;
+        }
+
+        // Repeats are unrolled: `min` required copies, then optional ones or a loop
+        auto s = add();
+        auto t = add();
+        if (!s || !t) {
+            return std::nullopt;
+        }
+        int tail = *s;
+        for (size_t i = 0; i < n.min; ++i) {
+            auto f = build(n.items.front());
+            if (!f) {
+                return std::nullopt;
+            }
+            link(tail, f->start);
+            tail = f->accept;
+        }
+        if (n.max == unbounded) {
+            auto f = build(n.items.front());
+            if (!f) {
+                return std::nullopt;
+            }
+            link(tail, f->start);
+            link(f->accept, tail);
+        } else {
+            for (size_t i = n.min; i < n.max; ++i) {
+                auto f = build(n.items.front());
+                if (!f) {
+                    return std::nullopt;
+                }
+                link(tail, *t);
+                link(tail, f->start);
+                tail = f->accept;
+            }
+        }
+        link(tail, *t);
+        return fragment{*s, *t};
+    }
+
+    // Sorted set of states reachable from `from` over epsilon edges
+    std::vector<int> closure(std::vector<int> from) const {
+        std::vector<char> seen(states.size(), 0);
+        std::vector<int> out;
+        while (!from.empty()) {
+            const int s = from.back();
+            from.pop_back();
+            if (seen[static_cast<size_t>(s)]) {
+                continue;
+            }
+            seen[static_cast<size_t>(s)] = 1;
+            out.push_back(s);
+            for (int e : states[static_cast<size_t>(s)].eps) {
+                from.push_back(e);
+            }
+        }
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+};
+
+// State 0 is dead and state 1 the start, as katana::pattern_dfa expects
+struct dfa_tables {
+    std::vector<size_t> byte_class = std::vector<size_t>(256, 0);
+    size_t classes = 0;
+    std::vector<size_t> next; // states * classes
+    std::vector<bool> accepting;
+
+    size_t states() const { return accepting.size(); }
+    size_t step(size_t state, size_t byte) const {
+        return next[state * classes + byte_class[byte]];
+    }
+};
+
+// Bytes that every NFA edge treats alike share an input class
+void split_byte_classes(const nfa& a, dfa_tables& d, std::vector<size_t>& representative) {
+    std::vector<const byte_set*> sets;
+    for (const auto& s : a.states) {
+        if (s.next >= 0) {
+            sets.push_back(&s.chars);
+        }
+    }
+    std::map<std::vector<bool>, size_t> ids;
+    for (size_t b = 0; b < 256; ++b) {
+        std::vector<bool> signature;
+        signature.reserve(sets.size());
+        for (const auto* set : sets) {
+            signature.push_back(set->test(b));
+        }
+        auto [it, inserted] = ids.emplace(std::move(signature), ids.size());
+        if (inserted) {
+            representative.push_back(b);
+        }
+        d.byte_class[b] = it->second;
+    }
+    d.classes = ids.size();
+}
+
+std::optional<dfa_tables> subset_construction(const nfa& a, const nfa::fragment& f) {
+    dfa_tables d;
+    std::vector<size_t> representative;
+    split_byte_classes(a, d, representative);
+
+    std::map<std::vector<int>, size_t> ids;
+    std::vector<std::vector<int>> sets{{}, a.closure({f.start})};
+    ids.emplace(sets[0], 0);
+    ids.emplace(sets[1], 1);
+    d.next.assign(2 * d.classes, 0);
+    for (size_t i = 1; i < sets.size(); ++i) {
+        for (size_t c = 0; c < d.classes; ++c) {
+            std::vector<int> moved;
+            for (int s : sets[i]) {
+                const auto& st = a.states[static_cast<size_t>(s)];
+                if (st.next >= 0 && st.chars.test(representative[c])) {
+                    moved.push_back(st.next);
+                }
+            }
+            auto target = a.closure(std::move(moved));
+            auto [it, inserted] = ids.emplace(target, sets.size());
+            if (inserted) {
+                if (sets.size() >= max_dfa_states) {
+                    return std::nullopt;
+                }
+                sets.push_back(std::move(target));
+                d.next.resize(sets.size() * d.classes, 0);
+            }
+            d.next[i * d.classes + c] = it->second;
+        }
+    }
+    for (const auto& set : sets) {
+        d.accepting.push_back(std::binary_search(set.begin(), set.end(), f.accept));
+    }
+    return d;
+}
+
+// Moore partition refinement, then classes whose columns ended up equal are merged and the
+// class covering the most bytes becomes class 0, the one pattern_dfa needs no ranges for
+std::optional<dfa_tables> minimize(const dfa_tables& d) {
+    const size_t n = d.states();
+    std::vector<size_t> block(n);
+    size_t blocks = 0;
+    for (size_t s = 0; s < n; ++s) {
+        block[s] = d.accepting[s] ? 1 : 0;
+    }
+    while (true) {
+        std::map<std::vector<size_t>, size_t> ids;
+        std::vector<size_t> refined(n);
+        for (size_t s = 0; s < n; ++s) {
+            std::vector<size_t> signature{block[s]};
+            for (size_t c = 0; c < d.classes; ++c) {
+                signature.push_back(block[d.next[s * d.classes + c]]);
+            }
+            refined[s] = ids.emplace(std::move(signature), ids.size()).first->second;
+        }
+        block = std::move(refined);
+        if (ids.size() == blocks) {
+            break;
+        }
+        blocks = ids.size();
+    }
+    if (block[1] == block[0]) {
+        return std::nullopt; // matches nothing
+    }
+
+    // Dead block first, then breadth-first from the start
+    std::vector<size_t> order(blocks, static_cast<size_t>(-1));
+    std::vector<size_t> first_state(blocks, 0);
+    for (size_t s = n; s-- > 0;) {
+        first_state[block[s]] = s;
+    }
+    std::vector<size_t> queue{block[0], block[1]};
+    order[block[0]] = 0;
+    order[block[1]] = 1;
+    for (size_t i = 1; i < queue.size(); ++i) {
+        const size_t s = first_state[queue[i]];
+        for (size_t c = 0; c < d.classes; ++c) {
+            const size_t b = block[d.next[s * d.classes + c]];
+            if (order[b] == static_cast<size_t>(-1)) {
+                order[b] = queue.size();
+                queue.push_back(b);
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> columns(d.classes, std::vector<size_t>(queue.size()));
+    for (size_t i = 0; i < queue.size(); ++i) {
+        const size_t s = first_state[queue[i]];
+        for (size_t c = 0; c < d.classes; ++c) {
+            columns[c][i] = order[block[d.next[s * d.classes + c]]];
+        }
+    }
+    std::vector<size_t> bytes_in(d.classes, 0);
+    for (size_t b = 0; b < 256; ++b) {
+        ++bytes_in[d.byte_class[b]];
+    }
+    std::map<std::vector<size_t>, size_t> merged;
+    std::vector<size_t> merged_bytes;
+    std::vector<size_t> class_of(d.classes);
+    for (size_t c = 0; c < d.classes; ++c) {
+        auto [it, inserted] = merged.emplace(columns[c], merged.size());
+        if (inserted) {
+            merged_bytes.push_back(0);
+        }
+        class_of[c] = it->second;
+        merged_bytes[it->second] += bytes_in[c];
+    }
+    const size_t widest = static_cast<size_t>(
+        std::max_element(merged_bytes.begin(), merged_bytes.end()) - merged_bytes.begin());
+    for (auto& c : class_of) {
+        c = c == widest ? 0 : c == 0 ? widest : c;
+    }
+
+    dfa_tables m;
+    m.classes = merged.size();
+    m.next.assign(queue.size() * m.classes, 0);
+    for (size_t b = 0; b < 256; ++b) {
+        m.byte_class[b] = class_of[d.byte_class[b]];
+    }
+    for (size_t c = 0; c < d.classes; ++c) {
+        for (size_t i = 0; i < queue.size(); ++i) {
+            m.next[i * m.classes + class_of[c]] = columns[c][i];
+        }
+    }
+    for (size_t i = 0; i < queue.size(); ++i) {
+        m.accepting.push_back(d.accepting[first_state[queue[i]]]);
+    }
+    return m;
+}
+
+std::optional<dfa_tables> build_dfa(std::string_view pattern) {
+    auto root = regex_parser(pattern).parse();
+    if (!root) {
+        return std::nullopt;
+    }
+    nfa a;
+    auto f = a.build(*root);
+    if (!f) {
+        return std::nullopt;
+    }
+    auto d = subset_construction(a, *f);
+    return d ? minimize(*d) : std::nullopt;
+}
+
+// Product walk over both automata; they differ if some pair disagrees on accepting
+bool same_language(const dfa_tables& a, const dfa_tables& b) {
+    std::set<std::pair<size_t, size_t>> seen{{1, 1}};
+    std::vector<std::pair<size_t, size_t>> work{{1, 1}};
+    while (!work.empty()) {
+        const auto [x, y] = work.back();
+        work.pop_back();
+        if (a.accepting[x] != b.accepting[y]) {
+            return false;
+        }
+        for (size_t byte = 0; byte < 256; ++byte) {
+            const std::pair next{a.step(x, byte), b.step(y, byte)};
+            if (seen.insert(next).second) {
+                work.push_back(next);
+            }
+        }
+    }
+    return true;
+}
+
+struct known_shape {
+    std::string_view pattern;
+    std::string_view checker;
+};
+
+// Hand-written checkers in katana/core/validation.hpp and the patterns they decide exactly
+constexpr known_shape known_shapes[] = {
+    {R"([0-9a-fA-F]{8}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{4}-[0-9a-fA-F]{12})",
+     "katana::is_valid_uuid"},
+    {R"([0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12})",
+     "katana::is_lowercase_uuid"},
+    {R"([^@]+@[^.]+\.[\s\S]+)", "katana::is_valid_email"},
+    {R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})", "katana::is_common_email"},
+    {R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d*)?(Z|[+-]\d{2}:\d{2}))",
+     "katana::is_valid_datetime"},
+    {R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(\.\d+)?(Z|[+-]\d{2}:\d{2}))",
+     "katana::is_strict_datetime"},
+    {R"(\d{4}-\d{2}-\d{2})", "katana::is_iso_date"},
+};
+
+std::string_view known_checker(const dfa_tables& d) {
+    static const auto shapes = [] {
+        std::vector<std::pair<dfa_tables, std::string_view>> out;
+        for (const auto& shape : known_shapes) {
+            out.emplace_back(*build_dfa(shape.pattern), shape.checker);
+        }
+        return out;
+    }();
+    for (const auto& [shape, checker] : shapes) {
+        // Minimal automata for one language have the same number of states
+        if (shape.states() == d.states() && same_language(shape, d)) {
+            return checker;
+        }
+    }
+    return {};
+}
+
+// Initializer lines for katana::pattern_dfa<states, classes>
+std::string dfa_declaration(const dfa_tables& d) {
+    std::string out = "static constexpr katana::pattern_dfa<" + std::to_string(d.states()) +
+                      ", " + std::to_string(d.classes) + "> dfa_{\n    {";
+    size_t ranges = 0;
+    for (size_t b = 0; b < 256;) {
+        size_t last = b;
+        while (last + 1 < 256 && d.byte_class[last + 1] == d.byte_class[b]) {
+            ++last;
+        }
+        if (d.byte_class[b] != 0) {
+            if (ranges > 0) {
+                out += ranges % 6 == 0 ? ",\n     " : ", ";
+            }
+            out += "{" + std::to_string(b) + ", " + std::to_string(last) + ", " +
+                   std::to_string(d.byte_class[b]) + "}";
+            ++ranges;
+        }
+        b = last + 1;
+    }
+    out += "},\n    {";
+    for (size_t i = 0; i < d.next.size(); ++i) {
+        if (i > 0) {
+            out += i % d.classes == 0 || i % d.classes % 16 == 0 ? ",\n     " : ", ";
+        }
+        out += std::to_string(d.next[i]);
+    }
+    out += "},\n    {";
+    size_t accepting = 0;
+    for (size_t s = 0; s < d.states(); ++s) {
+        if (d.accepting[s]) {
+            if (accepting > 0) {
+                out += accepting % 16 == 0 ? ",\n     " : ", ";
+            }
+            out += std::to_string(s);
+            ++accepting;
+        }
+    }
+    out += "}};";
+    return out;
+}
+
+} // namespace
+
+std::optional<compiled_pattern> compile_pattern(std::string_view pattern) {
+    auto d = build_dfa(pattern);
+    if (!d) {
+        return std::nullopt;
+    }
+    compiled_pattern out;
+    out.checker = std::string(known_checker(*d));
+    if (out.checker.empty()) {
+        out.dfa = dfa_declaration(*d);
+    }
+    return out;
+}
+
+bool needs_std_regex(const katana::openapi::schema& s) {
+    for (const auto& prop : s.properties) {
+        if (prop.type && prop.type->kind == katana::openapi::schema_kind::string &&
+            !prop.type->pattern.empty() && !compile_pattern(prop.type->pattern)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace katana_gen
@@ -1,5 +1,7 @@
 #include "generator.hpp"
 
+#include "katana/core/msgpack.hpp"
+
 #include <algorithm>
 #include <sstream>
 #include <string>
@@ -8,6 +10,44 @@
 
 namespace katana_gen {
 
+namespace {
+
+// Route pattern with `{name:int}` / `{name:uuid}` constraints derived from the path
+// parameter schemas, so type mismatches are rejected while matching.
+std::string typed_route_path(std::string_view path, const katana::openapi::operation& op) {
+    std::string out;
+    out.reserve(path.size() + 16);
+    size_t pos = 0;
+    while (pos < path.size()) {
+        auto open = path.find('{', pos);
+        auto close = open == std::string_view::npos ? open : path.find('}', open);
+        if (close == std::string_view::npos) {
+            out.append(path.substr(pos));
+            break;
+        }
+        auto name = path.substr(open + 1, close - open - 1);
+        out.append(path.substr(pos, close - pos));
+        for (const auto& param : op.parameters) {
+            if (param.in != katana::openapi::param_location::path || !param.type ||
+                param.name != name) {
+                continue;
+            }
+            if (param.type->kind == katana::openapi::schema_kind::integer) {
+                out.append(":int");
+            } else if (param.type->kind == katana::openapi::schema_kind::string &&
+                       param.type->format == "uuid") {
+                out.append(":uuid");
+            }
+            break;
+        }
+        out.push_back('}');
+        pos = close + 1;
+    }
+    return out;
+}
+
+} // namespace
+
 std::string generate_router_table(const document& doc) {
     std::ostringstream out;
     out << "#pragma once\n\n";
@@ -164,7 +204,8 @@ std::string generate_router_table(const document& doc) {
     return out.str();
 }
 
-std::string generate_router_bindings(const document& doc) {
+std::string
+generate_router_bindings(const document& doc, bool fused_validation, bool msgpack) {
     std::ostringstream out;
     out << "// Auto-generated router bindings from OpenAPI specification\n";
     out << "// \n";
@@ -192,6 +233,9 @@ std::string generate_router_bindings(const document& doc) {
     out << "#include \"generated_routes.hpp\"\n";
     out << "#include \"generated_handlers.hpp\"\n";
     out << "#include \"generated_json.hpp\"\n";
+    if (msgpack) {
+        out << "#include \"generated_msgpack.hpp\"\n";
+    }
     out << "#include \"generated_validators.hpp\"\n";
     out << "#include <array>\n";
     out << "#include <charconv>\n";
@@ -202,45 +246,6 @@ std::string generate_router_bindings(const document& doc) {
     out << "\n";
     out << "namespace generated {\n\n";
 
-    out << "inline std::optional<std::string_view> query_param(std::string_view uri, "
-           "std::string_view key) {\n";
-    out << "    auto qpos = uri.find('?');\n";
-    out << "    if (qpos == std::string_view::npos) return std::nullopt;\n";
-    out << "    auto query = uri.substr(qpos + 1);\n";
-    out << "    while (!query.empty()) {\n";
-    out << "        auto amp = query.find('&');\n";
-    out << "        auto part = query.substr(0, amp);\n";
-    out << "        auto eq = part.find('=');\n";
-    out << "        auto name = part.substr(0, eq);\n";
-    out << "        if (name == key) {\n";
-    out << "            if (eq == std::string_view::npos) return std::string_view{};\n";
-    out << "            return part.substr(eq + 1);\n";
-    out << "        }\n";
-    out << "        if (amp == std::string_view::npos) break;\n";
-    out << "        query.remove_prefix(amp + 1);\n";
-    out << "    }\n";
-    out << "    return std::nullopt;\n";
-    out << "}\n\n";
-
-    out << "inline std::optional<std::string_view> cookie_param(const katana::http::request& req, "
-           "std::string_view key) {\n";
-    out << "    auto cookie = req.headers.get(\"Cookie\");\n";
-    out << "    if (!cookie) return std::nullopt;\n";
-    out << "    std::string_view rest = *cookie;\n";
-    out << "    while (!rest.empty()) {\n";
-    out << "        auto sep = rest.find(';');\n";
-    out << "        auto token = rest.substr(0, sep);\n";
-    out << "        if (sep != std::string_view::npos) rest.remove_prefix(sep + 1);\n";
-    out << "        auto eq = token.find('=');\n";
-    out << "        if (eq == std::string_view::npos) continue;\n";
-    out << "        auto name = katana::serde::trim_view(token.substr(0, eq));\n";
-    out << "        auto val = katana::serde::trim_view(token.substr(eq + 1));\n";
-    out << "        if (name == key) return val;\n";
-    out << "        if (sep == std::string_view::npos) break;\n";
-    out << "    }\n";
-    out << "    return std::nullopt;\n";
-    out << "}\n\n";
-
     out << "inline std::optional<size_t> find_content_type(std::optional<std::string_view> "
            "header,\n"
            "                                               std::span<const content_type_info> "
@@ -351,6 +356,15 @@ std::string generate_router_bindings(const document& doc) {
             }
             bool has_body = op.body && !op.body->content.empty();
             bool body_is_variant = body_schema_names.size() > 1;
+            // A single object body is validated while it is parsed, see parse_validated_*
+            bool body_is_fused = false;
+            if (fused_validation && has_body && body_schema_names.size() == 1) {
+                body_is_fused = std::all_of(
+                    op.body->content.begin(), op.body->content.end(), [&](const auto& media) {
+                        return schema_identifier(doc, media.type).empty() ||
+                               has_fused_parser(doc, media.type);
+                    });
+            }
             std::string body_type_expr;
             if (has_body) {
                 if (body_is_variant) {
@@ -368,8 +382,8 @@ std::string generate_router_bindings(const document& doc) {
             }
             out << "        route_entry{katana::http::method::" << method_enum_literal(op.method)
                 << ",\n";
-            out << "                   katana::http::path_pattern::from_literal<\"" << path.path
-                << "\">(),\n";
+            out << "                   katana::http::path_pattern::from_literal<\""
+                << typed_route_path(path.path, op) << "\">(),\n";
             out << "                   handler_fn([&handler](const katana::http::request& req, "
                    "katana::http::request_context& ctx) -> katana::result<katana::http::response> "
                    "{\n";
@@ -383,6 +397,10 @@ std::string generate_router_bindings(const document& doc) {
                 out << "                           return katana::http::response::error("
                        "katana::problem_details::not_acceptable(\"unsupported Accept header\"));\n";
                 out << "                       }\n";
+                if (msgpack) {
+                    // Lets the handler answer in the negotiated format: encode_<name>(...)
+                    out << "                       ctx.response_type = *negotiated_response;\n";
+                }
             }
 
             // Path params extraction
@@ -391,8 +409,9 @@ std::string generate_router_bindings(const document& doc) {
                     continue;
                 }
                 auto param_ident = sanitize_identifier(param.name);
-                out << "                       auto p_" << param_ident << " = ctx.params.get(\""
-                    << param.name << "\");\n";
+                const bool typed_int = param.type->kind == katana::openapi::schema_kind::integer;
+                out << "                       auto p_" << param_ident << " = ctx.params."
+                    << (typed_int ? "get_int" : "get") << "(\"" << param.name << "\");\n";
                 out << "                       if (!p_" << param_ident
                     << ") return "
                        "katana::http::response::error(katana::problem_details::bad_request("
@@ -401,16 +420,9 @@ std::string generate_router_bindings(const document& doc) {
                     << param.name << "\"));\n";
                 switch (param.type->kind) {
                 case katana::openapi::schema_kind::integer:
-                    out << "                       int64_t " << param_ident << " = 0;\n";
-                    out << "                       {\n";
-                    out << "                           auto [ptr, ec] = std::from_chars(p_"
-                        << param_ident << "->data(), p_" << param_ident << "->data() + p_"
-                        << param_ident << "->size(), " << param_ident << ");\n";
-                    out << "                           if (ec != std::errc()) return "
-                           "katana::http::response::error("
-                           "katana::problem_details::bad_request(\"invalid path param "
-                        << param.name << "\"));\n";
-                    out << "                       }\n";
+                    // `{name:int}` in the route pattern: converted while matching
+                    out << "                       int64_t " << param_ident << " = *p_"
+                        << param_ident << ";\n";
                     break;
                 case katana::openapi::schema_kind::number:
                     out << "                       double " << param_ident << " = 0.0;\n";
@@ -445,11 +457,11 @@ std::string generate_router_bindings(const document& doc) {
                 std::string source_expr;
                 auto param_ident = sanitize_identifier(param.name);
                 if (param.in == katana::openapi::param_location::query) {
-                    source_expr = "query_param(req.uri, \"" + std::string(param.name) + "\")";
+                    source_expr = "ctx.query.get(\"" + std::string(param.name) + "\")";
                 } else if (param.in == katana::openapi::param_location::header) {
                     source_expr = "req.headers.get(\"" + std::string(param.name) + "\")";
                 } else if (param.in == katana::openapi::param_location::cookie) {
-                    source_expr = "cookie_param(req, \"" + std::string(param.name) + "\")";
+                    source_expr = "ctx.cookies.get(\"" + std::string(param.name) + "\")";
                 }
 
                 out << "                       auto p_" << param_ident << " = " << source_expr
@@ -587,8 +599,45 @@ std::string generate_router_bindings(const document& doc) {
                      ++media_idx) {
                     const auto& media = op.body->content[media_idx];
                     auto media_name = schema_identifier(doc, media.type);
+                    const bool media_msgpack =
+                        msgpack && katana::serde::is_msgpack_media_type(media.content_type);
                     out << "                       case " << media_idx << ": {\n";
-                    if (!media_name.empty()) {
+                    if (media_msgpack && has_msgpack_codec(doc, media.type)) {
+                        out << "                           auto candidate = parse_msgpack_"
+                            << media_name << "(req.body, &ctx.arena);\n";
+                        out << "                           if (!candidate) return "
+                               "katana::http::response::error("
+                               "katana::problem_details::bad_request(\"invalid request body\"));\n";
+                        if (body_is_fused) {
+                            // The JSON case checks while parsing; MessagePack checks after
+                            out << "                           if (auto err = validate_"
+                                << media_name << "(*candidate)) return "
+                                << "format_validation_error(*err);\n";
+                        }
+                        if (body_is_variant || body_schema_names.size() > 1) {
+                            out << "                           parsed_body = *candidate;\n";
+                        } else {
+                            out << "                           parsed_body = "
+                                   "std::move(*candidate);\n";
+                        }
+                    } else if (media_msgpack) {
+                        out << "                           return "
+                               "katana::http::response::error(katana::problem_details::unsupported_"
+                               "media_type("
+                               "\"unsupported Content-Type\"));\n";
+                    } else if (!media_name.empty() && body_is_fused) {
+                        out << "                           auto& candidate = "
+                               "parsed_body.emplace(&ctx.arena);\n";
+                        out << "                           if (auto err = parse_validated_"
+                            << media_name << "(req.body, &ctx.arena, candidate)) {\n";
+                        out << "                               if (err->field.empty()) return "
+                               "katana::http::response::error("
+                               "katana::problem_details::bad_request(\"invalid request "
+                               "body\"));\n";
+                        out << "                               return "
+                               "format_validation_error(*err);\n";
+                        out << "                           }\n";
+                    } else if (!media_name.empty()) {
                         out << "                           auto candidate = parse_" << media_name
                             << "(req.body, &ctx.arena);\n";
                         out << "                           if (!candidate) return "
@@ -649,7 +698,7 @@ std::string generate_router_bindings(const document& doc) {
                            "katana::problem_details::bad_request(std::move(*validation_result))\n";
                     out << "                           );\n";
                     out << "                       }\n";
-                } else if (!body_schema_names.empty()) {
+                } else if (!body_schema_names.empty() && !body_is_fused) {
                     // For single type, validate directly
                     std::string schema_name = body_schema_names.front();
                     out << "                       // Automatic validation (optimized: single "